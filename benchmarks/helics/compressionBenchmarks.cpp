@@ -0,0 +1,148 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "helics/core/ActionMessage.hpp"
+#include "helics/network/PayloadCompression.hpp"
+#include "helics_benchmark_util.h"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace helics;  // NOLINT
+
+/** the bandwidth of the link in MB/s used to find the crossover size, 125 MB/s is 1 Gbit/s*/
+static double linkBandwidth{125.0};
+
+/** the per codec results of payload size mapped to the codec time and the bytes saved*/
+static std::map<std::string, std::map<std::int64_t, std::pair<double, double>>> results;
+
+/** generate a vector of doubles as a publication payload
+@param count the number of values
+@param noisy add random noise so the low order bytes of each value are random, otherwise the
+values are quantized to a small number of levels as from a sensor*/
+static std::string generateVector(std::size_t count, bool noisy)
+{
+    std::mt19937 gen(124);
+    std::normal_distribution<double> noise(0.0, 0.01);
+    std::vector<double> vals(count);
+    for (std::size_t ii = 0; ii < count; ++ii) {
+        auto val = 120.0 + 5.0 * std::sin(static_cast<double>(ii) * 0.005);
+        vals[ii] = (noisy) ? val + noise(gen) : std::round(val * 64.0) / 64.0;
+    }
+    return std::string(reinterpret_cast<const char*>(vals.data()), count * sizeof(double));
+}
+
+/** compress and decompress a payload of state.range(0) doubles
+@details the counters report the compressed ratio and the net time gained per message on a link of
+linkBandwidth, which is the time saved sending fewer bytes less the compression and decompression
+time*/
+static void BMcompression(benchmark::State& state, std::uint8_t codecId, bool noisy)
+{
+    auto data = generateVector(static_cast<std::size_t>(state.range(0)), noisy);
+    ActionMessage cmd(CMD_PUB);
+    std::size_t compressedSize{0};
+    double codecTime{0.0};
+    for (auto _ : state) {
+        cmd.payload = data;
+        auto start = std::chrono::high_resolution_clock::now();
+        if (compressPayload(cmd, codecId)) {
+            compressedSize = cmd.payload.size();
+            decompressPayload(cmd);
+        } else {
+            compressedSize = data.size();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        codecTime += std::chrono::duration<double>(end - start).count();
+        benchmark::DoNotOptimize(cmd.payload.data());
+    }
+    auto ratio = static_cast<double>(compressedSize) / static_cast<double>(data.size());
+    auto iterationTime = codecTime / static_cast<double>(state.iterations());
+    state.counters["ratio"] = ratio;
+    auto savedBytes = static_cast<double>(data.size()) * (1.0 - ratio);
+    state.counters["net_gain_us"] = (savedBytes / (linkBandwidth * 1.0e6) - iterationTime) * 1.0e6;
+    std::string label = std::string((codecId == lzCodecId) ? "lz" : "lzshuffle") +
+        ((noisy) ? "_noisy" : "_quantized");
+    results[label][state.range(0)] = {iterationTime, savedBytes};
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(data.size()));
+}
+
+// the payloads range from 1 KB to 8 MB
+BENCHMARK_CAPTURE(BMcompression, lz_quantized, lzCodecId, false)
+    ->RangeMultiplier(4)
+    ->Range(1 << 7, 1 << 20)
+    ->Unit(benchmark::TimeUnit::kMicrosecond);
+BENCHMARK_CAPTURE(BMcompression, lzshuffle_quantized, lzShuffleCodecId, false)
+    ->RangeMultiplier(4)
+    ->Range(1 << 7, 1 << 20)
+    ->Unit(benchmark::TimeUnit::kMicrosecond);
+BENCHMARK_CAPTURE(BMcompression, lz_noisy, lzCodecId, true)
+    ->RangeMultiplier(4)
+    ->Range(1 << 7, 1 << 20)
+    ->Unit(benchmark::TimeUnit::kMicrosecond);
+BENCHMARK_CAPTURE(BMcompression, lzshuffle_noisy, lzShuffleCodecId, true)
+    ->RangeMultiplier(4)
+    ->Range(1 << 7, 1 << 20)
+    ->Unit(benchmark::TimeUnit::kMicrosecond);
+
+/** print the smallest tested payload size at which compression gains time on the link for each
+codec*/
+static void printCrossoverSizes()
+{
+    std::cout << "crossover sizes at a link bandwidth of " << linkBandwidth << " MB/s\n";
+    for (const auto& codec : results) {
+        std::cout << codec.first << ": ";
+        auto crossover =
+            std::find_if(codec.second.begin(), codec.second.end(), [](const auto& res) {
+                return res.second.second / (linkBandwidth * 1.0e6) > res.second.first;
+            });
+        if (crossover == codec.second.end()) {
+            std::cout << "no gain at any tested size\n";
+        } else {
+            std::cout << crossover->first * static_cast<std::int64_t>(sizeof(double))
+                      << " bytes\n";
+        }
+    }
+}
+
+// the link bandwidth is set with --link_bandwidth=<MB/s> and is removed before the benchmark
+// arguments are processed
+int main(int argc, char** argv)
+{
+    const char* bandwidthArg = "--link_bandwidth=";
+    int outArg{1};
+    for (int ii = 1; ii < argc; ++ii) {
+        if (std::strncmp(argv[ii], bandwidthArg, std::strlen(bandwidthArg)) == 0) {
+            linkBandwidth = std::atof(argv[ii] + std::strlen(bandwidthArg));
+        } else {
+            argv[outArg++] = argv[ii];
+        }
+    }
+    argc = outArg;
+    if (linkBandwidth <= 0.0) {
+        std::cerr << "link bandwidth must be positive\n";
+        return 1;
+    }
+    ::benchmark::Initialize(&argc, argv);
+    if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    std::cout << "HELICS_BENCHMARK: compressionBenchmark\n";
+    printHELICSsystemInfo();
+    ::benchmark::RunSpecifiedBenchmarks();
+    printCrossoverSizes();
+}
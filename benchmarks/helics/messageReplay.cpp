@@ -0,0 +1,169 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+
+/** @file
+replay a message stream captured from a broker or core with --capture_messages into a standalone
+broker or core with stubbed communications, and report the processing rate and latency*/
+
+#include "helics/core/CommonCore.hpp"
+#include "helics/core/CoreBroker.hpp"
+#include "helics/core/MessageCapture.hpp"
+#include "helics/core/helicsCLI11.hpp"
+#include "helics_benchmark_util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace helics;  // NOLINT
+
+/** a broker or core with the communications stubbed out and no processing thread*/
+template<class BaseT>
+class ReplayTarget: public BaseT {
+  public:
+    explicit ReplayTarget(const std::string& name): BaseT(name) { this->disableProcessingThread(); }
+    /** configure the object and mark it connected so messages are processed as in a live run*/
+    void setup(const std::string& configureString)
+    {
+        this->configure(configureString);
+        this->brokerState = BaseT::broker_state_t::connected;
+    }
+    std::uint64_t transmitted{0};  //!< the number of messages sent to the stubbed comms
+
+  private:
+    virtual bool brokerConnect() override { return true; }
+    virtual void brokerDisconnect() override {}
+    virtual bool tryReconnect() override { return false; }
+    virtual void transmit(route_id /*rid*/, const ActionMessage& /*cmd*/) override
+    {
+        ++transmitted;
+    }
+    virtual void transmit(route_id /*rid*/, ActionMessage&& /*cmd*/) override { ++transmitted; }
+    virtual void addRoute(route_id /*rid*/, int /*interfaceId*/, const std::string& /*info*/)
+        override
+    {
+    }
+    virtual void removeRoute(route_id /*rid*/) override {}
+    virtual std::string generateLocalAddressString() const override
+    {
+        return this->getIdentifier();
+    }
+};
+
+/** a broker needs nothing beyond the captured messages*/
+static void prepareMessage(CoreBroker& /*target*/, const ActionMessage& /*cmd*/) {}
+
+/** a core needs the federate and interface records the application API would have made*/
+static void prepareMessage(CommonCore& target, const ActionMessage& cmd)
+{
+    target.createReplayRecord(cmd);
+}
+
+/** replay the messages into a new target object
+@param elapsed incremented by the time spent in the replay loop, excluding the construction,
+configuration, and destruction of the target
+@return the processing time of each message in nanoseconds*/
+template<class TargetT>
+std::vector<std::int64_t> replay(const std::vector<CapturedMessage>& messages,
+                                 const std::string& configureString,
+                                 std::uint64_t& transmitted,
+                                 std::chrono::steady_clock::duration& elapsed)
+{
+    TargetT target("replay");
+    target.setup(configureString);
+    std::vector<std::int64_t> latency;
+    latency.reserve(messages.size());
+    auto loopStart = std::chrono::steady_clock::now();
+    for (const auto& captured : messages) {
+        ActionMessage cmd(captured.message);
+        prepareMessage(target, cmd);
+        auto start = std::chrono::steady_clock::now();
+        target.processMessageDirect(cmd);
+        latency.push_back((std::chrono::steady_clock::now() - start).count());
+    }
+    elapsed += std::chrono::steady_clock::now() - loopStart;
+    transmitted += target.transmitted;
+    return latency;
+}
+
+static double percentile(const std::vector<std::int64_t>& sorted, double fraction)
+{
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    auto index = static_cast<std::size_t>(fraction * static_cast<double>(sorted.size() - 1));
+    return static_cast<double>(sorted[index]) / 1000.0;
+}
+
+int main(int argc, char* argv[])
+{
+    std::string captureFile;
+    std::string targetType{"broker"};
+    std::string configureString;
+    int repetitions{1};
+    helics::helicsCLI11App app(
+        "replay a captured message stream into a standalone broker or core for profiling",
+        "helics_message_replay");
+    app.add_option("file", captureFile, "the message capture file to replay")->required();
+    app.add_option("--type", targetType, "the type of object to replay into")
+        ->check(CLI::IsMember({"broker", "core"}));
+    app.add_option("--args",
+                   configureString,
+                   "configuration string for the broker or core, should match the original run");
+    app.add_option("--repeat", repetitions, "the number of times to replay the stream")
+        ->check(CLI::PositiveNumber);
+    auto ret = app.helics_parse(argc, argv);
+    switch (ret) {
+        case helics::helicsCLI11App::parse_output::ok:
+            break;
+        case helics::helicsCLI11App::parse_output::help_call:
+        case helics::helicsCLI11App::parse_output::help_all_call:
+        case helics::helicsCLI11App::parse_output::version_call:
+            return 0;
+        default:
+            return static_cast<int>(ret);
+    }
+
+    std::vector<CapturedMessage> messages;
+    try {
+        messages = loadMessageCapture(captureFile);
+    }
+    catch (const std::invalid_argument& ia) {
+        std::cerr << ia.what() << '\n';
+        return -1;
+    }
+    printHELICSsystemInfo();
+    std::vector<std::int64_t> latency;
+    std::uint64_t transmitted{0};
+    std::chrono::steady_clock::duration replayTime{0};
+    for (int ii = 0; ii < repetitions; ++ii) {
+        auto run = (targetType == "core") ?
+            replay<ReplayTarget<CommonCore>>(messages, configureString, transmitted, replayTime) :
+            replay<ReplayTarget<CoreBroker>>(messages, configureString, transmitted, replayTime);
+        latency.insert(latency.end(), run.begin(), run.end());
+    }
+    std::chrono::duration<double> elapsed = replayTime;
+    std::sort(latency.begin(), latency.end());
+
+    std::cout << "replayed " << latency.size() << " messages into a " << targetType << " ("
+              << messages.size() << " captured, " << repetitions << " repetitions, "
+              << transmitted << " transmitted)\n";
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "replay time " << elapsed.count() << "s, "
+              << static_cast<double>(latency.size()) / elapsed.count() << " messages/s\n";
+    std::cout << "latency (us) p50=" << percentile(latency, 0.5)
+              << " p90=" << percentile(latency, 0.9) << " p99=" << percentile(latency, 0.99)
+              << " p99.9=" << percentile(latency, 0.999)
+              << " max=" << percentile(latency, 1.0) << '\n';
+    return 0;
+}
@@ -27,6 +27,9 @@
 %ignore helics_error;
 %ignore helicsMessageGetRawDataPointer;
 %ignore helicsMessageResize;
+#ifndef HELICS_PYTHON_VECTOR_DATA
+%ignore helicsInputGetVectorData;
+#endif
 
 %include "../helics_enums.h"
 %include "api-data.h"
@@ -179,6 +179,12 @@ class _SwigNonDynamicMeta(type):
 r""" used to not display warnings on mismatched requested times"""
 helics_flag_terminate_on_error = _helics.helics_flag_terminate_on_error
 r""" specify that a federate error should terminate the federation"""
+helics_flag_coupled_iterations = _helics.helics_flag_coupled_iterations
+r"""
+    flag indicating that iterations at the current time are only exchanged with dependents
+       which have a chain of dependents leading back to the federate, other dependents see the
+       federate waiting at the current time until it stops iterating
+    """
 helics_log_level_no_print = _helics.helics_log_level_no_print
 r""" don't print anything except a few catastrophic errors"""
 helics_log_level_error = _helics.helics_log_level_error
@@ -2589,6 +2595,23 @@ def helicsInputGetVector(ipt: "helics_input") -> "int *":
     """
     return _helics.helicsInputGetVector(ipt)
 
+def helicsInputGetVectorData(ipt: "helics_input") -> "double const *":
+    r"""
+    Get a pointer to the vector value of an input without copying the data.
+
+    The pointer refers to storage owned by the input and remains valid until a value is next retrieved from the input
+    or the federate is freed.
+
+    :type ipt: void
+    :param ipt: The input to get the result for.
+
+
+
+    :rtype: float
+    :return: a memoryview of floating point values holding its own copy of the vector which numpy.asarray can wrap without copying
+    """
+    return _helics.helicsInputGetVectorData(ipt)
+
 def helicsInputGetNamedPoint(ipt: "helics_input") -> "int *, double *":
     r"""
     Get a named point from a subscription.
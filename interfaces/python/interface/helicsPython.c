@@ -10827,6 +10827,8 @@ SWIGINTERN PyObject *_wrap_helicsPublicationPublishVector(PyObject *SWIGUNUSEDPA
   int arg3 ;
   helics_error *arg4 = (helics_error *) 0 ;
   int res1 ;
+  Py_buffer bufferView2 ;
+  int isBuffer2 = 0 ;
   helics_error etemp4 ;
   PyObject *swig_obj[2] ;
   
@@ -10841,25 +10843,41 @@ SWIGINTERN PyObject *_wrap_helicsPublicationPublishVector(PyObject *SWIGUNUSEDPA
   }
   {
     int i;
-    if (!PyList_Check(swig_obj[1])) {
-      PyErr_SetString(PyExc_ValueError,"Expected a list");
-      return NULL;
-    }
-    arg3=(int)(PyList_Size(swig_obj[1]));
-    arg2 = (double *) malloc(arg3*sizeof(double));
-    
-    for (i = 0; i < arg3; i++) {
-      PyObject *o = PyList_GetItem(swig_obj[1],i);
-      if (PyFloat_Check(o)) {
-        arg2[i] = PyFloat_AsDouble(o);
-      }else if (PyInt_Check(o))
-      {
-        arg2[i] = (double)(PyInt_AsLong(o));
-      } else {
-        PyErr_SetString(PyExc_ValueError,"List elements must be numbers");
-        free(arg2);
+    if (!PyList_Check(swig_obj[1]) && PyObject_CheckBuffer(swig_obj[1])) {
+      if (PyObject_GetBuffer(swig_obj[1], &bufferView2, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) != 0) {
         return NULL;
       }
+      isBuffer2=1;
+      if (bufferView2.itemsize != sizeof(double) || bufferView2.format == NULL ||
+        (strcmp(bufferView2.format, "d") != 0 && strcmp(bufferView2.format, "@d") != 0 &&
+          strcmp(bufferView2.format, "=d") != 0)) {
+        PyErr_SetString(PyExc_ValueError,"Expected a contiguous buffer of float64 values");
+        PyBuffer_Release(&bufferView2);
+        return NULL;
+      }
+      arg2=(double *)(bufferView2.buf);
+      arg3=(int)(bufferView2.len/bufferView2.itemsize);
+    } else {
+      if (!PyList_Check(swig_obj[1])) {
+        PyErr_SetString(PyExc_ValueError,"Expected a list or a buffer of float64 values");
+        return NULL;
+      }
+      arg3=(int)(PyList_Size(swig_obj[1]));
+      arg2 = (double *) malloc(arg3*sizeof(double));
+      
+      for (i = 0; i < arg3; i++) {
+        PyObject *o = PyList_GetItem(swig_obj[1],i);
+        if (PyFloat_Check(o)) {
+          arg2[i] = PyFloat_AsDouble(o);
+        }else if (PyInt_Check(o))
+        {
+          arg2[i] = (double)(PyInt_AsLong(o));
+        } else {
+          PyErr_SetString(PyExc_ValueError,"List elements must be numbers");
+          free(arg2);
+          return NULL;
+        }
+      }
     }
   }
   helicsPublicationPublishVector(arg1,(double const *)arg2,arg3,arg4);
@@ -10868,7 +10886,11 @@ SWIGINTERN PyObject *_wrap_helicsPublicationPublishVector(PyObject *SWIGUNUSEDPA
     
   }
   {
-    if (arg2) free(arg2);
+    if (isBuffer2) {
+      PyBuffer_Release(&bufferView2);
+    } else if (arg2) {
+      free(arg2);
+    }
   }
   {
     if (arg4->error_code!=helics_ok)
@@ -10880,7 +10902,11 @@ SWIGINTERN PyObject *_wrap_helicsPublicationPublishVector(PyObject *SWIGUNUSEDPA
   return resultobj;
 fail:
   {
-    if (arg2) free(arg2);
+    if (isBuffer2) {
+      PyBuffer_Release(&bufferView2);
+    } else if (arg2) {
+      free(arg2);
+    }
   }
   {
     if (arg4->error_code!=helics_ok)
@@ -11630,6 +11656,74 @@ SWIGINTERN PyObject *_wrap_helicsInputGetVector(PyObject *SWIGUNUSEDPARM(self),
 }
 
 
+SWIGINTERN PyObject *_wrap_helicsInputGetVectorData(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  PyObject *resultobj = 0;
+  helics_input arg1 = (helics_input) 0 ;
+  int *arg2 = (int *) 0 ;
+  helics_error *arg3 = (helics_error *) 0 ;
+  int res1 ;
+  int sizeTemp2 ;
+  helics_error etemp3 ;
+  PyObject *swig_obj[1] ;
+  double *result = 0 ;
+  
+  {
+    sizeTemp2=0;
+    arg2=&sizeTemp2;
+  }
+  {
+    etemp3=helicsErrorInitialize();
+    arg3=&etemp3;
+  }
+  if (!args) SWIG_fail;
+  swig_obj[0] = args;
+  res1 = SWIG_ConvertPtr(swig_obj[0],SWIG_as_voidptrptr(&arg1), 0, 0);
+  if (!SWIG_IsOK(res1)) {
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "helicsInputGetVectorData" "', argument " "1"" of type '" "helics_input""'"); 
+  }
+  result = (double *)helicsInputGetVectorData(arg1,arg2,arg3);
+  {
+    resultobj = SWIG_Py_Void();
+  }
+  {
+    // the storage of the input changes on the next retrieval so the view must own its data
+    PyObject *bytesArray=PyByteArray_FromStringAndSize((const char *)result,
+      (Py_ssize_t)(*arg2)*(Py_ssize_t)sizeof(double));
+    PyObject *o2=NULL;
+    if (bytesArray != NULL) {
+      PyObject *bytesView=PyMemoryView_FromObject(bytesArray);
+      Py_DECREF(bytesArray);
+      if (bytesView != NULL) {
+        o2=PyObject_CallMethod(bytesView, "cast", "s", "d");
+        Py_DECREF(bytesView);
+      }
+    }
+    if (o2 == NULL) {
+      return NULL;
+    }
+    Py_DECREF(resultobj);
+    resultobj = o2;
+  }
+  {
+    if (arg3->error_code!=helics_ok)
+    {
+      throwHelicsPythonException(arg3);
+      return NULL;
+    }
+  }
+  return resultobj;
+fail:
+  {
+    if (arg3->error_code!=helics_ok)
+    {
+      throwHelicsPythonException(arg3);
+      return NULL;
+    }
+  }
+  return NULL;
+}
+
+
 SWIGINTERN PyObject *_wrap_helicsInputGetNamedPoint(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
   PyObject *resultobj = 0;
   helics_input arg1 = (helics_input) 0 ;
@@ -12120,6 +12214,8 @@ SWIGINTERN PyObject *_wrap_helicsInputSetDefaultVector(PyObject *SWIGUNUSEDPARM(
   int arg3 ;
   helics_error *arg4 = (helics_error *) 0 ;
   int res1 ;
+  Py_buffer bufferView2 ;
+  int isBuffer2 = 0 ;
   helics_error etemp4 ;
   PyObject *swig_obj[2] ;
   
@@ -12134,25 +12230,41 @@ SWIGINTERN PyObject *_wrap_helicsInputSetDefaultVector(PyObject *SWIGUNUSEDPARM(
   }
   {
     int i;
-    if (!PyList_Check(swig_obj[1])) {
-      PyErr_SetString(PyExc_ValueError,"Expected a list");
-      return NULL;
-    }
-    arg3=(int)(PyList_Size(swig_obj[1]));
-    arg2 = (double *) malloc(arg3*sizeof(double));
-    
-    for (i = 0; i < arg3; i++) {
-      PyObject *o = PyList_GetItem(swig_obj[1],i);
-      if (PyFloat_Check(o)) {
-        arg2[i] = PyFloat_AsDouble(o);
-      }else if (PyInt_Check(o))
-      {
-        arg2[i] = (double)(PyInt_AsLong(o));
-      } else {
-        PyErr_SetString(PyExc_ValueError,"List elements must be numbers");
-        free(arg2);
+    if (!PyList_Check(swig_obj[1]) && PyObject_CheckBuffer(swig_obj[1])) {
+      if (PyObject_GetBuffer(swig_obj[1], &bufferView2, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) != 0) {
         return NULL;
       }
+      isBuffer2=1;
+      if (bufferView2.itemsize != sizeof(double) || bufferView2.format == NULL ||
+        (strcmp(bufferView2.format, "d") != 0 && strcmp(bufferView2.format, "@d") != 0 &&
+          strcmp(bufferView2.format, "=d") != 0)) {
+        PyErr_SetString(PyExc_ValueError,"Expected a contiguous buffer of float64 values");
+        PyBuffer_Release(&bufferView2);
+        return NULL;
+      }
+      arg2=(double *)(bufferView2.buf);
+      arg3=(int)(bufferView2.len/bufferView2.itemsize);
+    } else {
+      if (!PyList_Check(swig_obj[1])) {
+        PyErr_SetString(PyExc_ValueError,"Expected a list or a buffer of float64 values");
+        return NULL;
+      }
+      arg3=(int)(PyList_Size(swig_obj[1]));
+      arg2 = (double *) malloc(arg3*sizeof(double));
+      
+      for (i = 0; i < arg3; i++) {
+        PyObject *o = PyList_GetItem(swig_obj[1],i);
+        if (PyFloat_Check(o)) {
+          arg2[i] = PyFloat_AsDouble(o);
+        }else if (PyInt_Check(o))
+        {
+          arg2[i] = (double)(PyInt_AsLong(o));
+        } else {
+          PyErr_SetString(PyExc_ValueError,"List elements must be numbers");
+          free(arg2);
+          return NULL;
+        }
+      }
     }
   }
   helicsInputSetDefaultVector(arg1,(double const *)arg2,arg3,arg4);
@@ -12161,7 +12273,11 @@ SWIGINTERN PyObject *_wrap_helicsInputSetDefaultVector(PyObject *SWIGUNUSEDPARM(
     
   }
   {
-    if (arg2) free(arg2);
+    if (isBuffer2) {
+      PyBuffer_Release(&bufferView2);
+    } else if (arg2) {
+      free(arg2);
+    }
   }
   {
     if (arg4->error_code!=helics_ok)
@@ -12173,7 +12289,11 @@ SWIGINTERN PyObject *_wrap_helicsInputSetDefaultVector(PyObject *SWIGUNUSEDPARM(
   return resultobj;
 fail:
   {
-    if (arg2) free(arg2);
+    if (isBuffer2) {
+      PyBuffer_Release(&bufferView2);
+    } else if (arg2) {
+      free(arg2);
+    }
   }
   {
     if (arg4->error_code!=helics_ok)
@@ -17851,6 +17971,20 @@ static PyMethodDef SwigMethods[] = {
 		":rtype: void\n"
 		":return: a list of floating point values\n"
 		""},
+	 { "helicsInputGetVectorData", _wrap_helicsInputGetVectorData, METH_O, "\n"
+		"Get a pointer to the vector value of an input without copying the data.\n"
+		"\n"
+		"The pointer refers to storage owned by the input and remains valid until a value is next retrieved from the input\n"
+		"or the federate is freed.\n"
+		"\n"
+		":type ipt: void\n"
+		":param ipt: The input to get the result for.\n"
+		"\n"
+		"\n"
+		"\n"
+		":rtype: float\n"
+		":return: a memoryview of floating point values holding its own copy of the vector which numpy.asarray can wrap without copying\n"
+		""},
 	 { "helicsInputGetNamedPoint", _wrap_helicsInputGetNamedPoint, METH_O, "\n"
 		"Get a named point from a subscription.\n"
 		"\n"
@@ -19835,6 +19969,7 @@ SWIG_init(void) {
   SWIG_Python_SetConstant(d, "helics_flag_enable_init_entry",SWIG_From_int((int)(helics_flag_enable_init_entry)));
   SWIG_Python_SetConstant(d, "helics_flag_ignore_time_mismatch_warnings",SWIG_From_int((int)(helics_flag_ignore_time_mismatch_warnings)));
   SWIG_Python_SetConstant(d, "helics_flag_terminate_on_error",SWIG_From_int((int)(helics_flag_terminate_on_error)));
+  SWIG_Python_SetConstant(d, "helics_flag_coupled_iterations",SWIG_From_int((int)(helics_flag_coupled_iterations)));
   SWIG_Python_SetConstant(d, "helics_log_level_no_print",SWIG_From_int((int)(helics_log_level_no_print)));
   SWIG_Python_SetConstant(d, "helics_log_level_error",SWIG_From_int((int)(helics_log_level_error)));
   SWIG_Python_SetConstant(d, "helics_log_level_warning",SWIG_From_int((int)(helics_log_level_warning)));
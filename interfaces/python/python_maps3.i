@@ -144,10 +144,27 @@ PyModule_AddObject(m, "HelicsException", pHelicsException);
 }
 
 // typemap for vector input functions
-%typemap(in) (const double *vectorInput, int vectorLength) {
+// objects supporting the buffer protocol with contiguous doubles such as numpy arrays are passed
+// without copying, lists are converted element by element
+%typemap(in) (const double *vectorInput, int vectorLength) (Py_buffer bufferView, int isBuffer=0) {
   int i;
+  if (!PyList_Check($input) && PyObject_CheckBuffer($input)) {
+    if (PyObject_GetBuffer($input, &bufferView, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) != 0) {
+      return NULL;
+    }
+    isBuffer=1;
+    if (bufferView.itemsize != sizeof(double) || bufferView.format == NULL ||
+        (strcmp(bufferView.format, "d") != 0 && strcmp(bufferView.format, "@d") != 0 &&
+         strcmp(bufferView.format, "=d") != 0)) {
+      PyErr_SetString(PyExc_ValueError,"Expected a contiguous buffer of float64 values");
+      PyBuffer_Release(&bufferView);
+      return NULL;
+    }
+    $1=(double *)(bufferView.buf);
+    $2=(int)(bufferView.len/bufferView.itemsize);
+  } else {
   if (!PyList_Check($input)) {
-    PyErr_SetString(PyExc_ValueError,"Expected a list");
+    PyErr_SetString(PyExc_ValueError,"Expected a list or a buffer of float64 values");
     return NULL;
   }
   $2=(int)(PyList_Size($input));
@@ -166,6 +183,7 @@ PyModule_AddObject(m, "HelicsException", pHelicsException);
       return NULL;
     }
   }
+  }
 }
 
 %typemap(argout) (const double *vectorInput, int vectorLength)
@@ -173,7 +191,11 @@ PyModule_AddObject(m, "HelicsException", pHelicsException);
 }
 
 %typemap(freearg) (const double *vectorInput, int vectorLength) {
-   if ($1) free($1);
+   if (isBuffer$argnum) {
+     PyBuffer_Release(&bufferView$argnum);
+   } else if ($1) {
+     free($1);
+   }
 }
 
 // typemap for vector output functions
@@ -207,6 +229,38 @@ PyModule_AddObject(m, "HelicsException", pHelicsException);
   $result = SWIG_Python_AppendOutput($result, o2);
 }
 
+// typemap for vector output through the buffer protocol, the result is a memoryview of doubles
+// owning a single block copy of the vector which numpy.asarray can wrap without copying again
+#define HELICS_PYTHON_VECTOR_DATA
+%typemap(in, numinputs=0) int *vectorSize (int sizeTemp) {
+  sizeTemp=0;
+  $1=&sizeTemp;
+}
+
+%typemap(out) const double *helicsInputGetVectorData {
+  $result = SWIG_Py_Void();
+}
+
+%typemap(argout) int *vectorSize {
+  // the storage of the input changes on the next retrieval so the view must own its data
+  PyObject *bytesArray=PyByteArray_FromStringAndSize((const char *)result,
+      (Py_ssize_t)(*$1)*(Py_ssize_t)sizeof(double));
+  PyObject *o2=NULL;
+  if (bytesArray != NULL) {
+    PyObject *bytesView=PyMemoryView_FromObject(bytesArray);
+    Py_DECREF(bytesArray);
+    if (bytesView != NULL) {
+      o2=PyObject_CallMethod(bytesView, "cast", "s", "d");
+      Py_DECREF(bytesView);
+    }
+  }
+  if (o2 == NULL) {
+    return NULL;
+  }
+  Py_DECREF($result);
+  $result = o2;
+}
+
 
 // typemap for raw data input
 %typemap(in) (const void *data, int inputDataLength) {
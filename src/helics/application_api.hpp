@@ -7,6 +7,7 @@ SPDX-License-Identifier: BSD-3-Clause
 #pragma once
 
 #include "application_api/BrokerApp.hpp"
+#include "application_api/CallbackFederate.hpp"
 #include "application_api/CombinationFederate.hpp"
 #include "application_api/CoreApp.hpp"
 #include "application_api/Endpoints.hpp"
@@ -10,6 +10,7 @@ SPDX-License-Identifier: BSD-3-Clause
 #include <future>
 #include <map>
 #include <string>
+#include <vector>
 
 namespace helics {
 /** helper class for Federate info that holds the futures for asynchronous calls*/
@@ -24,5 +25,6 @@ class AsyncFedCallInfo {
     std::atomic<int> queryCounter{0};  //!< counter for the number of queries
     std::map<int, std::future<std::string>>
         inFlightQueries;  //!< the queries that are actually in flight at a given time
+    std::vector<int32_t> querySubscriptions;  //!< the query subscriptions made by the federate
 };
 }  // namespace helics
@@ -7,16 +7,72 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "BrokerApp.hpp"
 
 #include "../core/BrokerFactory.hpp"
+#include "../core/BrokerTreePlanner.hpp"
 #include "../core/CoreBroker.hpp"
 #include "../core/core-exceptions.hpp"
 #include "../core/coreTypeOperations.hpp"
 #include "../core/helicsCLI11.hpp"
+#include "../network/NetworkBrokerData.hpp"
 
 #include <fstream>
 #include <iostream>
 #include <utility>
 
 namespace helics {
+/** extract the arguments of a broker that sub-brokers constructed below it must share
+@details these are the broker key and the network options, the interface is passed without a port
+so each sub-broker opens its own port
+@param args the remaining arguments of the broker in the reversed order used by CLI11
+*/
+static std::string generateSubBrokerArgs(std::vector<std::string> args)
+{
+    helicsCLI11App parser;
+    parser.remove_helics_specifics();
+    parser.allow_extras();
+    parser.option_defaults()->ignore_underscore();
+    std::vector<std::pair<CLI::Option*, std::string>> valueOptions;
+    std::vector<std::pair<CLI::Option*, std::string>> flagOptions;
+    std::string interfaceAddress;
+    auto* intOpt = parser.add_option("--interface,--localinterface", interfaceAddress);
+    for (const auto* optName : {"--key,--broker_key",
+                                "--portstart",
+                                "--maxsize",
+                                "--maxcount",
+                                "--networkretries",
+                                "--timeout",
+                                "--networktimeout",
+                                "--compression",
+                                "--compression_threshold"}) {
+        std::string name(optName);
+        valueOptions.emplace_back(parser.add_option(name), name.substr(0, name.find(',')));
+    }
+    for (const auto* flagName : {"--local", "--ipv4", "--ipv6", "--all", "--external"}) {
+        flagOptions.emplace_back(parser.add_flag(flagName), flagName);
+    }
+    flagOptions.emplace_back(parser.add_flag("--reuse_address"), "--reuse_address");
+    flagOptions.emplace_back(parser.add_flag("--noack,--noack_connect"), "--noack");
+    flagOptions.emplace_back(parser.add_flag("--osport,--use_os_port"), "--osport");
+    if (parser.helics_parse(std::move(args)) != helicsCLI11App::parse_output::ok) {
+        return std::string{};
+    }
+    std::string subArgs;
+    if (intOpt->count() > 0) {
+        auto interfacePort = extractInterfaceandPortString(interfaceAddress);
+        subArgs.append(" --interface=\"").append(interfacePort.first).push_back('"');
+    }
+    for (auto& vopt : valueOptions) {
+        if (vopt.first->count() > 0) {
+            subArgs.append(" ").append(vopt.second).append("=\"");
+            subArgs.append(vopt.first->as<std::string>()).push_back('"');
+        }
+    }
+    for (auto& fopt : flagOptions) {
+        if (fopt.first->count() > 0) {
+            subArgs.append(" ").append(fopt.second);
+        }
+    }
+    return subArgs;
+}
 
 BrokerApp::BrokerApp(core_type ctype,
                      const std::string& broker_name,
@@ -118,6 +174,26 @@ std::unique_ptr<helicsCLI11App> BrokerApp::generateParser(bool noTypeOption)
     if (name.empty()) {
         app->add_option("--name,-n", name, "name of the broker");
     }
+    auto* tree_group = app->add_option_group(
+        "broker tree", "options for constructing a tree of sub-brokers below the broker");
+    tree_group->add_option("--expected_cores",
+                           expectedCores,
+                           "the number of cores expected to connect to the federation");
+    tree_group->add_option("--expected_federates",
+                           expectedFederates,
+                           "the number of federates expected, used as the number of cores if "
+                           "--expected_cores is not given");
+    tree_group->add_option("--max_fanout",
+                           maxFanout,
+                           "the maximum number of cores or brokers connected to any one broker, "
+                           "sub-brokers are constructed if the expected cores exceed this");
+    tree_group->add_option("--core_loads",
+                           coreLoads,
+                           "the relative load of each expected core, such as message rates "
+                           "observed in a previous run");
+    tree_group->add_option("--tree_file",
+                           treeFile,
+                           "file to write the JSON description of the constructed broker tree to");
     app->allow_extras();
     auto* app_p = app.get();
     app->footer([app_p]() {
@@ -131,6 +207,9 @@ std::unique_ptr<helicsCLI11App> BrokerApp::generateParser(bool noTypeOption)
 void BrokerApp::processArgs(std::unique_ptr<helicsCLI11App>& app)
 {
     auto& remArgs = app->remainArgs();
+    if (maxFanout > 0) {
+        subBrokerArgs = generateSubBrokerArgs(remArgs);
+    }
     try {
         broker = BrokerFactory::create(app->getCoreType(), name, remArgs);
     }
@@ -145,6 +224,43 @@ void BrokerApp::processArgs(std::unique_ptr<helicsCLI11App>& app)
     if (!broker || !broker->isConnected()) {
         throw(ConnectionFailure("Broker is unable to connect\n"));
     }
+    if (maxFanout > 0) {
+        buildBrokerTree(app->getCoreType());
+    }
+}
+
+void BrokerApp::buildBrokerTree(core_type ctype)
+{
+    auto coreCount = (expectedCores > 0) ? expectedCores : expectedFederates;
+    auto plan = generateBrokerTreePlan(coreCount, maxFanout, coreLoads);
+    if (plan.brokerParents.empty()) {
+        return;
+    }
+    std::vector<std::string> brokerNames;
+    std::vector<std::string> brokerAddresses;
+    brokerNames.reserve(plan.brokerParents.size());
+    brokerAddresses.reserve(plan.brokerParents.size());
+    // parents are listed first so the address of the parent is always available
+    for (auto parent : plan.brokerParents) {
+        const auto& parentAddress = (parent < 0) ? broker->getAddress() : brokerAddresses[parent];
+        brokerNames.push_back(broker->getIdentifier() + "_sub" +
+                              std::to_string(brokerNames.size()));
+        auto subBroker = BrokerFactory::create(ctype,
+                                               brokerNames.back(),
+                                               "--broker=" + parentAddress + subBrokerArgs);
+        if (!subBroker || !subBroker->isConnected()) {
+            throw(ConnectionFailure("sub-broker " + brokerNames.back() + " is unable to connect"));
+        }
+        brokerAddresses.push_back(subBroker->getAddress());
+        subBrokers.push_back(std::move(subBroker));
+    }
+    brokerTree = generateBrokerTreeJson(
+        plan, broker->getIdentifier(), broker->getAddress(), brokerNames, brokerAddresses);
+    broker->setGlobal("broker_tree", brokerTree);
+    if (!treeFile.empty()) {
+        std::ofstream out(treeFile);
+        out << brokerTree << std::endl;
+    }
 }
 
 bool BrokerApp::isConnected() const
@@ -244,5 +360,6 @@ void BrokerApp::setLogFile(const std::string& logFile)
 void BrokerApp::reset()
 {
     broker = nullptr;
+    subBrokers.clear();
 }
 }  // namespace helics
@@ -133,12 +133,26 @@ class HELICS_CXX_EXPORT BrokerApp {
 #endif
     /** get a copy of the core pointer*/
     std::shared_ptr<Broker> getCopyofBrokerPointer() const { return broker; }
+    /** get a JSON description of the broker tree constructed below the broker
+    @details the description is also available through a query of the global "broker_tree"
+    @return an empty string if no tree was constructed*/
+    const std::string& getBrokerTree() const { return brokerTree; }
 
   private:
     void processArgs(std::unique_ptr<helicsCLI11App>& app);
     std::unique_ptr<helicsCLI11App> generateParser(bool noTypeOption = false);
+    /** construct sub-brokers below the broker for the expected number of cores*/
+    void buildBrokerTree(core_type ctype);
     std::shared_ptr<Broker> broker;  //!< the actual endpoint objects
     std::string name;  //!< the name of the broker
+    std::vector<std::shared_ptr<Broker>> subBrokers;  //!< brokers constructed below the broker
+    std::vector<double> coreLoads;  //!< the relative load expected from each core
+    std::string brokerTree;  //!< JSON description of the constructed broker tree
+    std::string treeFile;  //!< file to write the broker tree description to
+    std::string subBrokerArgs;  //!< network arguments of the broker shared with its sub-brokers
+    int expectedCores{0};  //!< the number of cores expected to connect
+    int expectedFederates{0};  //!< the number of federates expected to connect
+    int maxFanout{0};  //!< the maximum number of connections to a single broker in the tree
 };
 
 /** class that waits for a broker to terminate before finishing the destructor*/
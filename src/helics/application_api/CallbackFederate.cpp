@@ -0,0 +1,170 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#include "CallbackFederate.hpp"
+
+#include "../core/Core.hpp"
+#include "../core/core-exceptions.hpp"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace helics {
+/** the operator passing the core callbacks on to a CallbackFederate*/
+class CallbackFederateOperator final: public FederateOperator {
+  public:
+    explicit CallbackFederateOperator(CallbackFederate* fed): callbackFed(fed) {}
+    virtual iteration_request initializeOperations() override
+    {
+        return callbackFed->initializeOperations();
+    }
+    virtual std::pair<Time, iteration_request> operate(iteration_time newTime) override
+    {
+        return {callbackFed->stepOperations(newTime.grantedTime), iteration_request::no_iterations};
+    }
+    virtual void finalize() override { callbackFed->finalizeOperations(); }
+    virtual void error_handler(int errorCode, const std::string& errorString) override
+    {
+        callbackFed->errorOperations(errorCode, errorString);
+    }
+
+  private:
+    CallbackFederate* callbackFed;
+};
+
+CallbackFederate::CallbackFederate(const std::string& fedName, const FederateInfo& fi):
+    Federate(fedName, fi), CombinationFederate(fedName, fi)
+{
+}
+
+CallbackFederate::CallbackFederate(const std::string& fedName,
+                                   const std::shared_ptr<Core>& core,
+                                   const FederateInfo& fi):
+    Federate(fedName, core, fi),
+    CombinationFederate(fedName, core, fi)
+{
+}
+
+CallbackFederate::CallbackFederate(const std::string& fedName, const std::string& configString):
+    Federate(fedName, loadFederateInfo(configString)), CombinationFederate(fedName, configString)
+{
+}
+
+CallbackFederate::CallbackFederate(const std::string& configString):
+    Federate(std::string(), loadFederateInfo(configString)), CombinationFederate(configString)
+{
+}
+
+CallbackFederate::~CallbackFederate()
+{
+    if (fedOperator) {
+        waitForCompletion();
+    }
+}
+
+void CallbackFederate::setInitializeCallback(std::function<iteration_request()> callback)
+{
+    initCallback = std::move(callback);
+}
+
+void CallbackFederate::setStepCallback(std::function<Time(Time)> callback)
+{
+    stepCallback = std::move(callback);
+}
+
+void CallbackFederate::setFinalizeCallback(std::function<void()> callback)
+{
+    finalizeCallback = std::move(callback);
+}
+
+void CallbackFederate::setErrorCallback(std::function<void(int, const std::string&)> callback)
+{
+    errorCallback = std::move(callback);
+}
+
+void CallbackFederate::startExecution()
+{
+    if (currentMode != modes::startup || fedOperator) {
+        throw(InvalidFunctionCall("callback execution may only be started from startup mode"));
+    }
+    fedOperator = std::make_shared<CallbackFederateOperator>(this);
+    coreObject->setFederateOperator(getID(), fedOperator);
+}
+
+void CallbackFederate::waitForCompletion()
+{
+    std::unique_lock<std::mutex> lock(completionLock);
+    completionCondition.wait(lock, [this]() { return completed; });
+}
+
+bool CallbackFederate::isCompleted() const
+{
+    std::lock_guard<std::mutex> lock(completionLock);
+    return completed;
+}
+
+iteration_request CallbackFederate::initializeOperations()
+{
+    if (currentMode == modes::startup) {
+        currentMode = modes::initializing;
+        currentTime = coreObject->getCurrentTime(getID());
+        startupToInitializeStateTransition();
+    } else {
+        // entry to executing mode iterated
+        updateTime(currentTime, currentTime);
+    }
+    return (initCallback) ? initCallback() : iteration_request::no_iterations;
+}
+
+Time CallbackFederate::stepOperations(Time grantedTime)
+{
+    if (currentMode == modes::initializing) {
+        currentMode = modes::executing;
+        currentTime = timeZero;
+        initializeToExecuteStateTransition();
+    } else {
+        Time oldTime = currentTime;
+        currentTime = grantedTime;
+        updateTime(grantedTime, oldTime);
+    }
+    return (stepCallback) ? stepCallback(currentTime) : Time::maxVal();
+}
+
+void CallbackFederate::finalizeOperations()
+{
+    if (currentMode != modes::error) {
+        currentMode = modes::finalize;
+    }
+    // notify under the lock since the waiting destructor can destroy the condition variable as
+    // soon as it sees the completion
+    auto complete = [this]() {
+        std::lock_guard<std::mutex> lock(completionLock);
+        completed = true;
+        completionCondition.notify_all();
+    };
+    if (finalizeCallback) {
+        try {
+            finalizeCallback();
+        }
+        catch (...) {
+            // the core logs the exception, but the federate is still complete
+            complete();
+            throw;
+        }
+    }
+    complete();
+}
+
+void CallbackFederate::errorOperations(int errorCode, const std::string& errorString)
+{
+    currentMode = modes::error;
+    if (errorCallback) {
+        errorCallback(errorCode, errorString);
+    }
+}
+
+}  // namespace helics
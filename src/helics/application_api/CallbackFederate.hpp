@@ -0,0 +1,108 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+
+#include "CombinationFederate.hpp"
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace helics {
+class FederateOperator;
+
+/** class defining a federate executed by the core through a set of callbacks
+@details instead of a user thread blocking in each time request, the federate is advanced by the
+core callback threads whenever its requests are granted, so many federates can share a small
+number of threads. The interfaces and callbacks must be set up before calling startExecution,
+and the blocking mode and time functions of the Federate must not be used afterward. The
+callbacks are called from a core thread and may use the interfaces of the federate.
+*/
+class HELICS_CXX_EXPORT CallbackFederate: public CombinationFederate {
+  public:
+    /**constructor taking a federate information structure and using the default core
+    @param fedName the name of the federate, may be left empty to use a default or one found in fi
+    @param fi  a federate information structure
+    */
+    CallbackFederate(const std::string& fedName, const FederateInfo& fi);
+
+    /**constructor taking a federate information structure and using the given core
+    @param fedName the name of the federate, may be left empty to use a default or one found in fi
+    @param core a pointer to core object which the federate can join
+    @param fi  a federate information structure
+    */
+    CallbackFederate(const std::string& fedName,
+                     const std::shared_ptr<Core>& core,
+                     const FederateInfo& fi = FederateInfo{});
+
+    /**constructor taking a federate name and a file with the required information
+    @param fedName the name of the federate, can be empty to use the name from the configString
+    @param configString can be either a JSON file a TOML file (with extension TOML) or a string
+    containing JSON code or a string with command line arguments
+    */
+    CallbackFederate(const std::string& fedName, const std::string& configString);
+
+    /**constructor taking a file with the required information
+     @param configString can be either a JSON file a TOML file (with extension TOML) or a string
+    containing JSON code or a string with command line arguments
+    */
+    explicit CallbackFederate(const std::string& configString);
+
+    /** destructor, waits for the federate to complete if it was started*/
+    virtual ~CallbackFederate();
+    /** the operator refers to the federate so it cannot be moved or copied*/
+    CallbackFederate(CallbackFederate&& fed) = delete;
+    CallbackFederate& operator=(CallbackFederate&& fed) = delete;
+    CallbackFederate(const CallbackFederate& fed) = delete;
+    CallbackFederate& operator=(const CallbackFederate& fed) = delete;
+
+    /** set the callback executed on entry to initializing mode
+    @details it is called again if it requests iteration and the entry to executing mode iterates
+    @param callback a function returning the iteration request for entering executing mode*/
+    void setInitializeCallback(std::function<iteration_request()> callback);
+    /** set the callback executed on entry to executing mode and on each granted time
+    @param callback a function taking the granted time and returning the next time to request,
+    returning Time::maxVal() finalizes the federate*/
+    void setStepCallback(std::function<Time(Time)> callback);
+    /** set the callback executed once the federate has disconnected*/
+    void setFinalizeCallback(std::function<void()> callback);
+    /** set the callback executed if the federate encounters an error, the finalize callback is
+    called afterward*/
+    void setErrorCallback(std::function<void(int, const std::string&)> callback);
+
+    /** hand the federate to the core to execute
+    @details the call returns immediately, the federate enters initializing mode and proceeds
+    through the callbacks on the core callback threads*/
+    void startExecution();
+    /** block until the federate has finalized*/
+    void waitForCompletion();
+    /** check if the federate has finalized*/
+    bool isCompleted() const;
+
+  private:
+    friend class CallbackFederateOperator;
+    /** the operations on entry to initializing mode*/
+    iteration_request initializeOperations();
+    /** the operations on each grant*/
+    Time stepOperations(Time grantedTime);
+    /** the operations after the federate disconnected*/
+    void finalizeOperations();
+    /** the operations on an error*/
+    void errorOperations(int errorCode, const std::string& errorString);
+
+    std::function<iteration_request()> initCallback;
+    std::function<Time(Time)> stepCallback;
+    std::function<void()> finalizeCallback;
+    std::function<void(int, const std::string&)> errorCallback;
+    std::shared_ptr<FederateOperator> fedOperator;  //!< the operator given to the core
+    mutable std::mutex completionLock;  //!< lock protecting completed
+    std::condition_variable completionCondition;  //!< notification of completion
+    bool completed{false};  //!< the federate has finalized
+};
+}  // namespace helics
@@ -21,6 +21,7 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "Filters.hpp"
 #include "helics/helics-config.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <string>
@@ -159,10 +160,22 @@ Federate& Federate::operator=(Federate&& fed) noexcept
     return *this;
 }
 
+/** stop all the query subscriptions made through a federate*/
+static void clearQuerySubscriptions(Core* core, AsyncFedCallInfo& asyncInfo)
+{
+    if (core != nullptr) {
+        for (auto index : asyncInfo.querySubscriptions) {
+            core->unsubscribeQuery(index);
+        }
+    }
+    asyncInfo.querySubscriptions.clear();
+}
+
 Federate::~Federate()
 {
     if (coreObject) {
         try {
+            clearQuerySubscriptions(coreObject.get(), *(asyncCallInfo->lock()));
             finalize();
         }
         // LCOV_EXCL_START
@@ -526,6 +539,9 @@ void Federate::finalizeComplete()
 void Federate::disconnect()
 {
     finalize();
+    if (coreObject) {
+        clearQuerySubscriptions(coreObject.get(), *(asyncCallInfo->lock()));
+    }
     coreObject = nullptr;
 }
 
@@ -1095,6 +1111,37 @@ bool Federate::isQueryCompleted(query_id_t queryIndex) const  // NOLINT
     return false;
 }
 
+query_id_t Federate::subscribeQuery(const std::string& target,
+                                    const std::string& queryStr,
+                                    std::function<void(const std::string&)> callback,
+                                    Time period,
+                                    bool everyPeriod)
+{
+    if (!coreObject) {
+        throw(InvalidFunctionCall(
+            "subscribeQuery cannot be called on uninitialized federate or after disconnect call"));
+    }
+    const auto& queryTarget = ((target.empty()) || (target == "federate")) ? getName() : target;
+    auto index = coreObject->subscribeQuery(
+        queryTarget, queryStr, std::move(callback), period.to_ms(), everyPeriod);
+    asyncCallInfo->lock()->querySubscriptions.push_back(index);
+    return query_id_t(index);
+}
+
+void Federate::unsubscribeQuery(query_id_t subscription)
+{
+    auto asyncInfo = asyncCallInfo->lock();
+    auto& subscriptions = asyncInfo->querySubscriptions;
+    auto fnd = std::find(subscriptions.begin(), subscriptions.end(), subscription.value());
+    if (fnd == subscriptions.end()) {
+        return;
+    }
+    subscriptions.erase(fnd);
+    if (coreObject) {
+        coreObject->unsubscribeQuery(subscription.value());
+    }
+}
+
 void Federate::setGlobal(const std::string& valueName, const std::string& value)
 {
     if (coreObject) {
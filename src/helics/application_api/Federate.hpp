@@ -361,6 +361,31 @@ class HELICS_CXX_EXPORT Federate {
     */
     bool isQueryCompleted(query_id_t queryIndex) const;
 
+    /** subscribe to the results of a query
+    @details the target of the query sends a new result when its state changes and the result is
+    different, which avoids the cost of polling with repeated queries.  The callback is executed on
+    the core's processing thread so it should return quickly and must not make blocking calls to the
+    federate or core.  Subscriptions are removed when the federate disconnects
+    @param target  the target of the query can be "federation", "federate", "broker", "core", or a
+    specific name of a federate, core, or broker
+    @param queryStr a string with the query see other documentation for specific properties to query
+    @param callback the function to call with the query results
+    @param period the minimum time between results
+    @param everyPeriod set to true to call the callback every period even if the result has not
+    changed
+    @return a query_id_t used to stop the subscription
+    */
+    query_id_t subscribeQuery(const std::string& target,
+                              const std::string& queryStr,
+                              std::function<void(const std::string&)> callback,
+                              Time period = Time(0.5),
+                              bool everyPeriod = false);
+
+    /** stop the updates from a query subscription
+    @details the callback may still be called until the core processes the request
+    @param subscription the value returned from subscribeQuery*/
+    void unsubscribeQuery(query_id_t subscription);
+
     /** set a federation global value
     @details this overwrites any previous value for this name
     @param valueName the name of the global to set
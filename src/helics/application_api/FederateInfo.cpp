@@ -90,6 +90,8 @@ static const std::map<std::string, int> flagStringsTranslations{
     {"restrictiveTime", helics_flag_restrictive_time_policy},
     {"conservativeTime", helics_flag_restrictive_time_policy},
     {"ignore_time_mismatch", helics_flag_ignore_time_mismatch_warnings},
+    {"coupled_iterations", helics_flag_coupled_iterations},
+    {"coupledIterations", helics_flag_coupled_iterations},
     {"delayed_update", helics_flag_wait_for_current_time_update},
     {"delayedUpdate", helics_flag_wait_for_current_time_update},
     {"strict_input_type_checking", helics_handle_option_strict_type_checking},
@@ -230,6 +230,16 @@ void Filter::addDestinationTarget(const std::string& destinationName)
     corePtr->addDestinationTarget(handle, destinationName);
 }
 
+void Filter::addSourceTargetPattern(const std::string& pattern)
+{
+    corePtr->addSourceTargetPattern(handle, pattern);
+}
+
+void Filter::addDestinationTargetPattern(const std::string& pattern)
+{
+    corePtr->addDestinationTargetPattern(handle, pattern);
+}
+
 void CloningFilter::addDeliveryEndpoint(const std::string& endpoint)
 {
     Filter::setString("add delivery", endpoint);
@@ -111,6 +111,10 @@ class HELICS_CXX_EXPORT Filter {
     virtual void addDestinationTarget(const std::string& destinationName);
     /** alias for addSourceTarget*/
     void addTarget(const std::string& target) { addSourceTarget(target); }
+    /** add all current and future source endpoints with names matching a pattern*/
+    void addSourceTargetPattern(const std::string& pattern);
+    /** add all current and future destination endpoints with names matching a pattern*/
+    void addDestinationTargetPattern(const std::string& pattern);
 
     /** remove a sourceEndpoint to the list of endpoint to clone*/
     virtual void removeTarget(const std::string& sourceName);
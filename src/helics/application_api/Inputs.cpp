@@ -12,6 +12,8 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "units/units/units.hpp"
 
 #include <algorithm>
+#include <cstring>
+#include <helics/external/cereal/archives/portable_binary.hpp>
 #include <limits>
 #include <string>
 #include <vector>
@@ -383,6 +385,211 @@ static bool changeDetected(const defV& prevValue, const defV& newVal, double del
     return mpark::visit(visitor, newVal);
 }
 
+/** append the numerical contents of a serialized double, complex, vector, or complex vector to a
+buffer of doubles; complex values are stored as interleaved real and imaginary parts
+@return false if the data cannot be read directly and must go through the general conversion*/
+static bool appendNumericData(const data_view& dv, data_type type, std::vector<double>& buffer)
+{
+    static const std::uint8_t hostLittleEndian = cereal::portable_binary_detail::is_little_endian();
+    // the first byte of the serialized data indicates the endianness of the source
+    if (dv.size() < 1 + sizeof(double) || static_cast<std::uint8_t>(dv[0]) != hostLittleEndian) {
+        return false;
+    }
+    const char* data = dv.data() + 1;
+    size_t count{0};
+    switch (type) {
+        case data_type::helics_double:
+            count = 1;
+            break;
+        case data_type::helics_complex:
+            count = 2;
+            break;
+        case data_type::helics_vector:
+        case data_type::helics_complex_vector: {
+            std::uint64_t elements{0};
+            std::memcpy(&elements, data, sizeof(elements));
+            if (elements > dv.size()) {
+                return false;
+            }
+            data += sizeof(elements);
+            count = static_cast<size_t>(elements);
+            if (type == data_type::helics_complex_vector) {
+                count *= 2;
+            }
+            if (dv.size() != 1 + sizeof(elements) + count * sizeof(double)) {
+                return false;
+            }
+        } break;
+        default:
+            return false;
+    }
+    if (data + count * sizeof(double) > dv.data() + dv.size()) {
+        return false;
+    }
+    auto offset = buffer.size();
+    buffer.resize(offset + count);
+    std::memcpy(buffer.data() + offset, data, count * sizeof(double));
+    return true;
+}
+
+/** the reduction kernels below operate on contiguous buffers and maintain the same evaluation order
+as the variant based operations so the results are identical*/
+static double bufferSum(const double* vals, size_t count)
+{
+    double result{0.0};
+    for (size_t ii = 0; ii < count; ++ii) {
+        result += vals[ii];
+    }
+    return result;
+}
+
+static double bufferMax(const double* vals, size_t count)
+{
+    double dmax = vals[0];
+    for (size_t ii = 1; ii < count; ++ii) {
+        dmax = (vals[ii] > dmax) ? vals[ii] : dmax;
+    }
+    return dmax;
+}
+
+static double bufferMin(const double* vals, size_t count)
+{
+    double dmin = vals[0];
+    for (size_t ii = 1; ii < count; ++ii) {
+        dmin = (vals[ii] < dmin) ? vals[ii] : dmin;
+    }
+    return dmin;
+}
+
+static double bufferDiff(const double* vals, size_t count)
+{
+    double result = vals[0];
+    for (size_t ii = 1; ii < count; ++ii) {
+        result = result - vals[ii];
+    }
+    return result;
+}
+
+static std::vector<double> bufferElementDiff(const double* vals, size_t count)
+{
+    std::vector<double> X;
+    double start{invalidDouble};
+    for (size_t ii = 0; ii < count; ++ii) {
+        if (start != invalidDouble) {
+            X.push_back(start - vals[ii]);
+        }
+        start = vals[ii];
+    }
+    return X;
+}
+
+bool Input::typedVectorDataProcess(const std::vector<std::shared_ptr<const data_block>>& dataV,
+                                   defV& result)
+{
+    bool complexTarget{false};
+    bool scalarOnly{false};
+    switch (inputVectorOp) {
+        case multi_input_handling_method::sum_operation:
+        case multi_input_handling_method::average_operation:
+            break;
+        case multi_input_handling_method::vectorize_operation:
+            if (targetType == data_type::helics_string) {
+                return false;
+            }
+            complexTarget = (targetType == data_type::helics_complex ||
+                             targetType == data_type::helics_complex_vector);
+            break;
+        case multi_input_handling_method::max_operation:
+        case multi_input_handling_method::min_operation:
+            if (targetType != data_type::helics_double && targetType != data_type::helics_unknown) {
+                return false;
+            }
+            scalarOnly = true;
+            break;
+        case multi_input_handling_method::diff_operation:
+            if (targetType == data_type::helics_vector) {
+                break;
+            }
+            if (targetType != data_type::helics_double && targetType != data_type::helics_unknown) {
+                return false;
+            }
+            scalarOnly = true;
+            break;
+        default:
+            return false;
+    }
+
+    reductionBuffer.clear();
+    // with a single unit and double sources the conversion can be applied to the whole buffer
+    const bool bulkConversion = !multiUnits && injectionType == data_type::helics_double;
+    for (size_t ii = 0; ii < dataV.size(); ++ii) {
+        if (!dataV[ii]) {
+            continue;
+        }
+        auto localType = (injectionType == helics::data_type::helics_multi) ?
+            sourceTypes[ii].first :
+            injectionType;
+        if (complexTarget) {
+            if (localType != data_type::helics_complex &&
+                localType != data_type::helics_complex_vector) {
+                return false;
+            }
+        } else if (scalarOnly) {
+            if (localType != data_type::helics_double) {
+                return false;
+            }
+        }
+        auto offset = reductionBuffer.size();
+        if (!appendNumericData(*dataV[ii], localType, reductionBuffer)) {
+            return false;
+        }
+        if (localType == data_type::helics_double && !bulkConversion) {
+            const auto& plan = (multiUnits) ? sourcePlans[ii] : unitPlan;
+            reductionBuffer[offset] = plan.apply(reductionBuffer[offset]);
+        }
+    }
+    if (reductionBuffer.empty()) {
+        return false;
+    }
+    if (bulkConversion) {
+        unitPlan.apply(reductionBuffer);
+    }
+    const double* vals = reductionBuffer.data();
+    const size_t count = reductionBuffer.size();
+    switch (inputVectorOp) {
+        case multi_input_handling_method::sum_operation:
+            result = bufferSum(vals, count);
+            break;
+        case multi_input_handling_method::average_operation:
+            result = bufferSum(vals, count) / static_cast<double>(count);
+            break;
+        case multi_input_handling_method::max_operation:
+            result = bufferMax(vals, count);
+            break;
+        case multi_input_handling_method::min_operation:
+            result = bufferMin(vals, count);
+            break;
+        case multi_input_handling_method::diff_operation:
+            if (scalarOnly) {
+                result = bufferDiff(vals, count);
+            } else {
+                result = bufferElementDiff(vals, count);
+            }
+            break;
+        case multi_input_handling_method::vectorize_operation:
+        default:
+            if (complexTarget) {
+                std::vector<std::complex<double>> cres(count / 2);
+                std::memcpy(cres.data(), vals, count * sizeof(double));
+                result = std::move(cres);
+            } else {
+                result = std::vector<double>(vals, vals + count);
+            }
+            break;
+    }
+    return true;
+}
+
 bool Input::vectorDataProcess(const std::vector<std::shared_ptr<const data_block>>& dataV)
 {
     if (injectionType == data_type::helics_unknown ||
@@ -390,6 +597,10 @@ bool Input::vectorDataProcess(const std::vector<std::shared_ptr<const data_block
         loadSourceInformation();
         prevInputCount = static_cast<int32_t>(dataV.size());
     }
+    defV result;
+    if (typedVectorDataProcess(dataV, result)) {
+        return updateFromProcessedValue(result);
+    }
     std::vector<defV> res;
     res.reserve(dataV.size());
     for (size_t ii = 0; ii < dataV.size(); ++ii) {
@@ -398,12 +609,12 @@ bool Input::vectorDataProcess(const std::vector<std::shared_ptr<const data_block
                 sourceTypes[ii].first :
                 injectionType;
 
-            const auto& localUnits = (multiUnits) ? sourceTypes[ii].second : inputUnits;
+            const auto& localPlan = (multiUnits) ? sourcePlans[ii] : unitPlan;
             if (localTargetType == helics::data_type::helics_double) {
-                res.emplace_back(doubleExtractAndConvert(*dataV[ii], localUnits, outputUnits));
+                res.emplace_back(doubleExtractAndConvert(*dataV[ii], localPlan));
             } else if (localTargetType == helics::data_type::helics_int) {
                 res.emplace_back();
-                integerExtractAndConvert(res.back(), *dataV[ii], localUnits, outputUnits);
+                integerExtractAndConvert(res.back(), *dataV[ii], localPlan);
             } else {
                 res.emplace_back();
                 valueExtract(*dataV[ii], localTargetType, res.back());
@@ -443,7 +654,6 @@ bool Input::vectorDataProcess(const std::vector<std::shared_ptr<const data_block
     for (auto& ival : res) {
         valueConvert(ival, type);
     }
-    defV result;
     switch (inputVectorOp) {
         case multi_input_handling_method::max_operation:
             result = maxOperation(res);
@@ -492,15 +702,20 @@ bool Input::vectorDataProcess(const std::vector<std::shared_ptr<const data_block
         default:
             break;
     }
+    return updateFromProcessedValue(result);
+}
+
+bool Input::updateFromProcessedValue(defV& result)
+{
     if (changeDetectionEnabled) {
         if (changeDetected(lastValue, result, delta)) {
-            lastValue = result;
+            lastValue = std::move(result);
             hasUpdate = true;
         } else {
             hasUpdate = false;
         }
     } else {
-        lastValue = result;
+        lastValue = std::move(result);
         hasUpdate = true;
     }
     return hasUpdate;
@@ -518,11 +733,11 @@ bool Input::checkUpdate(bool assumeUpdate)
                 std::remove_reference_t<decltype(arg)> newVal;
                 (void)arg;  // suppress VS2015 warning
                 if (injectionType == helics::data_type::helics_double) {
-                    defV val = doubleExtractAndConvert(dv, inputUnits, outputUnits);
+                    defV val = doubleExtractAndConvert(dv, unitPlan);
                     valueExtract(val, newVal);
                 } else if (injectionType == helics::data_type::helics_int) {
                     defV val;
-                    integerExtractAndConvert(val, dv, inputUnits, outputUnits);
+                    integerExtractAndConvert(val, dv, unitPlan);
                     valueExtract(val, newVal);
                 } else {
                     valueExtract(dv, injectionType, newVal);
@@ -712,6 +927,15 @@ void Input::loadSourceInformation()
             }
         }
     }
+    // compute the unit conversions once here instead of for every value
+    unitPlan = UnitConversionPlan(inputUnits, outputUnits);
+    sourcePlans.clear();
+    if (multiUnits) {
+        sourcePlans.reserve(sourceTypes.size());
+        for (const auto& src : sourceTypes) {
+            sourcePlans.emplace_back(src.second, outputUnits);
+        }
+    }
 }
 
 double doubleExtractAndConvert(const data_view& dv,
@@ -738,6 +962,21 @@ void integerExtractAndConvert(defV& store,
     }
 }
 
+double doubleExtractAndConvert(const data_view& dv, const UnitConversionPlan& plan)
+{
+    return plan.apply(ValueConverter<double>::interpret(dv));
+}
+
+void integerExtractAndConvert(defV& store, const data_view& dv, const UnitConversionPlan& plan)
+{
+    auto V = ValueConverter<int64_t>::interpret(dv);
+    if (plan.isActive()) {
+        store = plan.apply(static_cast<double>(V));
+    } else {
+        store = V;
+    }
+}
+
 char Input::getValueChar()
 {
     if (fed->isUpdated(*this) || allowDirectFederateUpdate()) {
@@ -761,7 +1000,7 @@ char Input::getValueChar()
         } else {
             int64_t out = invalidValue<int64_t>();
             if (injectionType == helics::data_type::helics_double) {
-                out = static_cast<int64_t>(doubleExtractAndConvert(dv, inputUnits, outputUnits));
+                out = static_cast<int64_t>(doubleExtractAndConvert(dv, unitPlan));
             } else {
                 valueExtract(dv, injectionType, out);
             }
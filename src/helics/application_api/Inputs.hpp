@@ -7,6 +7,7 @@ SPDX-License-Identifier: BSD-3-Clause
 #pragma once
 
 #include "HelicsPrimaryTypes.hpp"
+#include "UnitConversionPlan.hpp"
 #include "ValueFederate.hpp"
 #include "helicsTypes.hpp"
 
@@ -59,6 +60,10 @@ class HELICS_CXX_EXPORT Input {
     std::shared_ptr<units::precise_unit> inputUnits;  //!< the units of the linked publications
     std::vector<std::pair<data_type, std::shared_ptr<units::precise_unit>>>
         sourceTypes;  //!< source information for input sources
+    UnitConversionPlan unitPlan;  //!< the conversion from the input units to the output units
+    std::vector<UnitConversionPlan>
+        sourcePlans;  //!< the unit conversions for each source if they have different units
+    std::vector<double> reductionBuffer;  //!< scratch buffer for typed multi-input reductions
     double delta{-1.0};  //!< the minimum difference
     double threshold{0.0};  //!< the threshold to use for binary decisions
     std::string actualName;  //!< the name of the Input
@@ -230,6 +235,8 @@ class HELICS_CXX_EXPORT Input {
     const std::string& getTarget() const { return fed->getTarget(*this); }
     /** subscribe to a named publication*/
     void addTarget(const std::string& newTarget) { fed->addTarget(*this, newTarget); }
+    /** subscribe to all current and future publications with names matching a pattern*/
+    void addTargetPattern(const std::string& pattern) { fed->addTargetPattern(*this, pattern); }
     /** remove a named publication from being a target*/
     void removeTarget(const std::string& targetToRemove)
     {
@@ -440,6 +447,15 @@ class HELICS_CXX_EXPORT Input {
     bool vectorDataProcess(const std::vector<std::shared_ptr<const data_block>>& dataV);
 
   private:
+    /** process multi-input data for numeric sources directly from the serialized data
+    @details handles the cases where the sources can be decoded straight into a contiguous buffer
+    of doubles without going through the variant conversions
+    @return true if the result was computed, false if the general path must be used*/
+    bool typedVectorDataProcess(const std::vector<std::shared_ptr<const data_block>>& dataV,
+                                defV& result);
+    /** update the stored value from the result of a multi-input operation
+    @return true if the value is considered updated*/
+    bool updateFromProcessedValue(defV& result);
     /** load some information about the data source such as type and units*/
     void loadSourceInformation();
     /** helper class for getting a character since that is a bit odd*/
@@ -465,6 +481,14 @@ HELICS_CXX_EXPORT void
                              const std::shared_ptr<units::precise_unit>& inputUnits,
                              const std::shared_ptr<units::precise_unit>& outputUnits);
 
+/** convert a dataview to a double and apply a precomputed unit conversion*/
+HELICS_CXX_EXPORT double doubleExtractAndConvert(const data_view& dv,
+                                                 const UnitConversionPlan& plan);
+
+/** convert a dataview to an integer or a double if a unit conversion is active*/
+HELICS_CXX_EXPORT void
+    integerExtractAndConvert(defV& store, const data_view& dv, const UnitConversionPlan& plan);
+
 /** class to handle an input and extract a specific type
 @tparam X the class of the value associated with a input*/
 template<class X>
@@ -548,11 +572,11 @@ void Input::getValue_impl(std::integral_constant<int, primaryType> /*V*/, X& out
         }
 
         if (injectionType == helics::data_type::helics_double) {
-            defV val = doubleExtractAndConvert(dv, inputUnits, outputUnits);
+            defV val = doubleExtractAndConvert(dv, unitPlan);
             valueExtract(val, out);
         } else if (injectionType == helics::data_type::helics_int) {
             defV val;
-            integerExtractAndConvert(val, dv, inputUnits, outputUnits);
+            integerExtractAndConvert(val, dv, unitPlan);
             valueExtract(val, out);
         } else {
             valueExtract(dv, injectionType, out);
@@ -604,11 +628,11 @@ const X& Input::getValueRef()
         if (changeDetectionEnabled) {
             X out;
             if (injectionType == helics::data_type::helics_double) {
-                defV val = doubleExtractAndConvert(dv, inputUnits, outputUnits);
+                defV val = doubleExtractAndConvert(dv, unitPlan);
                 valueExtract(val, out);
             } else if (injectionType == helics::data_type::helics_int) {
                 defV val;
-                integerExtractAndConvert(val, dv, inputUnits, outputUnits);
+                integerExtractAndConvert(val, dv, unitPlan);
                 valueExtract(val, out);
             } else {
                 valueExtract(dv, injectionType, out);
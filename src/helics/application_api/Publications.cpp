@@ -294,23 +294,76 @@ void Publication::publish(double val, const std::string& units)
 {
     if (units == pubUnits) {
         publish(val);
+        return;
     }
-    auto punit = units::unit_from_string(units);
-    if (units::is_valid(punit)) {
-        publish(val, punit);
-    } else {
-        throw(InvalidConversion{});
-    }
+    publish(loadConversionPlan(units).apply(val));
 }
+
 void Publication::publish(double val, const units::precise_unit& units)
 {
     if (pubUnitType) {
-        publish(units::convert(val, units, *pubUnitType));
+        publish(loadConversionPlan(units).apply(val));
     } else {
         publish(val);
     }
 }
 
+void Publication::publish(const std::vector<double>& val, const std::string& units)
+{
+    if (units == pubUnits) {
+        publish(val);
+        return;
+    }
+    const auto& plan = loadConversionPlan(units);
+    if (plan.isIdentity()) {
+        publish(val);
+        return;
+    }
+    auto converted = val;
+    plan.apply(converted);
+    publish(converted);
+}
+
+void Publication::publish(const std::vector<double>& val, const units::precise_unit& units)
+{
+    if (!pubUnitType) {
+        publish(val);
+        return;
+    }
+    const auto& plan = loadConversionPlan(units);
+    if (plan.isIdentity()) {
+        publish(val);
+        return;
+    }
+    auto converted = val;
+    plan.apply(converted);
+    publish(converted);
+}
+
+const UnitConversionPlan& Publication::loadConversionPlan(const std::string& units)
+{
+    if (!conversionUnitType || units != conversionUnits) {
+        auto punit = units::unit_from_string(units);
+        if (!units::is_valid(punit)) {
+            throw(InvalidConversion{});
+        }
+        conversionUnitType = std::make_shared<units::precise_unit>(punit);
+        conversionUnits = units;
+        conversionPlan = UnitConversionPlan(conversionUnitType, pubUnitType);
+    }
+    return conversionPlan;
+}
+
+const UnitConversionPlan& Publication::loadConversionPlan(const units::precise_unit& units)
+{
+    if (!conversionUnitType || !(*conversionUnitType == units)) {
+        conversionUnitType = std::make_shared<units::precise_unit>(units);
+        conversionUnits = units::to_string(units);
+        conversionPlan = UnitConversionPlan(conversionUnitType, pubUnitType);
+    }
+    return conversionPlan;
+}
+
 data_block typeConvert(data_type type, const defV& val)
 {
     switch (val.index()) {
@@ -8,6 +8,7 @@ SPDX-License-Identifier: BSD-3-Clause
 
 #include "../core/core-exceptions.hpp"
 #include "HelicsPrimaryTypes.hpp"
+#include "UnitConversionPlan.hpp"
 #include "ValueFederate.hpp"
 
 #include <memory>
@@ -40,6 +41,10 @@ class HELICS_CXX_EXPORT Publication {
     std::string pubUnits;  //!< the defined units of the publication
     std::shared_ptr<units::precise_unit>
         pubUnitType;  //!< a unit representation of the publication unit Type;
+    std::string conversionUnits;  //!< the units string of the cached conversion plan
+    std::shared_ptr<units::precise_unit>
+        conversionUnitType;  //!< the source units of the cached conversion plan
+    UnitConversionPlan conversionPlan;  //!< the cached conversion to the publication units
   public:
     Publication() = default;
     /** constructor for a publication used by the valueFederateManager
@@ -211,6 +216,8 @@ class HELICS_CXX_EXPORT Publication {
 
     /** add a target to the publication*/
     void addTarget(const std::string& target) { fed->addTarget(*this, target); }
+    /** send data to all current and future inputs with names matching a pattern*/
+    void addTargetPattern(const std::string& pattern) { fed->addTargetPattern(*this, pattern); }
     /** remove a named input from sending data*/
     void removeTarget(const std::string& targetToRemove)
     {
@@ -243,6 +250,12 @@ class HELICS_CXX_EXPORT Publication {
 
     void publish(double val, const std::string& units);
     void publish(double val, const units::precise_unit& units);
+    /** publish a vector of values converting the whole vector to the publication units
+    @param val the values to publish
+    @param units  the units association with the values
+    */
+    void publish(const std::vector<double>& val, const std::string& units);
+    void publish(const std::vector<double>& val, const units::precise_unit& units);
 
     /** publish integral values */
     template<class X>
@@ -290,6 +303,12 @@ class HELICS_CXX_EXPORT Publication {
     all Int types and without this it would be recursive
     */
     void publishInt(int64_t val);
+    /** get the conversion from the given units to the publication units
+    @details the plan is cached so repeated publications with the same units do not need to
+    parse or compute the conversion again
+    @throw InvalidConversion if the units string is not a valid unit*/
+    const UnitConversionPlan& loadConversionPlan(const std::string& units);
+    const UnitConversionPlan& loadConversionPlan(const units::precise_unit& units);
     friend class ValueFederateManager;
 };
 
@@ -0,0 +1,85 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "UnitConversionPlan.hpp"
+
+#include "units/units/units.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace helics {
+/** check that an affine estimate matches the result from the units library at a test point*/
+static bool affineMatch(double estimate, double actual)
+{
+    constexpr double tolerance{1e-12};
+    return std::abs(estimate - actual) <=
+        tolerance * std::max({1.0, std::abs(actual), std::abs(estimate)});
+}
+
+UnitConversionPlan::UnitConversionPlan(std::shared_ptr<units::precise_unit> inUnits,
+                                       std::shared_ptr<units::precise_unit> outUnits):
+    inputUnits(std::move(inUnits)),
+    outputUnits(std::move(outUnits))
+{
+    if (!inputUnits || !outputUnits) {
+        inputUnits.reset();
+        outputUnits.reset();
+        return;
+    }
+    active = true;
+    if (*inputUnits == *outputUnits) {
+        return;
+    }
+    identity = false;
+    offset = units::convert(0.0, *inputUnits, *outputUnits);
+    scale = units::convert(1.0, *inputUnits, *outputUnits) - offset;
+    // verify the conversion is actually affine at a couple of points away from the basis
+    constexpr double testPoint1{1000.0};
+    constexpr double testPoint2{-3.5};
+    affine = std::isfinite(offset) && std::isfinite(scale) &&
+        affineMatch(testPoint1 * scale + offset,
+                    units::convert(testPoint1, *inputUnits, *outputUnits)) &&
+        affineMatch(testPoint2 * scale + offset,
+                    units::convert(testPoint2, *inputUnits, *outputUnits));
+    if (affine && scale == 1.0 && offset == 0.0) {
+        identity = true;
+    }
+}
+
+void UnitConversionPlan::apply(double* vals, std::size_t count) const
+{
+    if (identity) {
+        return;
+    }
+    if (!affine) {
+        for (std::size_t ii = 0; ii < count; ++ii) {
+            vals[ii] = applyGeneral(vals[ii]);
+        }
+        return;
+    }
+    // written as a simple multiply-add loop so the compiler can vectorize and fuse it
+    const double mult{scale};
+    const double add{offset};
+    if (add == 0.0) {
+        for (std::size_t ii = 0; ii < count; ++ii) {
+            vals[ii] *= mult;
+        }
+    } else {
+        for (std::size_t ii = 0; ii < count; ++ii) {
+            vals[ii] = vals[ii] * mult + add;
+        }
+    }
+}
+
+double UnitConversionPlan::applyGeneral(double val) const
+{
+    return units::convert(val, *inputUnits, *outputUnits);
+}
+
+}  // namespace helics
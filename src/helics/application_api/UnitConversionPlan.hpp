@@ -0,0 +1,67 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+
+#include "helics_cxx_export.h"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace units {
+class precise_unit;
+}  // namespace units
+
+namespace helics {
+/** a unit conversion computed once when the source and destination units are known
+@details most unit conversions are affine so they can be reduced to a scale and offset which is
+applied without going back through the units library for each value.  Conversions which are not
+affine (logarithmic units for example) fall back to calling the units library for each value*/
+class HELICS_CXX_EXPORT UnitConversionPlan {
+  public:
+    /** default plan which does no conversion*/
+    UnitConversionPlan() = default;
+    /** generate a plan for converting from one unit to another
+    @details if either unit is empty the plan is inactive and values pass through unchanged*/
+    UnitConversionPlan(std::shared_ptr<units::precise_unit> inUnits,
+                       std::shared_ptr<units::precise_unit> outUnits);
+    /** check if a conversion between two defined units is taking place*/
+    bool isActive() const { return active; }
+    /** check if the conversion leaves the values unchanged*/
+    bool isIdentity() const { return identity; }
+    /** get the multiplier for affine conversions*/
+    double getScale() const { return scale; }
+    /** get the offset for affine conversions*/
+    double getOffset() const { return offset; }
+
+    /** convert a single value*/
+    double apply(double val) const
+    {
+        if (identity) {
+            return val;
+        }
+        return (affine) ? val * scale + offset : applyGeneral(val);
+    }
+    /** convert an array of values in place*/
+    void apply(double* vals, std::size_t count) const;
+    /** convert a vector of values in place*/
+    void apply(std::vector<double>& vals) const { apply(vals.data(), vals.size()); }
+
+  private:
+    /** convert a value through the units library*/
+    double applyGeneral(double val) const;
+
+    std::shared_ptr<units::precise_unit> inputUnits;  //!< the units of the source
+    std::shared_ptr<units::precise_unit> outputUnits;  //!< the units to convert to
+    double scale{1.0};  //!< the multiplier of an affine conversion
+    double offset{0.0};  //!< the offset of an affine conversion
+    bool active{false};  //!< both units are defined so a conversion is taking place
+    bool identity{true};  //!< the conversion does not change the value
+    bool affine{true};  //!< the conversion can be represented as scale and offset
+};
+
+}  // namespace helics
@@ -139,6 +139,16 @@ void ValueFederate::addTarget(const Input& inp, const std::string& target)
     vfManager->addTarget(inp, target);
 }
 
+void ValueFederate::addTargetPattern(const Publication& pub, const std::string& pattern)
+{
+    vfManager->addTargetPattern(pub, pattern);
+}
+
+void ValueFederate::addTargetPattern(const Input& inp, const std::string& pattern)
+{
+    vfManager->addTargetPattern(inp, pattern);
+}
+
 void ValueFederate::addAlias(const Input& inp, const std::string& shortcutName)
 {
     vfManager->addAlias(inp, shortcutName);
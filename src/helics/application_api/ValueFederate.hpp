@@ -485,6 +485,20 @@ class HELICS_CXX_EXPORT ValueFederate:
     @param target the name of the publication to get data from
     */
     void addTarget(const Input& inp, const std::string& target);
+    /** add a pattern of destination targets to a publication
+    @details the pattern is matched against the names of all current and future inputs in the
+    federation, '*' matches any sequence of characters and '?' matches a single character
+    @param pub the publication object to add the targets to
+    @param pattern the pattern of input names to send the data to
+    */
+    void addTargetPattern(const Publication& pub, const std::string& pattern);
+    /** add a pattern of source targets to an input
+    @details the pattern is matched against the names of all current and future publications in
+    the federation, '*' matches any sequence of characters and '?' matches a single character
+    @param inp the input object to add the targets to
+    @param pattern the pattern of publication names to get data from
+    */
+    void addTargetPattern(const Input& inp, const std::string& pattern);
     /** remove a destination target from a publication
     @param pub the publication object to add a target to
     @param target the name of the input to remove
@@ -130,6 +130,16 @@ void ValueFederateManager::addTarget(const Input& inp, const std::string& target
     inputTargets.lock()->emplace(inp.handle, target);
 }
 
+void ValueFederateManager::addTargetPattern(const Publication& pub, const std::string& pattern)
+{
+    coreObject->addDestinationTargetPattern(pub.handle, pattern);
+}
+
+void ValueFederateManager::addTargetPattern(const Input& inp, const std::string& pattern)
+{
+    coreObject->addSourceTargetPattern(inp.handle, pattern);
+}
+
 void ValueFederateManager::removeTarget(const Publication& pub, const std::string& target)
 {
     // TODO(PT): erase from targetID's
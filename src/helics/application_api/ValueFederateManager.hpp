@@ -101,6 +101,16 @@ class ValueFederateManager {
     @param target the name of the input to send the data to
     */
     void addTarget(const Input& inp, const std::string& target);
+    /** add a pattern of destination targets to a publication
+    @param pub the identifier of the publication
+    @param pattern the pattern of input names to send the data to
+    */
+    void addTargetPattern(const Publication& pub, const std::string& pattern);
+    /** add a pattern of source targets to an input
+    @param inp the identifier of the input
+    @param pattern the pattern of publication names to get data from
+    */
+    void addTargetPattern(const Input& inp, const std::string& pattern);
 
     /** remove a destination target from a publication
     @param pub the identifier of the input
@@ -6,7 +6,9 @@ SPDX-License-Identifier: BSD-3-Clause
 */
 
 #include "../application_api/BrokerApp.hpp"
+#include "../common/BinaryLogger.hpp"
 #include "../common/loggerCore.hpp"
+#include "../core/FlightRecorder.hpp"
 #include "../core/core-exceptions.hpp"
 #include "../core/helicsCLI11.hpp"
 #include "Clone.hpp"
@@ -16,7 +18,9 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "Source.hpp"
 #include "Tracer.hpp"
 
+#include <fstream>
 #include <iostream>
+#include <stdexcept>
 
 static const std::vector<std::string> helpArgs{"-?"};
 int main(int argc, char* argv[])
@@ -108,6 +112,40 @@ int main(int argc, char* argv[])
             helics::BrokerApp broker(argc, argv);
             return std::string{};
         });
+    std::string binaryLogFile;
+    auto* binlog = app.add_subcommand("binlog", "format a HELICS binary log file as text");
+    binlog->add_option("file", binaryLogFile, "the binary log file to format")->required();
+    binlog->callback([&binaryLogFile]() {
+        std::ifstream input(binaryLogFile, std::ios::binary);
+        if (!input) {
+            std::cerr << "unable to open binary log file " << binaryLogFile << '\n';
+            return;
+        }
+        try {
+            helics::decodeBinaryLog(input, std::cout);
+        }
+        catch (const std::invalid_argument& ia) {
+            std::cerr << ia.what() << '\n';
+        }
+    });
+    std::string flightRecorderFile;
+    auto* flightlog =
+        app.add_subcommand("flightlog", "format a HELICS flight recorder dump as text");
+    flightlog->add_option("file", flightRecorderFile, "the flight recorder dump to format")
+        ->required();
+    flightlog->callback([&flightRecorderFile]() {
+        std::ifstream input(flightRecorderFile, std::ios::binary);
+        if (!input) {
+            std::cerr << "unable to open flight recorder dump " << flightRecorderFile << '\n';
+            return;
+        }
+        try {
+            helics::decodeFlightRecorderDump(input, std::cout);
+        }
+        catch (const std::invalid_argument& ia) {
+            std::cerr << ia.what() << '\n';
+        }
+    });
     app.footer(
         "helics_app [SUBCOMMAND] --help will display the options for a particular subcommand");
     auto ret = app.helics_parse(argc, argv);
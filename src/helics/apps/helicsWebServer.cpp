@@ -38,7 +38,9 @@ SPDX-License-Identifier: BSD-3-Clause
 #include <boost/uuid/uuid.hpp>  // uuid class
 #include <boost/uuid/uuid_generators.hpp>  // generators
 #include <boost/uuid/uuid_io.hpp>  // streaming operators etc.
+#include <chrono>
 #include <cstdlib>
+#include <deque>
 #include <fstream>
 #include <functional>
 #include <iostream>
@@ -375,15 +377,49 @@ static void fail(beast::error_code ec, char const* what)
 
 // LCOV_EXCL_STOP
 
-// Echoes back all received WebSocket messages
+/** find the broker for a query subscription by name or use the last connected broker*/
+static std::shared_ptr<helics::Broker> findSubscriptionBroker(const std::string& brokerName)
+{
+    if (!brokerName.empty()) {
+        return helics::BrokerFactory::findBroker(brokerName);
+    }
+    std::shared_ptr<helics::Broker> brkr;
+    auto brks = helics::BrokerFactory::getAllBrokers();
+    for (auto& brk : brks) {
+        if (brk->isConnected()) {
+            brkr = brk;
+        }
+    }
+    return brkr;
+}
+
+/** get a field from a request or a default value if the field is not present*/
+static std::string
+    getField(const boost::container::flat_map<std::string, std::string>& fields,
+             const std::string& field,
+             const std::string& defValue = std::string{})
+{
+    auto fnd = fields.find(field);
+    return (fnd != fields.end()) ? fnd->second : defValue;
+}
+
+// Answers queries received as WebSocket messages and pushes the results of query subscriptions
 class WebSocketsession: public std::enable_shared_from_this<WebSocketsession> {
     websocket::stream<beast::tcp_stream> ws;
     beast::flat_buffer buffer;
+    std::deque<std::string> writeQueue;  //!< messages waiting to be written
+    /// the query subscriptions made through the session
+    std::vector<std::pair<std::shared_ptr<helics::Broker>, std::int32_t>> subscriptions;
 
   public:
     // Take ownership of the socket
     explicit WebSocketsession(tcp::socket&& socket): ws(std::move(socket)) {}
-
+    ~WebSocketsession()
+    {
+        for (auto& sub : subscriptions) {
+            sub.first->unsubscribeQuery(sub.second);
+        }
+    }
     // Get on the correct executor
     void run()
     {
@@ -437,27 +473,32 @@ class WebSocketsession: public std::enable_shared_from_this<WebSocketsession> {
         }
 
         if (ec) {
-            fail(ec, "read");
+            return fail(ec, "read");
         }
 
         beast::string_view result{boost::asio::buffer_cast<const char*>(buffer.data()),
                                   buffer.size()};
         // Echo the message
         auto reqpr = processRequestParameters("", result);
+        // Clear the buffer
+        buffer.consume(buffer.size());
 
+        auto cmdstr = getField(reqpr.second, "command");
+        if (cmdstr == "subscribe") {
+            queueWrite(subscribe(reqpr.second));
+            return do_read();
+        }
+        if (cmdstr == "unsubscribe") {
+            queueWrite(unsubscribe(reqpr.second));
+            return do_read();
+        }
         cmd command{cmd::unknown};
 
         auto res = generateResults(command, {}, "", "", reqpr.second);
-        // Clear the buffer
-        buffer.consume(buffer.size());
 
-        ws.text(true);
         if (res.first == return_val::ok && !res.second.empty() && res.second.front() == '{') {
-            boost::beast::ostream(buffer) << res.second;  // NOLINT
-            ws.async_write(buffer.data(),
-                           beast::bind_front_handler(&WebSocketsession::on_write,
-                                                     shared_from_this()));
-            return;
+            queueWrite(std::move(res.second));
+            return do_read();
         }
         Json::Value response;
         switch (res.first) {
@@ -479,8 +520,23 @@ class WebSocketsession: public std::enable_shared_from_this<WebSocketsession> {
                 break;
         }
 
-        boost::beast::ostream(buffer) << generateJsonString(response);  // NOLINT
-        ws.async_write(buffer.data(),
+        queueWrite(generateJsonString(response));
+        do_read();
+    }
+
+    // Add a message to the write queue and start writing if no write is in progress
+    void queueWrite(std::string message)
+    {
+        writeQueue.push_back(std::move(message));
+        if (writeQueue.size() == 1) {
+            do_write();
+        }
+    }
+
+    void do_write()
+    {
+        ws.text(true);
+        ws.async_write(net::buffer(writeQueue.front()),
                        beast::bind_front_handler(&WebSocketsession::on_write, shared_from_this()));
     }
 
@@ -491,12 +547,93 @@ class WebSocketsession: public std::enable_shared_from_this<WebSocketsession> {
         if (ec) {
             return fail(ec, "write");
         }
+        writeQueue.pop_front();
+        if (!writeQueue.empty()) {
+            do_write();
+        }
+    }
 
-        // Clear the buffer
-        buffer.consume(buffer.size());
+  private:
+    // start a query subscription with the results pushed to the websocket
+    std::string subscribe(const boost::container::flat_map<std::string, std::string>& fields)
+    {
+        Json::Value response;
+        auto brokerName = getField(fields, "broker");
+        auto brkr = findSubscriptionBroker(brokerName);
+        if (!brkr) {
+            response["status"] = static_cast<int>(http::status::not_found);
+            response["error"] = brokerName + " not found";
+            return generateJsonString(response);
+        }
+        auto target = getField(fields, "target", "root");
+        auto query = getField(fields, "query", "current_state");
+        std::chrono::milliseconds period{500};
+        try {
+            period = std::chrono::milliseconds(std::stoll(getField(fields, "period", "500")));
+        }
+        catch (const std::exception&) {
+            response["status"] = static_cast<int>(http::status::bad_request);
+            response["error"] = "period must be an integer number of milliseconds";
+            return generateJsonString(response);
+        }
+        bool everyPeriod = (getField(fields, "every_period") == "true");
+
+        // the callback is executed on the broker thread so the result is passed to the strand,
+        // which also guarantees the index is set before it is used
+        std::weak_ptr<WebSocketsession> weakSession = shared_from_this();
+        auto index = std::make_shared<std::int32_t>(0);
+        auto update = [weakSession, index](const std::string& result) {
+            auto session = weakSession.lock();
+            if (!session) {
+                return;
+            }
+            net::post(session->ws.get_executor(), [session, index, result]() {
+                Json::Value message;
+                message["status"] = 0;
+                message["subscription"] = *index;
+                message["value"] = result;
+                if (!result.empty() && result.front() == '{') {
+                    try {
+                        message["value"] = loadJsonStr(result);
+                    }
+                    catch (const std::invalid_argument&) {
+                    }
+                }
+                session->queueWrite(generateJsonString(message));
+            });
+        };
+        *index = brkr->subscribeQuery(target, query, std::move(update), period, everyPeriod);
+        subscriptions.emplace_back(brkr, *index);
+        response["status"] = 0;
+        response["subscription"] = *index;
+        return generateJsonString(response);
+    }
 
-        // Do another read
-        do_read();
+    // stop a query subscription made through this session
+    std::string unsubscribe(const boost::container::flat_map<std::string, std::string>& fields)
+    {
+        Json::Value response;
+        std::int32_t index{0};
+        try {
+            index = std::stoi(getField(fields, "subscription"));
+        }
+        catch (const std::exception&) {
+            response["status"] = static_cast<int>(http::status::bad_request);
+            response["error"] = "subscription must be the identifier of a subscription";
+            return generateJsonString(response);
+        }
+        auto fnd = std::find_if(subscriptions.begin(),
+                                subscriptions.end(),
+                                [index](const auto& sub) { return sub.second == index; });
+        if (fnd == subscriptions.end()) {
+            response["status"] = static_cast<int>(http::status::not_found);
+            response["error"] = "subscription not found";
+            return generateJsonString(response);
+        }
+        fnd->first->unsubscribeQuery(index);
+        subscriptions.erase(fnd);
+        response["status"] = 0;
+        return generateJsonString(response);
     }
 };
 
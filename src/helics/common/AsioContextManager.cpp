@@ -18,12 +18,17 @@ SPDX-License-Identifier: BSD-3-Clause
 
 #include "AsioContextManager.h"
 
+#include "ThreadAffinity.hpp"
+
+#include <asio/post.hpp>
 #include <chrono>
 #include <iostream>
 #include <map>
 #include <mutex>
 #include <stdexcept>
+#include <thread>
 #include <utility>
+#include <vector>
 
 /** a storage system for the available core objects allowing references by name to the core
  */
@@ -106,6 +111,25 @@ void AsioContextManager::setContextToLeakOnDelete(const std::string& contextName
         fnd->second->leakOnDelete = true;
     }
 }
+void AsioContextManager::setContextAffinity(const std::string& contextName,
+                                            std::vector<int> cpus)
+{
+    auto ptr = getContextPointer(contextName);
+    std::lock_guard<std::mutex> cpuLock(ptr->affinityLock);
+    ptr->loopCpus = std::move(cpus);
+    if (ptr->isRunning() && !ptr->loopCpus.empty() && ptr->loopThreads == 1) {
+        // the loop is single threaded so the handler runs on the loop thread
+        asio::post(*ptr->ictx, [cpus = ptr->loopCpus]() { helics::setThreadAffinity(cpus); });
+    }
+}
+
+void AsioContextManager::setContextThreads(const std::string& contextName, int threads)
+{
+    auto ptr = getContextPointer(contextName);
+    std::lock_guard<std::mutex> cpuLock(ptr->affinityLock);
+    ptr->loopThreads = (threads > 1) ? threads : 1;
+}
+
 AsioContextManager::~AsioContextManager()
 {
     //  std::cout << "deleting context manager\n";
@@ -227,27 +251,46 @@ void AsioContextManager::haltContextLoop()
 
 void contextProcessingLoop(std::shared_ptr<AsioContextManager> ptr)
 {
-    while ((ptr->runCounter > 0) && (!(ptr->terminateLoop))) {
-        auto clk = std::chrono::steady_clock::now();
-        try {
-            ptr->running.store(AsioContextManager::loop_mode::running);
-            ptr->ictx->run();
-        }
-        catch (const std::system_error& se) {
-            auto nclk = std::chrono::steady_clock::now();
-            std::cerr << "asio system error in context loop " << se.what() << " ran for "
-                      << (nclk - clk).count() / 1000000 << "ms" << std::endl;
-        }
-        catch (const std::exception& e) {
-            auto nclk = std::chrono::steady_clock::now();
-            std::cerr << "std::exception in context loop " << e.what() << " ran for "
-                      << (nclk - clk).count() / 1000000 << "ms" << std::endl;
-        }
-        catch (...) {
-            std::cout << "caught other error in context loop" << std::endl;
+    std::vector<int> cpus;
+    int threads{1};
+    {
+        std::lock_guard<std::mutex> cpuLock(ptr->affinityLock);
+        cpus = ptr->loopCpus;
+        threads = ptr->loopThreads;
+    }
+    auto runLoop = [&ptr, &cpus]() {
+        helics::setThreadAffinity(cpus);
+        while ((ptr->runCounter > 0) && (!(ptr->terminateLoop))) {
+            auto clk = std::chrono::steady_clock::now();
+            try {
+                ptr->running.store(AsioContextManager::loop_mode::running);
+                ptr->ictx->run();
+            }
+            catch (const std::system_error& se) {
+                auto nclk = std::chrono::steady_clock::now();
+                std::cerr << "asio system error in context loop " << se.what() << " ran for "
+                          << (nclk - clk).count() / 1000000 << "ms" << std::endl;
+            }
+            catch (const std::exception& e) {
+                auto nclk = std::chrono::steady_clock::now();
+                std::cerr << "std::exception in context loop " << e.what() << " ran for "
+                          << (nclk - clk).count() / 1000000 << "ms" << std::endl;
+            }
+            catch (...) {
+                std::cout << "caught other error in context loop" << std::endl;
+            }
         }
+    };
+    // the extra threads are joined before the loop is marked as stopped so the context is not
+    // reset while any of them are still running it
+    std::vector<std::thread> extraThreads;
+    for (int ii = 1; ii < threads; ++ii) {
+        extraThreads.emplace_back(runLoop);
+    }
+    runLoop();
+    for (auto& thread : extraThreads) {
+        thread.join();
     }
-
     //   std::cout << "context loop stopped\n";
     ptr->running.store(AsioContextManager::loop_mode::stopped);
 }
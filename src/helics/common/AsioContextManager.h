@@ -26,6 +26,7 @@ SPDX-License-Identifier: BSD-3-Clause
 #include <mutex>
 #include <string>
 #include <utility>
+#include <vector>
 
 // The choice for noexcept isn't set correctly in asio::io_context (including asio.hpp instead
 // didn't help) With Boost 1.58 this resulted in a compile error, apparently from the BOOST_NOEXCEPT
@@ -55,6 +56,10 @@ class AsioContextManager: public std::enable_shared_from_this<AsioContextManager
     std::mutex runningLoopLock;  //!< lock protecting the nullwork object and the return future
     std::atomic<bool> terminateLoop{false};  //!< flag indicating that the loop should terminate
     std::future<void> loopRet;
+    /** lock protecting loopCpus and loopThreads, separate since the loop thread uses it*/
+    std::mutex affinityLock;
+    std::vector<int> loopCpus;  //!< the cpus to run the loop threads on, empty for any
+    int loopThreads{1};  //!< the number of threads running the loop
     /** constructor*/
     explicit AsioContextManager(const std::string& contextName);
 
@@ -117,6 +122,21 @@ class AsioContextManager: public std::enable_shared_from_this<AsioContextManager
     which cause all sorts of odd errors and issues
     */
     static void setContextToLeakOnDelete(const std::string& contextName = std::string());
+    /** restrict the thread running the loop of a context to a set of cpus
+    @details the context is created if it does not exist, the setting applies immediately if the
+    loop is running on a single thread and to any later loop threads
+    @param contextName the name of the context
+    @param cpus the cpus to run the loop on, an empty list removes the restriction for later loops
+    */
+    static void setContextAffinity(const std::string& contextName, std::vector<int> cpus);
+    /** set the number of threads running the loop of a context
+    @details the context is created if it does not exist, the setting applies the next time the
+    loop is started, handlers of a context with more than one thread may run concurrently so
+    anything they share must be protected by a strand or a lock
+    @param contextName the name of the context
+    @param threads the number of threads to run the loop on, at least 1
+    */
+    static void setContextThreads(const std::string& contextName, int threads);
     virtual ~AsioContextManager();
 
     /** get the name  of the current context manager*/
@@ -133,10 +153,10 @@ class AsioContextManager: public std::enable_shared_from_this<AsioContextManager
     */
     static LoopHandle runContextLoop(const std::string& contextName = std::string{});
 
-    /** run a single thread for the context manager to execute asynchronous contexts in
-    @details will run a single thread for the io_context,  it will not stop the thread until either
-    the context manager is closed or the haltContextLoop function is called and there is no more
-    work
+    /** run the threads for the context manager to execute asynchronous contexts in
+    @details will run a single thread for the io_context unless more were set with
+    setContextThreads,  it will not stop the threads until either the context manager is closed or
+    the haltContextLoop function is called and there is no more work
     */
     LoopHandle startContextLoop();
     /** check if the contextLoopo is running*/
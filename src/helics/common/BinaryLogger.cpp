@@ -0,0 +1,382 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "BinaryLogger.hpp"
+
+#include "../helics_enums.h"
+#include "binaryFileHelpers.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace helics {
+/** the header identifying a binary log file*/
+static constexpr char binaryLogMagic[8] = {'H', 'E', 'L', 'I', 'C', 'S', 'B', 'L'};
+static constexpr std::uint32_t binaryLogVersion{1};
+/** the kinds of entries in a binary log file*/
+static constexpr char formatEntry{'F'};
+static constexpr char recordEntry{'R'};
+static constexpr char droppedEntry{'D'};
+
+BinaryLogRing::BinaryLogRing(std::size_t capacity):
+    records([capacity]() {
+        std::size_t size{2};
+        while (size < capacity) {
+            size <<= 1U;
+        }
+        return size;
+    }()),
+    mask(records.size() - 1)
+{
+}
+
+bool BinaryLogRing::push(const BinaryLogRecord& record)
+{
+    auto current = head.load(std::memory_order_relaxed);
+    if (current - tail.load(std::memory_order_acquire) >= records.size()) {
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    records[current & mask] = record;
+    head.store(current + 1, std::memory_order_release);
+    return true;
+}
+
+bool BinaryLogRing::pop(BinaryLogRecord& record)
+{
+    auto current = tail.load(std::memory_order_relaxed);
+    if (current == head.load(std::memory_order_acquire)) {
+        return false;
+    }
+    record = records[current & mask];
+    tail.store(current + 1, std::memory_order_release);
+    return true;
+}
+
+/** the registry of format strings shared by all the binary loggers*/
+class BinaryLogFormats {
+  public:
+    std::mutex lock;
+    std::vector<const char*> formats;
+};
+
+static BinaryLogFormats& formatRegistry()
+{
+    static BinaryLogFormats registry;
+    return registry;
+}
+
+static std::atomic<std::uint64_t> loggerCounter{0};
+
+static void writeString(std::ostream& out, const char* str)
+{
+    auto len = static_cast<std::uint32_t>(std::strlen(str));
+    writeBinaryValue(out, len);
+    out.write(str, len);
+}
+
+static bool readString(std::istream& in, std::string& str)
+{
+    std::uint32_t len{0};
+    if (!readBinaryValue(in, len)) {
+        return false;
+    }
+    str.resize(len);
+    return (len == 0) || static_cast<bool>(in.read(&str[0], len));
+}
+
+BinaryLogger::BinaryLogger(const std::string& fileName, std::size_t ringSize):
+    loggerId(++loggerCounter), ringCapacity(ringSize), startTime(clock_type::now())
+{
+    outFile.exceptions(std::ios::failbit | std::ios::badbit);
+    outFile.open(fileName, std::ios::binary | std::ios::out | std::ios::trunc);
+    writeBinaryFileHeader(outFile, binaryLogMagic, binaryLogVersion);
+    outFile.exceptions(std::ios::goodbit);
+    writerThread = std::thread(&BinaryLogger::writerLoop, this);
+}
+
+BinaryLogger::~BinaryLogger()
+{
+    stopping.store(true);
+    wakeWriter.notify_one();
+    if (writerThread.joinable()) {
+        writerThread.join();
+    }
+    std::lock_guard<std::mutex> lock(writeLock);
+    drain();
+    outFile.flush();
+}
+
+std::uint16_t BinaryLogger::registerFormat(const char* format)
+{
+    auto& registry = formatRegistry();
+    std::lock_guard<std::mutex> lock(registry.lock);
+    auto fnd = std::find(registry.formats.begin(), registry.formats.end(), format);
+    if (fnd != registry.formats.end()) {
+        return static_cast<std::uint16_t>(fnd - registry.formats.begin());
+    }
+    registry.formats.push_back(format);
+    return static_cast<std::uint16_t>(registry.formats.size() - 1);
+}
+
+const char* BinaryLogger::getFormat(std::uint16_t formatId)
+{
+    auto& registry = formatRegistry();
+    std::lock_guard<std::mutex> lock(registry.lock);
+    return (formatId < registry.formats.size()) ? registry.formats[formatId] : nullptr;
+}
+
+BinaryLogRing& BinaryLogger::getRing()
+{
+    // cache of the last ring used by this thread
+    static thread_local std::uint64_t cachedLogger{0};
+    static thread_local BinaryLogRing* cachedRing{nullptr};
+    if (cachedLogger == loggerId) {
+        return *cachedRing;
+    }
+    auto id = std::this_thread::get_id();
+    std::lock_guard<std::mutex> lock(ringLock);
+    auto fnd = std::find_if(rings.begin(), rings.end(), [id](const auto& ring) {
+        return ring.first == id;
+    });
+    if (fnd == rings.end()) {
+        rings.emplace_back(id, std::make_unique<BinaryLogRing>(ringCapacity));
+        fnd = rings.end() - 1;
+    }
+    cachedLogger = loggerId;
+    cachedRing = fnd->second.get();
+    return *cachedRing;
+}
+
+void BinaryLogger::flush()
+{
+    std::lock_guard<std::mutex> lock(writeLock);
+    drain();
+    outFile.flush();
+}
+
+std::uint64_t BinaryLogger::recordsDropped() const
+{
+    std::uint64_t dropped{0};
+    std::lock_guard<std::mutex> lock(ringLock);
+    for (const auto& ring : rings) {
+        dropped += ring.second->dropped();
+    }
+    return dropped;
+}
+
+void BinaryLogger::writerLoop()
+{
+    while (!stopping.load()) {
+        {
+            std::unique_lock<std::mutex> lock(wakeLock);
+            wakeWriter.wait_for(lock, std::chrono::milliseconds(20), [this]() {
+                return stopping.load();
+            });
+        }
+        std::lock_guard<std::mutex> lock(writeLock);
+        drain();
+    }
+}
+
+void BinaryLogger::drain()
+{
+    std::vector<BinaryLogRing*> active;
+    {
+        std::lock_guard<std::mutex> lock(ringLock);
+        for (auto& ring : rings) {
+            active.push_back(ring.second.get());
+        }
+    }
+    BinaryLogRecord entry;
+    std::uint64_t dropped{0};
+    for (auto* ring : active) {
+        while (ring->pop(entry)) {
+            writeRecord(entry);
+        }
+        dropped += ring->dropped();
+    }
+    if (dropped > droppedReported) {
+        outFile.put(droppedEntry);
+        writeBinaryValue(outFile, dropped - droppedReported);
+        droppedReported = dropped;
+    }
+}
+
+void BinaryLogger::writeRecord(const BinaryLogRecord& entry)
+{
+    if (entry.format >= formatsWritten.size()) {
+        formatsWritten.resize(static_cast<std::size_t>(entry.format) + 1, false);
+    }
+    if (!formatsWritten[entry.format]) {
+        const auto* format = getFormat(entry.format);
+        outFile.put(formatEntry);
+        writeBinaryValue(outFile, entry.format);
+        writeString(outFile, (format != nullptr) ? format : "");
+        formatsWritten[entry.format] = true;
+    }
+    outFile.put(recordEntry);
+    writeBinaryValue(outFile, entry.timestamp);
+    writeBinaryValue(outFile, entry.source);
+    writeBinaryValue(outFile, entry.format);
+    writeBinaryValue(outFile, entry.level);
+    writeBinaryValue(outFile, entry.argCount);
+    for (int ii = 0; ii < entry.argCount; ++ii) {
+        const auto& arg = entry.args[ii];
+        outFile.put(static_cast<char>(arg.type));
+        if (arg.type == BinaryLogArgType::literal) {
+            writeString(outFile, (arg.literal != nullptr) ? arg.literal : "");
+        } else {
+            std::uint64_t raw{0};
+            std::memcpy(&raw, &arg.integer, sizeof(raw));
+            writeBinaryValue(outFile, raw);
+        }
+    }
+    ++writtenCount;
+}
+
+/** substitute the arguments into the "{}" placeholders of a format string*/
+static std::string formatBinaryRecord(const std::string& format,
+                                      const std::vector<std::string>& args)
+{
+    std::string result;
+    result.reserve(format.size() + 16 * args.size());
+    std::size_t argIndex{0};
+    for (std::size_t ii = 0; ii < format.size(); ++ii) {
+        auto chr = format[ii];
+        if ((chr == '{' || chr == '}') && ii + 1 < format.size() && format[ii + 1] == chr) {
+            result.push_back(chr);
+            ++ii;
+            continue;
+        }
+        if (chr == '{') {
+            auto close = format.find('}', ii);
+            if (close != std::string::npos && argIndex < args.size()) {
+                result.append(args[argIndex++]);
+                ii = close;
+                continue;
+            }
+        }
+        result.push_back(chr);
+    }
+    return result;
+}
+
+static const char* levelName(int level)
+{
+    switch (level) {
+        case helics_log_level_error:
+            return "error";
+        case helics_log_level_warning:
+            return "warning";
+        case helics_log_level_summary:
+            return "summary";
+        case helics_log_level_connections:
+            return "connections";
+        case helics_log_level_interfaces:
+            return "interfaces";
+        case helics_log_level_timing:
+            return "timing";
+        case helics_log_level_data:
+            return "data";
+        case helics_log_level_trace:
+            return "trace";
+        default:
+            return "log";
+    }
+}
+
+std::size_t decodeBinaryLog(std::istream& input, std::ostream& output)
+{
+    if (!readBinaryFileHeader(input, binaryLogMagic, binaryLogVersion)) {
+        throw(std::invalid_argument("input is not a HELICS binary log"));
+    }
+    std::vector<std::string> formats;
+    std::vector<std::string> args;
+    std::size_t count{0};
+    char kind{0};
+    while (input.get(kind)) {
+        if (kind == formatEntry) {
+            std::uint16_t formatId{0};
+            std::string format;
+            if (!readBinaryValue(input, formatId) || !readString(input, format)) {
+                break;
+            }
+            if (formatId >= formats.size()) {
+                formats.resize(static_cast<std::size_t>(formatId) + 1);
+            }
+            formats[formatId] = std::move(format);
+        } else if (kind == droppedEntry) {
+            std::uint64_t dropped{0};
+            if (!readBinaryValue(input, dropped)) {
+                break;
+            }
+            output << "[" << dropped << " records dropped]\n";
+        } else if (kind == recordEntry) {
+            BinaryLogRecord entry;
+            if (!readBinaryValue(input, entry.timestamp) || !readBinaryValue(input, entry.source) ||
+                !readBinaryValue(input, entry.format) || !readBinaryValue(input, entry.level) ||
+                !readBinaryValue(input, entry.argCount)) {
+                break;
+            }
+            args.clear();
+            bool valid{true};
+            for (int ii = 0; ii < entry.argCount && valid; ++ii) {
+                char type{0};
+                std::string str;
+                std::uint64_t raw{0};
+                valid = static_cast<bool>(input.get(type));
+                if (valid && static_cast<BinaryLogArgType>(type) == BinaryLogArgType::literal) {
+                    valid = readString(input, str);
+                    args.push_back(std::move(str));
+                    continue;
+                }
+                valid = valid && readBinaryValue(input, raw);
+                switch (static_cast<BinaryLogArgType>(type)) {
+                    case BinaryLogArgType::signed_integer:
+                        args.push_back(std::to_string(static_cast<std::int64_t>(raw)));
+                        break;
+                    case BinaryLogArgType::unsigned_integer:
+                        args.push_back(std::to_string(raw));
+                        break;
+                    case BinaryLogArgType::floating_point: {
+                        double value{0.0};
+                        std::memcpy(&value, &raw, sizeof(value));
+                        std::ostringstream val;
+                        val << std::setprecision(12) << value;
+                        args.push_back(val.str());
+                    } break;
+                    default:
+                        args.emplace_back();
+                        break;
+                }
+            }
+            if (!valid) {
+                break;
+            }
+            static const std::string unknownFormat{"unknown format"};
+            const auto& format =
+                (entry.format < formats.size()) ? formats[entry.format] : unknownFormat;
+            std::ostringstream line;
+            line << '[' << std::fixed << std::setprecision(9)
+                 << static_cast<double>(entry.timestamp) * 1e-9 << "] " << levelName(entry.level)
+                 << " (" << entry.source << ") " << formatBinaryRecord(format, args) << '\n';
+            output << line.str();
+            ++count;
+        } else {
+            throw(std::invalid_argument("corrupt HELICS binary log entry"));
+        }
+    }
+    return count;
+}
+
+}  // namespace helics
@@ -0,0 +1,207 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace helics {
+/** the maximum number of arguments in a binary log record*/
+constexpr int maxBinaryLogArgs{6};
+
+/** the types of argument which can be stored in a binary log record*/
+enum class BinaryLogArgType : std::uint8_t {
+    none = 0,
+    signed_integer = 1,
+    unsigned_integer = 2,
+    floating_point = 3,
+    literal = 4,  //!< pointer to a string with static storage duration
+};
+
+/** a single raw argument of a binary log record*/
+struct BinaryLogArg {
+    BinaryLogArgType type{BinaryLogArgType::none};
+    union {
+        std::int64_t integer;
+        std::uint64_t uinteger;
+        double value;
+        const char* literal;
+    };
+    BinaryLogArg(): integer(0) {}
+};
+
+/** a fixed size log record containing a format identifier and the unformatted arguments*/
+struct BinaryLogRecord {
+    std::uint64_t timestamp{0};  //!< nanoseconds since the logger started
+    std::int32_t source{0};  //!< the global id of the object generating the record
+    std::uint16_t format{0};  //!< the format identifier from BinaryLogger::registerFormat
+    std::int8_t level{0};  //!< the log level of the record
+    std::uint8_t argCount{0};  //!< the number of arguments used
+    BinaryLogArg args[maxBinaryLogArgs];  //!< the raw arguments
+};
+
+/** lock free single producer single consumer ring buffer of log records
+@details records are dropped and counted if the buffer is full rather than blocking the producer*/
+class BinaryLogRing {
+  public:
+    /** construct with a capacity, rounded up to a power of 2*/
+    explicit BinaryLogRing(std::size_t capacity);
+    /** add a record, called only from the owning thread
+    @return false if the buffer was full and the record was dropped*/
+    bool push(const BinaryLogRecord& record);
+    /** remove the oldest record, called only from the consuming thread
+    @return false if the buffer was empty*/
+    bool pop(BinaryLogRecord& record);
+    /** get the number of records dropped since construction*/
+    std::uint64_t dropped() const { return droppedCount.load(std::memory_order_relaxed); }
+
+  private:
+    std::vector<BinaryLogRecord> records;
+    const std::size_t mask;
+    std::atomic<std::size_t> head{0};  //!< the next slot to write
+    std::atomic<std::size_t> tail{0};  //!< the next slot to read
+    std::atomic<std::uint64_t> droppedCount{0};
+};
+
+/** logger recording structured binary records from performance critical code
+@details each producing thread writes raw records to its own ring buffer without locking or
+formatting, a background thread drains the rings periodically into a binary file.  The formatting
+into text is done offline with decodeBinaryLog.  Format strings must have static storage duration
+and only support "{}" placeholders; the arguments can be integers, floating point values, or string
+literals*/
+class BinaryLogger {
+  public:
+    /** construct a binary logger writing to a file
+    @param fileName the name of the binary log file to write
+    @param ringSize the number of records buffered for each producing thread
+    @throw std::ios_base::failure if the file cannot be opened*/
+    explicit BinaryLogger(const std::string& fileName, std::size_t ringSize = 4096);
+    /** destructor flushes any remaining records*/
+    ~BinaryLogger();
+    BinaryLogger(const BinaryLogger&) = delete;
+    BinaryLogger& operator=(const BinaryLogger&) = delete;
+    /** register a format string and get its identifier
+    @details the format is expected to be a string literal, the same pointer gets the same id*/
+    static std::uint16_t registerFormat(const char* format);
+    /** get a format string from its identifier, nullptr if it does not exist*/
+    static const char* getFormat(std::uint16_t formatId);
+    /** record a log entry with the raw arguments*/
+    template<typename... Args>
+    void record(int level, std::int32_t source, std::uint16_t formatId, const Args&... args)
+    {
+        static_assert(sizeof...(Args) <= maxBinaryLogArgs,
+                      "too many arguments for a binary log record");
+        BinaryLogRecord entry;
+        entry.timestamp = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - startTime)
+                .count());
+        entry.source = source;
+        entry.format = formatId;
+        entry.level = static_cast<std::int8_t>(level);
+        entry.argCount = static_cast<std::uint8_t>(sizeof...(Args));
+        int index{0};
+        int expander[] = {0, (entry.args[index++] = makeArg(args), 0)...};
+        (void)expander;
+        (void)index;
+        if (!getRing().push(entry)) {
+            // the writer should catch up
+            wakeWriter.notify_one();
+        }
+    }
+    /** write all the buffered records to the file*/
+    void flush();
+    /** get the number of records written to the file*/
+    std::uint64_t recordsWritten() const { return writtenCount.load(); }
+    /** get the number of records dropped because a ring buffer was full*/
+    std::uint64_t recordsDropped() const;
+
+  private:
+    using clock_type = std::chrono::steady_clock;
+
+    template<typename T>
+    static typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value,
+                                   BinaryLogArg>::type
+        makeArg(T val)
+    {
+        BinaryLogArg arg;
+        arg.type = BinaryLogArgType::signed_integer;
+        arg.integer = val;
+        return arg;
+    }
+    template<typename T>
+    static typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value,
+                                   BinaryLogArg>::type
+        makeArg(T val)
+    {
+        BinaryLogArg arg;
+        arg.type = BinaryLogArgType::unsigned_integer;
+        arg.uinteger = val;
+        return arg;
+    }
+    template<typename T>
+    static typename std::enable_if<std::is_floating_point<T>::value, BinaryLogArg>::type
+        makeArg(T val)
+    {
+        BinaryLogArg arg;
+        arg.type = BinaryLogArgType::floating_point;
+        arg.value = val;
+        return arg;
+    }
+    template<typename T>
+    static typename std::enable_if<std::is_enum<T>::value, BinaryLogArg>::type makeArg(T val)
+    {
+        return makeArg(static_cast<typename std::underlying_type<T>::type>(val));
+    }
+    static BinaryLogArg makeArg(const char* val)
+    {
+        BinaryLogArg arg;
+        arg.type = BinaryLogArgType::literal;
+        arg.literal = val;
+        return arg;
+    }
+    /** get the ring buffer for the calling thread, creating it if needed*/
+    BinaryLogRing& getRing();
+    /** loop for the writing thread*/
+    void writerLoop();
+    /** drain the rings into the file, must be called with the writeLock held*/
+    void drain();
+    /** write a single record to the file*/
+    void writeRecord(const BinaryLogRecord& entry);
+
+    const std::uint64_t loggerId;  //!< unique identifier for caching the thread rings
+    const std::size_t ringCapacity;
+    const clock_type::time_point startTime;
+    mutable std::mutex ringLock;  //!< lock protecting the list of rings
+    std::vector<std::pair<std::thread::id, std::unique_ptr<BinaryLogRing>>> rings;
+    std::mutex writeLock;  //!< lock protecting the file
+    std::ofstream outFile;
+    std::vector<bool> formatsWritten;  //!< the formats definitions written to the file
+    std::uint64_t droppedReported{0};  //!< the number of dropped records noted in the file
+    std::atomic<std::uint64_t> writtenCount{0};
+    std::mutex wakeLock;
+    std::condition_variable wakeWriter;
+    std::atomic<bool> stopping{false};
+    std::thread writerThread;
+};
+
+/** format a binary log file into text
+@param input the stream containing the binary log
+@param output the stream to write the formatted lines to
+@return the number of records decoded
+@throw std::invalid_argument if the input is not a binary log*/
+std::size_t decodeBinaryLog(std::istream& input, std::ostream& output);
+}  // namespace helics
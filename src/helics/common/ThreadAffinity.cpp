@@ -0,0 +1,136 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#include "ThreadAffinity.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <stdexcept>
+
+#ifdef __linux__
+#    include <pthread.h>
+#    include <sched.h>
+#elif defined(_WIN32)
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    include <windows.h>
+#endif
+
+namespace helics {
+/** the largest cpu number accepted in a cpu list*/
+static constexpr int maxCpuNumber{4095};
+/** the largest number of threads accepted for an asio context*/
+static constexpr int maxContextThreads{256};
+
+static int readCpuNumber(const std::string& cpuList, std::size_t& index)
+{
+    auto start = index;
+    int val = 0;
+    while (index < cpuList.size() && std::isdigit(static_cast<unsigned char>(cpuList[index]))) {
+        val = val * 10 + (cpuList[index] - '0');
+        if (val > maxCpuNumber) {
+            throw(std::invalid_argument("cpu number out of range in \"" + cpuList + "\""));
+        }
+        ++index;
+    }
+    if (index == start) {
+        throw(std::invalid_argument("invalid cpu list \"" + cpuList + "\""));
+    }
+    return val;
+}
+
+std::vector<int> parseCpuList(const std::string& cpuList)
+{
+    std::vector<int> cpus;
+    std::string list;
+    list.reserve(cpuList.size());
+    std::copy_if(cpuList.begin(), cpuList.end(), std::back_inserter(list), [](char c) {
+        return !std::isspace(static_cast<unsigned char>(c));
+    });
+    std::size_t index = 0;
+    while (index < list.size()) {
+        auto first = readCpuNumber(list, index);
+        auto last = first;
+        if (index < list.size() && list[index] == '-') {
+            ++index;
+            last = readCpuNumber(list, index);
+            if (last < first) {
+                throw(std::invalid_argument("invalid cpu range in \"" + cpuList + "\""));
+            }
+        }
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+        if (index < list.size()) {
+            if (list[index] != ',' || index + 1 == list.size()) {
+                throw(std::invalid_argument("invalid cpu list \"" + cpuList + "\""));
+            }
+            ++index;
+        }
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+bool setThreadAffinity(const std::vector<int>& cpus)
+{
+    if (cpus.empty()) {
+        return false;
+    }
+#ifdef __linux__
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (auto cpu : cpus) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &cpuSet);
+        }
+    }
+    if (CPU_COUNT(&cpuSet) == 0) {
+        return false;
+    }
+    return (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0);
+#elif defined(_WIN32)
+    DWORD_PTR mask = 0;
+    for (auto cpu : cpus) {
+        if (cpu < static_cast<int>(sizeof(DWORD_PTR) * 8)) {
+            mask |= (static_cast<DWORD_PTR>(1) << cpu);
+        }
+    }
+    if (mask == 0) {
+        return false;
+    }
+    return (SetThreadAffinityMask(GetCurrentThread(), mask) != 0);
+#else
+    return false;
+#endif
+}
+
+std::pair<std::string, int> parseContextThreads(const std::string& contextThreads)
+{
+    auto sep = contextThreads.find_last_of(':');
+    std::string name;
+    std::string count = contextThreads;
+    if (sep != std::string::npos) {
+        name = contextThreads.substr(0, sep);
+        count = contextThreads.substr(sep + 1);
+    }
+    if (count.empty() || count.size() > 3 ||
+        !std::all_of(count.begin(), count.end(), [](char c) {
+            return std::isdigit(static_cast<unsigned char>(c)) != 0;
+        })) {
+        throw(std::invalid_argument("invalid context thread count \"" + contextThreads + "\""));
+    }
+    auto threads = std::stoi(count);
+    if (threads < 1 || threads > maxContextThreads) {
+        throw(std::invalid_argument("context thread count out of range in \"" + contextThreads +
+                                    "\""));
+    }
+    return {name, threads};
+}
+}  // namespace helics
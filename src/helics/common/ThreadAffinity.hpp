@@ -0,0 +1,29 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace helics {
+/** parse a list of cpu numbers and ranges such as "0-3,8"
+@return the sorted list of unique cpu numbers, empty for an empty string
+@throw std::invalid_argument if the string is not a valid cpu list*/
+std::vector<int> parseCpuList(const std::string& cpuList);
+
+/** restrict the calling thread to run on a set of cpus
+@param cpus the cpus to run on, an empty list leaves the thread unchanged
+@return true if the affinity was set, false if it is not supported on the platform or failed*/
+bool setThreadAffinity(const std::vector<int>& cpus);
+
+/** parse the thread count of an asio context given as "<name>:<count>" or just "<count>"
+@details a count without a name is for the default context shared by the brokers and cores
+@return the context name and the number of threads
+@throw std::invalid_argument if the string is not a valid context thread count*/
+std::pair<std::string, int> parseContextThreads(const std::string& contextThreads);
+}  // namespace helics
@@ -0,0 +1,59 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+
+/** @file
+helper functions for the binary files written by the binary logger, flight recorder, and message
+capture, the files start with an 8 character identifier and a format version followed by values
+written in the native byte order
+*/
+namespace helics {
+/** the size of the identifier at the start of a binary file*/
+constexpr std::size_t binaryFileMagicSize{8};
+
+/** write the raw bytes of a trivially copyable value to a stream*/
+template<typename T>
+inline void writeBinaryValue(std::ostream& out, const T& val)
+{
+    out.write(reinterpret_cast<const char*>(&val), sizeof(T));
+}
+
+/** read the raw bytes of a trivially copyable value from a stream
+@return false if the stream did not contain a complete value*/
+template<typename T>
+inline bool readBinaryValue(std::istream& in, T& val)
+{
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&val), sizeof(T)));
+}
+
+/** write the identifier and format version at the start of a binary file*/
+inline void writeBinaryFileHeader(std::ostream& out,
+                                  const char (&magic)[binaryFileMagicSize],
+                                  std::uint32_t version)
+{
+    out.write(magic, binaryFileMagicSize);
+    writeBinaryValue(out, version);
+}
+
+/** read the header of a binary file
+@return true if the identifier and format version match the expected values*/
+inline bool readBinaryFileHeader(std::istream& in,
+                                 const char (&magic)[binaryFileMagicSize],
+                                 std::uint32_t version)
+{
+    char fileMagic[binaryFileMagicSize];
+    std::uint32_t fileVersion{0};
+    return (in.read(fileMagic, binaryFileMagicSize) &&
+            std::memcmp(fileMagic, magic, binaryFileMagicSize) == 0 &&
+            readBinaryValue(in, fileVersion) && fileVersion == version);
+}
+}  // namespace helics
@@ -596,6 +596,9 @@ static constexpr std::pair<action_message_def::action_t, const char*> actionStri
     {action_message_def::action_t::cmd_priority_ack, "priority_ack"},
     {action_message_def::action_t::cmd_query, "query"},
     {action_message_def::action_t::cmd_query_reply, "query_reply"},
+    {action_message_def::action_t::cmd_query_update, "query_update"},
+    {action_message_def::action_t::cmd_query_subscription, "query_subscription"},
+    {action_message_def::action_t::cmd_query_unsubscribe, "query_unsubscribe"},
     {action_message_def::action_t::cmd_reg_broker, "reg_broker"},
 
     {action_message_def::action_t::cmd_ignore, "ignore"},
@@ -634,6 +637,8 @@ static constexpr std::pair<action_message_def::action_t, const char*> actionStri
     {action_message_def::action_t::cmd_remove_dependency, "remove_dependency"},
     {action_message_def::action_t::cmd_add_dependent, "add_dependent"},
     {action_message_def::action_t::cmd_remove_dependent, "remove_dependent"},
+    {action_message_def::action_t::cmd_time_coupling_probe, "time_coupling_probe"},
+    {action_message_def::action_t::cmd_time_coupling_ack, "time_coupling_ack"},
     {action_message_def::action_t::cmd_add_interdependency, "add_interdependency"},
     {action_message_def::action_t::cmd_remove_interdependency, "remove_interdependency"},
 
@@ -665,6 +670,9 @@ static constexpr std::pair<action_message_def::action_t, const char*> actionStri
     {action_message_def::action_t::cmd_add_named_input, "add_named_input"},
     {action_message_def::action_t::cmd_add_named_publication, "add_named_publication"},
     {action_message_def::action_t::cmd_add_named_filter, "add_named_filter"},
+    {action_message_def::action_t::cmd_interface_location, "interface_location"},
+    {action_message_def::action_t::cmd_find_interface, "find_interface"},
+    {action_message_def::action_t::cmd_interface_summary, "interface_summary"},
     {action_message_def::action_t::cmd_remove_named_endpoint, "remove_named_endpoint"},
     {action_message_def::action_t::cmd_disconnect_fed, "disconnect_fed"},
     {action_message_def::action_t::cmd_disconnect_broker, "disconnect_broker"},
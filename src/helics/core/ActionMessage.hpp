@@ -263,6 +263,42 @@ inline bool isDependencyCommand(const ActionMessage& command) noexcept
     }
 }
 
+/** check if a command changes the structure of the federation reported in the map queries
+@details this includes registrations, data links, and dependency changes*/
+inline bool isStructureCommand(const ActionMessage& command) noexcept
+{
+    switch (command.action()) {
+        case CMD_REG_FED:
+        case CMD_REG_BROKER:
+        case CMD_REG_PUB:
+        case CMD_REG_INPUT:
+        case CMD_REG_ENDPOINT:
+        case CMD_REG_FILTER:
+        case CMD_ADD_PUBLISHER:
+        case CMD_ADD_SUBSCRIBER:
+        case CMD_ADD_ENDPOINT:
+        case CMD_ADD_FILTER:
+        case CMD_REMOVE_PUBLICATION:
+        case CMD_REMOVE_SUBSCRIBER:
+        case CMD_REMOVE_ENDPOINT:
+        case CMD_REMOVE_FILTER:
+        case CMD_ADD_NAMED_INPUT:
+        case CMD_ADD_NAMED_PUBLICATION:
+        case CMD_ADD_NAMED_ENDPOINT:
+        case CMD_ADD_NAMED_FILTER:
+        case CMD_REMOVE_NAMED_INPUT:
+        case CMD_REMOVE_NAMED_PUBLICATION:
+        case CMD_REMOVE_NAMED_ENDPOINT:
+        case CMD_REMOVE_NAMED_FILTER:
+        case CMD_DISCONNECT_FED:
+        case CMD_DISCONNECT_CORE:
+        case CMD_DISCONNECT_BROKER:
+            return true;
+        default:
+            return isDependencyCommand(command);
+    }
+}
+
 /** check if a command is a disconnect command*/
 inline bool isDisconnectCommand(const ActionMessage& command) noexcept
 {
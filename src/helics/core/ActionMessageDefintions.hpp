@@ -35,12 +35,17 @@ across different compilers*/
         cmd_set_global = -cmd_info_basis - 55,  //!< set a global value
         cmd_broker_query = -37,  //!< send a query to a core
         cmd_query_reply = -cmd_info_basis - 38,  //!< response to a query
+        cmd_query_update = -45,  //!< notify a parent that the cached query results of a child
+                                 //!< are out of date
+        cmd_query_unsubscribe = -46,  //!< remove a query subscription from the core or broker
+                                      //!< sending the results
         cmd_reg_broker =
             -cmd_info_basis - 40,  //!< for a broker to connect with a higher level broker
         cmd_broker_location = cmd_info_basis - 57,  //!< command to define a new broker location
         cmd_broker_setup = -1,  //!< command to load the setup information for a broker
         cmd_ignore = 0,  //!< null command
         cmd_tick = 1,  //!< command for a timer tick
+        cmd_query_subscription = 46,  //!< command to update the result of a query subscription
         cmd_user_disconnect = 2,  //!< command specifying that a user has issued a disconnect signal
         cmd_disconnect = 3,  //!< disconnect command
         cmd_disconnect_name = 4,  //!< disconnect a broker or core by name vs id
@@ -96,6 +101,9 @@ across different compilers*/
         cmd_add_dependent = 144,  //!< command to add a dependent to a federate
         cmd_remove_dependent =
             145,  //!< command to remove a dependent from a federates consideration
+        cmd_time_coupling_probe =
+            146,  //!< command to search for a path from a dependent back to a federate
+        cmd_time_coupling_ack = 147,  //!< command to report the result of a coupling probe
         cmd_add_interdependency =
             148,  //!< command to add a federate as both dependent and a dependency
         cmd_remove_interdependency =
@@ -151,6 +159,9 @@ across different compilers*/
         cmd_add_named_filter = 105,  //!< command to add named filter as a target
         cmd_add_named_publication = 106,  //!< command to add a named publication as a target
         cmd_add_named_endpoint = 107,  //!< command to add a named endpoint as a target
+        cmd_interface_location = 108,  //!< notify a broker of the broker owning a named interface
+        cmd_find_interface = 109,  //!< ask an interface owning broker if it holds a named interface
+        cmd_interface_summary = 110,  //!< the interface counts of an interface owning broker
         cmd_remove_named_input = 124,  //!< cmd to remove a target from connection by name
         cmd_remove_named_filter = 125,  //!< cmd to remove a filter from connection by name
         cmd_remove_named_publication =
@@ -257,6 +268,9 @@ across different compilers*/
 #define CMD_ADD_NAMED_FILTER action_message_def::action_t::cmd_add_named_filter
 #define CMD_ADD_NAMED_PUBLICATION action_message_def::action_t::cmd_add_named_publication
 #define CMD_ADD_NAMED_INPUT action_message_def::action_t::cmd_add_named_input
+#define CMD_INTERFACE_LOCATION action_message_def::action_t::cmd_interface_location
+#define CMD_FIND_INTERFACE action_message_def::action_t::cmd_find_interface
+#define CMD_INTERFACE_SUMMARY action_message_def::action_t::cmd_interface_summary
 
 #define CMD_REMOVE_NAMED_ENDPOINT action_message_def::action_t::cmd_remove_named_endpoint
 #define CMD_REMOVE_NAMED_FILTER action_message_def::action_t::cmd_remove_named_filter
@@ -287,6 +301,8 @@ across different compilers*/
 #define CMD_REMOVE_DEPENDENCY action_message_def::action_t::cmd_remove_dependency
 #define CMD_ADD_DEPENDENT action_message_def::action_t::cmd_add_dependent
 #define CMD_REMOVE_DEPENDENT action_message_def::action_t::cmd_remove_dependent
+#define CMD_TIME_COUPLING_PROBE action_message_def::action_t::cmd_time_coupling_probe
+#define CMD_TIME_COUPLING_ACK action_message_def::action_t::cmd_time_coupling_ack
 #define CMD_ADD_INTERDEPENDENCY action_message_def::action_t::cmd_add_interdependency
 #define CMD_REMOVE_INTERDEPENDENCY action_message_def::action_t::cmd_remove_interdependency
 
@@ -311,6 +327,9 @@ across different compilers*/
 #define CMD_QUERY action_message_def::action_t::cmd_query
 #define CMD_BROKER_QUERY action_message_def::action_t::cmd_broker_query
 #define CMD_QUERY_REPLY action_message_def::action_t::cmd_query_reply
+#define CMD_QUERY_UPDATE action_message_def::action_t::cmd_query_update
+#define CMD_QUERY_SUBSCRIPTION action_message_def::action_t::cmd_query_subscription
+#define CMD_QUERY_UNSUBSCRIBE action_message_def::action_t::cmd_query_unsubscribe
 #define CMD_SET_GLOBAL action_message_def::action_t::cmd_set_global
 
 #define CMD_MULTI_MESSAGE action_message_def::action_t::cmd_multi_message
@@ -342,6 +361,7 @@ across different compilers*/
 // definitions related to Core Configure
 #define UPDATE_FILTER_OPERATOR 572
 #define UPDATE_QUERY_CALLBACK 581
+#define UPDATE_QUERY_SUBSCRIPTION 585
 #define UPDATE_LOGGING_CALLBACK 592
 #define REQUEST_TICK_FORWARDING 607
 
@@ -7,6 +7,7 @@ SPDX-License-Identifier: BSD-3-Clause
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <functional>
 #include <string>
 #include <vector>
@@ -94,6 +95,27 @@ class Broker {
     return until the query is answered so use with caution
     */
     virtual std::string query(const std::string& target, const std::string& queryStr) = 0;
+    /** subscribe to the results of a query
+    @details the subscription is registered with the federate, core, or broker answering the query,
+    which sends a new result when its state changes and the result differs from the previous one.
+    The callback is executed on the broker's processing thread so it should return quickly and must
+    not make blocking calls back into the broker
+    @param target the target of the query, as used in query
+    @param queryStr the actual query
+    @param callback the function to call with the query results
+    @param period the minimum time between results
+    @param everyPeriod set to true to call the callback every period even if the result has not
+    changed
+    @return an identifier for the subscription to use in unsubscribeQuery
+    */
+    virtual int32_t subscribeQuery(const std::string& target,
+                                   const std::string& queryStr,
+                                   std::function<void(const std::string&)> callback,
+                                   std::chrono::milliseconds period,
+                                   bool everyPeriod = false) = 0;
+    /** stop a query subscription
+    @details the callback may still be called until the broker processes the request*/
+    virtual void unsubscribeQuery(int32_t subscriptionId) = 0;
 
     /** set a federation global value
     @details this overwrites any previous value for this name
@@ -7,9 +7,13 @@ SPDX-License-Identifier: BSD-3-Clause
 
 #include "BrokerBase.hpp"
 
+#include "../common/BinaryLogger.hpp"
+#include "../common/ThreadAffinity.hpp"
 #include "../common/fmt_format.h"
 #include "../common/logger.h"
+#include "FlightRecorder.hpp"
 #include "ForwardingTimeCoordinator.hpp"
+#include "MessageCapture.hpp"
 #include "flagOperations.hpp"
 #include "gmlc/libguarded/guarded.hpp"
 #include "gmlc/utilities/stringOps.h"
@@ -30,6 +34,7 @@ SPDX-License-Identifier: BSD-3-Clause
 
 #include <iostream>
 #include <map>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 
@@ -149,6 +154,11 @@ std::shared_ptr<helicsCLI11App> BrokerBase::generateBaseCLI()
                             forceLoggingFlush,
                             "flush the log after every message");
     logging_group->add_option("--logfile", logFile, "the file to log the messages to");
+    logging_group->add_option(
+        "--binarylog",
+        binaryLogFile,
+        "the file to record the timing and trace messages to in binary form, the messages are "
+        "formatted offline with \"helics_app binlog <file>\"");
     logging_group
         ->add_option_function<int>(
             "--loglevel,--log-level",
@@ -174,6 +184,68 @@ std::shared_ptr<helicsCLI11App> BrokerBase::generateBaseCLI()
         "--dumplog",
         dumplog,
         "capture a record of all messages and dump a complete log to file or console on termination");
+    logging_group->add_option(
+        "--flight_recorder",
+        flightRecorderSize,
+        "the number of recent message headers kept in memory for the flight_recorder query and "
+        "dumps, 0 to disable");
+    logging_group->add_option(
+        "--flight_recorder_file",
+        flightRecorderFile,
+        "the file to dump the flight recorder to on errors, no error dumps are made without it");
+    logging_group->add_option(
+        "--capture_messages",
+        captureFile,
+        "capture the messages processed by the broker or core to a file for replay in profiling");
+    logging_group->add_flag("--flight_recorder_signal",
+                            flightRecorderSignal,
+                            "dump the flight recorder when the process receives SIGUSR1 to the "
+                            "flight recorder file or <identifier>.hfr");
+
+    auto* thread_group =
+        hApp->add_option_group("threads", "Options related to the placement of threads");
+    thread_group->add_option_function<std::string>(
+        "--processing_cpus",
+        [this](const std::string& cpus) {
+            try {
+                processingCpus = parseCpuList(cpus);
+            }
+            catch (const std::invalid_argument& ia) {
+                throw(CLI::ValidationError(ia.what()));
+            }
+        },
+        "the cpus to run the message processing thread on as a list of numbers and ranges such as "
+        "\"0-3,8\"");
+    thread_group->add_option_function<std::string>(
+        "--context_cpus",
+        [this](const std::string& cpus) {
+            try {
+                contextCpus = parseCpuList(cpus);
+            }
+            catch (const std::invalid_argument& ia) {
+                throw(CLI::ValidationError(ia.what()));
+            }
+        },
+        "the cpus to run the thread of the shared asio context on, the context is shared by all "
+        "brokers and cores in a process so the last setting applies");
+    thread_group
+        ->add_option_function<std::vector<std::string>>(
+            "--context_threads",
+            [this](const std::vector<std::string>& threads) {
+                for (const auto& ctx : threads) {
+                    try {
+                        contextThreads.push_back(parseContextThreads(ctx));
+                    }
+                    catch (const std::invalid_argument& ia) {
+                        throw(CLI::ValidationError(ia.what()));
+                    }
+                }
+            },
+            "the number of threads to run asio contexts on as a list of <name>:<count>, a count "
+            "without a name is for the shared context, handlers of a context with more than one "
+            "thread may run concurrently")
+        ->delimiter(',')
+        ->type_name("<name>:<count>");
 
     auto* timeout_group =
         hApp->add_option_group("timeouts", "Options related to network and process timeouts");
@@ -261,8 +333,45 @@ void BrokerBase::configureBase()
         loggingObj->openFile(logFile);
     }
     loggingObj->startLogging(maxLogLevel, maxLogLevel);
-    mainLoopIsRunning.store(true);
-    queueProcessingThread = std::thread(&BrokerBase::queueProcessingLoop, this);
+    if (!binaryLogFile.empty()) {
+        try {
+            binaryLogger = std::make_unique<BinaryLogger>(binaryLogFile);
+        }
+        catch (const std::ios_base::failure&) {
+            sendToLogger(global_id.load(),
+                         log_level::warning,
+                         identifier,
+                         fmt::format("unable to open binary log file {}", binaryLogFile));
+        }
+    }
+    if (flightRecorderSize > 0) {
+        flightRecorder =
+            std::make_unique<FlightRecorder>(static_cast<std::size_t>(flightRecorderSize));
+        if (flightRecorderSignal) {
+            flightRecorder->enableSignalDump((flightRecorderFile.empty()) ? identifier + ".hfr" :
+                                                                            flightRecorderFile);
+        }
+    }
+    if (!captureFile.empty()) {
+        try {
+            messageCapture = std::make_unique<MessageCaptureWriter>(captureFile);
+        }
+        catch (const std::ios_base::failure&) {
+            sendToLogger(global_id.load(),
+                         log_level::warning,
+                         identifier,
+                         fmt::format("unable to open message capture file {}", captureFile));
+        }
+    }
+#ifndef HELICS_DISABLE_ASIO
+    for (const auto& ctx : contextThreads) {
+        AsioContextManager::setContextThreads(ctx.first, ctx.second);
+    }
+#endif
+    if (!queueDisabled) {
+        mainLoopIsRunning.store(true);
+        queueProcessingThread = std::thread(&BrokerBase::queueProcessingLoop, this);
+    }
     brokerState = broker_state_t::configured;
 }
 
@@ -309,11 +418,31 @@ void BrokerBase::setErrorState(int eCode, const std::string& estring)
             errorTimeStart = std::chrono::steady_clock::now();
             ActionMessage(CMD_ERROR_CHECK, global_id.load(), global_id.load());
         }
+        dumpFlightRecorder("error");
     }
 
     sendToLogger(global_id.load(), helics_log_level_error, identifier, estring);
 }
 
+void BrokerBase::dumpFlightRecorder(const std::string& reason)
+{
+    if (!flightRecorder || flightRecorderFile.empty()) {
+        return;
+    }
+    const auto& file = flightRecorderFile;
+    if (flightRecorder->dump(file)) {
+        sendToLogger(global_id.load(),
+                     log_level::warning,
+                     identifier,
+                     fmt::format("flight recorder dumped to {} on {}", file, reason));
+    } else {
+        sendToLogger(global_id.load(),
+                     log_level::warning,
+                     identifier,
+                     fmt::format("unable to dump flight recorder to {}", file));
+    }
+}
+
 void BrokerBase::setLoggingFile(const std::string& lfile)
 {
     if (loggingObj) {
@@ -381,6 +510,7 @@ void BrokerBase::addActionMessage(ActionMessage&& m)
         actionQueue.emplace(std::move(m));
     }
 }
+
 #ifndef HELICS_DISABLE_ASIO
 using activeProtector = gmlc::libguarded::guarded<std::pair<bool, bool>>;
 
@@ -447,6 +577,26 @@ bool BrokerBase::tryReconnect()
     return false;
 }
 
+/** the messageID marking the CMD_IGNORE messages used to touch the queue memory*/
+static constexpr int32_t firstTouchMessageID{0x4E554D41};
+/** the number of messages in each batch used to touch the queue memory*/
+static constexpr uint32_t firstTouchBatchSize{1024};
+
+void BrokerBase::touchQueueMemory(uint16_t batch)
+{
+    if (batch == 1) {
+        actionQueue.reserve(firstTouchBatchSize);
+    }
+    ActionMessage touch(CMD_IGNORE);
+    touch.messageID = firstTouchMessageID;
+    touch.counter = batch;
+    for (uint32_t ii = firstTouchBatchSize; ii > 0; --ii) {
+        // the sequenceID counts down so the last message of a batch is 0
+        touch.sequenceID = ii - 1;
+        actionQueue.push(touch);
+    }
+}
+
 //#define DISABLE_TICK
 void BrokerBase::queueProcessingLoop()
 {
@@ -454,8 +604,21 @@ void BrokerBase::queueProcessingLoop()
         mainLoopIsRunning.store(false);
         return;
     }
+    if (!processingCpus.empty()) {
+        if (setThreadAffinity(processingCpus)) {
+            touchQueueMemory(1);
+        } else {
+            sendToLogger(global_id.load(),
+                         log_level::warning,
+                         identifier,
+                         "unable to set the cpu affinity of the processing thread");
+        }
+    }
     std::vector<ActionMessage> dumpMessages;
 #ifndef HELICS_DISABLE_ASIO
+    if (!contextCpus.empty()) {
+        AsioContextManager::setContextAffinity(std::string(), contextCpus);
+    }
     auto serv = AsioContextManager::getContextPointer();
     auto contextLoop = serv->startContextLoop();
     asio::steady_timer ticktimer(serv->getBaseContext());
@@ -485,6 +648,9 @@ void BrokerBase::queueProcessingLoop()
     global_broker_id_local = global_id.load();
     int messagesSinceLastTick = 0;
     auto logDump = [&, this]() {
+        if (messageCapture) {
+            messageCapture->flush();
+        }
         if (dumplog) {
             for (auto& act : dumpMessages) {
                 sendToLogger(parent_broker_id,
@@ -504,7 +670,19 @@ void BrokerBase::queueProcessingLoop()
     }
     while (true) {
         auto command = actionQueue.pop();
+        if (command.action() == CMD_IGNORE && command.messageID == firstTouchMessageID) {
+            if (command.counter == 1 && command.sequenceID == 0) {
+                touchQueueMemory(2);
+            }
+            continue;
+        }
         ++messageCounter;
+        if (messageCapture) {
+            messageCapture->write(command);
+        }
+        if (flightRecorder) {
+            flightRecorder->record(command);
+        }
         if (dumplog) {
             dumpMessages.push_back(command);
         }
@@ -634,6 +812,15 @@ void BrokerBase::queueProcessingLoop()
     }
 }
 
+action_message_def::action_t BrokerBase::processMessageDirect(ActionMessage& command)
+{
+    ++messageCounter;
+    if (!global_broker_id_local.isValid()) {
+        global_broker_id_local = global_id.load();
+    }
+    return commandProcessor(command);
+}
+
 action_message_def::action_t BrokerBase::commandProcessor(ActionMessage& command)
 {
     switch (command.action()) {
@@ -19,10 +19,14 @@ and some common methods used cores and brokers
 #include <memory>
 #include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
 namespace helics {
 class Logger;
+class BinaryLogger;
+class FlightRecorder;
+class MessageCaptureWriter;
 class ForwardingTimeCoordinator;
 class helicsCLI11App;
 /** base class for broker like objects
@@ -56,6 +60,8 @@ class BrokerBase {
     mutable std::string address;  //!< network location of the broker
     std::unique_ptr<Logger>
         loggingObj;  //!< default logging object to use if the logging callback is not specified
+    /** binary logger recording deferred format log messages, only created if a file is given*/
+    std::unique_ptr<BinaryLogger> binaryLogger;
     std::thread queueProcessingThread;  //!< thread for running the broker
     /** a logging function for logging or printing messages*/
     std::function<void(int, const std::string&, const std::string&)> loggerFunction;
@@ -75,10 +81,23 @@ class BrokerBase {
         false};  //!< flag indicating that the message queue should not be used and all functions
     //!< called directly instead of distinct thread
     bool disable_timer{false};  //!< turn off the timer/timeout subsystem completely
+    bool flightRecorderSignal{false};  //!< dump the flight recorder on SIGUSR1
+    int flightRecorderSize{1024};  //!< the number of messages held by the flight recorder
+    std::string flightRecorderFile;  //!< the file to dump the flight recorder to
+    std::string captureFile;  //!< the file to capture the processed messages to
+    std::vector<int> processingCpus;  //!< the cpus to run the processing thread on, empty for any
+    std::vector<int> contextCpus;  //!< the cpus to run the shared asio context thread on
+    /** the number of threads to run the loops of asio contexts on by context name*/
+    std::vector<std::pair<std::string, int>> contextThreads;
+    /** writer for capturing the processed messages for later replay*/
+    std::unique_ptr<MessageCaptureWriter> messageCapture;
     std::atomic<std::size_t> messageCounter{
         0};  //!< counter for the total number of message processed
   protected:
     std::string logFile;  //!< the file to log message to
+    std::string binaryLogFile;  //!< the file to record binary log messages to
+    /** ring buffer of the recent messages processed, only created if the size is >0*/
+    std::unique_ptr<FlightRecorder> flightRecorder;
     std::unique_ptr<ForwardingTimeCoordinator> timeCoord;  //!< object managing the time control
     gmlc::containers::BlockingPriorityQueue<ActionMessage> actionQueue;  //!< primary routing queue
     /** enumeration of the possible core states*/
@@ -162,6 +181,12 @@ class BrokerBase {
   private:
     /** start main broker loop*/
     void queueProcessingLoop();
+    /** write to the memory of the action queue from the processing thread
+    @details the queue messages are pushed by the processing thread after it is pinned so the first
+    touch policy of the operating system places the queue memory on the NUMA node of its cpus, the
+    loop pushes the second batch once the first is drained so both internal buffers are touched
+    @param batch the warm up batch to push, 1 or 2*/
+    void touchQueueMemory(uint16_t batch);
     /** helper function for doing some preprocessing on a command
     @return (CMD_IGNORE) if the command is a termination command*/
     action_message_def::action_t commandProcessor(ActionMessage& command);
@@ -201,14 +226,28 @@ class BrokerBase {
     virtual std::shared_ptr<helicsCLI11App> generateCLI();
     /** set the broker error state and error string*/
     void setErrorState(int eCode, const std::string& estring);
+    /** write the contents of the flight recorder to the flight recorder file if one was given
+    @param reason a description of why the dump was triggered for the log*/
+    void dumpFlightRecorder(const std::string& reason);
     /** set the logging file if using the default logger*/
     void setLoggingFile(const std::string& lfile);
+    /** run without the processing thread, messages are then only processed through
+    processMessageDirect
+    @details must be called before the broker is configured*/
+    void disableProcessingThread() { queueDisabled = true; }
+    /** check if the processed messages are recorded in a dump log or message capture*/
+    bool isRecordingMessages() const { return dumplog || !captureFile.empty(); }
 
   public:
     /** generate a callback function for the logging purposes*/
     std::function<void(int, const std::string&, const std::string&)> getLoggingCallback() const;
     /** close all the threads*/
     void joinAllThreads();
+    /** process a message in the calling thread instead of through the queue
+    @details this is intended for replaying captured message streams into a broker or core with the
+    processing thread disabled, it must not be used while the processing thread is running
+    @return CMD_IGNORE if the message was processed otherwise the control action that was not*/
+    action_message_def::action_t processMessageDirect(ActionMessage& command);
     /** get the number of messages that have been processed internally*/
     std::size_t currentMessageCounter() const
     {
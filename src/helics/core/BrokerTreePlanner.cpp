@@ -0,0 +1,143 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "BrokerTreePlanner.hpp"
+
+#include "../common/JsonProcessingFunctions.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace helics {
+/** assign items to bins balancing the total load with a limit on the number of items in each bin
+@details uses a largest load first greedy assignment to the least loaded open bin
+@param loads the load of each item
+@param binCount the number of bins
+@param binCapacity the maximum number of items in a bin
+@param binLoads output of the total load assigned to each bin
+@return the bin index of each item*/
+static std::vector<int> balanceAssignment(const std::vector<double>& loads,
+                                          int binCount,
+                                          int binCapacity,
+                                          std::vector<double>& binLoads)
+{
+    std::vector<int> order(loads.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&loads](int item1, int item2) {
+        return loads[item1] > loads[item2];
+    });
+    binLoads.assign(binCount, 0.0);
+    std::vector<int> binCounts(binCount, 0);
+    std::vector<int> assignment(loads.size(), -1);
+    for (auto item : order) {
+        int best{-1};
+        for (int bin = 0; bin < binCount; ++bin) {
+            if (binCounts[bin] >= binCapacity) {
+                continue;
+            }
+            if ((best < 0) || (binLoads[bin] < binLoads[best])) {
+                best = bin;
+            }
+        }
+        assignment[item] = best;
+        binLoads[best] += loads[item];
+        ++binCounts[best];
+    }
+    return assignment;
+}
+
+BrokerTreePlan
+    generateBrokerTreePlan(int coreCount, int maxFanout, const std::vector<double>& coreLoads)
+{
+    BrokerTreePlan plan;
+    if (coreCount <= 0) {
+        return plan;
+    }
+    maxFanout = std::max(maxFanout, 2);
+    plan.coreAssignments.assign(coreCount, -1);
+    if (coreCount <= maxFanout) {
+        return plan;
+    }
+    std::vector<double> loads(coreCount, 1.0);
+    auto loadCount = std::min(coreLoads.size(), loads.size());
+    for (std::size_t ii = 0; ii < loadCount; ++ii) {
+        if (coreLoads[ii] >= 0.0) {
+            loads[ii] = coreLoads[ii];
+        }
+    }
+    // the size of each level of brokers starting from the level the cores connect to
+    std::vector<int> levelSizes{(coreCount + maxFanout - 1) / maxFanout};
+    while (levelSizes.back() > maxFanout) {
+        levelSizes.push_back((levelSizes.back() + maxFanout - 1) / maxFanout);
+    }
+    plan.levels = static_cast<int>(levelSizes.size());
+    // sub-brokers are listed from the top level down so parents are created first
+    std::vector<int> levelOffsets(levelSizes.size());
+    int brokerCount{0};
+    for (auto level = levelSizes.size(); level-- > 0;) {
+        levelOffsets[level] = brokerCount;
+        brokerCount += levelSizes[level];
+    }
+    plan.brokerParents.assign(brokerCount, -1);
+    plan.brokerLoads.assign(brokerCount, 0.0);
+
+    std::vector<double> binLoads;
+    auto assignment = balanceAssignment(loads, levelSizes[0], maxFanout, binLoads);
+    for (int ii = 0; ii < coreCount; ++ii) {
+        plan.coreAssignments[ii] = levelOffsets[0] + assignment[ii];
+    }
+    for (std::size_t level = 0; level < levelSizes.size(); ++level) {
+        std::copy(binLoads.begin(), binLoads.end(), plan.brokerLoads.begin() + levelOffsets[level]);
+        if (level + 1 == levelSizes.size()) {
+            // the top level connects to the root
+            break;
+        }
+        auto levelLoads = binLoads;
+        assignment = balanceAssignment(levelLoads, levelSizes[level + 1], maxFanout, binLoads);
+        for (int ii = 0; ii < levelSizes[level]; ++ii) {
+            plan.brokerParents[levelOffsets[level] + ii] = levelOffsets[level + 1] + assignment[ii];
+        }
+    }
+    return plan;
+}
+
+std::string generateBrokerTreeJson(const BrokerTreePlan& plan,
+                                   const std::string& rootName,
+                                   const std::string& rootAddress,
+                                   const std::vector<std::string>& brokerNames,
+                                   const std::vector<std::string>& brokerAddresses)
+{
+    auto brokerName = [&](int index) -> const std::string& {
+        return (index < 0) ? rootName : brokerNames[index];
+    };
+    auto brokerAddress = [&](int index) -> const std::string& {
+        return (index < 0) ? rootAddress : brokerAddresses[index];
+    };
+    Json::Value base;
+    base["name"] = rootName;
+    base["address"] = rootAddress;
+    base["levels"] = plan.levels;
+    base["brokers"] = Json::arrayValue;
+    for (std::size_t ii = 0; ii < plan.brokerParents.size(); ++ii) {
+        Json::Value brk;
+        brk["name"] = brokerName(static_cast<int>(ii));
+        brk["address"] = brokerAddress(static_cast<int>(ii));
+        brk["parent"] = brokerName(plan.brokerParents[ii]);
+        brk["load"] = plan.brokerLoads[ii];
+        base["brokers"].append(std::move(brk));
+    }
+    base["cores"] = Json::arrayValue;
+    for (std::size_t ii = 0; ii < plan.coreAssignments.size(); ++ii) {
+        Json::Value core;
+        core["index"] = static_cast<int>(ii);
+        core["broker"] = brokerName(plan.coreAssignments[ii]);
+        core["address"] = brokerAddress(plan.coreAssignments[ii]);
+        base["cores"].append(std::move(core));
+    }
+    return generateJsonString(base);
+}
+}  // namespace helics
@@ -0,0 +1,51 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace helics {
+/** description of a hierarchy of sub-brokers below a root broker*/
+struct BrokerTreePlan {
+    /** the parent of each sub-broker as an index into the sub-broker list or -1 for the root
+    @details parents are always listed before their children*/
+    std::vector<int> brokerParents;
+    /** the sub-broker each core should connect to or -1 for the root*/
+    std::vector<int> coreAssignments;
+    /** the total load of the cores below each sub-broker*/
+    std::vector<double> brokerLoads;
+    int levels{0};  //!< the number of sub-broker levels below the root
+};
+
+/** generate a broker tree for an expected number of cores
+@details cores are spread over the lowest level of brokers so the total load on each broker is
+balanced and no broker has more than maxFanout connections.  Additional levels are added until the
+root has no more than maxFanout children
+@param coreCount the number of cores expected to connect
+@param maxFanout the maximum number of cores or brokers connected to any single broker
+@param coreLoads the relative load of each core such as an observed message rate or the number of
+federates, if empty or short the remaining cores are given a load of 1
+@return a plan with no sub-brokers if the root can handle all the cores directly
+*/
+BrokerTreePlan generateBrokerTreePlan(int coreCount,
+                                      int maxFanout,
+                                      const std::vector<double>& coreLoads = {});
+
+/** generate a JSON description of a broker tree
+@param plan the plan used to generate the tree
+@param rootName the identifier of the root broker
+@param rootAddress the network address of the root broker
+@param brokerNames the identifiers of the sub-brokers in the same order as the plan
+@param brokerAddresses the addresses of the sub-brokers in the same order as the plan
+*/
+std::string generateBrokerTreeJson(const BrokerTreePlan& plan,
+                                   const std::string& rootName,
+                                   const std::string& rootAddress,
+                                   const std::vector<std::string>& brokerNames,
+                                   const std::vector<std::string>& brokerAddresses);
+}  // namespace helics
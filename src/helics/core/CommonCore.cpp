@@ -7,6 +7,7 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "CommonCore.hpp"
 
 #include "../common/JsonProcessingFunctions.hpp"
+#include "../common/ThreadAffinity.hpp"
 #include "../common/fmt_format.h"
 #include "../common/logger.h"
 #include "ActionMessage.hpp"
@@ -17,6 +18,7 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "FederateState.hpp"
 #include "FilterCoordinator.hpp"
 #include "FilterInfo.hpp"
+#include "FlightRecorder.hpp"
 #include "ForwardingTimeCoordinator.hpp"
 #include "InputInfo.hpp"
 #include "PublicationInfo.hpp"
@@ -25,6 +27,7 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "coreTypeOperations.hpp"
 #include "fileConnections.hpp"
 #include "gmlc/concurrency/DelayedObjects.hpp"
+#include "helicsCLI11.hpp"
 #include "helicsVersion.hpp"
 #include "helics_definitions.hpp"
 #include "loggingHelper.hpp"
@@ -37,6 +40,7 @@ SPDX-License-Identifier: BSD-3-Clause
 #include <functional>
 #include <map>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
@@ -258,7 +262,12 @@ void CommonCore::unregister()
 }
 CommonCore::~CommonCore()
 {
+    stopCallbackThreads();
     joinAllThreads();
+    // records can refer to handle keys which are destroyed before the logger
+    if (binaryLogger) {
+        binaryLogger->flush();
+    }
 }
 
 FederateState* CommonCore::getFederateAt(local_federate_id federateID) const
@@ -520,6 +529,79 @@ void CommonCore::enterInitializingMode(local_federate_id federateID)
     throw(InvalidFunctionCall("federate already has requested entry to initializing State"));
 }
 
+void CommonCore::setFederateOperator(local_federate_id federateID,
+                                     std::shared_ptr<FederateOperator> callbacks)
+{
+    auto* fed = getFederateAt(federateID);
+    if (fed == nullptr) {
+        throw(InvalidIdentifier("federateID not valid for setFederateOperator"));
+    }
+    if (!callbacks) {
+        throw(InvalidParameter("federate operator must be valid"));
+    }
+    if (fed->getState() != HELICS_CREATED) {
+        throw(InvalidFunctionCall("federate operator may only be set in the created state"));
+    }
+    bool exp = false;
+    if (!fed->init_requested.compare_exchange_strong(exp, true)) {
+        throw(
+            InvalidFunctionCall("federate already has requested entry to initializing State"));
+    }
+    startCallbackThreads();
+    fed->setCallbackOperator(std::move(callbacks));
+    ActionMessage m(CMD_INIT);
+    m.source_id = fed->global_id.load();
+    addActionMessage(m);
+}
+
+FederateState* CommonCore::getDirectValueFederate(global_federate_id fedID)
+{
+    // the message capture and dump log record the values processed by the core thread
+    if (noDirectValues || isRecordingMessages()) {
+        return nullptr;
+    }
+    auto feds = directFederates.lock_shared();
+    auto fnd = feds->find(fedID);
+    return (fnd != feds->end()) ? fnd->second : nullptr;
+}
+
+void CommonCore::scheduleCallbackFederate(FederateState* fed)
+{
+    callbackQueue.push(fed);
+}
+
+void CommonCore::startCallbackThreads()
+{
+    std::lock_guard<std::mutex> tlock(callbackThreadLock);
+    if (!callbackThreads.empty()) {
+        return;
+    }
+    for (int ii = 0; ii < std::max(callbackThreadCount, 1); ++ii) {
+        callbackThreads.emplace_back([this]() {
+            setThreadAffinity(callbackCpus);
+            while (true) {
+                auto* fed = callbackQueue.pop();
+                if (fed == nullptr) {
+                    return;
+                }
+                fed->callbackProcessing();
+            }
+        });
+    }
+}
+
+void CommonCore::stopCallbackThreads()
+{
+    std::lock_guard<std::mutex> tlock(callbackThreadLock);
+    for (std::size_t ii = 0; ii < callbackThreads.size(); ++ii) {
+        callbackQueue.push(nullptr);
+    }
+    for (auto& thread : callbackThreads) {
+        thread.join();
+    }
+    callbackThreads.clear();
+}
+
 iteration_result CommonCore::enterExecutingMode(local_federate_id federateID,
                                                 iteration_request iterate)
 {
@@ -556,24 +638,42 @@ local_federate_id CommonCore::registerFederate(const std::string& name,
     if (brokerState >= broker_state_t::operating) {
         throw(RegistrationFailure("Core has already moved to operating state"));
     }
+    auto* fed = createFederateState(name, info);
+    if (fed == nullptr) {
+        throw(RegistrationFailure("duplicate names " + name +
+                                  "detected multiple federates with the same name"));
+    }
+    auto local_id = fed->local_id;
+
+    ActionMessage m(CMD_REG_FED);
+    m.name = name;
+    addActionMessage(m);
+    // now wait for the federateQueue to get the response
+    auto valid = fed->waitSetup();
+    if (valid == iteration_result::next_step) {
+        return local_id;
+    }
+    throw(RegistrationFailure(std::string("fed received Failure ") + fed->lastErrorString()));
+}
+
+FederateState* CommonCore::createFederateState(const std::string& name,
+                                               const CoreFederateInfo& info)
+{
     FederateState* fed = nullptr;
     local_federate_id local_id;
     {
         auto feds = federates.lock();
         auto id = feds->insert(name, name, info);
-        if (id) {
-            local_id = local_federate_id(static_cast<int32_t>(*id));
-            fed = (*feds)[*id];
-        } else {
-            throw(RegistrationFailure("duplicate names " + name +
-                                      "detected multiple federates with the same name"));
+        if (!id) {
+            return nullptr;
         }
+        local_id = local_federate_id(static_cast<int32_t>(*id));
+        fed = (*feds)[*id];
     }
     if (fed == nullptr) {
         throw(RegistrationFailure("unknown allocation error occurred"));
     }
     // setting up the Logger
-    // auto ptr = fed.get();
     // if we are using the Logger, log all messages coming from the federates so they can control
     // the level*/
     fed->setLogger([this](int /*level*/, const std::string& ident, const std::string& message) {
@@ -582,16 +682,56 @@ local_federate_id CommonCore::registerFederate(const std::string& name,
 
     fed->local_id = local_id;
     fed->setParent(this);
+    fed->setBinaryLogger(binaryLogger.get());
+    return fed;
+}
 
-    ActionMessage m(CMD_REG_FED);
-    m.name = name;
-    addActionMessage(m);
-    // now wait for the federateQueue to get the response
-    auto valid = fed->waitSetup();
-    if (valid == iteration_result::next_step) {
-        return local_id;
+void CommonCore::createReplayRecord(const ActionMessage& command)
+{
+    switch (command.action()) {
+        case CMD_REG_FED:
+            // a duplicate name is left for the loop to reject as in a live run
+            createFederateState(command.name, CoreFederateInfo{});
+            break;
+        case CMD_REG_INPUT:
+        case CMD_REG_ENDPOINT:
+        case CMD_REG_PUB:
+        case CMD_REG_FILTER: {
+            // only the local registrations carry a handle made by the application API
+            if (command.dest_id != parent_broker_id) {
+                break;
+            }
+            handle_type type{handle_type::unknown};
+            switch (command.action()) {
+                case CMD_REG_INPUT:
+                    type = handle_type::input;
+                    break;
+                case CMD_REG_ENDPOINT:
+                    type = handle_type::endpoint;
+                    break;
+                case CMD_REG_PUB:
+                    type = handle_type::publication;
+                    break;
+                default:
+                    type = handle_type::filter;
+                    break;
+            }
+            auto* fed = getFederateCore(command.source_id);
+            BasicHandleInfo info(command.source_id,
+                                 command.source_handle,
+                                 type,
+                                 command.name,
+                                 command.getString(typeStringLoc),
+                                 command.getString(unitStringLoc));
+            info.local_fed_id = (fed != nullptr) ? fed->local_id : local_federate_id{};
+            info.flags = command.flags;
+            handles.modify([&info, &command](auto& hand) {
+                hand.addHandleAtIndex(info, command.source_handle.baseValue());
+            });
+        } break;
+        default:
+            break;
     }
-    throw(RegistrationFailure(std::string("fed received Failure ") + fed->lastErrorString()));
 }
 
 const std::string& CommonCore::getFederateName(local_federate_id federateID) const
@@ -1125,6 +1265,31 @@ void CommonCore::removeTarget(interface_handle handle, const std::string& target
 }
 
 void CommonCore::addDestinationTarget(interface_handle handle, const std::string& dest)
+{
+    addActionMessage(generateDestinationTarget(handle, dest));
+}
+
+void CommonCore::addDestinationTargetPattern(interface_handle handle, const std::string& pattern)
+{
+    auto cmd = generateDestinationTarget(handle, pattern);
+    setActionFlag(cmd, pattern_target_flag);
+    addActionMessage(std::move(cmd));
+}
+
+void CommonCore::addSourceTarget(interface_handle handle, const std::string& targetName)
+{
+    addActionMessage(generateSourceTarget(handle, targetName));
+}
+
+void CommonCore::addSourceTargetPattern(interface_handle handle, const std::string& pattern)
+{
+    auto cmd = generateSourceTarget(handle, pattern);
+    setActionFlag(cmd, pattern_target_flag);
+    addActionMessage(std::move(cmd));
+}
+
+ActionMessage CommonCore::generateDestinationTarget(interface_handle handle,
+                                                    const std::string& dest)
 {
     const auto* handleInfo = getHandleInfo(handle);
     if (handleInfo == nullptr) {
@@ -1160,11 +1325,11 @@ void CommonCore::addDestinationTarget(interface_handle handle, const std::string
         default:
             throw(InvalidIdentifier("inputs cannot have destination targets"));
     }
-
-    addActionMessage(std::move(cmd));
+    return cmd;
 }
 
-void CommonCore::addSourceTarget(interface_handle handle, const std::string& targetName)
+ActionMessage CommonCore::generateSourceTarget(interface_handle handle,
+                                               const std::string& targetName)
 {
     const auto* handleInfo = getHandleInfo(handle);
     if (handleInfo == nullptr) {
@@ -1196,7 +1361,7 @@ void CommonCore::addSourceTarget(interface_handle handle, const std::string& tar
         default:
             throw(InvalidIdentifier("publications cannot have source targets"));
     }
-    addActionMessage(std::move(cmd));
+    return cmd;
 }
 
 void CommonCore::setValue(interface_handle handle, const char* data, uint64_t len)
@@ -1216,14 +1381,48 @@ void CommonCore::setValue(interface_handle handle, const char* data, uint64_t le
     }
     auto* fed = getFederateAt(handleInfo->local_fed_id);
     if (fed->checkAndSetValue(handle, data, len)) {
-        LOG_DATA_MESSAGES(parent_broker_id,
-                          fed->getIdentifier(),
-                          fmt::format("setting Value for {} size {}", handleInfo->key, len));
+        LOG_DATA_MESSAGES_DEFERRED(parent_broker_id,
+                                   fed->getIdentifier(),
+                                   "setting Value for {} size {}",
+                                   // handle keys are never modified or removed while the core
+                                   // exists so the text is still valid when the record is written
+                                   handleInfo->key.c_str(),
+                                   len);
 
         auto subs = fed->getSubscribers(handle);
         if (subs.empty()) {
             return;
         }
+        // inputs in the same core get a shared copy of the data and a notification with no payload
+        std::shared_ptr<const data_block> directValue;
+        auto remoteEnd = subs.begin();
+        for (const auto& sub : subs) {
+            auto* target = getDirectValueFederate(sub.fed_id);
+            if (target == nullptr) {
+                *remoteEnd++ = sub;
+                continue;
+            }
+            if (!directValue) {
+                directValue = std::make_shared<const data_block>(data, len);
+            }
+            ActionMessage mv(CMD_PUB);
+            mv.source_id = handleInfo->getFederateId();
+            mv.source_handle = handle;
+            mv.setDestination(sub);
+            mv.counter = static_cast<uint16_t>(fed->getCurrentIteration());
+            mv.actionTime = fed->nextAllowedSendTime();
+            setActionFlag(mv, direct_value_flag);
+            mv.messageID = target->addDirectValue(directValue);
+            if (mv.messageID < 0) {
+                // the target has finished so the value would be dropped anyway
+                continue;
+            }
+            target->addAction(std::move(mv));
+        }
+        subs.erase(remoteEnd, subs.end());
+        if (subs.empty()) {
+            return;
+        }
         if (subs.size() == 1) {
             ActionMessage mv(CMD_PUB);
             mv.source_id = handleInfo->getFederateId();
@@ -1883,6 +2082,31 @@ void CommonCore::setFilterOperator(interface_handle filter,
     actionQueue.push(filtOpUpdate);
 }
 
+std::shared_ptr<helicsCLI11App> CommonCore::generateCLI()
+{
+    auto app = BrokerBase::generateCLI();
+    app->add_option("--callback_threads",
+                    callbackThreadCount,
+                    "the number of threads used to execute callback based federates (default 1)")
+        ->check(CLI::PositiveNumber);
+    app->add_option_function<std::string>(
+        "--callback_cpus",
+        [this](const std::string& cpus) {
+            try {
+                callbackCpus = parseCpuList(cpus);
+            }
+            catch (const std::invalid_argument& ia) {
+                throw(CLI::ValidationError(ia.what()));
+            }
+        },
+        "the cpus to run the callback threads on as a list of numbers and ranges such as \"0-3\"");
+    app->add_flag("--no_direct_values",
+                  noDirectValues,
+                  "specify that values published to inputs in the same core are routed through the "
+                  "core thread instead of being delivered directly to the input federate");
+    return app;
+}
+
 FilterCoordinator* CommonCore::getFilterCoordinator(interface_handle handle)
 {
     auto fnd = filterCoord.find(handle);
@@ -1915,12 +2139,15 @@ enum subqueries : std::uint16_t {
     current_time_map = 2,
     dependency_graph = 3,
     data_flow_graph = 4,
+    iteration_map = 6,
+    watched_query = 7,  // the answer for a query subscription held by the core
 };
 
 static const std::map<std::string, std::pair<std::uint16_t, bool>> mapIndex{
     {"global_time", {current_time_map, true}},
     {"dependency_graph", {dependency_graph, false}},
     {"data_flow_graph", {data_flow_graph, false}},
+    {"global_iterations", {iteration_map, true}},
 };
 
 void CommonCore::setQueryCallback(local_federate_id federateID,
@@ -2037,7 +2264,7 @@ std::string CommonCore::quickCoreQueries(const std::string& queryStr) const
 {
     if ((queryStr == "queries") || (queryStr == "available_queries")) {
         return "[isinit;isconnected;exists;name;identifier;address;queries;address;federates;inputs;endpoints;filtered_endpoints;"
-               "publications;filters;version;version_all;federate_map;dependency_graph;data_flow_graph;dependencies;dependson;dependents;current_time;global_time;current_state]";
+               "publications;filters;version;version_all;federate_map;dependency_graph;data_flow_graph;dependencies;dependson;dependents;current_time;global_time;global_iterations;current_state;query_subscriptions;query_watchers;flight_recorder]";
     }
     if (queryStr == "isconnected") {
         return (isConnected()) ? "true" : "false";
@@ -2216,6 +2443,20 @@ std::string CommonCore::coreQuery(const std::string& queryStr) const
         }
         return timeCoord->printTimeStatus();
     }
+    if (queryStr == "query_subscriptions") {
+        return querySubscriptions.generateStatus();
+    }
+    if (queryStr == "query_watchers") {
+        return queryWatchers.generateStatus();
+    }
+    if (queryStr == "flight_recorder") {
+        Json::Value base;
+        base["name"] = getIdentifier();
+        if (flightRecorder) {
+            flightRecorder->generateRecords(base);
+        }
+        return generateJsonString(base);
+    }
     if (queryStr == "version_all") {
         Json::Value base;
         loadBasicJsonInfo(base, [](Json::Value& /*val*/, const FedInfo& /*fed*/) {});
@@ -2356,6 +2597,42 @@ std::string CommonCore::query(const std::string& target, const std::string& quer
     return ret;
 }
 
+int32_t CommonCore::subscribeQuery(const std::string& target,
+                                   const std::string& queryStr,
+                                   std::function<void(const std::string&)> callback,
+                                   std::chrono::milliseconds period,
+                                   bool everyPeriod)
+{
+    if (!callback) {
+        throw(InvalidParameter("query subscriptions require a callback"));
+    }
+    QuerySubscription subscription;
+    subscription.target = target;
+    subscription.query = queryStr;
+    subscription.callback = std::move(callback);
+    subscription.period = period;
+    subscription.everyPeriod = everyPeriod;
+
+    auto index = ++queryCounter;
+    ActionMessage subscribe(CMD_CORE_CONFIGURE);
+    subscribe.messageID = UPDATE_QUERY_SUBSCRIPTION;
+    subscribe.setExtraData(index);
+    auto ii = getNextAirlockIndex();
+    dataAirlocks[ii].load(std::move(subscription));
+    subscribe.counter = ii;
+    addActionMessage(std::move(subscribe));
+    return index;
+}
+
+void CommonCore::unsubscribeQuery(int32_t subscriptionId)
+{
+    ActionMessage unsubscribe(CMD_CORE_CONFIGURE);
+    unsubscribe.messageID = UPDATE_QUERY_SUBSCRIPTION;
+    unsubscribe.setExtraData(subscriptionId);
+    setActionFlag(unsubscribe, empty_flag);
+    addActionMessage(std::move(unsubscribe));
+}
+
 void CommonCore::setGlobal(const std::string& valueName, const std::string& value)
 {
     ActionMessage querycmd(CMD_SET_GLOBAL);
@@ -2369,11 +2646,13 @@ void CommonCore::setGlobal(const std::string& valueName, const std::string& valu
 void CommonCore::processPriorityCommand(ActionMessage&& command)
 {
     // deal with a few types of message immediately
-    LOG_TRACE(global_broker_id_local,
-              getIdentifier(),
-              fmt::format("|| priority_cmd:{} from {}",
-                          prettyPrintString(command),
-                          command.source_id.baseValue()));
+    LOG_TRACE_DEFERRED_COMMAND(global_broker_id_local,
+                               getIdentifier(),
+                               "|| priority_cmd:{} from {}",
+                               command,
+                               command.source_id.baseValue());
+    checkQueryCache(command);
+    checkQueryWatchers(command);
     switch (command.action()) {
         case CMD_PING_PRIORITY:
             if (command.dest_id == global_broker_id_local) {
@@ -2468,6 +2747,7 @@ void CommonCore::processPriorityCommand(ActionMessage&& command)
                 } else {
                     fed->global_id = command.dest_id;
                     loopFederates.addSearchTerm(command.dest_id, command.name);
+                    directFederates.lock()->emplace(command.dest_id, fed);
                 }
 
                 // push the command to the local queue
@@ -2484,11 +2764,22 @@ void CommonCore::processPriorityCommand(ActionMessage&& command)
             break;
         case CMD_BROKER_QUERY:
             if (command.dest_id == global_broker_id_local || command.dest_id == direct_core_id) {
+                if (command.counter != general_query && command.source_id == higher_broker_id) {
+                    // the parent caches the sub-result so it needs to hear about later changes
+                    parentHasQueryResults = true;
+                    if (checkActionFlag(command, query_subscription_flag)) {
+                        parentWatchesState = true;
+                        watchLocalFederates();
+                    }
+                } else if (checkActionFlag(command, query_subscription_flag)) {
+                    watchLocalFederates();
+                    processQueryWatcher(queryWatchers.addWatcher(command, global_federate_id{}));
+                    break;
+                }
                 std::string repStr = coreQuery(command.payload);
                 if (repStr != "#wait") {
                     if (command.source_id == direct_core_id) {
-                        // TODO(PT) make setDelayedValue have a move method
-                        activeQueries.setDelayedValue(command.messageID, repStr);
+                        setQueryResult(command.messageID, repStr);
                     } else {
                         ActionMessage queryResp(CMD_QUERY_REPLY);
                         queryResp.dest_id = command.source_id;
@@ -2542,10 +2833,21 @@ void CommonCore::processPriorityCommand(ActionMessage&& command)
                 queryResp.counter = command.counter;
                 const std::string& target = command.getString(targetStringLoc);
                 if (target == getIdentifier()) {
+                    if (checkActionFlag(command, query_subscription_flag)) {
+                        watchLocalFederates();
+                        processQueryWatcher(
+                            queryWatchers.addWatcher(command, global_federate_id{}));
+                        break;
+                    }
                     queryResp.source_id = global_broker_id_local;
                     repStr = coreQuery(command.payload);
                 } else {
                     auto* fedptr = getFederateCore(target);
+                    if (fedptr != nullptr && checkActionFlag(command, query_subscription_flag)) {
+                        fedptr->setQueryWatched(true);
+                        processQueryWatcher(queryWatchers.addWatcher(command, fedptr->global_id));
+                        break;
+                    }
                     repStr = federateQuery(fedptr, command.payload);
                     if (repStr == "#wait") {
                         if (fedptr != nullptr) {
@@ -2569,6 +2871,16 @@ void CommonCore::processPriorityCommand(ActionMessage&& command)
                 transmit(getRoute(command.dest_id), command);
             }
             break;
+        case CMD_QUERY_UPDATE:
+            // a watched federate changed state which was handled in checkQueryWatchers
+            break;
+        case CMD_QUERY_UNSUBSCRIBE:
+            if (command.dest_id == global_broker_id_local) {
+                queryWatchers.removeWatcher(command.source_id, command.messageID);
+            } else {
+                transmit(getRoute(command.dest_id), command);
+            }
+            break;
         case CMD_PRIORITY_ACK:
         case CMD_ROUTE_ACK:
             break;
@@ -2612,7 +2924,7 @@ void CommonCore::errorRespondDelayedMessages(const std::string& estring)
         if ((*msg).action() == CMD_QUERY ||
             (*msg).action() == CMD_BROKER_QUERY) {  // deal with in flight queries that will block
                                                     // unless a response is given
-            activeQueries.setDelayedValue((*msg).messageID, std::string("#error:") + estring);
+            setQueryResult((*msg).messageID, std::string("#error:") + estring);
         }
         // else other message which might get into here shouldn't need any action, just drop them
         msg = delayTransmitQueue.pop();
@@ -2662,11 +2974,14 @@ void CommonCore::transmitDelayedMessages(global_federate_id source)
 
 void CommonCore::processCommand(ActionMessage&& command)
 {
-    LOG_TRACE(global_broker_id_local,
-              getIdentifier(),
-              fmt::format("|| cmd:{} from {}",
-                          prettyPrintString(command),
-                          command.source_id.baseValue()));
+    LOG_TRACE_DEFERRED_COMMAND(global_broker_id_local,
+                               getIdentifier(),
+                               "|| cmd:{} from {} to {}",
+                               command,
+                               command.source_id.baseValue(),
+                               command.dest_id.baseValue());
+    checkQueryCache(command);
+    checkQueryWatchers(command);
     switch (command.action()) {
         case CMD_IGNORE:
             break;
@@ -2675,6 +2990,19 @@ void CommonCore::processCommand(ActionMessage&& command)
                 timeoutMon->tick(this);
                 LOG_SUMMARY(global_broker_id_local, getIdentifier(), " core tick");
             }
+            for (auto index : querySubscriptions.getTickUpdates()) {
+                processQuerySubscription(index);
+            }
+            for (auto index : queryWatchers.getTickUpdates()) {
+                processQueryWatcher(index);
+            }
+            break;
+        case CMD_QUERY_SUBSCRIPTION:
+            if (checkActionFlag(command, indicator_flag)) {
+                processQueryWatcher(command.messageID);
+            } else {
+                processQuerySubscription(command.messageID);
+            }
             break;
         case CMD_PING:
         case CMD_BROKER_PING:  // broker ping for core is the same as core
@@ -2760,6 +3088,8 @@ void CommonCore::processCommand(ActionMessage&& command)
                 }
             }
             activeQueries.fulfillAllPromises("#disconnected");
+            querySubscriptions.clear();
+            queryWatchers.clear();
             break;
 
         case CMD_EXEC_GRANT:
@@ -2866,6 +3196,8 @@ void CommonCore::processCommand(ActionMessage&& command)
         case CMD_REMOVE_DEPENDENT:
         case CMD_ADD_INTERDEPENDENCY:
         case CMD_REMOVE_INTERDEPENDENCY:
+        case CMD_TIME_COUPLING_PROBE:
+        case CMD_TIME_COUPLING_ACK:
             routeMessage(command);
             break;
         case CMD_SEND_FOR_FILTER:
@@ -2928,6 +3260,7 @@ void CommonCore::processCommand(ActionMessage&& command)
                     if (brokerState != broker_state_t::errored) {
                         sendErrorToFederates(command.messageID, command.payload);
                         brokerState = broker_state_t::errored;
+                        dumpFlightRecorder("terminate_on_error");
                     }
                     command.setAction(CMD_GLOBAL_ERROR);
                     command.source_id = global_broker_id_local;
@@ -2940,6 +3273,7 @@ void CommonCore::processCommand(ActionMessage&& command)
                         if (brokerState != broker_state_t::errored) {
                             sendErrorToFederates(command.messageID, command.payload);
                             brokerState = broker_state_t::errored;
+                            dumpFlightRecorder("terminate_on_error");
                         }
                         command.setAction(CMD_GLOBAL_ERROR);
                         command.source_id = global_broker_id_local;
@@ -3015,6 +3349,11 @@ void CommonCore::processCommand(ActionMessage&& command)
         case CMD_ADD_NAMED_PUBLICATION:
         case CMD_ADD_NAMED_INPUT:
         case CMD_ADD_NAMED_FILTER:
+            if (checkActionFlag(command, pattern_target_flag)) {
+                // patterns are matched at the root broker against every interface
+                transmit(parent_route_id, command);
+                break;
+            }
             checkForNamedInterface(command);
             break;
         case CMD_ADD_ENDPOINT:
@@ -3550,7 +3889,15 @@ void CommonCore::processFilterInfo(ActionMessage& command)
 void CommonCore::processQueryResponse(const ActionMessage& m)
 {
     if (m.counter == general_query) {
-        activeQueries.setDelayedValue(m.messageID, m.payload);
+        if (m.messageID < 0) {
+            processSubscriptionResult(m);
+            return;
+        }
+        setQueryResult(m.messageID, m.payload);
+        return;
+    }
+    if (m.counter == watched_query) {
+        sendQueryWatcherResult(m.messageID, m.payload);
         return;
     }
     if (isValidIndex(m.counter, mapBuilders)) {
@@ -3559,8 +3906,9 @@ void CommonCore::processQueryResponse(const ActionMessage& m)
         if (builder.addComponent(m.payload, m.messageID)) {
             auto str = builder.generate();
             for (int ii = 0; ii < static_cast<int>(requestors.size()) - 1; ++ii) {
-                if (requestors[ii].dest_id == global_broker_id_local) {
-                    activeQueries.setDelayedValue(requestors[ii].messageID, str);
+                if (requestors[ii].dest_id == global_broker_id_local ||
+                    requestors[ii].dest_id == direct_core_id) {
+                    setLocalQueryResult(requestors[ii], str);
                 } else {
                     requestors[ii].payload = str;
                     routeMessage(std::move(requestors[ii]));
@@ -3568,8 +3916,7 @@ void CommonCore::processQueryResponse(const ActionMessage& m)
             }
             if (requestors.back().dest_id == global_broker_id_local ||
                 requestors.back().dest_id == direct_core_id) {
-                // TODO(PT) make setDelayedValue have move set function
-                activeQueries.setDelayedValue(requestors.back().messageID, str);
+                setLocalQueryResult(requestors.back(), str);
             } else {
                 requestors.back().payload = std::move(str);
                 routeMessage(std::move(requestors.back()));
@@ -3583,6 +3930,211 @@ void CommonCore::processQueryResponse(const ActionMessage& m)
     }
 }
 
+void CommonCore::setQueryResult(int32_t index, const std::string& result)
+{
+    if (index < 0) {
+        // subscription results use the negative of the subscription index
+        if (!querySubscriptions.processResult(-index, result, global_broker_id_local)) {
+            queryWatchers.removeWatcher(direct_core_id, index);
+        }
+    } else {
+        activeQueries.setDelayedValue(index, result);
+    }
+}
+
+void CommonCore::setLocalQueryResult(const ActionMessage& requestor, const std::string& result)
+{
+    if (requestor.counter == watched_query) {
+        sendQueryWatcherResult(requestor.messageID, result);
+    } else {
+        setQueryResult(requestor.messageID, result);
+    }
+}
+
+bool CommonCore::processSubscriptionResult(const ActionMessage& m)
+{
+    if (querySubscriptions.processResult(-m.messageID, m.payload, m.source_id)) {
+        return true;
+    }
+    // the subscription was removed before the sender knew about it
+    sendQueryUnsubscribe(m.source_id, m.messageID);
+    return false;
+}
+
+void CommonCore::sendQueryUnsubscribe(global_federate_id source, int32_t messageID)
+{
+    if (!source.isValid()) {
+        return;
+    }
+    if (source == global_broker_id_local || source == direct_core_id) {
+        queryWatchers.removeWatcher(direct_core_id, messageID);
+        return;
+    }
+    ActionMessage unsubscribe(CMD_QUERY_UNSUBSCRIBE);
+    unsubscribe.source_id = global_broker_id_local;
+    unsubscribe.dest_id = source;
+    unsubscribe.messageID = messageID;
+    transmit(getRoute(unsubscribe.dest_id), unsubscribe);
+}
+
+void CommonCore::processQuerySubscription(int32_t index)
+{
+    if (brokerState.load() >= broker_state_t::terminating) {
+        querySubscriptions.clear();
+        return;
+    }
+    const auto* subscription = querySubscriptions.startUpdate(index);
+    if (subscription == nullptr) {
+        return;
+    }
+    // the subscription is registered with the target which sends any changes in the result
+    ActionMessage querycmd(CMD_QUERY);
+    querycmd.source_id = direct_core_id;
+    querycmd.messageID = -index;
+    querycmd.payload = subscription->query;
+    querycmd.setExtraData(static_cast<int32_t>(
+        (std::min)(subscription->period.count(), std::chrono::milliseconds::rep{0x7FFFFFFF})));
+    setActionFlag(querycmd, query_subscription_flag);
+    if (subscription->everyPeriod) {
+        setActionFlag(querycmd, indicator_flag);
+    }
+    const auto& target = subscription->target;
+    if (target == "core" || target == getIdentifier() || target.empty()) {
+        querycmd.setAction(CMD_BROKER_QUERY);
+        querycmd.dest_id = direct_core_id;
+        processPriorityCommand(std::move(querycmd));
+        return;
+    }
+    auto* fed = (target != "federate") ? getFederate(target) : getFederateAt(local_federate_id(0));
+    if (fed != nullptr) {
+        querycmd.dest_id = direct_core_id;
+        querycmd.setStringData(fed->getIdentifier());
+    } else {
+        querycmd.dest_id = parent_broker_id;
+        querycmd.setStringData(target);
+    }
+    processPriorityCommand(std::move(querycmd));
+}
+
+void CommonCore::processQueryWatcher(int32_t index)
+{
+    if (brokerState.load() >= broker_state_t::terminating) {
+        queryWatchers.clear();
+        return;
+    }
+    const auto* watcher = queryWatchers.startUpdate(index);
+    if (watcher == nullptr) {
+        return;
+    }
+    std::string result;
+    if (!watcher->target.isValid()) {
+        result = coreQuery(watcher->query);
+        if (result == "#wait") {
+            // the result is delivered to the watcher when the map is complete
+            ActionMessage queryResp(CMD_QUERY_REPLY);
+            queryResp.dest_id = global_broker_id_local;
+            queryResp.source_id = global_broker_id_local;
+            queryResp.messageID = index;
+            queryResp.counter = watched_query;
+            std::get<1>(mapBuilders[mapIndex.at(watcher->query).first]).push_back(queryResp);
+            return;
+        }
+    } else {
+        auto* fed = getFederateCore(watcher->target);
+        result = federateQuery(fed, watcher->query);
+        if (result == "#wait" && fed != nullptr) {
+            ActionMessage querycmd(CMD_QUERY);
+            querycmd.source_id = global_broker_id_local;
+            querycmd.dest_id = fed->global_id;
+            querycmd.messageID = index;
+            querycmd.counter = watched_query;
+            querycmd.payload = watcher->query;
+            fed->addAction(std::move(querycmd));
+            return;
+        }
+    }
+    sendQueryWatcherResult(index, result);
+}
+
+void CommonCore::sendQueryWatcherResult(int32_t index, const std::string& result)
+{
+    const auto* watcher = queryWatchers.updateResult(index, result);
+    if (watcher == nullptr) {
+        return;
+    }
+    if (watcher->subscriber == global_broker_id_local || watcher->subscriber == direct_core_id) {
+        setQueryResult(watcher->messageID, result);
+        return;
+    }
+    ActionMessage queryResp(CMD_QUERY_REPLY);
+    queryResp.dest_id = watcher->subscriber;
+    queryResp.source_id = global_broker_id_local;
+    queryResp.messageID = watcher->messageID;
+    queryResp.payload = result;
+    transmit(getRoute(queryResp.dest_id), queryResp);
+}
+
+void CommonCore::checkQueryCache(const ActionMessage& command)
+{
+    if (!isStructureCommand(command)) {
+        return;
+    }
+    for (auto& mb : mapBuilders) {
+        auto& builder = std::get<0>(mb);
+        if (std::get<2>(mb)) {
+            continue;
+        }
+        if (builder.isCompleted()) {
+            builder.reset();
+        } else if (builder.isActive()) {
+            // drop the result once the request in progress completes
+            std::get<2>(mb) = true;
+        }
+    }
+    if (parentHasQueryResults && global_broker_id_local.isValid() &&
+        global_broker_id_local != parent_broker_id) {
+        // only one notice is needed until the parent asks for new results
+        parentHasQueryResults = false;
+        ActionMessage update(CMD_QUERY_UPDATE);
+        update.source_id = global_broker_id_local;
+        update.dest_id = higher_broker_id;
+        transmit(parent_route_id, update);
+    }
+}
+
+void CommonCore::checkQueryWatchers(const ActionMessage& command)
+{
+    if (!isTimingCommand(command) && !isStructureCommand(command) &&
+        command.action() != CMD_QUERY_UPDATE && command.action() != CMD_INIT_GRANT) {
+        return;
+    }
+    if (parentWatchesState && global_broker_id_local.isValid() &&
+        global_broker_id_local != parent_broker_id) {
+        // the parent asks again for the results so one notice is enough
+        parentWatchesState = false;
+        ActionMessage update(CMD_QUERY_UPDATE);
+        setActionFlag(update, indicator_flag);
+        update.source_id = global_broker_id_local;
+        update.dest_id = higher_broker_id;
+        transmit(parent_route_id, update);
+    }
+    if (queryWatchers.empty()) {
+        return;
+    }
+    queryWatchers.stateChanged(global_federate_id{});
+    queryWatchers.stateChanged(command.source_id);
+    if (command.dest_id != command.source_id) {
+        queryWatchers.stateChanged(command.dest_id);
+    }
+}
+
+void CommonCore::watchLocalFederates()
+{
+    for (auto& fed : loopFederates) {
+        fed.fed->setQueryWatched(true);
+    }
+}
+
 void CommonCore::checkDependencies()
 {
     bool isobs = false;
@@ -3795,6 +4347,19 @@ void CommonCore::processCoreConfigureCommands(ActionMessage& cmd)
                 }
             }
             break;
+        case UPDATE_QUERY_SUBSCRIPTION:
+            if (checkActionFlag(cmd, empty_flag)) {
+                sendQueryUnsubscribe(querySubscriptions.removeSubscription(cmd.getExtraData()),
+                                     -cmd.getExtraData());
+            } else {
+                auto op = dataAirlocks[cmd.counter].try_unload();
+                if (op) {
+                    querySubscriptions.addSubscription(
+                        cmd.getExtraData(), stx::any_cast<QuerySubscription>(std::move(*op)));
+                    processQuerySubscription(cmd.getExtraData());
+                }
+            }
+            break;
         case UPDATE_FILTER_OPERATOR: {
             auto* FiltI = filters.find(global_handle(global_broker_id_local, cmd.source_handle));
             int ii = cmd.counter;
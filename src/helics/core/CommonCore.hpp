@@ -12,9 +12,11 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "BrokerBase.hpp"
 #include "Core.hpp"
 #include "HandleManager.hpp"
+#include "QuerySubscriptions.hpp"
 #include "gmlc/concurrency/DelayedObjects.hpp"
 #include "gmlc/concurrency/TriggerVariable.hpp"
 #include "gmlc/containers/AirLock.hpp"
+#include "gmlc/containers/BlockingQueue.hpp"
 #include "gmlc/containers/DualMappedPointerVector.hpp"
 #include "gmlc/containers/DualMappedVector.hpp"
 #include "gmlc/containers/MappedPointerVector.hpp"
@@ -28,10 +30,13 @@ SPDX-License-Identifier: BSD-3-Clause
 #include <atomic>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace helics {
@@ -146,6 +151,10 @@ class CommonCore: public Core, public BrokerBase {
     virtual void addDestinationTarget(interface_handle handle,
                                       const std::string& dest) override final;
     virtual void addSourceTarget(interface_handle handle, const std::string& name) override final;
+    virtual void addDestinationTargetPattern(interface_handle handle,
+                                             const std::string& pattern) override final;
+    virtual void addSourceTargetPattern(interface_handle handle,
+                                        const std::string& pattern) override final;
     virtual const std::string& getInjectionUnits(interface_handle handle) const override final;
     virtual const std::string& getExtractionUnits(interface_handle handle) const override final;
     virtual const std::string& getInjectionType(interface_handle handle) const override final;
@@ -200,6 +209,10 @@ class CommonCore: public Core, public BrokerBase {
                             const std::string& messageToLog) override final;
     virtual void setFilterOperator(interface_handle filter,
                                    std::shared_ptr<FilterOperator> callback) override final;
+    virtual void setFederateOperator(local_federate_id federateID,
+                                     std::shared_ptr<FederateOperator> callbacks) override final;
+    /** queue a callback based federate for processing on the callback thread pool*/
+    void scheduleCallbackFederate(FederateState* fed);
 
     /** set the local identification for the core*/
     void setIdentifier(const std::string& name);
@@ -217,6 +230,12 @@ class CommonCore: public Core, public BrokerBase {
     virtual void setLogFile(const std::string& lfile) override final;
 
     virtual std::string query(const std::string& target, const std::string& queryStr) override;
+    virtual int32_t subscribeQuery(const std::string& target,
+                                   const std::string& queryStr,
+                                   std::function<void(const std::string&)> callback,
+                                   std::chrono::milliseconds period,
+                                   bool everyPeriod = false) override final;
+    virtual void unsubscribeQuery(int32_t subscriptionId) override final;
     virtual void
         setQueryCallback(local_federate_id federateID,
                          std::function<std::string(const std::string&)> queryFunction) override;
@@ -231,6 +250,12 @@ class CommonCore: public Core, public BrokerBase {
     /**TODO(PT): figure out how to make this non-public, it needs to be called in a lambda function,
      * may need a helper class of some sort*/
     virtual void processDisconnect(bool skipUnregister = false) override final;
+    /** create the federate or interface record the application API makes before queuing a
+    registration message
+    @details this is intended for replaying captured message streams into a core with the processing
+    thread disabled, where no live federates exist to make the records, it should be called just
+    before the captured message is processed*/
+    void createReplayRecord(const ActionMessage& command);
 
     virtual void setInterfaceInfo(interface_handle handle, std::string info) override final;
     virtual const std::string& getInterfaceInfo(interface_handle handle) const override final;
@@ -246,6 +271,8 @@ class CommonCore: public Core, public BrokerBase {
   protected:
     virtual void processCommand(ActionMessage&& command) override final;
 
+    virtual std::shared_ptr<helicsCLI11App> generateCLI() override;
+
     virtual void processPriorityCommand(ActionMessage&& command) override final;
 
     /** transit an ActionMessage to another core or broker
@@ -288,6 +315,9 @@ class CommonCore: public Core, public BrokerBase {
     operation_state minFederateState() const;
 
   private:
+    /** create a new federate object and attach it to the core
+    @return nullptr if a federate with the given name already exists*/
+    FederateState* createFederateState(const std::string& name, const CoreFederateInfo& info);
     /** get the federate Information from the federateID*/
     FederateState* getFederateCore(global_federate_id federateID);
     /** get the federate Information from the federateID*/
@@ -349,6 +379,21 @@ class CommonCore: public Core, public BrokerBase {
     void checkDependencies();
     /** deal with a query response addressed to this core*/
     void processQueryResponse(const ActionMessage& m);
+    /** deliver the result of a query to a waiting local request or a query subscription*/
+    void setQueryResult(int32_t index, const std::string& result);
+    /** register a query subscription with the core, broker, or federate answering it*/
+    void processQuerySubscription(int32_t index);
+    /** deliver a query result from a watcher to the query subscription it belongs to
+    @return false if the subscription no longer exists*/
+    bool processSubscriptionResult(const ActionMessage& m);
+    /** remove a query subscription from the core or broker sending its results*/
+    void sendQueryUnsubscribe(global_federate_id source, int32_t messageID);
+    /** answer the query of a query subscription held by this core*/
+    void processQueryWatcher(int32_t index);
+    /** send the result of a query subscription held by this core to the subscriber*/
+    void sendQueryWatcherResult(int32_t index, const std::string& result);
+    /** deliver a completed map query to a local requestor*/
+    void setLocalQueryResult(const ActionMessage& requestor, const std::string& result);
 
     /** handle command with the core itself as a destination at the core*/
     void processCommandsForCore(const ActionMessage& cmd);
@@ -365,6 +410,12 @@ class CommonCore: public Core, public BrokerBase {
         const std::function<void(Json::Value& fedval, const FedInfo& fed)>& fedLoader) const;
     /** generate a mapbuilder for the federates*/
     void initializeMapBuilder(const std::string& request, std::uint16_t index, bool reset) const;
+    /** drop cached query results affected by a command and notify the parent*/
+    void checkQueryCache(const ActionMessage& command);
+    /** notify the query subscriptions held by the core of a change in state*/
+    void checkQueryWatchers(const ActionMessage& command);
+    /** mark the local federates as watched so they report changes in state*/
+    void watchLocalFederates();
     /** generate results for core queries*/
     std::string coreQuery(const std::string& queryStr) const;
 
@@ -404,6 +455,13 @@ class CommonCore: public Core, public BrokerBase {
         activeQueries;  //!< holder for active queries
                         /// holder for the query map builder information
     mutable std::vector<std::tuple<JsonMapBuilder, std::vector<ActionMessage>, bool>> mapBuilders;
+    bool parentHasQueryResults{false};  //!< the parent may have cached query results from us
+    bool parentWatchesState{false};  //!< the parent holds a query subscription using our results
+    /// the query subscriptions made by the core with results pushed to a callback
+    QuerySubscriptions querySubscriptions{
+        [this](ActionMessage&& cmd) { addActionMessage(std::move(cmd)); }};
+    /// the query subscriptions answered by the core
+    QueryWatchers queryWatchers{[this](ActionMessage&& cmd) { addActionMessage(std::move(cmd)); }};
     std::map<interface_handle, std::unique_ptr<FilterCoordinator>>
         filterCoord;  //!< map of all local filters
     // The interface_handle used is here is usually referencing an endpoint
@@ -416,7 +474,24 @@ class CommonCore: public Core, public BrokerBase {
     std::array<gmlc::containers::AirLock<stx::any>, 4>
         dataAirlocks;  //!< airlocks for updating filter operators and other functions
     gmlc::concurrency::TriggerVariable disconnection;  //!< controller for the disconnection process
+    /// callback based federates with pending messages, nullptr stops a worker thread
+    gmlc::containers::BlockingQueue<FederateState*> callbackQueue;
+    std::vector<std::thread> callbackThreads;  //!< the threads executing callback federates
+    std::mutex callbackThreadLock;  //!< lock for starting and stopping the callback threads
+    int callbackThreadCount{1};  //!< the number of threads to execute callback federates
+    std::vector<int> callbackCpus;  //!< the cpus to run the callback threads on, empty for any
+    /// the local federates by global id for delivering values without the core thread
+    ordered_guarded<std::unordered_map<global_federate_id, FederateState*>> directFederates;
+    bool noDirectValues{false};  //!< publish all values through the core thread
+
   private:
+    /** start the callback threads if they are not already running*/
+    void startCallbackThreads();
+    /** stop and join the callback threads*/
+    void stopCallbackThreads();
+    /** get a local federate that can receive values directly from the calling thread
+    @return nullptr if the federate is not local or direct delivery is disabled*/
+    FederateState* getDirectValueFederate(global_federate_id fedID);
     /** wait for the core to be registered with the broker*/
     bool waitCoreRegistration();
     /** deliver a message to the appropriate location*/
@@ -446,6 +521,10 @@ class CommonCore: public Core, public BrokerBase {
     @param command the message to process
     */
     void processFilterInfo(ActionMessage& command);
+    /** generate the command adding a destination target to an interface*/
+    ActionMessage generateDestinationTarget(interface_handle handle, const std::string& dest);
+    /** generate the command adding a source target to an interface*/
+    ActionMessage generateSourceTarget(interface_handle handle, const std::string& targetName);
     /** function to check for a named interface*/
     void checkForNamedInterface(ActionMessage& command);
     /** function to remove a named target*/
@@ -9,6 +9,7 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "core-data.hpp"
 #include "federate_id.hpp"
 
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <string>
@@ -557,6 +558,23 @@ class Core {
     */
     virtual void addSourceTarget(interface_handle handle, const std::string& name) = 0;
 
+    /** add a pattern of destination targets, the handle can be for a filter or a publication
+    @details the pattern is matched at the root broker against the names of all current and future
+    interfaces of the target type, '*' matches any sequence of characters and '?' matches a single
+    character.  Patterns matching no interfaces do not generate errors
+    @param handle an interface to add the targets to
+    @param pattern the pattern of target names
+    */
+    virtual void addDestinationTargetPattern(interface_handle handle,
+                                             const std::string& pattern) = 0;
+
+    /** add a pattern of source targets, the handle can be an input, filter, or endpoint
+    @details the pattern is matched in the same way as addDestinationTargetPattern
+    @param handle the identifier of the interface
+    @param pattern the pattern of target names
+    */
+    virtual void addSourceTargetPattern(interface_handle handle, const std::string& pattern) = 0;
+
     /** get a destination filter Handle from its name or target(this may not be unique so it will
     only find the first one)
     @param name the name of the filter or its target
@@ -689,6 +707,16 @@ class Core {
     virtual void setFilterOperator(interface_handle filter,
                                    std::shared_ptr<FilterOperator> callback) = 0;
 
+    /** set a federate to be driven by the core through a set of callbacks
+    @details the federate requests entry to initializing mode and from then on the core calls the
+    operator from its own thread pool whenever the federate can proceed, so no user thread is
+    blocked for the federate. Must be called in place of enterInitializingMode
+    @param federateID the identifier of the federate
+    @param callbacks the operator executing the federate
+    */
+    virtual void setFederateOperator(local_federate_id federateID,
+                                     std::shared_ptr<FederateOperator> callbacks) = 0;
+
     /** define a logging function to use for logging message and notices from the federation and
     individual federate
     @param federateID  the identifier for the individual federate or 0 for the Core Logger
@@ -722,6 +750,27 @@ class Core {
     return until the query is answered so use with caution
     */
     virtual std::string query(const std::string& target, const std::string& queryStr) = 0;
+    /** subscribe to the results of a query
+    @details the subscription is registered with the federate, core, or broker answering the query,
+    which sends a new result when its state changes and the result differs from the previous one.
+    The callback is executed on the core's processing thread so it should return quickly and must
+    not make blocking calls back into the core
+    @param target the target of the query, as used in query
+    @param queryStr the actual query
+    @param callback the function to call with the query results
+    @param period the minimum time between results
+    @param everyPeriod set to true to call the callback every period even if the result has not
+    changed
+    @return an identifier for the subscription to use in unsubscribeQuery
+    */
+    virtual int32_t subscribeQuery(const std::string& target,
+                                   const std::string& queryStr,
+                                   std::function<void(const std::string&)> callback,
+                                   std::chrono::milliseconds period,
+                                   bool everyPeriod = false) = 0;
+    /** stop a query subscription
+    @details the callback may still be called until the core processes the request*/
+    virtual void unsubscribeQuery(int32_t subscriptionId) = 0;
     /** supply a query callback function
     @details the intention of the query callback is to allow federates to answer particular requests
     through the query interface this allows other federates to make requests or queries of other
@@ -11,6 +11,7 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "../common/fmt_format.h"
 #include "../common/logger.h"
 #include "BrokerFactory.hpp"
+#include "FlightRecorder.hpp"
 #include "ForwardingTimeCoordinator.hpp"
 #include "TimeoutMonitor.h"
 #include "fileConnections.hpp"
@@ -20,6 +21,7 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "loggingHelper.hpp"
 #include "queryHelpers.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <utility>
@@ -205,6 +207,12 @@ route_id CoreBroker::fillMessageRouteInformation(ActionMessage& mess)
     if (fnd2 != knownExternalEndpoints.end()) {
         return fnd2->second;
     }
+    auto owner = interfaceDirectory.findOwner(handle_type::endpoint, endpointName);
+    if (owner.isValid()) {
+        // the owning broker fills in the destination
+        mess.dest_id = owner;
+        return getRoute(owner);
+    }
     return parent_route_id;
 }
 
@@ -218,11 +226,13 @@ bool CoreBroker::isOpenToNewFederates() const
 void CoreBroker::processPriorityCommand(ActionMessage&& command)
 {
     // deal with a few types of message immediately
-    LOG_TRACE(global_broker_id_local,
-              getIdentifier(),
-              fmt::format("|| priority_cmd:{} from {}",
-                          prettyPrintString(command),
-                          command.source_id.baseValue()));
+    LOG_TRACE_DEFERRED_COMMAND(global_broker_id_local,
+                               getIdentifier(),
+                               "|| priority_cmd:{} from {}",
+                               command,
+                               command.source_id.baseValue());
+    checkQueryCache(command);
+    checkQueryWatchers(command);
     switch (command.action()) {
         case CMD_PING_PRIORITY:
             if (command.dest_id == global_broker_id_local) {
@@ -288,6 +298,7 @@ void CoreBroker::processPriorityCommand(ActionMessage&& command)
             if (!isRootc) {
                 if (global_broker_id_local.isValid()) {
                     command.source_id = global_broker_id_local;
+                    markTimeAggregation(command);
                     transmit(parent_route_id, command);
                 } else {
                     // delay the response if we are not fully registered yet
@@ -305,6 +316,15 @@ void CoreBroker::processPriorityCommand(ActionMessage&& command)
                 auto global_fedid = _federates.back().global_id;
 
                 routing_table.emplace(global_fedid, route_id);
+                if (checkActionFlag(command, time_aggregation_flag)) {
+                    auto& aggregators = timeAggregators[global_fedid];
+                    for (const auto& agg : command.getStringData()) {
+                        aggregators.emplace_back(
+                            gmlc::utilities::numeric_conversion<global_federate_id::base_type>(
+                                agg, global_federate_id{}.baseValue()));
+                    }
+                    hasTimeAggregators = true;
+                }
                 // don't bother with the federate_table
                 // transmit the response
                 ActionMessage fedReply(CMD_FED_ACK);
@@ -458,6 +478,11 @@ void CoreBroker::processPriorityCommand(ActionMessage&& command)
                 if (checkActionFlag(command, slow_responding_flag)) {
                     _brokers.back()._disable_ping = true;
                 }
+                if (checkActionFlag(command, interface_directory_flag) && !_brokers.back()._core &&
+                    !_brokers.back()._nonLocal) {
+                    _brokers.back()._interface_directory = true;
+                    hasInterfaceOwners = true;
+                }
                 routing_table.emplace(global_brkid, route);
                 // don't bother with the broker_table for root broker
 
@@ -470,6 +495,12 @@ void CoreBroker::processPriorityCommand(ActionMessage&& command)
                     setActionFlag(brokerReply, slow_responding_flag);
                 }
                 transmit(route, brokerReply);
+                if (_brokers.back()._interface_directory) {
+                    // the new owner matches the standing patterns against its subtree
+                    for (const auto& pattern : targetPatterns) {
+                        forwardTargetPattern(pattern.second, global_brkid);
+                    }
+                }
                 LOG_CONNECTIONS(global_broker_id_local,
                                 getIdentifier(),
                                 fmt::format("registering broker {}({}) on route {}",
@@ -509,6 +540,7 @@ void CoreBroker::processPriorityCommand(ActionMessage&& command)
                 global_id.store(global_broker_id_local);
                 higher_broker_id = command.source_id;
                 timeCoord->source_id = global_broker_id_local;
+                timeCoord->aggregating = aggregateTime;
                 transmitDelayedMessages();
                 _brokers.apply([localid = global_broker_id_local](auto& brk) {
                     if (!brk._nonLocal) {
@@ -582,6 +614,19 @@ void CoreBroker::processPriorityCommand(ActionMessage&& command)
                 transmit(getRoute(command.dest_id), command);
             }
             break;
+        case CMD_QUERY_UPDATE:
+            // a notice only about a change in state does not affect the cached structure
+            if (!checkActionFlag(command, indicator_flag)) {
+                invalidateQueryCache(global_broker_id(command.source_id));
+            }
+            break;
+        case CMD_QUERY_UNSUBSCRIBE:
+            if (command.dest_id == global_broker_id_local) {
+                queryWatchers.removeWatcher(command.source_id, command.messageID);
+            } else {
+                transmit(getRoute(command.dest_id), command);
+            }
+            break;
         case CMD_SET_GLOBAL:
             if (isRootc) {
                 global_values[command.name] = command.getString(0);
@@ -623,6 +668,15 @@ std::string CoreBroker::generateFederationSummary() const
                 break;
         }
     }
+    // the interfaces below an owning sub-broker are only counted in its summary
+    for (const auto& brk : _brokers) {
+        if (brk._interface_directory) {
+            pubs += brk.interfaceCounts[0];
+            ipts += brk.interfaceCounts[1];
+            epts += brk.interfaceCounts[2];
+            filt += brk.interfaceCounts[3];
+        }
+    }
     std::string output = fmt::format(
         "Federation Summary> \n\t{} federates [min {}]\n\t{}/{} brokers/cores [min {}]\n\t{} "
         "publications\n\t{} inputs\n\t{} endpoints\n\t{} filters\n<<<<<<<<<",
@@ -642,11 +696,40 @@ std::string CoreBroker::generateFederationSummary() const
     return output;
 }
 
+std::vector<std::string> CoreBroker::getInterfaceNames(handle_type type) const
+{
+    std::vector<std::string> names;
+    for (const auto& handle : handles) {
+        if (handle.handleType == type) {
+            names.push_back(handle.key);
+        }
+    }
+    return names;
+}
+
+std::string CoreBroker::generateInterfaceList(handle_type type) const
+{
+    return generateStringVector(getInterfaceNames(type),
+                                [](const std::string& name) { return name; });
+}
+
+std::string CoreBroker::generateOwnedInterfaceList(handle_type type, const Json::Value& owned) const
+{
+    auto names = getInterfaceNames(type);
+    for (const auto& ownerNames : owned["brokers"]) {
+        for (const auto& name : ownerNames) {
+            names.push_back(name.asString());
+        }
+    }
+    return generateStringVector(names, [](const std::string& name) { return name; });
+}
+
 void CoreBroker::transmitDelayedMessages()
 {
     auto msg = delayTransmitQueue.pop();
     while (msg) {
         msg->source_id = global_broker_id_local;
+        markTimeAggregation(*msg);
         transmit(parent_route_id, *msg);
         msg = delayTransmitQueue.pop();
     }
@@ -693,12 +776,14 @@ void CoreBroker::sendErrorToImmediateBrokers(int error_code)
 
 void CoreBroker::processCommand(ActionMessage&& command)
 {
-    LOG_TRACE(global_broker_id_local,
-              getIdentifier(),
-              fmt::format("|| cmd:{} from {} to {}",
-                          prettyPrintString(command),
-                          command.source_id.baseValue(),
-                          command.dest_id.baseValue()));
+    LOG_TRACE_DEFERRED_COMMAND(global_broker_id_local,
+                               getIdentifier(),
+                               "|| cmd:{} from {} to {}",
+                               command,
+                               command.source_id.baseValue(),
+                               command.dest_id.baseValue());
+    checkQueryCache(command);
+    checkQueryWatchers(command);
     switch (command.action()) {
         case CMD_IGNORE:
         case CMD_PROTOCOL:
@@ -709,6 +794,19 @@ void CoreBroker::processCommand(ActionMessage&& command)
                 timeoutMon->tick(this);
                 LOG_SUMMARY(global_broker_id_local, getIdentifier(), " broker tick");
             }
+            for (auto index : querySubscriptions.getTickUpdates()) {
+                processQuerySubscription(index);
+            }
+            for (auto index : queryWatchers.getTickUpdates()) {
+                processQueryWatcher(index);
+            }
+            break;
+        case CMD_QUERY_SUBSCRIPTION:
+            if (checkActionFlag(command, indicator_flag)) {
+                processQueryWatcher(command.messageID);
+            } else {
+                processQuerySubscription(command.messageID);
+            }
             break;
         case CMD_PING:
             if (command.dest_id == global_broker_id_local) {
@@ -802,6 +900,10 @@ void CoreBroker::processCommand(ActionMessage&& command)
             auto* brk = getBrokerById(static_cast<global_broker_id>(command.source_id));
             if (brk != nullptr) {
                 brk->state = connection_state::init_requested;
+                if (isRootc && brk->_interface_directory) {
+                    // the owner can now answer for everything registered below it
+                    probeInterfaceOwner(brk->global_id);
+                }
             }
             if (allInitReady()) {
                 if (isRootc) {
@@ -813,6 +915,9 @@ void CoreBroker::processCommand(ActionMessage&& command)
                                getIdentifier(),
                                "entering initialization mode");
                     checkDependencies();
+                    if (ownsSubtreeInterfaces()) {
+                        sendSubtreeLookups();
+                    }
                     command.source_id = global_broker_id_local;
                     transmit(parent_route_id, command);
                 }
@@ -850,6 +955,7 @@ void CoreBroker::processCommand(ActionMessage&& command)
             if (fed != _federates.end()) {
                 if (fed->global_id.isValid()) {
                     ActionMessage dep(CMD_ADD_DEPENDENCY, fed->global_id, command.source_id);
+                    addDirectDependency(dep.source_id, dep.dest_id);
                     routeMessage(dep);
                     dep = ActionMessage(CMD_ADD_DEPENDENT, command.source_id, fed->global_id);
                     routeMessage(dep);
@@ -869,19 +975,22 @@ void CoreBroker::processCommand(ActionMessage&& command)
                 command.name = command.getString(targetStringLoc);
                 command.setAction(CMD_ADD_NAMED_INPUT);
                 command.setSource(pub->handle);
+                command.dest_id = parent_broker_id;
                 checkForNamedInterface(command);
             } else {
                 auto* input = handles.getInput(command.getString(targetStringLoc));
                 if (input == nullptr) {
-                    if (isRootc) {
-                        unknownHandles.addDataLink(command.name,
-                                                   command.getString(targetStringLoc));
-                    } else {
-                        routeMessage(command);
+                    auto owner =
+                        interfaceDirectory.findOwner(handle_type::publication, command.name);
+                    if (!owner.isValid()) {
+                        owner = interfaceDirectory.findOwner(handle_type::input,
+                                                             command.getString(targetStringLoc));
                     }
+                    routeUnknownLink(command, handle_type::publication, owner);
                 } else {
                     command.setAction(CMD_ADD_NAMED_PUBLICATION);
                     command.setSource(input->handle);
+                    command.dest_id = parent_broker_id;
                     checkForNamedInterface(command);
                 }
             }
@@ -895,25 +1004,21 @@ void CoreBroker::processCommand(ActionMessage&& command)
                 if (checkActionFlag(*filt, clone_flag)) {
                     setActionFlag(command, clone_flag);
                 }
+                command.dest_id = parent_broker_id;
                 checkForNamedInterface(command);
             } else {
                 auto* ept = handles.getEndpoint(command.getString(targetStringLoc));
                 if (ept == nullptr) {
-                    if (isRootc) {
-                        if (checkActionFlag(command, destination_target)) {
-                            unknownHandles.addDestinationFilterLink(command.name,
-                                                                    command.getString(
-                                                                        targetStringLoc));
-                        } else {
-                            unknownHandles.addSourceFilterLink(command.name,
-                                                               command.getString(targetStringLoc));
-                        }
-                    } else {
-                        routeMessage(command);
+                    auto owner = interfaceDirectory.findOwner(handle_type::filter, command.name);
+                    if (!owner.isValid()) {
+                        owner = interfaceDirectory.findOwner(handle_type::endpoint,
+                                                             command.getString(targetStringLoc));
                     }
+                    routeUnknownLink(command, handle_type::filter, owner);
                 } else {
                     command.setAction(CMD_ADD_NAMED_FILTER);
                     command.setSource(ept->handle);
+                    command.dest_id = parent_broker_id;
                     checkForNamedInterface(command);
                 }
             }
@@ -959,12 +1064,18 @@ void CoreBroker::processCommand(ActionMessage&& command)
                 fed->state = connection_state::disconnected;
             }
             if (!isRootc) {
+                if (ownsSubtreeInterfaces()) {
+                    unknownHandles.clearFederateUnknowns(command.source_id);
+                }
                 transmit(parent_route_id, command);
             } else if (brokerState < broker_state_t::operating) {
                 command.setAction(CMD_BROADCAST_DISCONNECT);
                 broadcast(command);
                 unknownHandles.clearFederateUnknowns(command.source_id);
             }
+            if (resolvesInterfaces()) {
+                clearTargetPatterns(command.source_id);
+            }
         } break;
         case CMD_STOP:
             if ((getAllConnectionState() <
@@ -978,13 +1089,22 @@ void CoreBroker::processCommand(ActionMessage&& command)
                 }
             }
             activeQueries.fulfillAllPromises("#disconnected");
+            querySubscriptions.clear();
+            queryWatchers.clear();
             break;
         case CMD_BROADCAST_DISCONNECT: {
             timeCoord->processTimeMessage(command);
+            if (ownsSubtreeInterfaces()) {
+                unknownHandles.clearFederateUnknowns(command.source_id);
+                clearTargetPatterns(command.source_id);
+            }
             broadcast(command);
         } break;
         case CMD_EXEC_REQUEST:
         case CMD_EXEC_GRANT:
+            if (holdTimeMessage(command)) {
+                break;
+            }
             if (command.dest_id == global_broker_id_local) {
                 timeCoord->processTimeMessage(command);
                 if (!enteredExecutionMode) {
@@ -1005,6 +1125,9 @@ void CoreBroker::processCommand(ActionMessage&& command)
             break;
         case CMD_TIME_REQUEST:
         case CMD_TIME_GRANT:
+            if (holdTimeMessage(command)) {
+                break;
+            }
             if ((command.source_id == global_broker_id_local) &&
                 (command.dest_id == parent_broker_id)) {
                 LOG_TIMING(global_broker_id_local,
@@ -1029,7 +1152,26 @@ void CoreBroker::processCommand(ActionMessage&& command)
         case CMD_NULL_MESSAGE:
             if (command.dest_id == parent_broker_id) {
                 auto route = fillMessageRouteInformation(command);
-                transmit(route, command);
+                if (route == parent_route_id && isRootc && hasInterfaceOwners) {
+                    // the endpoint may be registered below an owning broker
+                    holdForInterfaceOwner(command,
+                                          handle_type::endpoint,
+                                          command.getString(targetStringLoc));
+                } else {
+                    transmit(route, command);
+                }
+            } else if (!isRootc && command.dest_id == global_broker_id_local) {
+                // sent here by the root from its interface directory
+                command.dest_id = parent_broker_id;
+                auto route = fillMessageRouteInformation(command);
+                if (route != parent_route_id) {
+                    transmit(route, command);
+                } else {
+                    LOG_WARNING(global_broker_id_local,
+                                getIdentifier(),
+                                fmt::format("unknown endpoint {}, message dropped",
+                                            command.getString(targetStringLoc)));
+                }
             } else {
                 transmit(getRoute(command.dest_id), command);
             }
@@ -1100,10 +1242,30 @@ void CoreBroker::processCommand(ActionMessage&& command)
                 }
             }
             break;
+        case CMD_TIME_COUPLING_PROBE:
+        case CMD_TIME_COUPLING_ACK:
+            // probes are only exchanged between federates
+            if (command.dest_id != global_broker_id_local) {
+                routeMessage(command);
+            }
+            break;
         case CMD_ADD_NAMED_ENDPOINT:
         case CMD_ADD_NAMED_PUBLICATION:
         case CMD_ADD_NAMED_INPUT:
         case CMD_ADD_NAMED_FILTER:
+            if (command.dest_id.isValid() && command.dest_id != parent_broker_id &&
+                command.dest_id != global_broker_id_local) {
+                // a lookup sent directly to the broker owning the interface
+                routeMessage(command);
+                if (isRootc) {
+                    syncInterfaceOwner(global_broker_id(command.dest_id));
+                }
+                break;
+            }
+            if (checkActionFlag(command, pattern_target_flag)) {
+                addTargetPattern(command);
+                break;
+            }
             checkForNamedInterface(command);
             break;
         case CMD_REMOVE_NAMED_ENDPOINT:
@@ -1112,6 +1274,37 @@ void CoreBroker::processCommand(ActionMessage&& command)
         case CMD_REMOVE_NAMED_FILTER:
             removeNamedTarget(command);
             break;
+        case CMD_INTERFACE_LOCATION:
+            if (command.dest_id != global_broker_id_local) {
+                routeMessage(command);
+            } else if (isRootc) {
+                processInterfaceLocation(command);
+            } else {
+                interfaceDirectory.addInterface(static_cast<handle_type>(command.counter),
+                                                command.name,
+                                                command.source_id);
+            }
+            break;
+        case CMD_FIND_INTERFACE:
+            if (command.dest_id == global_broker_id_local) {
+                answerInterfaceProbe(command);
+            } else {
+                routeMessage(command);
+            }
+            break;
+        case CMD_INTERFACE_SUMMARY:
+            if (isRootc) {
+                auto* brk = getBrokerById(global_broker_id(command.source_id));
+                if (brk != nullptr) {
+                    for (int ii = 0; ii < 4; ++ii) {
+                        brk->interfaceCounts[ii] =
+                            gmlc::utilities::numeric_conversion<int32_t>(command.getString(ii), 0);
+                    }
+                }
+            } else {
+                transmit(parent_route_id, command);
+            }
+            break;
         case CMD_BROKER_CONFIGURE:
             processBrokerConfigureCommands(command);
             break;
@@ -1165,6 +1358,19 @@ void CoreBroker::processBrokerConfigureCommands(ActionMessage& cmd)
                 }
             }
             break;
+        case UPDATE_QUERY_SUBSCRIPTION:
+            if (checkActionFlag(cmd, empty_flag)) {
+                sendQueryUnsubscribe(querySubscriptions.removeSubscription(cmd.getExtraData()),
+                                     -cmd.getExtraData());
+            } else {
+                auto op = dataAirlocks[cmd.counter].try_unload();
+                if (op) {
+                    querySubscriptions.addSubscription(
+                        cmd.getExtraData(), stx::any_cast<QuerySubscription>(std::move(*op)));
+                    processQuerySubscription(cmd.getExtraData());
+                }
+            }
+            break;
         case REQUEST_TICK_FORWARDING:
             forwardTick = checkActionFlag(cmd, indicator_flag);
         default:
@@ -1172,6 +1378,27 @@ void CoreBroker::processBrokerConfigureCommands(ActionMessage& cmd)
     }
 }
 
+/** get the type of interface a named target command refers to*/
+static handle_type namedTargetType(action_message_def::action_t action)
+{
+    switch (action) {
+        case CMD_ADD_NAMED_PUBLICATION:
+        case CMD_REMOVE_NAMED_PUBLICATION:
+            return handle_type::publication;
+        case CMD_ADD_NAMED_INPUT:
+        case CMD_REMOVE_NAMED_INPUT:
+            return handle_type::input;
+        case CMD_ADD_NAMED_ENDPOINT:
+        case CMD_REMOVE_NAMED_ENDPOINT:
+            return handle_type::endpoint;
+        case CMD_ADD_NAMED_FILTER:
+        case CMD_REMOVE_NAMED_FILTER:
+            return handle_type::filter;
+        default:
+            return handle_type::unknown;
+    }
+}
+
 void CoreBroker::checkForNamedInterface(ActionMessage& command)
 {
     bool foundInterface = false;
@@ -1190,6 +1417,7 @@ void CoreBroker::checkForNamedInterface(ActionMessage& command)
                     command.name = pub->key;
                     command.setStringData(pub->type, pub->units);
                     routeMessage(command);
+                    insertTimeAggregators(command.source_id, command.dest_id);
                 } else {
                     command.setAction(CMD_ADD_PUBLISHER);
                     setActionFlag(command, error_flag);
@@ -1219,6 +1447,7 @@ void CoreBroker::checkForNamedInterface(ActionMessage& command)
                     command.clearStringData();
                     command.name = inp->key;
                     routeMessage(command);
+                    insertTimeAggregators(command.dest_id, command.source_id);
                 } else {
                     command.setAction(CMD_ADD_SUBSCRIBER);
                     setActionFlag(command, error_flag);
@@ -1245,6 +1474,7 @@ void CoreBroker::checkForNamedInterface(ActionMessage& command)
                 if (checkActionFlag(*filt, clone_flag)) {
                     setActionFlag(command, clone_flag);
                 }
+                addDirectDependency(command.dest_id, command.source_id);
                 routeMessage(command);
                 foundInterface = true;
             }
@@ -1266,6 +1496,7 @@ void CoreBroker::checkForNamedInterface(ActionMessage& command)
                             setActionFlag(command, clone_flag);
                         }
                     }
+                    addDirectDependency(command.dest_id, command.source_id);
                     routeMessage(command);
                     command.setAction(CMD_ADD_ENDPOINT);
                     command.swapSourceDest();
@@ -1286,65 +1517,593 @@ void CoreBroker::checkForNamedInterface(ActionMessage& command)
             break;
     }
     if (!foundInterface) {
+        auto type = namedTargetType(command.action());
         if (isRootc) {
-            switch (command.action()) {
-                case CMD_ADD_NAMED_PUBLICATION:
-                    unknownHandles.addUnknownPublication(command.name,
-                                                         command.getSource(),
-                                                         command.flags);
-                    break;
-                case CMD_ADD_NAMED_INPUT:
-                    unknownHandles.addUnknownInput(command.name,
-                                                   command.getSource(),
-                                                   command.flags);
-                    if (!command.getStringData().empty()) {
-                        auto* pub = handles.findHandle(command.getSource());
-                        if (pub == nullptr) {
-                            // an anonymous publisher is adding an input
-                            auto& apub = handles.addHandle(command.source_id,
-                                                           command.source_handle,
-                                                           handle_type::publication,
-                                                           std::string(),
-                                                           command.getString(typeStringLoc),
-                                                           command.getString(unitStringLoc));
-
-                            addLocalInfo(apub, command);
-                        }
+            if (hasInterfaceOwners) {
+                auto owner = interfaceDirectory.findOwner(type, command.name);
+                if (owner.isValid()) {
+                    routeToInterfaceOwner(command, type, owner);
+                    return;
+                }
+            }
+            // the owners were asked when the name first became unknown
+            bool probed = unknownHandles.hasUnknown(command.name, static_cast<char>(type));
+            addUnknownInterface(command);
+            if (hasInterfaceOwners && !probed) {
+                probeInterfaceOwners(type, command.name, getInterfaceOwner(command.source_id));
+            }
+        } else if (command.dest_id == global_broker_id_local) {
+            // the root routed the lookup here from its directory but the interface is gone
+            LOG_WARNING(global_broker_id_local,
+                        getIdentifier(),
+                        fmt::format("interface {} is not owned by this broker", command.name));
+        } else if (ownsSubtreeInterfaces()) {
+            auto owner = interfaceDirectory.findOwner(type, command.name);
+            if (owner.isValid()) {
+                addSourceInterfaceInfo(command);
+                routeMessage(command, owner);
+            } else if (holdsSubtreeLookups()) {
+                // the interface may still be registered below this broker
+                addUnknownInterface(command);
+            } else {
+                addSourceInterfaceInfo(command);
+                routeMessage(command);
+            }
+        } else {
+            routeMessage(command);
+        }
+    }
+}
+
+void CoreBroker::addUnknownInterface(ActionMessage& command)
+{
+    switch (command.action()) {
+        case CMD_ADD_NAMED_PUBLICATION:
+            unknownHandles.addUnknownPublication(command.name, command.getSource(), command.flags);
+            break;
+        case CMD_ADD_NAMED_INPUT:
+            unknownHandles.addUnknownInput(command.name, command.getSource(), command.flags);
+            if (!command.getStringData().empty()) {
+                auto* pub = handles.findHandle(command.getSource());
+                if (pub == nullptr) {
+                    // an anonymous publisher is adding an input
+                    auto& apub = handles.addHandle(command.source_id,
+                                                   command.source_handle,
+                                                   handle_type::publication,
+                                                   std::string(),
+                                                   command.getString(typeStringLoc),
+                                                   command.getString(unitStringLoc));
+
+                    addLocalInfo(apub, command);
+                }
+            }
+            break;
+        case CMD_ADD_NAMED_ENDPOINT:
+            unknownHandles.addUnknownEndpoint(command.name, command.getSource(), command.flags);
+            if (!command.getStringData().empty()) {
+                auto* filt = handles.findHandle(command.getSource());
+                if (filt == nullptr) {
+                    // an anonymous filter is adding an endpoint
+                    auto& afilt = handles.addHandle(command.source_id,
+                                                    command.source_handle,
+                                                    handle_type::filter,
+                                                    std::string(),
+                                                    command.getString(typeStringLoc),
+                                                    command.getString(typeOutStringLoc));
+
+                    addLocalInfo(afilt, command);
+                }
+            }
+            break;
+        case CMD_ADD_NAMED_FILTER:
+            unknownHandles.addUnknownFilter(command.name, command.getSource(), command.flags);
+            break;
+        default:
+            LOG_WARNING(global_broker_id_local,
+                        getIdentifier(),
+                        "unknown command in interface addition code section\n");
+            break;
+    }
+}
+
+void CoreBroker::addUnknownLink(const ActionMessage& command)
+{
+    if (command.action() == CMD_DATA_LINK) {
+        unknownHandles.addDataLink(command.name, command.getString(targetStringLoc));
+    } else if (checkActionFlag(command, destination_target)) {
+        unknownHandles.addDestinationFilterLink(command.name, command.getString(targetStringLoc));
+    } else {
+        unknownHandles.addSourceFilterLink(command.name, command.getString(targetStringLoc));
+    }
+}
+
+void CoreBroker::routeUnknownLink(ActionMessage& command, handle_type type, global_broker_id owner)
+{
+    if (!isRootc && command.dest_id == global_broker_id_local) {
+        LOG_WARNING(global_broker_id_local,
+                    getIdentifier(),
+                    fmt::format("unable to link {} from the interface directory", command.name));
+        return;
+    }
+    if (owner.isValid()) {
+        routeMessage(command, owner);
+        syncInterfaceOwner(owner);
+    } else if (isRootc) {
+        bool probed = unknownHandles.hasUnknown(command.name, static_cast<char>(type));
+        addUnknownLink(command);
+        if (hasInterfaceOwners && !probed) {
+            probeInterfaceOwners(type, command.name, global_broker_id{});
+        }
+    } else if (holdsSubtreeLookups()) {
+        addUnknownLink(command);
+    } else {
+        routeMessage(command);
+    }
+}
+
+global_broker_id CoreBroker::getInterfaceOwner(global_federate_id fedid)
+{
+    if (!hasInterfaceOwners) {
+        return global_broker_id{};
+    }
+    auto fed = _federates.find(fedid);
+    if (fed == _federates.end()) {
+        return global_broker_id{};
+    }
+    auto brk = _brokers.find(fed->parent);
+    if ((brk != _brokers.end()) && (brk->_interface_directory)) {
+        return brk->global_id;
+    }
+    return global_broker_id{};
+}
+
+void CoreBroker::routeToInterfaceOwner(ActionMessage& command,
+                                       handle_type type,
+                                       global_broker_id owner)
+{
+    auto requester = getInterfaceOwner(command.source_id);
+    if (requester.isValid() && requester != owner) {
+        // let the sub-broker send later lookups for the interface straight to the owner
+        ActionMessage location(CMD_INTERFACE_LOCATION, owner, requester);
+        location.name = command.name;
+        location.counter = static_cast<uint16_t>(type);
+        routeMessage(location);
+    }
+    routeMessage(command, owner);
+    syncInterfaceOwner(owner);
+}
+
+bool CoreBroker::notifyInterfaceOwner(handle_type type,
+                                      const std::string& name,
+                                      global_broker_id owner)
+{
+    // the lookups are rebuilt and go through checkForNamedInterface which finds the new entry
+    bool notified = false;
+    switch (type) {
+        case handle_type::publication: {
+            auto subHandles = unknownHandles.checkForPublications(name);
+            for (const auto& sub : subHandles) {
+                ActionMessage m(CMD_ADD_NAMED_PUBLICATION);
+                m.name = name;
+                m.setSource(sub.first);
+                m.flags = sub.second;
+                checkForNamedInterface(m);
+            }
+            auto links = unknownHandles.checkForLinks(name);
+            for (const auto& link : links) {
+                ActionMessage m(CMD_DATA_LINK);
+                m.name = name;
+                m.setStringData(link);
+                routeMessage(m, owner);
+            }
+            if (!(subHandles.empty() && links.empty())) {
+                unknownHandles.clearPublication(name);
+                notified = true;
+            }
+        } break;
+        case handle_type::input: {
+            auto pubHandles = unknownHandles.checkForInputs(name);
+            for (const auto& target : pubHandles) {
+                ActionMessage m(CMD_ADD_NAMED_INPUT);
+                m.name = name;
+                m.setSource(target.first);
+                m.flags = target.second;
+                auto* pub = handles.findHandle(target.first);
+                if (pub != nullptr) {
+                    m.setStringData(pub->type, pub->units);
+                }
+                checkForNamedInterface(m);
+            }
+            if (!pubHandles.empty()) {
+                unknownHandles.clearInput(name);
+                notified = true;
+            }
+        } break;
+        case handle_type::endpoint: {
+            auto filtHandles = unknownHandles.checkForEndpoints(name);
+            for (const auto& target : filtHandles) {
+                ActionMessage m(CMD_ADD_NAMED_ENDPOINT);
+                m.name = name;
+                m.setSource(target.first);
+                m.flags = target.second;
+                auto* filt = handles.findHandle(target.first);
+                if (filt != nullptr) {
+                    if ((!filt->type_in.empty()) || (!filt->type_out.empty())) {
+                        m.setStringData(filt->type_in, filt->type_out);
                     }
-                    break;
-                case CMD_ADD_NAMED_ENDPOINT:
-                    unknownHandles.addUnknownEndpoint(command.name,
-                                                      command.getSource(),
-                                                      command.flags);
-                    if (!command.getStringData().empty()) {
-                        auto* filt = handles.findHandle(command.getSource());
-                        if (filt == nullptr) {
-                            // an anonymous filter is adding an endpoint
-                            auto& afilt = handles.addHandle(command.source_id,
-                                                            command.source_handle,
-                                                            handle_type::filter,
-                                                            std::string(),
-                                                            command.getString(typeStringLoc),
-                                                            command.getString(typeOutStringLoc));
-
-                            addLocalInfo(afilt, command);
-                        }
+                    if (checkActionFlag(*filt, clone_flag)) {
+                        setActionFlag(m, clone_flag);
                     }
-                    break;
-                case CMD_ADD_NAMED_FILTER:
-                    unknownHandles.addUnknownFilter(command.name,
-                                                    command.getSource(),
-                                                    command.flags);
-                    break;
-                default:
-                    LOG_WARNING(global_broker_id_local,
-                                getIdentifier(),
-                                "unknown command in interface addition code section\n");
-                    break;
+                }
+                checkForNamedInterface(m);
+            }
+            if (!filtHandles.empty()) {
+                unknownHandles.clearEndpoint(name);
+                notified = true;
+            }
+        } break;
+        case handle_type::filter: {
+            auto eptHandles = unknownHandles.checkForFilters(name);
+            for (const auto& target : eptHandles) {
+                ActionMessage m(CMD_ADD_NAMED_FILTER);
+                m.name = name;
+                m.setSource(target.first);
+                m.flags = target.second;
+                checkForNamedInterface(m);
+            }
+            auto destTargets = unknownHandles.checkForFilterDestTargets(name);
+            for (const auto& target : destTargets) {
+                ActionMessage m(CMD_FILTER_LINK);
+                m.name = name;
+                m.setStringData(target);
+                setActionFlag(m, destination_target);
+                routeMessage(m, owner);
+            }
+            auto sourceTargets = unknownHandles.checkForFilterSourceTargets(name);
+            for (const auto& target : sourceTargets) {
+                ActionMessage m(CMD_FILTER_LINK);
+                m.name = name;
+                m.setStringData(target);
+                routeMessage(m, owner);
+            }
+            if (!(eptHandles.empty() && destTargets.empty() && sourceTargets.empty())) {
+                unknownHandles.clearFilter(name);
+                notified = true;
+            }
+        } break;
+        default:
+            break;
+    }
+    return notified;
+}
+
+bool CoreBroker::ownsSubtreeInterfaces() const
+{
+    return ownInterfaces && !isRootc && higher_broker_id == root_broker_id;
+}
+
+bool CoreBroker::resolvesInterfaces() const
+{
+    return isRootc || ownsSubtreeInterfaces();
+}
+
+bool CoreBroker::holdsSubtreeLookups() const
+{
+    return ownsSubtreeInterfaces() && brokerState < broker_state_t::operating && !allInitReady();
+}
+
+/** get the lookup command for an interface type code from the UnknownHandleManager*/
+static action_message_def::action_t namedTargetAction(char type)
+{
+    switch (type) {
+        case 'p':
+            return CMD_ADD_NAMED_PUBLICATION;
+        case 'i':
+            return CMD_ADD_NAMED_INPUT;
+        case 'e':
+            return CMD_ADD_NAMED_ENDPOINT;
+        case 'f':
+        default:
+            return CMD_ADD_NAMED_FILTER;
+    }
+}
+
+void CoreBroker::sendSubtreeLookups()
+{
+    sendInterfaceSummary();
+    unknownHandles.processUnknowns(
+        [this](const std::string& name, char type, global_handle handle, uint16_t flags) {
+            ActionMessage lookup(namedTargetAction(type));
+            lookup.name = name;
+            lookup.setSource(handle);
+            lookup.dest_id = parent_broker_id;
+            lookup.flags = flags;
+            addSourceInterfaceInfo(lookup);
+            transmit(parent_route_id, lookup);
+        });
+    unknownHandles.processUnknownLinks(
+        [this](const std::string& origin, char type, const std::string& target) {
+            ActionMessage link((type == 'l') ? CMD_DATA_LINK : CMD_FILTER_LINK);
+            link.name = origin;
+            link.setStringData(target);
+            if (type == 'd') {
+                setActionFlag(link, destination_target);
+            }
+            transmit(parent_route_id, link);
+        });
+    // the root waits on everything the subtree could not resolve
+    unknownHandles.clear();
+}
+
+void CoreBroker::sendInterfaceSummary()
+{
+    if (!ownsSubtreeInterfaces() || holdsSubtreeLookups()) {
+        return;
+    }
+    std::array<int, 4> counts{{0, 0, 0, 0}};
+    for (const auto& handle : handles) {
+        switch (handle.handleType) {
+            case handle_type::publication:
+                ++counts[0];
+                break;
+            case handle_type::input:
+                ++counts[1];
+                break;
+            case handle_type::endpoint:
+                ++counts[2];
+                break;
+            case handle_type::filter:
+                ++counts[3];
+                break;
+            default:
+                break;
+        }
+    }
+    ActionMessage summary(CMD_INTERFACE_SUMMARY, global_broker_id_local, higher_broker_id);
+    summary.setStringData(std::to_string(counts[0]),
+                          std::to_string(counts[1]),
+                          std::to_string(counts[2]),
+                          std::to_string(counts[3]));
+    transmit(parent_route_id, summary);
+}
+
+int CoreBroker::probeInterfaceOwners(handle_type type,
+                                     const std::string& name,
+                                     global_broker_id skip)
+{
+    int probes = 0;
+    for (const auto& brk : _brokers) {
+        // an owner only answers once the registrations below it are complete
+        if (brk._interface_directory && brk.global_id != skip &&
+            brk.state >= connection_state::init_requested && brk.state < connection_state::error) {
+            sendInterfaceProbe(type, name, brk.global_id);
+            ++probes;
+        }
+    }
+    return probes;
+}
+
+void CoreBroker::probeInterfaceOwner(global_broker_id owner)
+{
+    unknownHandles.processUnknownNames([this, owner](const std::string& name, char type) {
+        sendInterfaceProbe(static_cast<handle_type>(type), name, owner);
+    });
+}
+
+void CoreBroker::sendInterfaceProbe(handle_type type,
+                                    const std::string& name,
+                                    global_broker_id owner)
+{
+    interfaceProbes[std::make_pair(type, name)].owners.push_back(owner);
+    ActionMessage probe(CMD_FIND_INTERFACE, global_broker_id_local, owner);
+    probe.name = name;
+    probe.counter = static_cast<uint16_t>(type);
+    routeMessage(probe);
+}
+
+void CoreBroker::syncInterfaceOwner(global_broker_id owner)
+{
+    if (!isRootc || brokerState >= broker_state_t::operating) {
+        return;
+    }
+    // the owner answers after it has processed everything sent to it before
+    sendInterfaceProbe(handle_type::unknown, std::string(), owner);
+}
+
+void CoreBroker::answerInterfaceProbe(const ActionMessage& command)
+{
+    bool found = false;
+    switch (static_cast<handle_type>(command.counter)) {
+        case handle_type::publication:
+            found = (handles.getPublication(command.name) != nullptr);
+            break;
+        case handle_type::input:
+            found = (handles.getInput(command.name) != nullptr);
+            break;
+        case handle_type::endpoint:
+            found = (handles.getEndpoint(command.name) != nullptr);
+            break;
+        case handle_type::filter:
+            found = (handles.getFilter(command.name) != nullptr);
+            break;
+        default:
+            break;
+    }
+    ActionMessage location(CMD_INTERFACE_LOCATION, global_broker_id_local, command.source_id);
+    location.name = command.name;
+    location.counter = command.counter;
+    if (!found) {
+        setActionFlag(location, error_flag);
+    }
+    transmit(parent_route_id, location);
+}
+
+void CoreBroker::processInterfaceLocation(ActionMessage& command)
+{
+    auto type = static_cast<handle_type>(command.counter);
+    global_broker_id owner(command.source_id);
+    auto probe = interfaceProbes.find(std::make_pair(type, command.name));
+    if (!checkActionFlag(command, error_flag)) {
+        auto known = interfaceDirectory.findOwner(type, command.name);
+        if (!known.isValid()) {
+            interfaceDirectory.addInterface(type, command.name, owner);
+            if (notifyInterfaceOwner(type, command.name, owner)) {
+                syncInterfaceOwner(owner);
             }
+            if (probe != interfaceProbes.end()) {
+                for (auto& message : probe->second.messages) {
+                    routeMessage(std::move(message), owner);
+                }
+                probe->second.messages.clear();
+            }
+        } else if (known != owner) {
+            LOG_ERROR(global_broker_id_local,
+                      getIdentifier(),
+                      fmt::format("duplicate interface {} below brokers {} and {}",
+                                  command.name,
+                                  known.baseValue(),
+                                  owner.baseValue()));
+        }
+    }
+    if (probe == interfaceProbes.end()) {
+        return;
+    }
+    auto& owners = probe->second.owners;
+    auto answered = std::find(owners.begin(), owners.end(), owner);
+    if (answered != owners.end()) {
+        owners.erase(answered);
+    }
+    if (owners.empty()) {
+        dropHeldMessages(probe->first.second, probe->second);
+        interfaceProbes.erase(probe);
+    }
+    checkInterfaceProbes();
+}
+
+void CoreBroker::removeInterfaceProbes(global_broker_id owner)
+{
+    auto probe = interfaceProbes.begin();
+    while (probe != interfaceProbes.end()) {
+        auto& owners = probe->second.owners;
+        owners.erase(std::remove(owners.begin(), owners.end(), owner), owners.end());
+        if (owners.empty()) {
+            dropHeldMessages(probe->first.second, probe->second);
+            probe = interfaceProbes.erase(probe);
         } else {
-            routeMessage(command);
+            ++probe;
+        }
+    }
+    checkInterfaceProbes();
+}
+
+void CoreBroker::checkInterfaceProbes()
+{
+    auto held = heldTimeMessages.begin();
+    while (held != heldTimeMessages.end()) {
+        if (isHeldRoute(held->first)) {
+            ++held;
+            continue;
+        }
+        auto messages = std::move(held->second);
+        held = heldTimeMessages.erase(held);
+        for (auto& message : messages) {
+            processCommand(std::move(message));
+        }
+        // processing may have held messages again
+        held = heldTimeMessages.begin();
+    }
+    if (interfaceProbes.empty() && brokerState < broker_state_t::operating && allInitReady()) {
+        // the federation was only waiting on the answers of the interface owners
+        LOG_TIMING(global_broker_id_local, "root", "entering initialization mode");
+        LOG_SUMMARY(global_broker_id_local, "root", generateFederationSummary());
+        executeInitializationOperations();
+    }
+}
+
+bool CoreBroker::isHeldRoute(route_id rid) const
+{
+    for (const auto& probe : interfaceProbes) {
+        for (const auto& message : probe.second.messages) {
+            if (getRoute(message.source_id) == rid) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool CoreBroker::holdTimeMessage(ActionMessage& command)
+{
+    if (!isRootc || interfaceProbes.empty() || command.source_id == global_broker_id_local) {
+        return false;
+    }
+    auto rid = getRoute(command.source_id);
+    auto held = heldTimeMessages.find(rid);
+    if (held == heldTimeMessages.end()) {
+        if (!isHeldRoute(rid)) {
+            return false;
+        }
+        held = heldTimeMessages.emplace(rid, std::vector<ActionMessage>()).first;
+    }
+    // a time message must not overtake a message sent before it on the same route
+    held->second.push_back(std::move(command));
+    return true;
+}
+
+void CoreBroker::holdForInterfaceOwner(ActionMessage& command,
+                                       handle_type type,
+                                       const std::string& name)
+{
+    auto key = std::make_pair(type, name);
+    auto probe = interfaceProbes.find(key);
+    if (probe == interfaceProbes.end()) {
+        if (probeInterfaceOwners(type, name, getInterfaceOwner(command.source_id)) == 0) {
+            LOG_WARNING(global_broker_id_local,
+                        getIdentifier(),
+                        fmt::format("unknown interface {}, {} dropped",
+                                    name,
+                                    prettyPrintString(command)));
+            return;
         }
+        probe = interfaceProbes.find(key);
+    }
+    probe->second.messages.push_back(command);
+}
+
+void CoreBroker::dropHeldMessages(const std::string& name, const InterfaceProbe& probe)
+{
+    for (const auto& message : probe.messages) {
+        LOG_WARNING(global_broker_id_local,
+                    getIdentifier(),
+                    fmt::format("unknown interface {}, {} dropped",
+                                name,
+                                prettyPrintString(message)));
+    }
+}
+
+void CoreBroker::addSourceInterfaceInfo(ActionMessage& command) const
+{
+    if (!command.getStringData().empty()) {
+        return;
+    }
+    const auto* source = handles.findHandle(command.getSource());
+    if (source == nullptr) {
+        return;
+    }
+    switch (command.action()) {
+        case CMD_ADD_NAMED_INPUT:
+            command.setStringData(source->type, source->units);
+            break;
+        case CMD_ADD_NAMED_ENDPOINT:
+            if ((!source->type_in.empty()) || (!source->type_out.empty())) {
+                command.setStringData(source->type_in, source->type_out);
+            }
+            if (checkActionFlag(*source, clone_flag)) {
+                setActionFlag(command, clone_flag);
+            }
+            break;
+        default:
+            break;
     }
 }
 
@@ -1410,13 +2169,112 @@ void CoreBroker::removeNamedTarget(ActionMessage& command)
     }
     if (!foundInterface) {
         if (isRootc) {
+            auto type = namedTargetType(command.action());
+            auto owner = interfaceDirectory.findOwner(type, command.name);
+            if (owner.isValid()) {
+                routeMessage(command, owner);
+                return;
+            }
+            if (hasInterfaceOwners) {
+                // the target may be registered below an owning broker
+                holdForInterfaceOwner(command, type, command.name);
+                return;
+            }
             LOG_WARNING(global_broker_id_local,
                         getIdentifier(),
                         fmt::format("attempt to remove unrecognized target {} ", command.name));
+        } else if (command.dest_id == global_broker_id_local) {
+            LOG_WARNING(global_broker_id_local,
+                        getIdentifier(),
+                        fmt::format("interface {} is not owned by this broker", command.name));
+        } else {
+            routeMessage(command);
+        }
+    }
+}
+
+void CoreBroker::addTargetPattern(ActionMessage& command)
+{
+    if (!resolvesInterfaces()) {
+        // patterns are matched where the interfaces are registered
+        transmit(parent_route_id, command);
+        return;
+    }
+    if (isRootc) {
+        auto requester = getInterfaceOwner(command.source_id);
+        for (const auto& brk : _brokers) {
+            if (brk._interface_directory && brk.global_id != requester &&
+                brk.state < connection_state::error) {
+                forwardTargetPattern(command, brk.global_id);
+            }
+        }
+    } else if (command.dest_id != global_broker_id_local) {
+        // the root matches the pattern against the rest of the federation
+        transmit(parent_route_id, command);
+    }
+    clearActionFlag(command, pattern_target_flag);
+    command.dest_id = parent_broker_id;
+    if (targetPatterns.empty()) {
+        // the index is only kept while there are patterns to match against
+        loadInterfaceNames();
+    }
+    auto type = namedTargetType(command.action());
+    auto pattern = command.name;
+    interfaceNames.addPattern(type, pattern, nextPatternId);
+    targetPatterns.emplace(nextPatternId++, command);
+    for (auto& name : interfaceNames.findInterfaces(type, pattern)) {
+        ActionMessage match(command);
+        match.name = std::move(name);
+        checkForNamedInterface(match);
+    }
+}
+
+void CoreBroker::forwardTargetPattern(const ActionMessage& pattern, global_broker_id owner)
+{
+    ActionMessage forward(pattern);
+    setActionFlag(forward, pattern_target_flag);
+    routeMessage(forward, owner);
+    syncInterfaceOwner(owner);
+}
+
+void CoreBroker::matchTargetPatterns(handle_type type, const std::string& name)
+{
+    if (targetPatterns.empty() || name.empty() || !interfaceNames.addInterface(type, name)) {
+        return;
+    }
+    for (auto id : interfaceNames.findPatterns(type, name)) {
+        ActionMessage match(targetPatterns.at(id));
+        match.name = name;
+        checkForNamedInterface(match);
+    }
+}
+
+void CoreBroker::clearTargetPatterns(global_federate_id fedid)
+{
+    auto pattern = targetPatterns.begin();
+    while (pattern != targetPatterns.end()) {
+        if (pattern->second.source_id == fedid) {
+            interfaceNames.removePattern(namedTargetType(pattern->second.action()),
+                                         pattern->second.name,
+                                         pattern->first);
+            pattern = targetPatterns.erase(pattern);
         } else {
-            routeMessage(command);
+            ++pattern;
+        }
+    }
+    if (targetPatterns.empty()) {
+        interfaceNames.clear();
+    }
+}
+
+void CoreBroker::loadInterfaceNames()
+{
+    for (const auto& handle : handles) {
+        if (!handle.key.empty()) {
+            interfaceNames.addInterface(handle.handleType, handle.key);
         }
     }
+    // the interfaces held by owning sub-brokers are matched by the owner
 }
 
 void CoreBroker::addLocalInfo(BasicHandleInfo& handleInfo, const ActionMessage& m)
@@ -1449,7 +2307,8 @@ void CoreBroker::propagateError(ActionMessage&& cmd)
 void CoreBroker::addPublication(ActionMessage& m)
 {
     // detect duplicate publications
-    if (handles.getPublication(m.name) != nullptr) {
+    if ((handles.getPublication(m.name) != nullptr) ||
+        interfaceDirectory.findOwner(handle_type::publication, m.name).isValid()) {
         ActionMessage eret(CMD_LOCAL_ERROR, global_broker_id_local, m.source_id);
         eret.dest_handle = m.source_handle;
         eret.messageID = defs::errors::registration_failure;
@@ -1465,16 +2324,19 @@ void CoreBroker::addPublication(ActionMessage& m)
                                   m.getString(1));
 
     addLocalInfo(pub, m);
-    if (!isRootc) {
-        transmit(parent_route_id, m);
-    } else {
+    if (resolvesInterfaces()) {
         FindandNotifyPublicationTargets(pub);
+        matchTargetPatterns(handle_type::publication, pub.key);
+        sendInterfaceSummary();
+    } else {
+        transmit(parent_route_id, m);
     }
 }
 void CoreBroker::addInput(ActionMessage& m)
 {
     // detect duplicate publications
-    if (handles.getInput(m.name) != nullptr) {
+    if ((handles.getInput(m.name) != nullptr) ||
+        interfaceDirectory.findOwner(handle_type::input, m.name).isValid()) {
         ActionMessage eret(CMD_LOCAL_ERROR, global_broker_id_local, m.source_id);
         eret.dest_handle = m.source_handle;
         eret.messageID = defs::errors::registration_failure;
@@ -1486,17 +2348,20 @@ void CoreBroker::addInput(ActionMessage& m)
         m.source_id, m.source_handle, handle_type::input, m.name, m.getString(0), m.getString(1));
 
     addLocalInfo(inp, m);
-    if (!isRootc) {
-        transmit(parent_route_id, m);
-    } else {
+    if (resolvesInterfaces()) {
         FindandNotifyInputTargets(inp);
+        matchTargetPatterns(handle_type::input, inp.key);
+        sendInterfaceSummary();
+    } else {
+        transmit(parent_route_id, m);
     }
 }
 
 void CoreBroker::addEndpoint(ActionMessage& m)
 {
     // detect duplicate endpoints
-    if (handles.getEndpoint(m.name) != nullptr) {
+    if ((handles.getEndpoint(m.name) != nullptr) ||
+        interfaceDirectory.findOwner(handle_type::endpoint, m.name).isValid()) {
         ActionMessage eret(CMD_LOCAL_ERROR, global_broker_id_local, m.source_id);
         eret.dest_handle = m.source_handle;
         eret.messageID = defs::errors::registration_failure;
@@ -1512,9 +2377,14 @@ void CoreBroker::addEndpoint(ActionMessage& m)
                                   m.getString(unitStringLoc));
 
     addLocalInfo(ept, m);
-
-    if (!isRootc) {
+    if (resolvesInterfaces()) {
+        FindandNotifyEndpointTargets(ept);
+        matchTargetPatterns(handle_type::endpoint, ept.key);
+        sendInterfaceSummary();
+    } else {
         transmit(parent_route_id, m);
+    }
+    if (!isRootc) {
         if (!hasTimeDependency) {
             if (timeCoord->addDependency(higher_broker_id)) {
                 hasTimeDependency = true;
@@ -1526,14 +2396,13 @@ void CoreBroker::addEndpoint(ActionMessage& m)
                 timeCoord->addDependent(higher_broker_id);
             }
         }
-    } else {
-        FindandNotifyEndpointTargets(ept);
     }
 }
 void CoreBroker::addFilter(ActionMessage& m)
 {
     // detect duplicate endpoints
-    if (handles.getFilter(m.name) != nullptr) {
+    if ((handles.getFilter(m.name) != nullptr) ||
+        interfaceDirectory.findOwner(handle_type::filter, m.name).isValid()) {
         ActionMessage eret(CMD_LOCAL_ERROR, global_broker_id_local, m.source_id);
         eret.dest_handle = m.source_handle;
         eret.messageID = defs::errors::registration_failure;
@@ -1549,9 +2418,14 @@ void CoreBroker::addFilter(ActionMessage& m)
                                    m.getString(typeStringLoc),
                                    m.getString(typeOutStringLoc));
     addLocalInfo(filt, m);
-
-    if (!isRootc) {
+    if (resolvesInterfaces()) {
+        FindandNotifyFilterTargets(filt);
+        matchTargetPatterns(handle_type::filter, filt.key);
+        sendInterfaceSummary();
+    } else {
         transmit(parent_route_id, m);
+    }
+    if (!isRootc) {
         if (!hasFilters) {
             hasFilters = true;
             if (timeCoord->addDependent(higher_broker_id)) {
@@ -1560,8 +2434,6 @@ void CoreBroker::addFilter(ActionMessage& m)
                 transmit(parent_route_id, add);
             }
         }
-    } else {
-        FindandNotifyFilterTargets(filt);
     }
 }
 
@@ -1629,6 +2501,22 @@ std::shared_ptr<helicsCLI11App> CoreBroker::generateCLI()
     app->remove_helics_specifics();
     app->add_flag_callback(
         "--root", [this]() { setAsRoot(); }, "specify whether the broker is a root");
+    app->add_flag("--aggregate_time,--time_aggregation",
+                  aggregateTime,
+                  "specify that the broker should act as a single time dependency for its "
+                  "federates on value links to federates outside of its subtree, this works at "
+                  "any level so nested aggregating brokers each aggregate for their parent "
+                  "(ignored on the root)");
+    app->add_flag("--interface_directory",
+                  ownInterfaces,
+                  "specify that the broker should resolve the interfaces registered below it "
+                  "and answer lookups from the root which misses them, only used on brokers "
+                  "directly below the root (ignored on the root and deeper brokers)");
+    app->add_option("--global_time_cache",
+                    globalTimeCachePeriod,
+                    "the maximum age of a cached global_time query result, structural queries such "
+                    "as federate_map are cached until the federation changes (default 0, "
+                    "global_time is always regenerated)");
     return app;
 }
 
@@ -1660,6 +2548,9 @@ bool CoreBroker::connect()
                     if (no_ping) {
                         setActionFlag(m, slow_responding_flag);
                     }
+                    if (ownInterfaces) {
+                        setActionFlag(m, interface_directory_flag);
+                    }
                     if (!brokerKey.empty() && brokerKey != universalKey) {
                         m.setStringData(getAddress(), brokerKey);
                     } else {
@@ -1970,6 +2861,7 @@ void CoreBroker::FindandNotifyInputTargets(BasicHandleInfo& handleInfo)
         }
 
         transmit(getRoute(m.dest_id), std::move(m));
+        insertTimeAggregators(target.first.fed_id, handleInfo.handle.fed_id);
     }
     if (!Handles.empty()) {
         unknownHandles.clearInput(handleInfo.key);
@@ -1996,6 +2888,7 @@ void CoreBroker::FindandNotifyPublicationTargets(BasicHandleInfo& handleInfo)
         m.flags = handleInfo.flags;
         m.setStringData(handleInfo.type, handleInfo.units);
         transmit(getRoute(m.dest_id), std::move(m));
+        insertTimeAggregators(handleInfo.handle.fed_id, sub.first.fed_id);
     }
 
     auto Pubtargets = unknownHandles.checkForLinks(handleInfo.key);
@@ -2010,6 +2903,74 @@ void CoreBroker::FindandNotifyPublicationTargets(BasicHandleInfo& handleInfo)
     }
 }
 
+void CoreBroker::markTimeAggregation(ActionMessage& command) const
+{
+    if (!aggregateTime || command.action() != CMD_REG_FED) {
+        return;
+    }
+    // each aggregating broker on the way up appends itself so the root gets the whole chain
+    setActionFlag(command, time_aggregation_flag);
+    command.setString(static_cast<int>(command.getStringData().size()),
+                      std::to_string(global_broker_id_local.baseValue()));
+}
+
+std::vector<global_federate_id> CoreBroker::getTimeAggregators(global_federate_id fedid) const
+{
+    auto fnd = timeAggregators.find(fedid);
+    if (fnd == timeAggregators.end()) {
+        return {};
+    }
+    return fnd->second;
+}
+
+void CoreBroker::insertTimeAggregators(global_federate_id pubFed, global_federate_id inputFed)
+{
+    if (!hasTimeAggregators || pubFed == inputFed) {
+        return;
+    }
+    auto pubAggregators = getTimeAggregators(pubFed);
+    auto inputAggregators = getTimeAggregators(inputFed);
+    // the aggregators above both federates are shared ancestors which the link does not leave
+    while (!pubAggregators.empty() && !inputAggregators.empty() &&
+           pubAggregators.back() == inputAggregators.back()) {
+        pubAggregators.pop_back();
+        inputAggregators.pop_back();
+    }
+    if (pubAggregators.empty() && inputAggregators.empty()) {
+        // the federates are in the same subtree or neither is behind an aggregator
+        return;
+    }
+    // the link messages already set up a direct dependency, these follow them on the same
+    // routes so they are processed after the link and replace the direct dependency with a chain
+    // through the aggregating brokers, unless a filter or explicit dependency also needs it
+    if (directDependencies.find(std::make_pair(pubFed, inputFed)) == directDependencies.end()) {
+        ActionMessage rmdep(CMD_REMOVE_DEPENDENT, inputFed, pubFed);
+        routeMessage(rmdep);
+        rmdep = ActionMessage(CMD_REMOVE_DEPENDENCY, pubFed, inputFed);
+        routeMessage(rmdep);
+    }
+
+    // up through each level of aggregation above the publication and down through those above the
+    // input, so each aggregating broker is the single dependency of its subtree for its parent
+    std::vector<global_federate_id> chain{pubFed};
+    chain.insert(chain.end(), pubAggregators.begin(), pubAggregators.end());
+    chain.insert(chain.end(), inputAggregators.rbegin(), inputAggregators.rend());
+    chain.push_back(inputFed);
+    for (std::size_t ii = 1; ii < chain.size(); ++ii) {
+        ActionMessage adddep(CMD_ADD_DEPENDENT, chain[ii], chain[ii - 1]);
+        routeMessage(adddep);
+        adddep = ActionMessage(CMD_ADD_DEPENDENCY, chain[ii - 1], chain[ii]);
+        routeMessage(adddep);
+    }
+}
+
+void CoreBroker::addDirectDependency(global_federate_id dependency, global_federate_id dependent)
+{
+    if (isRootc && dependency != dependent && dependency.isFederate() && dependent.isFederate()) {
+        directDependencies.emplace(dependency, dependent);
+    }
+}
+
 void CoreBroker::FindandNotifyEndpointTargets(BasicHandleInfo& handleInfo)
 {
     auto Handles = unknownHandles.checkForEndpoints(handleInfo.key);
@@ -2025,6 +2986,7 @@ void CoreBroker::FindandNotifyEndpointTargets(BasicHandleInfo& handleInfo)
         m.setAction(CMD_ADD_FILTER);
         m.swapSourceDest();
         m.flags = target.second;
+        addDirectDependency(m.dest_id, m.source_id);
         transmit(getRoute(m.dest_id), m);
     }
 
@@ -2048,6 +3010,7 @@ void CoreBroker::FindandNotifyFilterTargets(BasicHandleInfo& handleInfo)
         if ((!handleInfo.type_in.empty()) || (!handleInfo.type_out.empty())) {
             m.setStringData(handleInfo.type_in, handleInfo.type_out);
         }
+        addDirectDependency(m.dest_id, m.source_id);
         transmit(getRoute(m.dest_id), m);
 
         // notify the filter about an endpoint
@@ -2091,6 +3054,7 @@ void CoreBroker::processError(ActionMessage& command)
     sendToLogger(command.source_id, log_level::error, std::string(), command.payload);
     if (command.source_id == global_broker_id_local) {
         brokerState = broker_state_t::errored;
+        dumpFlightRecorder("error");
         broadcast(command);
         if (!isRootc) {
             command.setAction(CMD_LOCAL_ERROR);
@@ -2101,6 +3065,7 @@ void CoreBroker::processError(ActionMessage& command)
 
     if (command.source_id == parent_broker_id || command.source_id == root_broker_id) {
         brokerState = broker_state_t::errored;
+        dumpFlightRecorder("global error");
         broadcast(command);
     }
 
@@ -2288,12 +3253,21 @@ void CoreBroker::markAsDisconnected(global_broker_id brkid)
 void CoreBroker::disconnectBroker(BasicBrokerInfo& brk)
 {
     markAsDisconnected(brk.global_id);
+    // responses to subscription queries routed through the broker may never arrive
+    for (auto index : querySubscriptions.resetInFlight()) {
+        processQuerySubscription(index);
+    }
+    queryWatchers.removeSubscriber(brk.global_id);
     if (brokerState < broker_state_t::operating) {
         if (isRootc) {
             ActionMessage dis(CMD_BROADCAST_DISCONNECT);
             dis.source_id = brk.global_id;
             broadcast(dis);
             unknownHandles.clearFederateUnknowns(brk.global_id);
+            if (brk._interface_directory) {
+                interfaceDirectory.removeOwner(brk.global_id);
+                removeInterfaceProbes(brk.global_id);
+            }
             if (!brk._core) {
                 for (const auto& subbrk : _brokers) {
                     if ((subbrk.parent == brk.global_id) && (subbrk._core)) {
@@ -2379,6 +3353,42 @@ std::string CoreBroker::query(const std::string& target, const std::string& quer
     //  return "#invalid";
 }
 
+int32_t CoreBroker::subscribeQuery(const std::string& target,
+                                   const std::string& queryStr,
+                                   std::function<void(const std::string&)> callback,
+                                   std::chrono::milliseconds period,
+                                   bool everyPeriod)
+{
+    if (!callback) {
+        throw(InvalidParameter("query subscriptions require a callback"));
+    }
+    QuerySubscription subscription;
+    subscription.target = target;
+    subscription.query = queryStr;
+    subscription.callback = std::move(callback);
+    subscription.period = period;
+    subscription.everyPeriod = everyPeriod;
+
+    auto index = ++queryCounter;
+    ActionMessage subscribe(CMD_BROKER_CONFIGURE);
+    subscribe.messageID = UPDATE_QUERY_SUBSCRIPTION;
+    subscribe.setExtraData(index);
+    auto ii = getNextAirlockIndex();
+    dataAirlocks[ii].load(std::move(subscription));
+    subscribe.counter = ii;
+    addActionMessage(std::move(subscribe));
+    return index;
+}
+
+void CoreBroker::unsubscribeQuery(int32_t subscriptionId)
+{
+    ActionMessage unsubscribe(CMD_BROKER_CONFIGURE);
+    unsubscribe.messageID = UPDATE_QUERY_SUBSCRIPTION;
+    unsubscribe.setExtraData(subscriptionId);
+    setActionFlag(unsubscribe, empty_flag);
+    addActionMessage(std::move(unsubscribe));
+}
+
 void CoreBroker::setGlobal(const std::string& valueName, const std::string& value)
 {
     ActionMessage querycmd(CMD_SET_GLOBAL);
@@ -2394,7 +3404,13 @@ enum subqueries : std::uint16_t {
     current_time_map = 2,
     dependency_graph = 3,
     data_flow_graph = 4,
-    version_all = 5
+    version_all = 5,
+    iteration_map = 6,
+    watched_query = 7,  // the answer for a query subscription held by the broker
+    publication_list = 8,  // the interface lists of the interface owning brokers
+    input_list = 9,
+    endpoint_list = 10,
+    filter_list = 11,
 };
 
 static const std::map<std::string, std::pair<std::uint16_t, bool>> mapIndex{
@@ -2403,8 +3419,52 @@ static const std::map<std::string, std::pair<std::uint16_t, bool>> mapIndex{
     {"dependency_graph", {dependency_graph, false}},
     {"data_flow_graph", {data_flow_graph, false}},
     {"version_all", {version_all, false}},
+    {"global_iterations", {iteration_map, true}},
 };
 
+/** get the subquery for the interface list query of the interface owning brokers
+@return general_query if the request is not an interface list*/
+static std::uint16_t interfaceListIndex(const std::string& request)
+{
+    if (request == "publications") {
+        return publication_list;
+    }
+    if (request == "inputs") {
+        return input_list;
+    }
+    if (request == "endpoints") {
+        return endpoint_list;
+    }
+    if (request == "filters") {
+        return filter_list;
+    }
+    return general_query;
+}
+
+/** get the type of interface listed by a subquery or unknown if it is not an interface list*/
+static handle_type interfaceListType(std::uint16_t index)
+{
+    switch (index) {
+        case publication_list:
+            return handle_type::publication;
+        case input_list:
+            return handle_type::input;
+        case endpoint_list:
+            return handle_type::endpoint;
+        case filter_list:
+            return handle_type::filter;
+        default:
+            return handle_type::unknown;
+    }
+}
+
+/** get the subquery used to build the answer to a request*/
+static std::uint16_t mapQueryIndex(const std::string& request)
+{
+    auto mi = mapIndex.find(request);
+    return (mi != mapIndex.end()) ? mi->second.first : interfaceListIndex(request);
+}
+
 std::string CoreBroker::generateQueryAnswer(const std::string& request)
 {
     if (request == "isinit") {
@@ -2423,7 +3483,7 @@ std::string CoreBroker::generateQueryAnswer(const std::string& request)
     if ((request == "queries") || (request == "available_queries")) {
         return "[isinit;isconnected;name;identifier;address;queries;address;counts;summary;federates;brokers;inputs;endpoints;"
                "publications;filters;federate_map;dependency_graph;data_flow_graph;dependencies;dependson;dependents;"
-               "current_time;current_state;status;global_time;version;version_all;exists]";
+               "current_time;current_state;status;global_time;global_iterations;version;version_all;exists;query_cache;query_subscriptions;query_watchers;flight_recorder]";
     }
     if (request == "address") {
         return getAddress();
@@ -2453,7 +3513,22 @@ std::string CoreBroker::generateQueryAnswer(const std::string& request)
         }
         base["brokers"] = static_cast<int>(_brokers.size());
         base["federates"] = static_cast<int>(_federates.size());
-        base["handles"] = static_cast<int>(handles.size());
+        auto handleCount = static_cast<int>(handles.size());
+        for (const auto& brk : _brokers) {
+            if (brk._interface_directory) {
+                // the root holds no handles for the interfaces of owning sub-brokers
+                for (auto count : brk.interfaceCounts) {
+                    handleCount += count;
+                }
+            }
+        }
+        base["handles"] = handleCount;
+        if (!interfaceDirectory.empty()) {
+            base["interface_directory"] = static_cast<int>(interfaceDirectory.size());
+        }
+        if (interfaceNames.patternCount() > 0) {
+            base["target_patterns"] = static_cast<int>(interfaceNames.patternCount());
+        }
         return generateJsonString(base);
     }
     if (request == "summary") {
@@ -2506,48 +3581,34 @@ std::string CoreBroker::generateQueryAnswer(const std::string& request)
         }
         return timeCoord->printTimeStatus();
     }
-    auto mi = mapIndex.find(request);
-    if (mi != mapIndex.end()) {
-        auto index = mi->second.first;
-        if (isValidIndex(index, mapBuilders) && !mi->second.second) {
-            if (std::get<0>(mapBuilders[index]).isCompleted()) {
-                return std::get<0>(mapBuilders[index]).generate();
-            }
-            if (std::get<0>(mapBuilders[index]).isActive()) {
-                return "#wait";
-            }
-        }
-
-        initializeMapBuilder(request, index, mi->second.second);
-        if (std::get<0>(mapBuilders[index]).isCompleted()) {
-            return std::get<0>(mapBuilders[index]).generate();
-        }
-        return "#wait";
+    if (request == "query_cache") {
+        return generateQueryCacheStatus();
     }
-
-    if (request == "inputs") {
-        return generateStringVector_if(
-            handles,
-            [](auto& handle) { return handle.key; },
-            [](auto& handle) { return (handle.handleType == handle_type::input); });
+    if (request == "query_subscriptions") {
+        return querySubscriptions.generateStatus();
     }
-    if (request == "publications") {
-        return generateStringVector_if(
-            handles,
-            [](auto& handle) { return handle.key; },
-            [](auto& handle) { return (handle.handleType == handle_type::publication); });
+    if (request == "query_watchers") {
+        return queryWatchers.generateStatus();
     }
-    if (request == "filters") {
-        return generateStringVector_if(
-            handles,
-            [](auto& handle) { return handle.key; },
-            [](auto& handle) { return (handle.handleType == handle_type::filter); });
+    if (request == "flight_recorder") {
+        Json::Value base;
+        base["name"] = getIdentifier();
+        if (flightRecorder) {
+            flightRecorder->generateRecords(base);
+        }
+        return generateJsonString(base);
     }
-    if (request == "endpoints") {
-        return generateStringVector_if(
-            handles,
-            [](auto& handle) { return handle.key; },
-            [](auto& handle) { return (handle.handleType == handle_type::endpoint); });
+    auto mi = mapIndex.find(request);
+    if (mi != mapIndex.end()) {
+        return generateMapQuery(request, mi->second.first, mi->second.second);
+    }
+    auto listIndex = interfaceListIndex(request);
+    if (listIndex != general_query) {
+        if (isRootc && hasInterfaceOwners) {
+            // only the owning brokers know the interfaces registered below them
+            return generateMapQuery(request, listIndex, false);
+        }
+        return generateInterfaceList(interfaceListType(listIndex));
     }
 
     if (request == "dependson") {
@@ -2583,6 +3644,27 @@ std::string CoreBroker::generateQueryAnswer(const std::string& request)
     return "#invalid";
 }
 
+std::string
+    CoreBroker::generateMapQuery(const std::string& request, std::uint16_t index, bool timeBased)
+{
+    if (isMapCacheValid(index, timeBased)) {
+        return mapCache[index].result;
+    }
+    if (isValidIndex(index, mapBuilders)) {
+        const auto& builder = std::get<0>(mapBuilders[index]);
+        if (builder.isActive() && !builder.isCompleted()) {
+            // join the request already in progress
+            return "#wait";
+        }
+    }
+
+    initializeMapBuilder(request, index, timeBased);
+    if (std::get<0>(mapBuilders[index]).isCompleted()) {
+        return completeMapQuery(index);
+    }
+    return "#wait";
+}
+
 std::string CoreBroker::getNameList(std::string gidString) const
 {
     if (gidString.back() == ']') {
@@ -2616,6 +3698,14 @@ void CoreBroker::initializeMapBuilder(const std::string& request, std::uint16_t
     if (!isValidIndex(index, mapBuilders)) {
         mapBuilders.resize(index + 1);
     }
+    if (!isValidIndex(index, mapCache)) {
+        mapCache.resize(index + 1);
+    }
+    auto& cache = mapCache[index];
+    cache.version = structureVersion;
+    if (reset) {
+        cache.children.clear();
+    }
     std::get<2>(mapBuilders[index]) = reset;
     auto& builder = std::get<0>(mapBuilders[index]);
     builder.reset();
@@ -2633,9 +3723,17 @@ void CoreBroker::initializeMapBuilder(const std::string& request, std::uint16_t
     queryReq.payload = request;
     queryReq.source_id = global_broker_id_local;
     queryReq.counter = index;  // indicating which processing to use
+    if (watchedQueryActive) {
+        // the children report changes in state so the query subscription is answered again
+        setActionFlag(queryReq, query_subscription_flag);
+    }
     bool hasCores = false;
+    bool ownersOnly = (interfaceListType(index) != handle_type::unknown);
     for (const auto& broker : _brokers) {
         if (broker.parent == global_broker_id_local) {
+            if (ownersOnly && !broker._interface_directory) {
+                continue;
+            }
             int brkindex;
             if (broker._core) {
                 if (!hasCores) {
@@ -2646,6 +3744,12 @@ void CoreBroker::initializeMapBuilder(const std::string& request, std::uint16_t
             } else {
                 brkindex = builder.generatePlaceHolder("brokers");
             }
+            auto cached = cache.children.find(broker.global_id);
+            if (cached != cache.children.end()) {
+                // the child has not reported a change since this sub-result
+                builder.addComponent(cached->second, brkindex);
+                continue;
+            }
             queryReq.messageID = brkindex;
             queryReq.dest_id = broker.global_id;
             transmit(broker.route, queryReq);
@@ -2654,6 +3758,7 @@ void CoreBroker::initializeMapBuilder(const std::string& request, std::uint16_t
     switch (index) {
         case federate_map:
         case current_time_map:
+        case iteration_map:
         case data_flow_graph:
         default:
             break;
@@ -2675,16 +3780,38 @@ void CoreBroker::initializeMapBuilder(const std::string& request, std::uint16_t
 
 void CoreBroker::processLocalQuery(const ActionMessage& m)
 {
+    bool watched = checkActionFlag(m, query_subscription_flag);
+    if (watched && m.counter == general_query) {
+        processQueryWatcher(queryWatchers.addWatcher(m, global_federate_id{}));
+        return;
+    }
     ActionMessage queryRep(CMD_QUERY_REPLY);
     queryRep.source_id = global_broker_id_local;
     queryRep.dest_id = m.source_id;
     queryRep.messageID = m.messageID;
-    queryRep.payload = generateQueryAnswer(m.payload);
+    watchedQueryActive = watched;
+    auto listType = interfaceListType(m.counter);
+    if (listType != handle_type::unknown) {
+        // the root merges the lists of the interface owning brokers
+        Json::Value names = Json::arrayValue;
+        for (const auto& name : getInterfaceNames(listType)) {
+            names.append(name);
+        }
+        queryRep.payload = generateJsonString(names);
+    } else {
+        queryRep.payload = generateQueryAnswer(m.payload);
+    }
+    watchedQueryActive = false;
     queryRep.counter = m.counter;
+    if (m.counter != general_query && m.source_id == higher_broker_id) {
+        // the parent caches the sub-result so it needs to hear about later changes
+        parentHasQueryResults = true;
+        parentWatchesState = parentWatchesState || watched;
+    }
     if (queryRep.payload == "#wait") {
-        std::get<1>(mapBuilders[mapIndex.at(m.payload).first]).push_back(queryRep);
+        std::get<1>(mapBuilders[mapQueryIndex(m.payload)]).push_back(queryRep);
     } else if (queryRep.dest_id == global_broker_id_local) {
-        activeQueries.setDelayedValue(m.messageID, queryRep.payload);
+        setQueryResult(m.messageID, queryRep.payload);
     } else {
         routeMessage(std::move(queryRep), m.source_id);
     }
@@ -2746,7 +3873,7 @@ void CoreBroker::processQuery(ActionMessage& m)
         queryResp.messageID = m.messageID;
         queryResp.payload = getNameList(m.payload);
         if (queryResp.dest_id == global_broker_id_local) {
-            activeQueries.setDelayedValue(m.messageID, queryResp.payload);
+            setQueryResult(m.messageID, queryResp.payload);
         } else {
             transmit(getRoute(queryResp.dest_id), queryResp);
         }
@@ -2773,7 +3900,7 @@ void CoreBroker::processQuery(ActionMessage& m)
             queryResp.payload = "#invalid";
         }
         if (queryResp.dest_id == global_broker_id_local) {
-            activeQueries.setDelayedValue(m.messageID, queryResp.payload);
+            setQueryResult(m.messageID, queryResp.payload);
         } else {
             transmit(getRoute(queryResp.dest_id), queryResp);
         }
@@ -2781,16 +3908,22 @@ void CoreBroker::processQuery(ActionMessage& m)
         route_id route = parent_route_id;
         auto fed = _federates.find(target);
         std::string response;
+        // a query subscription is registered with the core or broker holding the target
+        bool watched = checkActionFlag(m, query_subscription_flag);
         if (fed != _federates.end()) {
             route = fed->route;
             m.dest_id = fed->parent;
-            response = checkFedQuery(*fed, m.payload);
+            if (!watched) {
+                response = checkFedQuery(*fed, m.payload);
+            }
         } else {
             auto broker = _brokers.find(target);
             if (broker != _brokers.end()) {
                 route = broker->route;
                 m.dest_id = broker->global_id;
-                response = checkBrokerQuery(*broker, m.payload);
+                if (!watched) {
+                    response = checkBrokerQuery(*broker, m.payload);
+                }
             } else if (isRootc && m.payload == "exists") {
                 response = "false";
             }
@@ -2805,10 +3938,16 @@ void CoreBroker::processQuery(ActionMessage& m)
             queryResp.messageID = m.messageID;
 
             queryResp.payload = response;
-            if (queryResp.dest_id == global_broker_id_local) {
-                activeQueries.setDelayedValue(m.messageID, queryResp.payload);
-            } else {
+            if (watched) {
+                // there is no watcher for an unknown target so the subscription is sent again
+                setActionFlag(queryResp, error_flag);
+            }
+            if (queryResp.dest_id != global_broker_id_local) {
                 transmit(getRoute(queryResp.dest_id), queryResp);
+            } else if (watched) {
+                processSubscriptionResult(queryResp);
+            } else {
+                setQueryResult(m.messageID, queryResp.payload);
             }
         } else {
             transmit(route, m);
@@ -2816,20 +3955,165 @@ void CoreBroker::processQuery(ActionMessage& m)
     }
 }
 
+void CoreBroker::setQueryResult(int32_t index, const std::string& result)
+{
+    if (index < 0) {
+        // subscription results use the negative of the subscription index
+        if (!querySubscriptions.processResult(-index, result, global_broker_id_local)) {
+            queryWatchers.removeWatcher(global_broker_id_local, index);
+        }
+    } else {
+        activeQueries.setDelayedValue(index, result);
+    }
+}
+
+void CoreBroker::setLocalQueryResult(const ActionMessage& requestor, const std::string& result)
+{
+    if (requestor.counter == watched_query) {
+        sendQueryWatcherResult(requestor.messageID, result);
+    } else {
+        setQueryResult(requestor.messageID, result);
+    }
+}
+
+void CoreBroker::processSubscriptionResult(const ActionMessage& m)
+{
+    // an error flag marks a result that did not come from a watcher
+    auto source = checkActionFlag(m, error_flag) ? global_federate_id{} : m.source_id;
+    if (!querySubscriptions.processResult(-m.messageID, m.payload, source)) {
+        // the subscription was removed before the sender knew about it
+        sendQueryUnsubscribe(source, m.messageID);
+    }
+}
+
+void CoreBroker::sendQueryUnsubscribe(global_federate_id source, int32_t messageID)
+{
+    if (!source.isValid()) {
+        return;
+    }
+    if (source == global_broker_id_local) {
+        queryWatchers.removeWatcher(global_broker_id_local, messageID);
+        return;
+    }
+    ActionMessage unsubscribe(CMD_QUERY_UNSUBSCRIBE);
+    unsubscribe.source_id = global_broker_id_local;
+    unsubscribe.dest_id = source;
+    unsubscribe.messageID = messageID;
+    routeMessage(std::move(unsubscribe));
+}
+
+void CoreBroker::processQuerySubscription(int32_t index)
+{
+    if (brokerState.load() >= broker_state_t::terminating) {
+        querySubscriptions.clear();
+        return;
+    }
+    const auto* subscription = querySubscriptions.startUpdate(index);
+    if (subscription == nullptr) {
+        return;
+    }
+    // the subscription is registered with the target which sends any changes in the result
+    const auto& target = subscription->target;
+    ActionMessage querycmd(CMD_BROKER_QUERY);
+    querycmd.source_id = global_broker_id_local;
+    querycmd.messageID = -index;
+    querycmd.payload = subscription->query;
+    querycmd.setExtraData(static_cast<int32_t>(
+        (std::min)(subscription->period.count(), std::chrono::milliseconds::rep{0x7FFFFFFF})));
+    setActionFlag(querycmd, query_subscription_flag);
+    if (subscription->everyPeriod) {
+        setActionFlag(querycmd, indicator_flag);
+    }
+    if (target == "broker" || target == getIdentifier() || target.empty()) {
+        querycmd.dest_id = global_broker_id_local;
+        addActionMessage(std::move(querycmd));
+    } else if (target == "parent") {
+        if (isRootc) {
+            querySubscriptions.processResult(index, "#na", global_broker_id_local);
+            return;
+        }
+        addActionMessage(std::move(querycmd));
+    } else if ((target == "root") || (target == "rootbroker")) {
+        transmitToParent(std::move(querycmd));
+    } else {
+        querycmd.setAction(CMD_QUERY);
+        querycmd.setStringData(target);
+        transmitToParent(std::move(querycmd));
+    }
+}
+
+void CoreBroker::processQueryWatcher(int32_t index)
+{
+    if (brokerState.load() >= broker_state_t::terminating) {
+        queryWatchers.clear();
+        return;
+    }
+    const auto* watcher = queryWatchers.startUpdate(index);
+    if (watcher == nullptr) {
+        return;
+    }
+    watchedQueryActive = true;
+    auto result = generateQueryAnswer(watcher->query);
+    watchedQueryActive = false;
+    if (result == "#wait") {
+        // the result is delivered to the watcher when the map is complete
+        ActionMessage queryResp(CMD_QUERY_REPLY);
+        queryResp.dest_id = global_broker_id_local;
+        queryResp.source_id = global_broker_id_local;
+        queryResp.messageID = index;
+        queryResp.counter = watched_query;
+        std::get<1>(mapBuilders[mapQueryIndex(watcher->query)]).push_back(queryResp);
+        return;
+    }
+    sendQueryWatcherResult(index, result);
+}
+
+void CoreBroker::sendQueryWatcherResult(int32_t index, const std::string& result)
+{
+    const auto* watcher = queryWatchers.updateResult(index, result);
+    if (watcher == nullptr) {
+        return;
+    }
+    if (watcher->subscriber == global_broker_id_local) {
+        setQueryResult(watcher->messageID, result);
+        return;
+    }
+    ActionMessage queryResp(CMD_QUERY_REPLY);
+    queryResp.dest_id = watcher->subscriber;
+    queryResp.source_id = global_broker_id_local;
+    queryResp.messageID = watcher->messageID;
+    queryResp.payload = result;
+    routeMessage(std::move(queryResp));
+}
+
 void CoreBroker::processQueryResponse(const ActionMessage& m)
 {
     if (m.counter == general_query) {
-        activeQueries.setDelayedValue(m.messageID, m.payload);
+        if (m.messageID < 0) {
+            processSubscriptionResult(m);
+            return;
+        }
+        setQueryResult(m.messageID, m.payload);
+        return;
+    }
+    if (m.counter == watched_query) {
+        sendQueryWatcherResult(m.messageID, m.payload);
         return;
     }
     if (isValidIndex(m.counter, mapBuilders)) {
         auto& builder = std::get<0>(mapBuilders[m.counter]);
         auto& requestors = std::get<1>(mapBuilders[m.counter]);
+        if (!std::get<2>(mapBuilders[m.counter]) && isValidIndex(m.counter, mapCache)) {
+            mapCache[m.counter].children[global_broker_id(m.source_id)] = m.payload;
+        }
         if (builder.addComponent(m.payload, m.messageID)) {
-            auto str = builder.generate();
+            auto str = completeMapQuery(m.counter);
+            if (requestors.empty()) {
+                return;
+            }
             for (int ii = 0; ii < static_cast<int>(requestors.size()) - 1; ++ii) {
                 if (requestors[ii].dest_id == global_broker_id_local) {
-                    activeQueries.setDelayedValue(requestors[ii].messageID, str);
+                    setLocalQueryResult(requestors[ii], str);
                 } else {
                     requestors[ii].payload = str;
                     routeMessage(std::move(requestors[ii]));
@@ -2837,20 +4121,136 @@ void CoreBroker::processQueryResponse(const ActionMessage& m)
             }
             if (requestors.back().dest_id == global_broker_id_local) {
                 // TODO(PT) add rvalue reference method
-                activeQueries.setDelayedValue(requestors.back().messageID, str);
+                setLocalQueryResult(requestors.back(), str);
             } else {
                 requestors.back().payload = std::move(str);
                 routeMessage(std::move(requestors.back()));
             }
 
             requestors.clear();
-            if (std::get<2>(mapBuilders[m.counter])) {
-                builder.reset();
-            }
         }
     }
 }
 
+std::string CoreBroker::completeMapQuery(std::uint16_t index)
+{
+    auto& builder = std::get<0>(mapBuilders[index]);
+    auto& cache = mapCache[index];
+    auto listType = interfaceListType(index);
+    cache.result = (listType == handle_type::unknown) ?
+        builder.generate() :
+        generateOwnedInterfaceList(listType, builder.getJValue());
+    cache.generated = std::chrono::steady_clock::now();
+    // a change during the build means parts of the result may already be out of date
+    cache.valid = (cache.version == structureVersion) || std::get<2>(mapBuilders[index]);
+    if (std::get<2>(mapBuilders[index])) {
+        builder.reset();
+    }
+    return cache.result;
+}
+
+bool CoreBroker::isMapCacheValid(std::uint16_t index, bool timeBased) const
+{
+    if (!isValidIndex(index, mapCache) || !mapCache[index].valid) {
+        return false;
+    }
+    if (!timeBased) {
+        return true;
+    }
+    if (globalTimeCachePeriod <= timeZero) {
+        return false;
+    }
+    auto age = std::chrono::steady_clock::now() - mapCache[index].generated;
+    return (age <= globalTimeCachePeriod.to_ns());
+}
+
+void CoreBroker::invalidateQueryCache(global_broker_id child)
+{
+    ++structureVersion;
+    for (auto& cache : mapCache) {
+        cache.valid = false;
+        if (child.isValid()) {
+            cache.children.erase(child);
+        } else {
+            cache.children.clear();
+        }
+    }
+    if (parentHasQueryResults && !isRootc) {
+        // only one notice is needed until the parent asks for new results
+        parentHasQueryResults = false;
+        ActionMessage update(CMD_QUERY_UPDATE);
+        update.source_id = global_broker_id_local;
+        update.dest_id = higher_broker_id;
+        transmit(parent_route_id, update);
+    }
+}
+
+void CoreBroker::checkQueryCache(const ActionMessage& command)
+{
+    if (!isStructureCommand(command)) {
+        return;
+    }
+    auto childOf = [this](global_federate_id fedid) {
+        auto fed = _federates.find(fedid);
+        return (fed != _federates.end()) ? fed->parent : global_broker_id{};
+    };
+    auto sourceChild = childOf(command.source_id);
+    auto destChild = childOf(command.dest_id);
+    if (!sourceChild.isValid() || !destChild.isValid()) {
+        // registrations and changes involving this broker affect everything
+        invalidateQueryCache(global_broker_id{});
+        return;
+    }
+    invalidateQueryCache(sourceChild);
+    if (destChild != sourceChild) {
+        invalidateQueryCache(destChild);
+    }
+}
+
+void CoreBroker::checkQueryWatchers(const ActionMessage& command)
+{
+    if (!isTimingCommand(command) && !isStructureCommand(command) &&
+        command.action() != CMD_QUERY_UPDATE && command.action() != CMD_INIT_GRANT) {
+        return;
+    }
+    if (parentWatchesState && !isRootc) {
+        // the parent asks again for the results so one notice is enough
+        parentWatchesState = false;
+        ActionMessage update(CMD_QUERY_UPDATE);
+        setActionFlag(update, indicator_flag);
+        update.source_id = global_broker_id_local;
+        update.dest_id = higher_broker_id;
+        transmit(parent_route_id, update);
+    }
+    if (queryWatchers.empty()) {
+        return;
+    }
+    queryWatchers.stateChanged(global_federate_id{});
+}
+
+std::string CoreBroker::generateQueryCacheStatus() const
+{
+    Json::Value base;
+    base["name"] = getIdentifier();
+    base["version"] = static_cast<Json::UInt64>(structureVersion);
+    base["caches"] = Json::objectValue;
+    auto now = std::chrono::steady_clock::now();
+    for (const auto& mi : mapIndex) {
+        auto index = mi.second.first;
+        if (!isValidIndex(index, mapCache) || mapCache[index].result.empty()) {
+            continue;
+        }
+        const auto& cache = mapCache[index];
+        Json::Value cacheInfo;
+        cacheInfo["valid"] = isMapCacheValid(index, mi.second.second);
+        cacheInfo["version"] = static_cast<Json::UInt64>(cache.version);
+        cacheInfo["age"] = std::chrono::duration<double>(now - cache.generated).count();
+        cacheInfo["cached_children"] = static_cast<int>(cache.children.size());
+        base["caches"][mi.first] = std::move(cacheInfo);
+    }
+    return generateJsonString(base);
+}
+
 void CoreBroker::checkDependencies()
 {
     if (isRootc) {
@@ -2858,6 +4258,7 @@ void CoreBroker::checkDependencies()
             auto depfed = _federates.find(newdep.first);
             if (depfed != _federates.end()) {
                 ActionMessage addDep(CMD_ADD_DEPENDENCY, newdep.second, depfed->global_id);
+                addDirectDependency(addDep.source_id, addDep.dest_id);
                 routeMessage(addDep);
                 addDep = ActionMessage(CMD_ADD_DEPENDENT, depfed->global_id, newdep.second);
                 routeMessage(addDep);
@@ -2906,6 +4307,10 @@ void CoreBroker::checkDependencies()
         if (timeCoord->getDependents().size() > 2) {
             return;
         }
+        // an aggregating broker was placed in the dependency chain deliberately
+        if (aggregateTime) {
+            return;
+        }
 
         global_federate_id fedid;
         int localcnt = 0;
@@ -2963,6 +4368,10 @@ bool CoreBroker::allInitReady() const
     if (static_cast<decltype(minBrokerCount)>(_brokers.size()) < minBrokerCount) {
         return false;
     }
+    if (!interfaceProbes.empty()) {
+        // the owning brokers have not answered all the lookups yet
+        return false;
+    }
     return getAllConnectionState() >= connection_state::init_requested;
     // return std::all_of(_brokers.begin(), _brokers.end(), [](const auto& brk) {
     //   return ((brk._nonLocal) || (brk.state==connection_state::init_requested));
@@ -12,6 +12,9 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "Broker.hpp"
 #include "BrokerBase.hpp"
 #include "HandleManager.hpp"
+#include "InterfaceDirectory.hpp"
+#include "InterfaceNameIndex.hpp"
+#include "QuerySubscriptions.hpp"
 #include "TimeDependencies.hpp"
 #include "UnknownHandleManager.hpp"
 #include "federate_id_extra.hpp"
@@ -24,9 +27,12 @@ SPDX-License-Identifier: BSD-3-Clause
 
 #include <array>
 #include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <thread>
 #include <tuple>
@@ -77,10 +83,32 @@ class BasicBrokerInfo {
     bool _sent_disconnect_ack{false};  //!< indicator that the disconnect ack has been sent
     bool _disable_ping{false};  //!< indicator that the broker doesn't respond to pings
     // 1 byte gap
+    bool _interface_directory{false};  //!< indicator that the broker owns its subtree interfaces
+    /// the number of publications, inputs, endpoints, and filters an owning broker holds
+    std::array<int32_t, 4> interfaceCounts{{0, 0, 0, 0}};
     std::string routeInfo;  //!< string describing the connection information for the route
     explicit BasicBrokerInfo(const std::string& brokerName): name(brokerName) {}
 };
 
+/** cached result of a federation wide map query
+@details the sub-results from each child broker or core are kept so only the children which
+reported a change need to be queried again*/
+class MapQueryCache {
+  public:
+    std::string result;  //!< the last complete result
+    std::map<global_broker_id, std::string> children;  //!< the latest sub-result of each child
+    std::chrono::steady_clock::time_point generated;  //!< the time the result was completed
+    std::uint64_t version{0};  //!< the structure version the result was built from
+    bool valid{false};  //!< indicator that the result matches the current structure
+};
+
+/** outstanding lookup of an interface name at the brokers owning their subtree interfaces*/
+class InterfaceProbe {
+  public:
+    std::vector<global_broker_id> owners;  //!< the owning brokers which have not answered yet
+    std::vector<ActionMessage> messages;  //!< messages waiting for the endpoint to be located
+};
+
 class TimeCoordinator;
 class Logger;
 class TimeoutMonitor;
@@ -96,6 +124,13 @@ class CoreBroker: public Broker, public BrokerBase {
     std::atomic<bool> _isRoot{false};  //!< set to true if this object is a root broker
     bool isRootc{false};
     bool connectionEstablished{false};  //!< the setup has been received by the core loop thread
+    bool aggregateTime{false};  //!< act as a single time dependency for the federates below it
+    bool hasTimeAggregators{false};  //!< (root only) some brokers below aggregate time
+    bool ownInterfaces{false};  //!< resolve the interfaces below this broker for the root
+    bool hasInterfaceOwners{false};  //!< (root only) some child brokers own their interfaces
+    bool parentHasQueryResults{false};  //!< the parent may have cached query results from us
+    bool parentWatchesState{false};  //!< the parent holds a query subscription using our results
+    bool watchedQueryActive{false};  //!< the query being answered belongs to a query subscription
     int routeCount = 1;  //!< counter for creating new routes;
     gmlc::containers::DualMappedVector<BasicFedInfo, std::string, global_federate_id>
         _federates;  //!< container for all federates
@@ -106,8 +141,25 @@ class CoreBroker: public Broker, public BrokerBase {
 
     HandleManager handles;  //!< structure for managing handles and search operations on handles
     UnknownHandleManager unknownHandles;  //!< structure containing unknown targeted handles
+    /// the owners of interfaces found by earlier lookups which went through an owning broker
+    InterfaceDirectory interfaceDirectory;
+    /// (root and owning brokers) the names of the locally registered interfaces and the standing
+    /// target patterns, only filled while there are standing patterns
+    InterfaceNameIndex interfaceNames;
+    std::map<int32_t, ActionMessage> targetPatterns;  //!< (root and owning brokers) pattern target
+                                                      //!< requests indexed by their pattern id
+    /// (root only) the lookups waiting on an answer from the owning brokers
+    std::map<std::pair<handle_type, std::string>, InterfaceProbe> interfaceProbes;
+    /// (root only) time messages held behind messages waiting on an owning broker by route
+    std::map<route_id, std::vector<ActionMessage>> heldTimeMessages;
+    int32_t nextPatternId{0};  //!< the identifier for the next target pattern
     std::vector<std::pair<std::string, global_federate_id>>
         delayedDependencies;  //!< set of dependencies that need to be created on init
+    /// (root only) the {dependency, dependent} federate pairs linked directly by a filter or an
+    /// explicit dependency, the time aggregation must not remove these
+    std::set<std::pair<global_federate_id, global_federate_id>> directDependencies;
+    /// (root only) the time aggregating brokers above each federate behind one, nearest first
+    std::unordered_map<global_federate_id, std::vector<global_federate_id>> timeAggregators;
     std::unordered_map<global_federate_id, local_federate_id>
         global_id_translation;  //!< map to translate global ids to local ones
     std::unordered_map<global_federate_id, route_id>
@@ -121,6 +173,15 @@ class CoreBroker: public Broker, public BrokerBase {
     gmlc::concurrency::DelayedObjects<std::string> activeQueries;  //!< holder for active queries
     /// holder for the query map builder information
     std::vector<std::tuple<JsonMapBuilder, std::vector<ActionMessage>, bool>> mapBuilders;
+    /// cached results of the map queries
+    std::vector<MapQueryCache> mapCache;
+    /// the query subscriptions made by the broker with results pushed to a callback
+    QuerySubscriptions querySubscriptions{
+        [this](ActionMessage&& cmd) { addActionMessage(std::move(cmd)); }};
+    /// the query subscriptions answered by the broker
+    QueryWatchers queryWatchers{[this](ActionMessage&& cmd) { addActionMessage(std::move(cmd)); }};
+    std::uint64_t structureVersion{0};  //!< counter for changes in the federation structure
+    Time globalTimeCachePeriod{timeZero};  //!< the maximum age of a cached global_time result
 
     std::vector<ActionMessage> earlyMessages;  //!< list of messages that came before connection
     gmlc::concurrency::TriggerVariable disconnection;  //!< controller for the disconnection process
@@ -280,6 +341,12 @@ class CoreBroker: public Broker, public BrokerBase {
     virtual void setLogFile(const std::string& lfile) override final;
     virtual std::string query(const std::string& target,
                               const std::string& queryStr) override final;
+    virtual int32_t subscribeQuery(const std::string& target,
+                                   const std::string& queryStr,
+                                   std::function<void(const std::string&)> callback,
+                                   std::chrono::milliseconds period,
+                                   bool everyPeriod = false) override final;
+    virtual void unsubscribeQuery(int32_t subscriptionId) override final;
     virtual void setGlobal(const std::string& valueName, const std::string& value) override final;
     virtual void makeConnections(const std::string& file) override final;
     virtual void dataLink(const std::string& publication, const std::string& input) override final;
@@ -302,6 +369,15 @@ class CoreBroker: public Broker, public BrokerBase {
 
     void FindandNotifyFilterTargets(BasicHandleInfo& handleInfo);
     void FindandNotifyEndpointTargets(BasicHandleInfo& handleInfo);
+    /** add this broker to the time aggregators of a federate registration passing through it*/
+    void markTimeAggregation(ActionMessage& command) const;
+    /** get the time aggregating brokers above a federate, nearest first*/
+    std::vector<global_federate_id> getTimeAggregators(global_federate_id fedid) const;
+    /** route the time dependency created by a publication to input link through the time
+    aggregating brokers of the two federates*/
+    void insertTimeAggregators(global_federate_id pubFed, global_federate_id inputFed);
+    /** record a direct dependency between two federates which does not come from a value link*/
+    void addDirectDependency(global_federate_id dependency, global_federate_id dependent);
     /** process a disconnect message*/
     void processDisconnect(ActionMessage& command);
     /** process an error message*/
@@ -312,13 +388,92 @@ class CoreBroker: public Broker, public BrokerBase {
     void markAsDisconnected(global_broker_id brkid);
     /** run a check for a named interface*/
     void checkForNamedInterface(ActionMessage& command);
+    /** get the interface owning broker a federate is behind or an invalid id if there is none*/
+    global_broker_id getInterfaceOwner(global_federate_id fedid);
+    /** check if the broker resolves the interfaces of its subtree in place of the root*/
+    bool ownsSubtreeInterfaces() const;
+    /** check if registrations and lookups are resolved by this broker (root or owning broker)*/
+    bool resolvesInterfaces() const;
+    /** check if an owning broker should hold the lookups its subtree could not resolve yet*/
+    bool holdsSubtreeLookups() const;
+    /** store a named lookup which could not be resolved*/
+    void addUnknownInterface(ActionMessage& command);
+    /** store a link between two named interfaces which could not be resolved*/
+    void addUnknownLink(const ActionMessage& command);
+    /** route, store, or forward a link for which the interface named by the link is unknown
+    @param type the type of the interface named by the link
+    @param owner the owning broker of the interface from the directory if known*/
+    void routeUnknownLink(ActionMessage& command, handle_type type, global_broker_id owner);
+    /** forward a named lookup to the broker owning the interface and tell the sub-broker the
+    request came through where the interface is*/
+    void routeToInterfaceOwner(ActionMessage& command, handle_type type, global_broker_id owner);
+    /** forward the pending lookups for an interface just added to the directory
+    @return true if anything was sent to the owner*/
+    bool notifyInterfaceOwner(handle_type type, const std::string& name, global_broker_id owner);
+    /** send the lookups and links the subtree of an owning broker could not resolve to the root*/
+    void sendSubtreeLookups();
+    /** send the interface counts of an owning broker to the root*/
+    void sendInterfaceSummary();
+    /** ask all the ready owning brokers if they hold an interface
+    @return the number of brokers asked*/
+    int probeInterfaceOwners(handle_type type, const std::string& name, global_broker_id skip);
+    /** ask an owning broker which just became ready about all the unknown interfaces*/
+    void probeInterfaceOwner(global_broker_id owner);
+    /** ask an owning broker if it holds an interface*/
+    void sendInterfaceProbe(handle_type type, const std::string& name, global_broker_id owner);
+    /** hold the initialization until the messages sent to an owning broker have been processed*/
+    void syncInterfaceOwner(global_broker_id owner);
+    /** answer the root if this broker holds an interface*/
+    void answerInterfaceProbe(const ActionMessage& command);
+    /** process the answer of an owning broker to a probe*/
+    void processInterfaceLocation(ActionMessage& command);
+    /** remove a disconnected owning broker from the outstanding probes*/
+    void removeInterfaceProbes(global_broker_id owner);
+    /** check if a message from a route is held until the owning brokers answer*/
+    bool isHeldRoute(route_id rid) const;
+    /** hold a time message from a route with held messages so it keeps its order
+    @return true if the message was held*/
+    bool holdTimeMessage(ActionMessage& command);
+    /** release the held time messages and enter initialization if the federation was only
+    waiting on probe answers*/
+    void checkInterfaceProbes();
+    /** hold a message for an unknown interface until the owning brokers answered*/
+    void holdForInterfaceOwner(ActionMessage& command, handle_type type, const std::string& name);
+    /** log the messages dropped for an interface no owning broker holds*/
+    void dropHeldMessages(const std::string& name, const InterfaceProbe& probe);
+    /** attach the type information from a local source interface to a lookup sent upward*/
+    void addSourceInterfaceInfo(ActionMessage& command) const;
     /** remove a named target from an interface*/
     void removeNamedTarget(ActionMessage& command);
+    /** store a target pattern as a standing request and connect the interfaces matching it*/
+    void addTargetPattern(ActionMessage& command);
+    /** send a target pattern to an owning broker to match against the interfaces below it*/
+    void forwardTargetPattern(const ActionMessage& pattern, global_broker_id owner);
+    /** add a new interface to the name index and connect it to any matching target patterns*/
+    void matchTargetPatterns(handle_type type, const std::string& name);
+    /** drop the target patterns requested by a federate*/
+    void clearTargetPatterns(global_federate_id fedid);
+    /** add the names of all the locally registered interfaces to the name index*/
+    void loadInterfaceNames();
     /** answer a query or route the message the appropriate location*/
     void processQuery(ActionMessage& m);
 
     /** answer a query or route the message the appropriate location*/
     void processQueryResponse(const ActionMessage& m);
+    /** deliver the result of a query to a waiting local request or a query subscription*/
+    void setQueryResult(int32_t index, const std::string& result);
+    /** register a query subscription with the core, broker, or federate answering it*/
+    void processQuerySubscription(int32_t index);
+    /** deliver a query result from a watcher to the query subscription it belongs to*/
+    void processSubscriptionResult(const ActionMessage& m);
+    /** remove a query subscription from the core or broker sending its results*/
+    void sendQueryUnsubscribe(global_federate_id source, int32_t messageID);
+    /** answer the query of a query subscription held by this broker*/
+    void processQueryWatcher(int32_t index);
+    /** send the result of a query subscription held by this broker to the subscriber*/
+    void sendQueryWatcherResult(int32_t index, const std::string& result);
+    /** deliver a completed map query to a local requestor*/
+    void setLocalQueryResult(const ActionMessage& requestor, const std::string& result);
     /** generate an answer to a local query*/
     void processLocalQuery(const ActionMessage& m);
     /** generate an actual response string to a query*/
@@ -343,6 +498,22 @@ class CoreBroker: public Broker, public BrokerBase {
     //   bool updateSourceFilterOperator (ActionMessage &m);
     /** generate a JSON string containing one of the data Maps*/
     void initializeMapBuilder(const std::string& request, std::uint16_t index, bool reset);
+    /** generate the answer to a query built from the sub-results of the child brokers*/
+    std::string generateMapQuery(const std::string& request, std::uint16_t index, bool timeBased);
+    /** finish a map query and store the result in the cache
+    @return the generated result*/
+    std::string completeMapQuery(std::uint16_t index);
+    /** check if the cached result of a map query can be used*/
+    bool isMapCacheValid(std::uint16_t index, bool timeBased) const;
+    /** mark cached query results as out of date after a change in the federation structure
+    @param child the child broker or core with a changed sub-result, invalid for all children*/
+    void invalidateQueryCache(global_broker_id child);
+    /** invalidate the cached query results affected by a command*/
+    void checkQueryCache(const ActionMessage& command);
+    /** notify the query subscriptions held by the broker of a change in state*/
+    void checkQueryWatchers(const ActionMessage& command);
+    /** generate a JSON string describing the state of the query cache*/
+    std::string generateQueryCacheStatus() const;
 
     /** send an error code to all direct cores*/
     void sendErrorToImmediateBrokers(int error_code);
@@ -350,6 +521,13 @@ class CoreBroker: public Broker, public BrokerBase {
     void sendDisconnect();
     /** generate a string about the federation summarizing connections*/
     std::string generateFederationSummary() const;
+    /** get the names of the interfaces of a type registered with the broker*/
+    std::vector<std::string> getInterfaceNames(handle_type type) const;
+    /** generate the list of interface names of a type registered with the broker*/
+    std::string generateInterfaceList(handle_type type) const;
+    /** generate the list of interface names of a type including the names reported by the owning
+    brokers in a map query result*/
+    std::string generateOwnedInterfaceList(handle_type type, const Json::Value& owned) const;
     /** label the broker and all children as disconnected*/
     void labelAsDisconnected(global_broker_id brkid);
 
@@ -6,6 +6,7 @@ SPDX-License-Identifier: BSD-3-Clause
 */
 #include "FederateState.hpp"
 
+#include "../common/BinaryLogger.hpp"
 #include "../common/JsonProcessingFunctions.hpp"
 #include "CommonCore.hpp"
 #include "CoreFederateInfo.hpp"
@@ -93,6 +94,56 @@ static const std::string emptyStr;
 #    define LOG_TRACE(message) ((void)0)
 #endif  // LOGGING_DISABLED
 
+// the deferred versions record the raw arguments if a binary logger is active
+#define LOG_DEFERRED(level, fmtString, ...)                                                        \
+    do {                                                                                           \
+        if (logLevel >= (level)) {                                                                 \
+            if (binaryLogger != nullptr) {                                                         \
+                static const auto binaryFormatId = BinaryLogger::registerFormat(fmtString);        \
+                binaryLogger->record(                                                              \
+                    level, global_id.load().baseValue(), binaryFormatId, __VA_ARGS__);             \
+            } else {                                                                               \
+                logMessage(level, emptyStr, fmt::format(fmtString, __VA_ARGS__));                  \
+            }                                                                                      \
+        }                                                                                          \
+    } while (false)
+
+// the command is recorded as its action type in a binary log and with prettyPrintString otherwise
+#define LOG_DEFERRED_COMMAND(level, fmtString, command, ...)                                       \
+    do {                                                                                           \
+        if (logLevel >= (level)) {                                                                 \
+            if (binaryLogger != nullptr) {                                                         \
+                static const auto binaryFormatId = BinaryLogger::registerFormat(fmtString);        \
+                binaryLogger->record(level,                                                        \
+                                     global_id.load().baseValue(),                                 \
+                                     binaryFormatId,                                               \
+                                     actionMessageType((command).action()),                        \
+                                     __VA_ARGS__);                                                 \
+            } else {                                                                               \
+                logMessage(level,                                                                  \
+                           emptyStr,                                                               \
+                           fmt::format(fmtString, prettyPrintString(command), __VA_ARGS__));       \
+            }                                                                                      \
+        }                                                                                          \
+    } while (false)
+
+#if defined(HELICS_ENABLE_LOGGING) && defined(HELICS_ENABLE_DEBUG_LOGGING)
+#    define LOG_TIMING_DEFERRED(fmtString, ...)                                                    \
+        LOG_DEFERRED(helics_log_level_timing, fmtString, __VA_ARGS__)
+#else
+#    define LOG_TIMING_DEFERRED(fmtString, ...) ((void)0)
+#endif
+
+#if defined(HELICS_ENABLE_LOGGING) && defined(HELICS_ENABLE_TRACE_LOGGING)
+#    define LOG_TRACE_DEFERRED(fmtString, ...)                                                     \
+        LOG_DEFERRED(helics_log_level_trace, fmtString, __VA_ARGS__)
+#    define LOG_TRACE_DEFERRED_COMMAND(fmtString, command, ...)                                    \
+        LOG_DEFERRED_COMMAND(helics_log_level_trace, fmtString, command, __VA_ARGS__)
+#else
+#    define LOG_TRACE_DEFERRED(fmtString, ...) ((void)0)
+#    define LOG_TRACE_DEFERRED_COMMAND(fmtString, command, ...) ((void)0)
+#endif
+
 using namespace std::chrono_literals;  // NOLINT
 
 namespace helics {
@@ -123,6 +174,11 @@ void FederateState::setState(federate_state newState)
     switch (newState) {
         case HELICS_ERROR:
         case HELICS_FINISHED:
+            state = newState;
+            // values waiting in the queue will not be processed anymore, and addDirectValue
+            // checks the state under the same lock so no later value can be left behind
+            directValues.lock()->clear();
+            break;
         case HELICS_CREATED:
         case HELICS_TERMINATING:
             state = newState;
@@ -277,6 +333,9 @@ void FederateState::addAction(const ActionMessage& action)
 {
     if (action.action() != CMD_IGNORE) {
         queue.push(action);
+        if (isCallbackFederate() && !callbackScheduled.exchange(true)) {
+            parent_->scheduleCallbackFederate(this);
+        }
     }
 }
 
@@ -284,6 +343,9 @@ void FederateState::addAction(ActionMessage&& action)
 {
     if (action.action() != CMD_IGNORE) {
         queue.push(std::move(action));
+        if (isCallbackFederate() && !callbackScheduled.exchange(true)) {
+            parent_->scheduleCallbackFederate(this);
+        }
     }
 }
 
@@ -372,8 +434,7 @@ void FederateState::closeInterface(interface_handle handle, handle_type type)
                     rem.setDestination(pub);
                     routeMessage(rem);
                 }
-                ipt->input_sources.clear();
-                ipt->clearFutureData();
+                ipt->clearSources();
             }
         } break;
         default:
@@ -449,44 +510,10 @@ iteration_result FederateState::enterInitializingMode()
 iteration_result FederateState::enterExecutingMode(iteration_request iterate)
 {
     if (try_lock()) {  // only enter this loop once per federate
-        // timeCoord->enteringExecMode (iterate);
-        ActionMessage exec(CMD_EXEC_REQUEST);
-        exec.source_id = global_id.load();
-        setIterationFlags(exec, iterate);
-
-        addAction(exec);
-
+        startExecRequest(iterate);
         auto ret = processQueue();
-        if (ret == message_processing_result::next_step) {
-            time_granted = timeZero;
-            allowed_send_time = timeCoord->allowedSendTime();
-        }
-        switch (iterate) {
-            case iteration_request::force_iteration:
-                fillEventVectorNextIteration(time_granted);
-                break;
-            case iteration_request::iterate_if_needed:
-                if (ret == message_processing_result::next_step) {
-                    fillEventVectorUpTo(time_granted);
-                } else {
-                    fillEventVectorNextIteration(time_granted);
-                }
-                break;
-            case iteration_request::no_iterations:
-                fillEventVectorUpTo(time_granted);
-                break;
-        }
-
+        completeExecRequest(ret, iterate);
         unlock();
-#ifndef HELICS_DISABLE_ASIO
-        if ((realtime) && (ret == message_processing_result::next_step)) {
-            if (!mTimer) {
-                mTimer = std::make_shared<MessageTimer>(
-                    [this](ActionMessage&& mess) { return this->addAction(std::move(mess)); });
-            }
-            start_clock_time = std::chrono::steady_clock::now();
-        }
-#endif
         return static_cast<iteration_result>(ret);
     }
     // the following code is for situation which this has been called multiple times, which really
@@ -512,6 +539,48 @@ iteration_result FederateState::enterExecutingMode(iteration_request iterate)
     return ret;
 }
 
+void FederateState::startExecRequest(iteration_request iterate)
+{
+    // timeCoord->enteringExecMode (iterate);
+    ActionMessage exec(CMD_EXEC_REQUEST);
+    exec.source_id = global_id.load();
+    setIterationFlags(exec, iterate);
+
+    addAction(exec);
+}
+
+void FederateState::completeExecRequest(message_processing_result ret, iteration_request iterate)
+{
+    if (ret == message_processing_result::next_step) {
+        time_granted = timeZero;
+        allowed_send_time = timeCoord->allowedSendTime();
+    }
+    switch (iterate) {
+        case iteration_request::force_iteration:
+            fillEventVectorNextIteration(time_granted);
+            break;
+        case iteration_request::iterate_if_needed:
+            if (ret == message_processing_result::next_step) {
+                fillEventVectorUpTo(time_granted);
+            } else {
+                fillEventVectorNextIteration(time_granted);
+            }
+            break;
+        case iteration_request::no_iterations:
+            fillEventVectorUpTo(time_granted);
+            break;
+    }
+    if ((realtime) && (ret == message_processing_result::next_step)) {
+#ifndef HELICS_DISABLE_ASIO
+        if (!mTimer) {
+            mTimer = std::make_shared<MessageTimer>(
+                [this](ActionMessage&& mess) { return this->addAction(std::move(mess)); });
+        }
+#endif
+        pacer.start();
+    }
+}
+
 std::vector<global_handle> FederateState::getSubscribers(interface_handle handle)
 {
     std::lock_guard<FederateState> fedlock(*this);
@@ -522,91 +591,25 @@ std::vector<global_handle> FederateState::getSubscribers(interface_handle handle
     return {};
 }
 
+int32_t FederateState::addDirectValue(std::shared_ptr<const data_block> value)
+{
+    auto values = directValues.lock();
+    if (state == HELICS_FINISHED || state == HELICS_ERROR) {
+        return -1;
+    }
+    // keys stay non-negative when the counter wraps
+    auto key = directValueCounter++ & 0x7FFFFFFF;
+    values->emplace(key, std::move(value));
+    return key;
+}
+
 iteration_time FederateState::requestTime(Time nextTime, iteration_request iterate)
 {
     if (try_lock()) {  // only enter this loop once per federate
         Time lastTime = timeCoord->getGrantedTime();
-        events.clear();  // clear the event queue
-        LOG_TRACE(timeCoord->printTimeStatus());
-        // timeCoord->timeRequest (nextTime, iterate, nextValueTime (), nextMessageTime ());
-
-        ActionMessage treq(CMD_TIME_REQUEST);
-        treq.source_id = global_id.load();
-        treq.actionTime = nextTime;
-        setIterationFlags(treq, iterate);
-        addAction(treq);
-        LOG_TRACE(timeCoord->printTimeStatus());
-// timeCoord->timeRequest (nextTime, iterate, nextValueTime (), nextMessageTime ());
-#ifndef HELICS_DISABLE_ASIO
-        if ((realtime) && (rt_lag < Time::maxVal())) {
-            auto current_clock_time = std::chrono::steady_clock::now();
-            auto timegap = current_clock_time - start_clock_time;
-            auto current_lead = (nextTime + rt_lag).to_ns() - timegap;
-            if (current_lead > std::chrono::milliseconds(0)) {
-                ActionMessage tforce(CMD_FORCE_TIME_GRANT);
-                tforce.source_id = global_id.load();
-                tforce.actionTime = nextTime;
-                if (realTimeTimerIndex < 0) {
-                    realTimeTimerIndex =
-                        mTimer->addTimer(current_clock_time + current_lead, std::move(tforce));
-                } else {
-                    mTimer->updateTimer(realTimeTimerIndex,
-                                        current_clock_time + current_lead,
-                                        std::move(tforce));
-                }
-            } else {
-                ActionMessage tforce(CMD_FORCE_TIME_GRANT);
-                tforce.source_id = global_id.load();
-                tforce.actionTime = nextTime;
-                addAction(tforce);
-            }
-        }
-#endif
+        startTimeRequest(nextTime, iterate);
         auto ret = processQueue();
-        time_granted = timeCoord->getGrantedTime();
-        allowed_send_time = timeCoord->allowedSendTime();
-        iterating = (ret == message_processing_result::iterating);
-
-        iteration_time retTime = {time_granted, static_cast<iteration_result>(ret)};
-        // now fill the event vector so external systems know what has been updated
-        switch (iterate) {
-            case iteration_request::force_iteration:
-                fillEventVectorNextIteration(time_granted);
-                break;
-            case iteration_request::iterate_if_needed:
-                if (time_granted < nextTime) {
-                    fillEventVectorNextIteration(time_granted);
-                } else {
-                    fillEventVectorUpTo(time_granted);
-                }
-                break;
-            case iteration_request::no_iterations:
-                if (time_granted < nextTime) {
-                    fillEventVectorInclusive(time_granted);
-                } else {
-                    fillEventVectorUpTo(time_granted);
-                }
-
-                break;
-        }
-#ifndef HELICS_DISABLE_ASIO
-        if (realtime) {
-            if (rt_lag < Time::maxVal()) {
-                mTimer->cancelTimer(realTimeTimerIndex);
-            }
-            if (ret == message_processing_result::next_step) {
-                auto current_clock_time = std::chrono::steady_clock::now();
-                auto timegap = current_clock_time - start_clock_time;
-                if (time_granted - Time(timegap) > rt_lead) {
-                    auto current_lead = (time_granted - rt_lead).to_ns() - timegap;
-                    if (current_lead > std::chrono::milliseconds(5)) {
-                        std::this_thread::sleep_for(current_lead);
-                    }
-                }
-            }
-        }
-#endif
-
+        auto retTime = completeTimeRequest(ret, nextTime, iterate);
         unlock();
         if ((retTime.grantedTime > nextTime) && (nextTime > lastTime)) {
             if (!ignore_time_mismatch_warnings) {
@@ -631,6 +634,94 @@ iteration_time FederateState::requestTime(Time nextTime, iteration_request itera
     return retTime;
 }
 
+void FederateState::startTimeRequest(Time nextTime, iteration_request iterate)
+{
+    events.clear();  // clear the event queue
+    LOG_TRACE(timeCoord->printTimeStatus());
+    // timeCoord->timeRequest (nextTime, iterate, nextValueTime (), nextMessageTime ());
+
+    ActionMessage treq(CMD_TIME_REQUEST);
+    treq.source_id = global_id.load();
+    treq.actionTime = nextTime;
+    setIterationFlags(treq, iterate);
+    addAction(treq);
+    LOG_TRACE(timeCoord->printTimeStatus());
+// timeCoord->timeRequest (nextTime, iterate, nextValueTime (), nextMessageTime ());
+#ifndef HELICS_DISABLE_ASIO
+    if ((realtime) && (rt_lag < Time::maxVal())) {
+        auto current_clock_time = std::chrono::steady_clock::now();
+        auto timegap = pacer.elapsed(current_clock_time);
+        auto current_lead = (nextTime + rt_lag).to_ns() - timegap;
+        if (current_lead > std::chrono::milliseconds(0)) {
+            ActionMessage tforce(CMD_FORCE_TIME_GRANT);
+            tforce.source_id = global_id.load();
+            tforce.actionTime = nextTime;
+            if (realTimeTimerIndex < 0) {
+                realTimeTimerIndex =
+                    mTimer->addTimer(current_clock_time + current_lead, std::move(tforce));
+            } else {
+                mTimer->updateTimer(realTimeTimerIndex,
+                                    current_clock_time + current_lead,
+                                    std::move(tforce));
+            }
+        } else {
+            ActionMessage tforce(CMD_FORCE_TIME_GRANT);
+            tforce.source_id = global_id.load();
+            tforce.actionTime = nextTime;
+            addAction(tforce);
+        }
+    }
+#endif
+}
+
+iteration_time FederateState::completeTimeRequest(message_processing_result ret,
+                                                  Time nextTime,
+                                                  iteration_request iterate)
+{
+    time_granted = timeCoord->getGrantedTime();
+    allowed_send_time = timeCoord->allowedSendTime();
+    iterating = (ret == message_processing_result::iterating);
+
+    iteration_time retTime = {time_granted, static_cast<iteration_result>(ret)};
+    // now fill the event vector so external systems know what has been updated
+    switch (iterate) {
+        case iteration_request::force_iteration:
+            fillEventVectorNextIteration(time_granted);
+            break;
+        case iteration_request::iterate_if_needed:
+            if (time_granted < nextTime) {
+                fillEventVectorNextIteration(time_granted);
+            } else {
+                fillEventVectorUpTo(time_granted);
+            }
+            break;
+        case iteration_request::no_iterations:
+            if (time_granted < nextTime) {
+                fillEventVectorInclusive(time_granted);
+            } else {
+                fillEventVectorUpTo(time_granted);
+            }
+
+            break;
+    }
+    if (realtime) {
+#ifndef HELICS_DISABLE_ASIO
+        if (rt_lag < Time::maxVal()) {
+            mTimer->cancelTimer(realTimeTimerIndex);
+        }
+#endif
+        if (ret == message_processing_result::next_step) {
+            // hold the grant until the wall clock is within rt_lead of the granted time
+            pacer.waitForTime(time_granted - rt_lead);
+            if (pacer.recordGrant(time_granted, rt_lag)) {
+                LOG_TIMING(fmt::format("realtime deadline missed for grant at {}",
+                                       static_cast<double>(time_granted)));
+            }
+        }
+    }
+    return retTime;
+}
+
 void FederateState::fillEventVectorUpTo(Time currentTime)
 {
     events.clear();
@@ -692,6 +783,166 @@ void FederateState::finalize()
     }
 }
 
+void FederateState::setCallbackOperator(std::shared_ptr<FederateOperator> callbacks)
+{
+    fedCallbacks = std::move(callbacks);
+    callbackStage = callback_stage::initializing;
+    callbackBased.store(true, std::memory_order_release);
+    if (!queue.empty() && !callbackScheduled.exchange(true)) {
+        parent_->scheduleCallbackFederate(this);
+    }
+}
+
+void FederateState::callbackProcessing() noexcept
+{
+    do {
+        while (processCallbackStage()) {
+        }
+        callbackScheduled.store(false);
+        // recheck in case a message arrived after the queue was emptied
+    } while (!queue.empty() && !callbackScheduled.exchange(true));
+}
+
+bool FederateState::processCallbackStage()
+{
+    if (callbackStage == callback_stage::complete) {
+        return false;
+    }
+    std::unique_lock<FederateState> fedlock(*this);
+    auto ret = message_processing_result::error;
+    try {
+        ret = processQueue(false);
+    }
+    catch (const std::exception& e) {
+        errorCode = defs::errors::execution_failure;
+        errorString = std::string("exception processing messages ") + e.what();
+        setState(HELICS_ERROR);
+    }
+    catch (...) {
+        errorCode = defs::errors::execution_failure;
+        errorString = "unknown exception processing messages";
+        setState(HELICS_ERROR);
+    }
+    if (!returnableResult(ret)) {
+        return false;
+    }
+    iteration_time granted{time_granted, static_cast<iteration_result>(ret)};
+    switch (callbackStage) {
+        case callback_stage::initializing:
+            if (ret == message_processing_result::next_step) {
+                time_granted = initialTime;
+                allowed_send_time = initialTime;
+            }
+            break;
+        case callback_stage::executing:
+            completeExecRequest(ret, callbackIterate);
+            granted.grantedTime = time_granted;
+            break;
+        case callback_stage::time_request:
+            granted = completeTimeRequest(ret, callbackRequestTime, callbackIterate);
+            break;
+        default:
+            break;
+    }
+    fedlock.unlock();
+    // the callbacks are always run without holding the federate lock
+    if (callbackStage == callback_stage::finalizing) {
+        if (ret != message_processing_result::halted &&
+            ret != message_processing_result::error) {
+            return true;
+        }
+        callbackStage = callback_stage::complete;
+        try {
+            fedCallbacks->finalize();
+        }
+        catch (const std::exception& e) {
+            LOG_ERROR(std::string("exception in finalize callback ") + e.what());
+        }
+        catch (...) {
+            LOG_ERROR("unknown exception in finalize callback");
+        }
+        return false;
+    }
+    try {
+        switch (ret) {
+            case message_processing_result::next_step:
+                if (callbackStage == callback_stage::initializing) {
+                    callbackExecRequest(fedCallbacks->initializeOperations());
+                } else {
+                    callbackTimeRequest(fedCallbacks->operate(granted));
+                }
+                return true;
+            case message_processing_result::iterating:
+                if (callbackStage == callback_stage::executing) {
+                    callbackExecRequest(fedCallbacks->initializeOperations());
+                } else {
+                    callbackTimeRequest(fedCallbacks->operate(granted));
+                }
+                return true;
+            case message_processing_result::error:
+                callbackError(errorCode, errorString);
+                break;
+            default:
+                break;
+        }
+    }
+    catch (const std::exception& e) {
+        callbackError(defs::errors::execution_failure, e.what());
+    }
+    catch (...) {
+        callbackError(defs::errors::execution_failure, "unknown exception in federate callback");
+    }
+    // the federation halted or the federate errored so move on to finalizing
+    callbackFinalize();
+    return true;
+}
+
+void FederateState::callbackExecRequest(iteration_request iterate)
+{
+    callbackIterate = iterate;
+    callbackStage = callback_stage::executing;
+    // process previously received messages before the request as CommonCore does for users
+    addAction(ActionMessage(CMD_EXEC_CHECK));
+    std::lock_guard<FederateState> fedlock(*this);
+    startExecRequest(iterate);
+}
+
+void FederateState::callbackTimeRequest(std::pair<Time, iteration_request> next)
+{
+    if (next.first == Time::maxVal()) {
+        callbackFinalize();
+        return;
+    }
+    callbackRequestTime = next.first;
+    callbackIterate = next.second;
+    callbackStage = callback_stage::time_request;
+    std::lock_guard<FederateState> fedlock(*this);
+    startTimeRequest(next.first, next.second);
+}
+
+void FederateState::callbackError(int code, const std::string& message) noexcept
+{
+    // this runs on a core thread so nothing from the user code can be allowed to escape
+    try {
+        fedCallbacks->error_handler(code, message);
+    }
+    catch (const std::exception& e) {
+        LOG_ERROR(std::string("exception in error callback ") + e.what());
+    }
+    catch (...) {
+        LOG_ERROR("unknown exception in error callback");
+    }
+}
+
+void FederateState::callbackFinalize()
+{
+    callbackStage = callback_stage::finalizing;
+    ActionMessage bye(CMD_DISCONNECT);
+    bye.source_id = global_id.load();
+    bye.dest_id = bye.source_id;
+    parent_->addActionMessage(std::move(bye));
+}
+
 const std::vector<interface_handle> emptyHandles;
 
 const std::vector<interface_handle>& FederateState::getEvents() const
@@ -765,6 +1016,11 @@ bool FederateState::messageShouldBeDelayed(const ActionMessage& cmd) const
 }
 
 message_processing_result FederateState::processQueue() noexcept
+{
+    return processQueue(true);
+}
+
+message_processing_result FederateState::processQueue(bool waitForMessages) noexcept
 {
     if (state == HELICS_FINISHED) {
         return message_processing_result::halted;
@@ -775,7 +1031,16 @@ message_processing_result FederateState::processQueue() noexcept
     auto ret_code = processDelayQueue();
 
     while (!(returnableResult(ret_code))) {
-        auto cmd = queue.pop();
+        ActionMessage cmd;
+        if (waitForMessages) {
+            cmd = queue.pop();
+        } else {
+            auto next = queue.try_pop();
+            if (!next) {
+                break;
+            }
+            cmd = std::move(*next);
+        }
         if (messageShouldBeDelayed(cmd)) {
             delayQueues[cmd.source_id].push_back(cmd);
             continue;
@@ -810,12 +1075,25 @@ message_processing_result FederateState::processQueue() noexcept
     if (initError) {
         ret_code = message_processing_result::error;
     }
+    if (queryWatched.load() && parent_ != nullptr &&
+        (state != watchedState || time_granted != watchedTime)) {
+        // the core answers query subscriptions on the federate again
+        watchedState = state;
+        watchedTime = time_granted;
+        ActionMessage update(CMD_QUERY_UPDATE);
+        update.source_id = global_id.load();
+        update.dest_id = parent_broker_id;
+        parent_->addActionMessage(std::move(update));
+    }
     return ret_code;
 }
 
 message_processing_result FederateState::processActionMessage(ActionMessage& cmd)
 {
-    LOG_TRACE(fmt::format("processing cmd {}", prettyPrintString(cmd)));
+    LOG_TRACE_DEFERRED_COMMAND("processing cmd {} from {} to {}",
+                               cmd,
+                               cmd.source_id.baseValue(),
+                               cmd.dest_id.baseValue());
     switch (cmd.action()) {
         case CMD_IGNORE:
         default:
@@ -1037,7 +1315,7 @@ message_processing_result FederateState::processActionMessage(ActionMessage& cmd
                 if (returnableResult(ret)) {
                     time_granted = timeCoord->getGrantedTime();
                     allowed_send_time = timeCoord->allowedSendTime();
-                    LOG_TIMING(fmt::format("Granted Time={}", time_granted));
+                    LOG_TIMING_DEFERRED("Granted Time={}", static_cast<double>(time_granted));
                     timeGranted_mode = true;
                     return ret;
                 }
@@ -1065,22 +1343,29 @@ message_processing_result FederateState::processActionMessage(ActionMessage& cmd
             }
         } break;
         case CMD_PUB: {
+            std::shared_ptr<const data_block> value;
+            if (checkActionFlag(cmd, direct_value_flag)) {
+                auto values = directValues.lock();
+                auto fnd = values->find(cmd.messageID);
+                if (fnd == values->end()) {
+                    break;
+                }
+                value = std::move(fnd->second);
+                values->erase(fnd);
+            }
             auto* subI = interfaceInformation.getInput(interface_handle(cmd.dest_handle));
             if (subI == nullptr) {
                 break;
             }
-            for (auto& src : subI->input_sources) {
-                if ((cmd.source_id == src.fed_id) && (cmd.source_handle == src.handle)) {
-                    subI->addData(src,
-                                  cmd.actionTime,
-                                  cmd.counter,
-                                  std::make_shared<const data_block>(std::move(cmd.payload)));
-                    if (!subI->not_interruptible) {
-                        timeCoord->updateValueTime(cmd.actionTime);
-                        LOG_TRACE(timeCoord->printTimeStatus());
-                    }
-                    LOG_DATA(fmt::format("receive publication {}", prettyPrintString(cmd)));
+            if (!value) {
+                value = std::make_shared<const data_block>(std::move(cmd.payload));
+            }
+            if (subI->addData(cmd.getSource(), cmd.actionTime, cmd.counter, std::move(value))) {
+                if (!subI->not_interruptible) {
+                    timeCoord->updateValueTime(cmd.actionTime);
+                    LOG_TRACE(timeCoord->printTimeStatus());
                 }
+                LOG_DATA(fmt::format("receive publication {}", prettyPrintString(cmd)));
             }
         } break;
         case CMD_WARNING:
@@ -1167,6 +1452,12 @@ message_processing_result FederateState::processActionMessage(ActionMessage& cmd
                 timeCoord->processDependencyUpdateMessage(cmd);
             }
 
+            break;
+        case CMD_TIME_COUPLING_PROBE:
+        case CMD_TIME_COUPLING_ACK:
+            if (cmd.dest_id == global_id.load()) {
+                timeCoord->processCouplingMessage(cmd);
+            }
             break;
         case CMD_REMOVE_NAMED_PUBLICATION: {
             auto* subI = interfaceInformation.getInput(cmd.source_handle);
@@ -1731,6 +2022,14 @@ std::string FederateState::processQueryActual(const std::string& query) const
         base["send_time"] = static_cast<double>(timeCoord->allowedSendTime());
         return generateJsonString(base);
     }
+    if (query == "iterations" || query == "global_iterations") {
+        Json::Value base;
+        base["name"] = getIdentifier();
+        base["id"] = global_id.load().baseValue();
+        base["parent"] = parent_->getGlobalId().baseValue();
+        timeCoord->generateIterationStatus(base);
+        return generateJsonString(base);
+    }
     if (query == "dependency_graph") {
         Json::Value base;
         base["name"] = getIdentifier();
@@ -1746,6 +2045,17 @@ std::string FederateState::processQueryActual(const std::string& query) const
         }
         return generateJsonString(base);
     }
+    if (query == "realtime") {
+        Json::Value base;
+        pacer.generateStatus(base);
+        base["name"] = getIdentifier();
+        base["realtime"] = realtime;
+        if (realtime) {
+            base["rt_lag"] = static_cast<double>(rt_lag);
+            base["rt_lead"] = static_cast<double>(rt_lead);
+        }
+        return generateJsonString(base);
+    }
     if (queryCallback) {
         return queryCallback(query);
     }
@@ -1760,7 +2070,7 @@ std::string FederateState::processQuery(const std::string& query) const
         qstring = processQueryActual(query);
     } else if ((query == "queries") || (query == "available_queries")) {
         qstring =
-            "publications;inputs;endpoints;interfaces;subscriptions;dependencies;timeconfig;config;dependents;current_time";
+            "publications;inputs;endpoints;interfaces;subscriptions;dependencies;timeconfig;config;dependents;current_time;realtime;iterations";
     } else {  // the rest might to prevent a race condition
         if (try_lock()) {
             qstring = processQueryActual(query);
@@ -10,6 +10,7 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "ActionMessage.hpp"
 #include "BasicHandleInfo.hpp"
 #include "InterfaceInfo.hpp"
+#include "RealTimePacer.hpp"
 #include "core-data.hpp"
 #include "core-types.hpp"
 #include "gmlc/containers/BlockingQueue.hpp"
@@ -17,11 +18,13 @@ SPDX-License-Identifier: BSD-3-Clause
 
 #include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <deque>
 #include <map>
 #include <memory>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -31,6 +34,7 @@ class PublicationInfo;
 class EndpointInfo;
 class FilterInfo;
 class CommonCore;
+class BinaryLogger;
 class CoreFederateInfo;
 
 class TimeCoordinator;
@@ -80,12 +84,36 @@ class FederateState {
   private:
     int errorCode{0};  //!< storage for an error code
     CommonCore* parent_{nullptr};  //!< pointer to the higher level;
+    BinaryLogger* binaryLogger{nullptr};  //!< binary logger for deferred format messages
     std::string errorString;  //!< storage for an error string populated on an error
-    decltype(std::chrono::steady_clock::now())
-        start_clock_time;  //!< time the initialization mode started for real time capture
+    RealTimePacer pacer;  //!< pacing of the time grants against the wall clock in real time mode
     Time rt_lag{timeZero};  //!< max lag for the rt control
     Time rt_lead{timeZero};  //!< min lag for the realtime control
     int32_t realTimeTimerIndex{-1};  //!< the timer index for the real time timer;
+    /** the stages of a federate driven by the core*/
+    enum class callback_stage : std::uint8_t {
+        initializing,
+        executing,
+        time_request,
+        finalizing,
+        complete
+    };
+    std::shared_ptr<FederateOperator> fedCallbacks;  //!< the callbacks of a core driven federate
+    std::atomic<bool> callbackBased{false};  //!< the federate is driven by the core
+    /// the federate is waiting for or running in a core callback thread
+    std::atomic<bool> callbackScheduled{false};
+    callback_stage callbackStage{callback_stage::initializing};  //!< the pending operation
+    Time callbackRequestTime{timeZero};  //!< the time of the pending time request
+    /// the iteration request of the pending operation
+    iteration_request callbackIterate{iteration_request::no_iterations};
+    /// values delivered directly from publications in the same core keyed by the notification
+    guarded<std::unordered_map<int32_t, std::shared_ptr<const data_block>>> directValues;
+    std::atomic<int32_t> directValueCounter{0};  //!< the key of the next direct value
+    /// the core holds query subscriptions that depend on the federate state
+    std::atomic<bool> queryWatched{false};
+    federate_state watchedState{HELICS_CREATED};  //!< the state last reported to the core
+    Time watchedTime{startupTime};  //!< the granted time last reported to the core
+
   public:
     std::atomic<bool> init_requested{
         false};  //!< this federate has requested entry to initialization
@@ -178,6 +206,10 @@ class FederateState {
 
     /** set the CommonCore object that is managing this Federate*/
     void setParent(CommonCore* coreObject) { parent_ = coreObject; }
+    /** set the binary logger to record deferred format log messages to*/
+    void setBinaryLogger(BinaryLogger* logger) { binaryLogger = logger; }
+    /** set whether the core should be notified of changes in state or granted time*/
+    void setQueryWatched(bool watched) { queryWatched.store(watched); }
     /** update the info structure
    @details public call so it also calls the federate lock before calling private update function
    the action Message should be CMD_FED_CONFIGURE
@@ -249,6 +281,10 @@ class FederateState {
     @return a convergence state value with an indicator of return reason and state of convergence
     */
     message_processing_result processQueue() noexcept;
+    /** process the federate queue until a returnable event or until it is empty
+    @param waitForMessages set to true to block on the queue instead of returning when it is empty
+    @return a convergence state value, continue_processing if the queue emptied first*/
+    message_processing_result processQueue(bool waitForMessages) noexcept;
 
     /** process the federate delayed Message queue until a returnable event or it is empty
     @details processQueue will process messages until one of 3 things occur
@@ -284,6 +320,27 @@ class FederateState {
     int checkInterfaces();
     /** generate results from a query*/
     std::string processQueryActual(const std::string& query) const;
+    /** send the request for entering executing mode*/
+    void startExecRequest(iteration_request iterate);
+    /** update the granted time and events after a request for executing mode returns*/
+    void completeExecRequest(message_processing_result ret, iteration_request iterate);
+    /** send a time request and set up any real time controls*/
+    void startTimeRequest(Time nextTime, iteration_request iterate);
+    /** update the granted time and events after a time request returns*/
+    iteration_time completeTimeRequest(message_processing_result ret,
+                                       Time nextTime,
+                                       iteration_request iterate);
+    /** process the queue of a core driven federate for the pending operation
+    @return true if the operation completed and the next one was started*/
+    bool processCallbackStage();
+    /** request executing mode for a core driven federate*/
+    void callbackExecRequest(iteration_request iterate);
+    /** request the next time for a core driven federate*/
+    void callbackTimeRequest(std::pair<Time, iteration_request> next);
+    /** disconnect a core driven federate*/
+    void callbackFinalize();
+    /** pass an error to a core driven federate, exceptions from the error handler are logged*/
+    void callbackError(int code, const std::string& message) noexcept;
 
   public:
     /** get the granted time of a federate*/
@@ -325,6 +382,12 @@ class FederateState {
     @param handle the publication handle to use
     */
     std::vector<global_handle> getSubscribers(interface_handle handle);
+    /** store a value from a publication in the same core for delivery to an input
+    @details the value is shared with any other local inputs instead of being copied into each
+    CMD_PUB, the notification carrying the returned key must be sent to the federate afterward
+    @return the key to place in the messageID of the CMD_PUB notification or -1 if the federate
+    has finished and will not process any more values*/
+    int32_t addDirectValue(std::shared_ptr<const data_block> value);
 
     /** function to process the queue in a generic fashion used to just process messages
     with no specific end in mind
@@ -332,6 +395,15 @@ class FederateState {
     iteration_result genericUnspecifiedQueueProcess();
     /** function to process the queue until a disconnect_fed_ack is received*/
     void finalize();
+    /** set the callbacks for a federate driven by the core
+    @details must be called before the federate requests initializing mode, afterward the
+    federate is advanced by callbackProcessing as messages arrive*/
+    void setCallbackOperator(std::shared_ptr<FederateOperator> callbacks);
+    /** check if the federate is driven by the core*/
+    bool isCallbackFederate() const { return callbackBased.load(std::memory_order_acquire); }
+    /** process the messages of a core driven federate and run its callbacks for each grant
+    @details called from a core callback thread*/
+    void callbackProcessing() noexcept;
 
     /** add an action message to the queue*/
     void addAction(const ActionMessage& action);
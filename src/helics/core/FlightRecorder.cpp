@@ -0,0 +1,324 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "FlightRecorder.hpp"
+
+#include "../common/binaryFileHelpers.hpp"
+#include "ActionMessage.hpp"
+#include "json/json.h"
+
+#include <algorithm>
+#include <csignal>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace helics {
+/** the header identifying a flight recorder dump*/
+static constexpr char flightRecorderMagic[8] = {'H', 'E', 'L', 'I', 'C', 'S', 'F', 'R'};
+static constexpr std::uint32_t flightRecorderVersion{1};
+
+static std::atomic<unsigned int> dumpRequests{0};
+
+static_assert(sizeof(FlightRecord) % sizeof(std::uint64_t) == 0,
+              "flight records are copied as 64 bit words");
+
+FlightRecorder::FlightRecorder(std::size_t capacity):
+    mask([capacity]() {
+        std::size_t size{2};
+        while (size < capacity) {
+            size <<= 1U;
+        }
+        return size - 1;
+    }()),
+    slots(new RecordSlot[mask + 1]), startTime(clock_type::now()),
+    startSystemTime(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::system_clock::now().time_since_epoch())
+                        .count())
+{
+    for (std::size_t ii = 0; ii <= mask; ++ii) {
+        for (auto& word : slots[ii].words) {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+void FlightRecorder::record(const ActionMessage& command) noexcept
+{
+    auto current = position.load(std::memory_order_relaxed);
+    FlightRecord entry;
+    entry.timestamp = (clock_type::now() - startTime).count();
+    entry.action = static_cast<std::int32_t>(command.action());
+    entry.messageID = command.messageID;
+    entry.source_id = command.source_id.baseValue();
+    entry.source_handle = command.source_handle.baseValue();
+    entry.dest_id = command.dest_id.baseValue();
+    entry.dest_handle = command.dest_handle.baseValue();
+    entry.counter = command.counter;
+    entry.flags = command.flags;
+    entry.payloadSize = static_cast<std::uint32_t>(command.payload.size());
+    entry.actionTime = command.actionTime.getBaseTimeCode();
+    entry.Te = command.Te.getBaseTimeCode();
+    entry.Tdemin = command.Tdemin.getBaseTimeCode();
+    std::array<std::uint64_t, recordWords> raw;
+    std::memcpy(raw.data(), &entry, sizeof(entry));
+
+    auto& slot = slots[current & mask];
+    slot.sequence.store(2 * current + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t ii = 0; ii < recordWords; ++ii) {
+        slot.words[ii].store(raw[ii], std::memory_order_relaxed);
+    }
+    slot.sequence.store(2 * current + 2, std::memory_order_release);
+    position.store(current + 1, std::memory_order_release);
+}
+
+bool FlightRecorder::readRecord(std::uint64_t index, FlightRecord& record) const
+{
+    const auto& slot = slots[index & mask];
+    const auto expected = 2 * index + 2;
+    if (slot.sequence.load(std::memory_order_acquire) != expected) {
+        return false;
+    }
+    std::array<std::uint64_t, recordWords> raw;
+    for (std::size_t ii = 0; ii < recordWords; ++ii) {
+        raw[ii] = slot.words[ii].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != expected) {
+        return false;
+    }
+    std::memcpy(&record, raw.data(), sizeof(record));
+    return true;
+}
+
+std::vector<FlightRecord> FlightRecorder::snapshot() const
+{
+    auto end = position.load(std::memory_order_acquire);
+    auto start = (end > capacity()) ? end - capacity() : 0;
+    std::vector<FlightRecord> result;
+    result.reserve(static_cast<std::size_t>(end - start));
+    FlightRecord entry;
+    for (auto index = start; index < end; ++index) {
+        // records overwritten by the processing thread during the copy are skipped
+        if (readRecord(index, entry)) {
+            result.push_back(entry);
+        }
+    }
+    return result;
+}
+
+bool FlightRecorder::dump(const std::string& fileName) const
+{
+    std::ofstream out(fileName, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+    dump(out);
+    return static_cast<bool>(out);
+}
+
+void FlightRecorder::dump(std::ostream& output) const
+{
+    auto entries = snapshot();
+    writeBinaryFileHeader(output, flightRecorderMagic, flightRecorderVersion);
+    writeBinaryValue(output, startSystemTime);
+    writeBinaryValue(output, static_cast<std::uint64_t>(position.load(std::memory_order_acquire)));
+    writeBinaryValue(output, static_cast<std::uint32_t>(entries.size()));
+    for (const auto& entry : entries) {
+        writeBinaryValue(output, entry.timestamp);
+        writeBinaryValue(output, entry.action);
+        writeBinaryValue(output, entry.messageID);
+        writeBinaryValue(output, entry.source_id);
+        writeBinaryValue(output, entry.source_handle);
+        writeBinaryValue(output, entry.dest_id);
+        writeBinaryValue(output, entry.dest_handle);
+        writeBinaryValue(output, entry.counter);
+        writeBinaryValue(output, entry.flags);
+        writeBinaryValue(output, entry.payloadSize);
+        writeBinaryValue(output, entry.actionTime);
+        writeBinaryValue(output, entry.Te);
+        writeBinaryValue(output, entry.Tdemin);
+    }
+    output.flush();
+}
+
+static double timeValue(std::int64_t baseTime)
+{
+    Time val;
+    val.setBaseTimeCode(baseTime);
+    return static_cast<double>(val);
+}
+
+void FlightRecorder::generateRecords(Json::Value& base, std::size_t maxRecords) const
+{
+    auto entries = snapshot();
+    auto skip = (entries.size() > maxRecords) ? entries.size() - maxRecords : 0;
+    base["capacity"] = static_cast<Json::UInt64>(capacity());
+    base["count"] = static_cast<Json::UInt64>(recordCount());
+    base["records"] = Json::arrayValue;
+    for (auto index = skip; index < entries.size(); ++index) {
+        const auto& entry = entries[index];
+        Json::Value rec;
+        rec["timestamp"] = static_cast<double>(entry.timestamp) * 1e-9;
+        rec["action"] =
+            actionMessageType(static_cast<action_message_def::action_t>(entry.action));
+        rec["source_id"] = entry.source_id;
+        rec["source_handle"] = entry.source_handle;
+        rec["dest_id"] = entry.dest_id;
+        rec["dest_handle"] = entry.dest_handle;
+        rec["message_id"] = entry.messageID;
+        rec["flags"] = entry.flags;
+        rec["size"] = entry.payloadSize;
+        rec["time"] = timeValue(entry.actionTime);
+        base["records"].append(rec);
+    }
+}
+
+void FlightRecorder::requestDump() noexcept
+{
+    dumpRequests.fetch_add(1, std::memory_order_relaxed);
+}
+
+unsigned int FlightRecorder::dumpRequestCount() noexcept
+{
+    return dumpRequests.load(std::memory_order_relaxed);
+}
+
+#ifndef _WIN32
+extern "C" {
+static void flightRecorderSignalHandler(int /*signal*/)
+{
+    FlightRecorder::requestDump();
+}
+}
+#endif
+
+void FlightRecorder::installSignalHandler()
+{
+#ifndef _WIN32
+    static const bool installed = []() {
+        std::signal(SIGUSR1, flightRecorderSignalHandler);
+        return true;
+    }();
+    (void)installed;
+#endif
+}
+
+/** the recorders dumped on a dump request along with their files*/
+class FlightRecorderDumps {
+  public:
+    std::mutex lock;
+    std::vector<std::pair<const FlightRecorder*, std::string>> recorders;
+    bool watching{false};  //!< the watcher thread has been started
+};
+
+static FlightRecorderDumps& signalDumps()
+{
+    // never destroyed since the detached watcher thread can outlive static destruction
+    static auto* dumps = new FlightRecorderDumps();  // NOLINT
+    return *dumps;
+}
+
+/** loop run by a detached thread checking for dump requests, which come from a signal handler that
+can only change an atomic counter*/
+static void dumpWatcher(unsigned int lastRequest)
+{
+    auto& dumps = signalDumps();
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        auto request = FlightRecorder::dumpRequestCount();
+        if (request == lastRequest) {
+            continue;
+        }
+        lastRequest = request;
+        std::lock_guard<std::mutex> dumpLock(dumps.lock);
+        for (const auto& rec : dumps.recorders) {
+            rec.first->dump(rec.second);
+        }
+    }
+}
+
+void FlightRecorder::enableSignalDump(const std::string& fileName)
+{
+    installSignalHandler();
+    auto& dumps = signalDumps();
+    std::lock_guard<std::mutex> dumpLock(dumps.lock);
+    if (!signalDump) {
+        dumps.recorders.emplace_back(this, fileName);
+        signalDump = true;
+    }
+    if (!dumps.watching) {
+        std::thread(dumpWatcher, dumpRequestCount()).detach();
+        dumps.watching = true;
+    }
+}
+
+FlightRecorder::~FlightRecorder()
+{
+    if (!signalDump) {
+        return;
+    }
+    auto& dumps = signalDumps();
+    std::lock_guard<std::mutex> dumpLock(dumps.lock);
+    dumps.recorders.erase(std::remove_if(dumps.recorders.begin(),
+                                         dumps.recorders.end(),
+                                         [this](const auto& rec) { return rec.first == this; }),
+                          dumps.recorders.end());
+}
+
+std::size_t decodeFlightRecorderDump(std::istream& input, std::ostream& output)
+{
+    std::int64_t startSystemTime{0};
+    std::uint64_t totalCount{0};
+    std::uint32_t recordCount{0};
+    if (!readBinaryFileHeader(input, flightRecorderMagic, flightRecorderVersion) ||
+        !readBinaryValue(input, startSystemTime) || !readBinaryValue(input, totalCount) ||
+        !readBinaryValue(input, recordCount)) {
+        throw(std::invalid_argument("input is not a HELICS flight recorder dump"));
+    }
+    std::ostringstream line;
+    line << "flight recorder started at " << startSystemTime << "ns since epoch, " << totalCount
+         << " messages recorded, " << recordCount << " retained\n";
+    output << line.str();
+    std::size_t count{0};
+    for (std::uint32_t ii = 0; ii < recordCount; ++ii) {
+        FlightRecord entry;
+        if (!readBinaryValue(input, entry.timestamp) || !readBinaryValue(input, entry.action) ||
+            !readBinaryValue(input, entry.messageID) || !readBinaryValue(input, entry.source_id) ||
+            !readBinaryValue(input, entry.source_handle) ||
+            !readBinaryValue(input, entry.dest_id) ||
+            !readBinaryValue(input, entry.dest_handle) ||
+            !readBinaryValue(input, entry.counter) || !readBinaryValue(input, entry.flags) ||
+            !readBinaryValue(input, entry.payloadSize) ||
+            !readBinaryValue(input, entry.actionTime) || !readBinaryValue(input, entry.Te) ||
+            !readBinaryValue(input, entry.Tdemin)) {
+            break;
+        }
+        line.str(std::string{});
+        line << '[' << entry.timestamp / 1000000000 << '.' << std::setfill('0') << std::setw(9)
+             << entry.timestamp % 1000000000 << std::setfill(' ') << "] "
+             << actionMessageType(static_cast<action_message_def::action_t>(entry.action))
+             << " from " << entry.source_id << ':' << entry.source_handle << " to "
+             << entry.dest_id << ':' << entry.dest_handle << " id=" << entry.messageID
+             << " flags=" << entry.flags << " size=" << entry.payloadSize
+             << " time=" << timeValue(entry.actionTime) << " Te=" << timeValue(entry.Te)
+             << " Tdemin=" << timeValue(entry.Tdemin) << '\n';
+        output << line.str();
+        ++count;
+    }
+    return count;
+}
+
+}  // namespace helics
@@ -0,0 +1,112 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+
+#include "json/forwards.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace helics {
+class ActionMessage;
+
+/** the header information of a single ActionMessage captured by the flight recorder*/
+struct FlightRecord {
+    std::int64_t timestamp{0};  //!< nanoseconds since the recorder was created
+    std::int32_t action{0};  //!< the action of the message
+    std::int32_t messageID{0};  //!< the message ID
+    std::int32_t source_id{0};  //!< the source federate or broker id
+    std::int32_t source_handle{0};  //!< the source handle
+    std::int32_t dest_id{0};  //!< the destination federate or broker id
+    std::int32_t dest_handle{0};  //!< the destination handle
+    std::uint16_t counter{0};  //!< the message counter
+    std::uint16_t flags{0};  //!< the message flags
+    std::uint32_t payloadSize{0};  //!< the size of the payload
+    std::int64_t actionTime{0};  //!< the base time code of the action time
+    std::int64_t Te{0};  //!< the base time code of the event time
+    std::int64_t Tdemin{0};  //!< the base time code of the min dependent event time
+};
+
+/** fixed size ring buffer of the most recent ActionMessage headers processed by a broker or core
+@details recording is done by the single processing thread of the broker and only copies a few
+integers into a preallocated slot, so it is cheap enough to leave on all the time.  The contents can
+be taken from any thread, each slot is guarded by a sequence number and records overwritten while a
+snapshot is being taken are discarded from the snapshot*/
+class FlightRecorder {
+  public:
+    using clock_type = std::chrono::steady_clock;
+    /** construct with a capacity, rounded up to a power of 2*/
+    explicit FlightRecorder(std::size_t capacity);
+    /** destructor removing the recorder from the signal dumps*/
+    ~FlightRecorder();
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+    /** record the header of a message, called only from the processing thread*/
+    void record(const ActionMessage& command) noexcept;
+    /** get the number of records the buffer can hold*/
+    std::size_t capacity() const { return mask + 1; }
+    /** get the total number of messages recorded*/
+    std::uint64_t recordCount() const { return position.load(std::memory_order_acquire); }
+    /** get a copy of the records currently in the buffer, oldest first*/
+    std::vector<FlightRecord> snapshot() const;
+    /** write the current records to a binary file
+    @return true if the file was written*/
+    bool dump(const std::string& fileName) const;
+    /** write the current records in binary form to a stream*/
+    void dump(std::ostream& output) const;
+    /** load the most recent records into a json array
+    @param base the json value to store the records in
+    @param maxRecords the maximum number of records to include*/
+    void generateRecords(Json::Value& base, std::size_t maxRecords = 100) const;
+
+    /** request all the flight recorders dump their contents
+    @details only does an atomic increment so it is safe to call from a signal handler*/
+    static void requestDump() noexcept;
+    /** get a counter of the dump requests, recorders dump when it changes*/
+    static unsigned int dumpRequestCount() noexcept;
+    /** install a handler on SIGUSR1 which requests a dump, does nothing on Windows*/
+    static void installSignalHandler();
+    /** dump the recorder to a file whenever a dump is requested
+    @details the dump is written by a watcher thread shared by all the recorders, so it does not
+    depend on the processing thread of the broker or core which may be the one that is hung
+    @param fileName the file to write the dump to*/
+    void enableSignalDump(const std::string& fileName);
+
+  private:
+    /// the number of 64 bit words in a record
+    static constexpr std::size_t recordWords{sizeof(FlightRecord) / sizeof(std::uint64_t)};
+    /** a slot of the ring buffer, the record is stored as relaxed atomic words with a sequence
+    number that is odd while the record is being written so a reader can detect torn copies*/
+    struct RecordSlot {
+        std::atomic<std::uint64_t> sequence{0};
+        std::array<std::atomic<std::uint64_t>, recordWords> words;
+    };
+    /** copy the record with a specific index out of its slot
+    @return false if the slot does not hold that record or was changed during the copy*/
+    bool readRecord(std::uint64_t index, FlightRecord& record) const;
+
+    const std::size_t mask;
+    std::unique_ptr<RecordSlot[]> slots;
+    bool signalDump{false};  //!< the recorder is registered for signal dumps
+    const clock_type::time_point startTime;
+    const std::int64_t startSystemTime;  //!< the system clock time of the start in nanoseconds
+    std::atomic<std::uint64_t> position{0};  //!< the total number of records written
+};
+
+/** format a flight recorder dump into text
+@param input the stream containing the binary dump
+@param output the stream to write the formatted lines to
+@return the number of records decoded
+@throw std::invalid_argument if the input is not a flight recorder dump*/
+std::size_t decodeFlightRecorderDump(std::istream& input, std::ostream& output);
+}  // namespace helics
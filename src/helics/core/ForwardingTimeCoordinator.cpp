@@ -153,6 +153,14 @@ void ForwardingTimeCoordinator::updateTimeFactors()
     if (prev_next != time_next) {
         update = true;
     }
+    if (aggregating) {
+        // the federates behind an aggregate dependency reset iterating requests on every grant so
+        // each iterative request has to be passed through even if the aggregate did not change
+        iterating = (time_state == DependencyInfo::time_state_t::time_requested_iterative);
+        if (iterating) {
+            update = true;
+        }
+    }
 
     if (mTime.minFed != lastMinFed) {
         lastMinFed = mTime.minFed;
@@ -317,7 +325,8 @@ void ForwardingTimeCoordinator::transmitTimingMessage(ActionMessage& msg) const
     if (sendMessageFunction) {
         if ((msg.action() == CMD_TIME_REQUEST) || (msg.action() == CMD_TIME_GRANT)) {
             for (auto dep : dependents) {
-                if ((isBroker(dep)) && (!ignoreMinFed)) {
+                // an aggregating coordinator must not reflect a federate's own time back to it
+                if ((isBroker(dep) || aggregating) && (!ignoreMinFed)) {
                     auto di = getDependencyInfo(dep);
                     if (di != nullptr) {
                         if ((di->Tnext == msg.actionTime) || (di->fedID == lastMinFed)) {
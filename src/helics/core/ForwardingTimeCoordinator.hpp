@@ -50,6 +50,8 @@ class ForwardingTimeCoordinator {
     bool ignoreMinFed{false};  //!< flag indicating that minFed Controls should not be used
     bool restrictive_time_policy{
         false};  //!< flag indicating that a restrictive time policy should be used
+    bool aggregating{false};  //!< flag indicating the coordinator stands in for a subtree of
+                              //!< federates as a single time dependency
   public:
     ForwardingTimeCoordinator() = default;
 
@@ -79,35 +79,78 @@ static auto recordComparison = [](const InputInfo::dataRecord& rec1,
         ((rec1.time == rec2.time) ? (rec1.iteration < rec2.iteration) : false);
 };
 
-void InputInfo::addData(global_handle source_id,
+void InputInfo::recordQueue::insert(dataRecord&& record)
+{
+    if (count == records.size()) {
+        grow();
+    }
+    // find the first record ordered after the new one, most records arrive in order
+    std::size_t position{count};
+    if (count > 0 && recordComparison(record, back())) {
+        std::size_t low{0};
+        std::size_t high{count - 1};
+        while (low < high) {
+            auto mid = low + (high - low) / 2;
+            if (recordComparison(record, (*this)[mid])) {
+                high = mid;
+            } else {
+                low = mid + 1;
+            }
+        }
+        position = low;
+        for (auto ii = count; ii > position; --ii) {
+            (*this)[ii] = std::move((*this)[ii - 1]);
+        }
+    }
+    (*this)[position] = std::move(record);
+    ++count;
+}
+
+void InputInfo::recordQueue::pop_front(std::size_t number)
+{
+    for (std::size_t ii = 0; ii < number; ++ii) {
+        // release the data now instead of when the slot is reused
+        (*this)[ii].data.reset();
+    }
+    head = (count == number) ? 0 : ((head + number) & mask());
+    count -= number;
+}
+
+void InputInfo::recordQueue::pop_back()
+{
+    back().data.reset();
+    --count;
+}
+
+void InputInfo::recordQueue::grow()
+{
+    std::vector<dataRecord> larger(std::max<std::size_t>(records.size() * 2, 4));
+    for (std::size_t ii = 0; ii < count; ++ii) {
+        larger[ii] = std::move((*this)[ii]);
+    }
+    records.swap(larger);
+    head = 0;
+}
+
+bool InputInfo::addData(global_handle source_id,
                         Time valueTime,
                         unsigned int iteration,
                         std::shared_ptr<const data_block> data)
 {
-    int index;
-    bool found = false;
-    for (index = 0; index < static_cast<int>(input_sources.size()); ++index) {
-        if (input_sources[index] == source_id) {
-            if (valueTime > deactivated[index]) {
-                return;
-            }
-            found = true;
-            break;
-        }
+    auto fnd = source_index.find(source_id);
+    if (fnd == source_index.end()) {
+        return false;
     }
-    if (!found) {
-        return;
+    auto index = fnd->second;
+    // the sources are cleared if the input is closed
+    if (!isValidIndex(index, input_sources) || !(input_sources[index] == source_id)) {
+        return false;
     }
-    if ((data_queues[index].empty()) || (valueTime > data_queues[index].back().time)) {
-        data_queues[index].emplace_back(valueTime, iteration, std::move(data));
-    } else {
-        dataRecord newRecord(valueTime, iteration, std::move(data));
-        auto m = std::upper_bound(data_queues[index].begin(),
-                                  data_queues[index].end(),
-                                  newRecord,
-                                  recordComparison);
-        data_queues[index].insert(m, std::move(newRecord));
+    if (valueTime > deactivated[index]) {
+        return true;
     }
+    data_queues[index].insert(dataRecord(valueTime, iteration, std::move(data)));
+    return true;
 }
 
 void InputInfo::addSource(global_handle newSource,
@@ -118,6 +161,7 @@ void InputInfo::addSource(global_handle newSource,
     inputUnits.clear();
     inputType.clear();
     input_sources.push_back(newSource);
+    source_index.emplace(newSource, static_cast<int32_t>(input_sources.size() - 1));
     source_info.emplace_back(sourceName, stype, sunits);
     data_queues.resize(input_sources.size());
     current_data.resize(input_sources.size());
@@ -167,6 +211,19 @@ void InputInfo::clearFutureData()
     }
 }
 
+void InputInfo::clearSources()
+{
+    inputUnits.clear();
+    inputType.clear();
+    input_sources.clear();
+    source_index.clear();
+    source_info.clear();
+    data_queues.clear();
+    current_data.clear();
+    current_data_time.clear();
+    deactivated.clear();
+}
+
 const std::string& InputInfo::getInjectionType() const
 {
     if (inputType.empty()) {
@@ -228,26 +285,19 @@ bool InputInfo::updateTimeUpTo(Time newTime)
     int index{0};
     bool updated{false};
     for (auto& data_queue : data_queues) {
-        auto currentValue = data_queue.begin();
-
-        auto it_final = data_queue.end();
-        if (currentValue == it_final) {
+        if (data_queue.empty() || data_queue.front().time > newTime) {
             ++index;
             continue;
         }
-        if (currentValue->time > newTime) {
-            ++index;
-            continue;
-        }
-        auto last = currentValue;
-        ++currentValue;
-        while ((currentValue != it_final) && (currentValue->time < newTime)) {
+        std::size_t last{0};
+        std::size_t currentValue{1};
+        while ((currentValue < data_queue.size()) && (data_queue[currentValue].time < newTime)) {
             last = currentValue;
             ++currentValue;
         }
 
-        auto res = updateData(std::move(*last), index);
-        data_queue.erase(data_queue.begin(), currentValue);
+        auto res = updateData(std::move(data_queue[last]), index);
+        data_queue.pop_front(currentValue);
         ++index;
         if (res) {
             updated = true;
@@ -261,35 +311,30 @@ bool InputInfo::updateTimeNextIteration(Time newTime)
     int index{0};
     bool updated{false};
     for (auto& data_queue : data_queues) {
-        auto currentValue = data_queue.begin();
-        auto it_final = data_queue.end();
-        if (currentValue == it_final) {
-            ++index;
-            continue;
-        }
-        if (currentValue->time > newTime) {
+        if (data_queue.empty() || data_queue.front().time > newTime) {
             ++index;
             continue;
         }
-        auto last = currentValue;
-        ++currentValue;
-        while ((currentValue != it_final) && (currentValue->time < newTime)) {
+        std::size_t last{0};
+        std::size_t currentValue{1};
+        while ((currentValue < data_queue.size()) && (data_queue[currentValue].time < newTime)) {
             last = currentValue;
             ++currentValue;
         }
-        if (currentValue != it_final) {
-            if (currentValue->time == newTime) {
-                auto cindex = last->iteration;
-                while ((currentValue != it_final) && (currentValue->time == newTime) &&
-                       (currentValue->iteration == cindex)) {
+        if (currentValue < data_queue.size()) {
+            if (data_queue[currentValue].time == newTime) {
+                auto cindex = data_queue[last].iteration;
+                while ((currentValue < data_queue.size()) &&
+                       (data_queue[currentValue].time == newTime) &&
+                       (data_queue[currentValue].iteration == cindex)) {
                     last = currentValue;
                     ++currentValue;
                 }
             }
         }
 
-        auto res = updateData(std::move(*last), index);
-        data_queue.erase(data_queue.begin(), currentValue);
+        auto res = updateData(std::move(data_queue[last]), index);
+        data_queue.pop_front(currentValue);
         ++index;
         if (res) {
             updated = true;
@@ -303,25 +348,19 @@ bool InputInfo::updateTimeInclusive(Time newTime)
     int index = 0;
     bool updated = false;
     for (auto& data_queue : data_queues) {
-        auto currentValue = data_queue.begin();
-        auto it_final = data_queue.end();
-        if (currentValue == it_final) {
-            ++index;
-            continue;
-        }
-        if (currentValue->time > newTime) {
+        if (data_queue.empty() || data_queue.front().time > newTime) {
             ++index;
             continue;
         }
-        auto last = currentValue;
-        ++currentValue;
-        while ((currentValue != it_final) && (currentValue->time <= newTime)) {
+        std::size_t last{0};
+        std::size_t currentValue{1};
+        while ((currentValue < data_queue.size()) && (data_queue[currentValue].time <= newTime)) {
             last = currentValue;
             ++currentValue;
         }
 
-        auto res = updateData(std::move(*last), index);
-        data_queue.erase(data_queue.begin(), currentValue);
+        auto res = updateData(std::move(data_queue[last]), index);
+        data_queue.pop_front(currentValue);
         ++index;
         if (res) {
             updated = true;
@@ -8,9 +8,11 @@ SPDX-License-Identifier: BSD-3-Clause
 
 #include "basic_core_types.hpp"
 
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -38,6 +40,45 @@ class InputInfo {
         }
     };
 
+    /** queue of pending data records ordered by time and iteration
+    @details the records are stored in a ring buffer so consumed records are dropped from the front
+    without moving the remaining records, the storage only grows when more records are pending than
+    at any previous point*/
+    class recordQueue {
+      public:
+        /** check if the queue is empty*/
+        bool empty() const { return count == 0; }
+        /** get the number of records in the queue*/
+        std::size_t size() const { return count; }
+        /** access a record by its position from the front of the queue*/
+        dataRecord& operator[](std::size_t index) { return records[(head + index) & mask()]; }
+        /** access a record by its position from the front of the queue*/
+        const dataRecord& operator[](std::size_t index) const
+        {
+            return records[(head + index) & mask()];
+        }
+        dataRecord& front() { return (*this)[0]; }
+        const dataRecord& front() const { return (*this)[0]; }
+        dataRecord& back() { return (*this)[count - 1]; }
+        const dataRecord& back() const { return (*this)[count - 1]; }
+        /** insert a record after any records with the same time and iteration*/
+        void insert(dataRecord&& record);
+        /** remove a number of records from the front of the queue*/
+        void pop_front(std::size_t number);
+        /** remove the last record*/
+        void pop_back();
+        /** remove all the records*/
+        void clear() { pop_front(count); }
+
+      private:
+        /** double the storage*/
+        void grow();
+        std::size_t mask() const { return records.size() - 1; }
+        std::vector<dataRecord> records;  //!< the storage, the size is always a power of 2
+        std::size_t head{0};  //!< the storage index of the first record
+        std::size_t count{0};  //!< the number of records in the queue
+    };
+
     struct sourceInformation {
         std::string key;
         std::string type;
@@ -86,7 +127,9 @@ class InputInfo {
     std::vector<sourceInformation> source_info;  //!< the name,type,units of the sources
     std::vector<int32_t> priority_sources;  //!< the list of priority inputs;
   private:
-    std::vector<std::vector<dataRecord>> data_queues;  //!< queue of the data
+    std::vector<recordQueue> data_queues;  //!< queue of the data
+    /// the index of each source, the first index if a source was added more than once
+    std::unordered_map<global_handle, int32_t> source_index;
 
   public:
     /** get all the current data*/
@@ -95,8 +138,9 @@ class InputInfo {
     const std::shared_ptr<const data_block>& getData(int index) const;
     /** get a the most recent data point*/
     const std::shared_ptr<const data_block>& getData(uint32_t* inputIndex) const;
-    /** add a data block into the queue*/
-    void addData(global_handle source_id,
+    /** add a data block into the queue
+    @return true if the source is connected to the input*/
+    bool addData(global_handle source_id,
                  Time valueTime,
                  unsigned int iteration,
                  std::shared_ptr<const data_block> data);
@@ -130,6 +174,8 @@ class InputInfo {
     void removeSource(const std::string& sourceName, Time minTime);
     /** clear all non-current data*/
     void clearFutureData();
+    /** remove all the sources along with their data and the index of sources*/
+    void clearSources();
 
     const std::string& getInjectionType() const;
     const std::string& getInjectionUnits() const;
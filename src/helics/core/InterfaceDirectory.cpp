@@ -0,0 +1,88 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#include "InterfaceDirectory.hpp"
+
+namespace helics {
+bool InterfaceDirectory::addInterface(handle_type type,
+                                      const std::string& name,
+                                      global_broker_id owner)
+{
+    auto* dmap = getMap(type);
+    if (dmap == nullptr) {
+        return false;
+    }
+    return dmap->emplace(name, owner).second;
+}
+
+global_broker_id InterfaceDirectory::findOwner(handle_type type, const std::string& name) const
+{
+    const auto* dmap = getMap(type);
+    if (dmap == nullptr) {
+        return global_broker_id{};
+    }
+    auto fnd = dmap->find(name);
+    return (fnd != dmap->end()) ? fnd->second : global_broker_id{};
+}
+
+static void removeOwnerFromMap(std::unordered_map<std::string, global_broker_id>& dmap,
+                               global_broker_id owner)
+{
+    for (auto it = dmap.begin(); it != dmap.end();) {
+        if (it->second == owner) {
+            it = dmap.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void InterfaceDirectory::removeOwner(global_broker_id owner)
+{
+    removeOwnerFromMap(publications, owner);
+    removeOwnerFromMap(inputs, owner);
+    removeOwnerFromMap(endpoints, owner);
+    removeOwnerFromMap(filters, owner);
+}
+
+std::size_t InterfaceDirectory::size() const
+{
+    return publications.size() + inputs.size() + endpoints.size() + filters.size();
+}
+
+InterfaceDirectory::ownerMap* InterfaceDirectory::getMap(handle_type type)
+{
+    switch (type) {
+        case handle_type::publication:
+            return &publications;
+        case handle_type::input:
+            return &inputs;
+        case handle_type::endpoint:
+            return &endpoints;
+        case handle_type::filter:
+            return &filters;
+        default:
+            return nullptr;
+    }
+}
+
+const InterfaceDirectory::ownerMap* InterfaceDirectory::getMap(handle_type type) const
+{
+    switch (type) {
+        case handle_type::publication:
+            return &publications;
+        case handle_type::input:
+            return &inputs;
+        case handle_type::endpoint:
+            return &endpoints;
+        case handle_type::filter:
+            return &filters;
+        default:
+            return nullptr;
+    }
+}
+
+}  // namespace helics
@@ -0,0 +1,48 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+#include "BasicHandleInfo.hpp"
+#include "global_federate_id.hpp"
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+
+namespace helics {
+/** class recording which broker owns a named interface
+@details the root and the interface owning sub-brokers use it to cache the owners found by earlier
+lookups so later lookups and messages for the same interface go straight to the owner.  This class
+is not thread safe*/
+class InterfaceDirectory {
+  public:
+    /** default constructor*/
+    InterfaceDirectory() = default;
+    /** record the owner of an interface
+    @return false if an interface of the same type and name is already present*/
+    bool addInterface(handle_type type, const std::string& name, global_broker_id owner);
+    /** get the broker owning an interface
+    @return an invalid id if the interface is not known*/
+    global_broker_id findOwner(handle_type type, const std::string& name) const;
+    /** remove all the interfaces owned by a broker*/
+    void removeOwner(global_broker_id owner);
+    /** get the total number of interfaces in the directory*/
+    std::size_t size() const;
+    /** check if the directory is empty*/
+    bool empty() const { return size() == 0; }
+
+  private:
+    using ownerMap = std::unordered_map<std::string, global_broker_id>;
+    ownerMap* getMap(handle_type type);
+    const ownerMap* getMap(handle_type type) const;
+
+    ownerMap publications;  //!< the owners of the publications
+    ownerMap inputs;  //!< the owners of the inputs
+    ownerMap endpoints;  //!< the owners of the endpoints
+    ownerMap filters;  //!< the owners of the filters
+};
+
+}  // namespace helics
@@ -0,0 +1,181 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#include "InterfaceNameIndex.hpp"
+
+#include <algorithm>
+
+namespace helics {
+static constexpr const char* patternWildcards{"*?"};
+
+bool isNamePattern(const std::string& name)
+{
+    return name.find_first_of(patternWildcards) != std::string::npos;
+}
+
+bool matchNamePattern(const std::string& pattern, const std::string& name)
+{
+    std::size_t pi{0};
+    std::size_t ni{0};
+    std::size_t star{std::string::npos};
+    std::size_t starMatch{0};
+    while (ni < name.size()) {
+        if (pi < pattern.size() && (pattern[pi] == '?' || pattern[pi] == name[ni])) {
+            ++pi;
+            ++ni;
+        } else if (pi < pattern.size() && pattern[pi] == '*') {
+            star = pi++;
+            starMatch = ni;
+        } else if (star != std::string::npos) {
+            // let the last '*' absorb one more character and try again
+            pi = star + 1;
+            ni = ++starMatch;
+        } else {
+            return false;
+        }
+    }
+    while (pi < pattern.size() && pattern[pi] == '*') {
+        ++pi;
+    }
+    return pi == pattern.size();
+}
+
+static std::string makeKey(handle_type type, const std::string& name)
+{
+    std::string key;
+    key.reserve(name.size() + 1);
+    key.push_back(static_cast<char>(type));
+    key.append(name);
+    return key;
+}
+
+bool InterfaceNameIndex::addInterface(handle_type type, const std::string& name)
+{
+    auto* node = &root;
+    for (auto c : makeKey(type, name)) {
+        auto& child = node->children[c];
+        if (!child) {
+            child = std::make_unique<Node>();
+        }
+        node = child.get();
+    }
+    if (node->terminal) {
+        return false;
+    }
+    node->terminal = true;
+    ++interfaces;
+    return true;
+}
+
+const InterfaceNameIndex::Node* InterfaceNameIndex::findNode(const std::string& key) const
+{
+    const auto* node = &root;
+    for (auto c : key) {
+        auto fnd = node->children.find(c);
+        if (fnd == node->children.end()) {
+            return nullptr;
+        }
+        node = fnd->second.get();
+    }
+    return node;
+}
+
+template<class NodeT>
+static void collectMatches(const NodeT& node,
+                           std::string& key,
+                           const std::string& patternKey,
+                           std::vector<std::string>& matches)
+{
+    if (node.terminal && matchNamePattern(patternKey, key)) {
+        matches.push_back(key.substr(1));
+    }
+    for (const auto& child : node.children) {
+        key.push_back(child.first);
+        collectMatches(*child.second, key, patternKey, matches);
+        key.pop_back();
+    }
+}
+
+std::vector<std::string> InterfaceNameIndex::findInterfaces(handle_type type,
+                                                            const std::string& pattern) const
+{
+    std::vector<std::string> matches;
+    auto patternKey = makeKey(type, pattern);
+    auto key = patternKey.substr(0, patternKey.find_first_of(patternWildcards));
+    const auto* node = findNode(key);
+    if (node != nullptr) {
+        collectMatches(*node, key, patternKey, matches);
+    }
+    return matches;
+}
+
+void InterfaceNameIndex::addPattern(handle_type type, const std::string& pattern, int32_t id)
+{
+    auto patternKey = makeKey(type, pattern);
+    auto* node = &root;
+    for (auto c : patternKey.substr(0, patternKey.find_first_of(patternWildcards))) {
+        auto& child = node->children[c];
+        if (!child) {
+            child = std::make_unique<Node>();
+        }
+        node = child.get();
+    }
+    node->patterns.emplace_back(std::move(patternKey), id);
+    ++patterns;
+}
+
+void InterfaceNameIndex::removePattern(handle_type type, const std::string& pattern, int32_t id)
+{
+    auto patternKey = makeKey(type, pattern);
+    auto* node = findNode(patternKey.substr(0, patternKey.find_first_of(patternWildcards)));
+    if (node == nullptr) {
+        return;
+    }
+    auto& stored = node->patterns;
+    auto fnd = std::find_if(stored.begin(), stored.end(), [id, &patternKey](const auto& entry) {
+        return entry.second == id && entry.first == patternKey;
+    });
+    if (fnd != stored.end()) {
+        stored.erase(fnd);
+        --patterns;
+    }
+}
+
+void InterfaceNameIndex::clear()
+{
+    root.children.clear();
+    root.patterns.clear();
+    root.terminal = false;
+    interfaces = 0;
+    patterns = 0;
+}
+
+std::vector<int32_t> InterfaceNameIndex::findPatterns(handle_type type,
+                                                      const std::string& name) const
+{
+    std::vector<int32_t> ids;
+    if (patterns == 0) {
+        return ids;
+    }
+    auto key = makeKey(type, name);
+    const auto* node = &root;
+    std::size_t depth{0};
+    while (node != nullptr) {
+        for (const auto& pattern : node->patterns) {
+            if (matchNamePattern(pattern.first, key)) {
+                ids.push_back(pattern.second);
+            }
+        }
+        if (depth == key.size()) {
+            break;
+        }
+        auto fnd = node->children.find(key[depth++]);
+        node = (fnd != node->children.end()) ? fnd->second.get() : nullptr;
+    }
+    return ids;
+}
+
+}  // namespace helics
@@ -0,0 +1,74 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+#include "BasicHandleInfo.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace helics {
+/** check if a target name contains the wildcard characters used in name patterns*/
+bool isNamePattern(const std::string& name);
+/** check if a name matches a pattern
+@details '*' matches any sequence of characters including an empty one and '?' matches any single
+character, all other characters must match exactly*/
+bool matchNamePattern(const std::string& pattern, const std::string& name);
+
+/** class holding a prefix trie of interface names and the standing patterns matched against them
+@details the literal prefix of a pattern (the part before the first wildcard) selects a subtree
+of the trie so only names sharing the prefix are tested against the full pattern, and patterns
+are stored at the node of their prefix so a new name only tests the patterns along its path.
+This class is not thread safe*/
+class InterfaceNameIndex {
+  public:
+    /** default constructor*/
+    InterfaceNameIndex() = default;
+    /** add the name of an interface
+    @return false if an interface of the same type and name is already present*/
+    bool addInterface(handle_type type, const std::string& name);
+    /** get the names of the interfaces of a type matching a pattern in lexicographic order*/
+    std::vector<std::string> findInterfaces(handle_type type, const std::string& pattern) const;
+    /** add a standing pattern to match against interfaces of a type
+    @param type the type of interface the pattern matches
+    @param pattern the pattern to match
+    @param id an identifier returned from findPatterns for names matching the pattern*/
+    void addPattern(handle_type type, const std::string& pattern, int32_t id);
+    /** remove a standing pattern added with addPattern*/
+    void removePattern(handle_type type, const std::string& pattern, int32_t id);
+    /** get the identifiers of the standing patterns matching an interface name*/
+    std::vector<int32_t> findPatterns(handle_type type, const std::string& name) const;
+    /** remove all the interface names and patterns*/
+    void clear();
+    /** get the number of interface names in the index*/
+    std::size_t interfaceCount() const { return interfaces; }
+    /** get the number of standing patterns in the index*/
+    std::size_t patternCount() const { return patterns; }
+
+  private:
+    /** a node of the trie, keys are prefixed by the handle type*/
+    struct Node {
+        std::map<char, std::unique_ptr<Node>> children;
+        std::vector<std::pair<std::string, int32_t>> patterns;  //!< patterns ending their prefix
+        bool terminal{false};  //!< an interface name ends at the node
+    };
+    const Node* findNode(const std::string& key) const;
+    Node* findNode(const std::string& key)
+    {
+        return const_cast<Node*>(static_cast<const InterfaceNameIndex*>(this)->findNode(key));
+    }
+
+    Node root;
+    std::size_t interfaces{0};
+    std::size_t patterns{0};
+};
+
+}  // namespace helics
@@ -0,0 +1,78 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "MessageCapture.hpp"
+
+#include "../common/binaryFileHelpers.hpp"
+
+#include <stdexcept>
+
+namespace helics {
+/** the header identifying a message capture file*/
+static constexpr char messageCaptureMagic[8] = {'H', 'E', 'L', 'I', 'C', 'S', 'M', 'C'};
+static constexpr std::uint32_t messageCaptureVersion{1};
+
+MessageCaptureWriter::MessageCaptureWriter(const std::string& fileName):
+    startTime(clock_type::now())
+{
+    outFile.open(fileName, std::ios::binary | std::ios::trunc);
+    if (!outFile) {
+        throw(std::ios_base::failure("unable to open message capture file " + fileName));
+    }
+    writeBinaryFileHeader(outFile, messageCaptureMagic, messageCaptureVersion);
+}
+
+void MessageCaptureWriter::write(const ActionMessage& command)
+{
+    auto size = command.serializedByteCount();
+    if (buffer.size() < static_cast<std::size_t>(size)) {
+        buffer.resize(static_cast<std::size_t>(size));
+    }
+    size = command.toByteArray(&buffer[0], size);
+    if (size < 0) {
+        return;
+    }
+    std::int64_t timestamp = (clock_type::now() - startTime).count();
+    writeBinaryValue(outFile, timestamp);
+    writeBinaryValue(outFile, static_cast<std::uint32_t>(size));
+    outFile.write(buffer.data(), size);
+    ++messageCount;
+}
+
+void MessageCaptureWriter::flush()
+{
+    outFile.flush();
+}
+
+std::vector<CapturedMessage> loadMessageCapture(const std::string& fileName)
+{
+    std::ifstream input(fileName, std::ios::binary);
+    if (!input) {
+        throw(std::invalid_argument("unable to open " + fileName));
+    }
+    if (!readBinaryFileHeader(input, messageCaptureMagic, messageCaptureVersion)) {
+        throw(std::invalid_argument(fileName + " is not a HELICS message capture"));
+    }
+    std::vector<CapturedMessage> messages;
+    std::string buffer;
+    CapturedMessage entry;
+    std::uint32_t size{0};
+    // a partially written final message is ignored
+    while (readBinaryValue(input, entry.timestamp) && readBinaryValue(input, size)) {
+        buffer.resize(size);
+        if (size > 0 && !input.read(&buffer[0], size)) {
+            break;
+        }
+        if (entry.message.fromByteArray(buffer.data(), static_cast<int>(size)) <= 0) {
+            break;
+        }
+        messages.push_back(entry);
+    }
+    return messages;
+}
+
+}  // namespace helics
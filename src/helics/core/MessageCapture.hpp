@@ -0,0 +1,50 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+
+#include "ActionMessage.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace helics {
+/** a message loaded from a capture file*/
+struct CapturedMessage {
+    std::int64_t timestamp{0};  //!< nanoseconds since the capture started
+    ActionMessage message;  //!< the captured message
+};
+
+/** class writing the stream of messages processed by a broker or core to a binary capture file
+@details the messages are stored in their serialized form so the file can be replayed into a
+standalone broker or core for profiling*/
+class MessageCaptureWriter {
+  public:
+    /** open a capture file
+    @throw std::ios_base::failure if the file cannot be opened*/
+    explicit MessageCaptureWriter(const std::string& fileName);
+    /** append a message to the capture*/
+    void write(const ActionMessage& command);
+    /** flush the written messages to the file*/
+    void flush();
+    /** get the number of messages written*/
+    std::uint64_t count() const { return messageCount; }
+
+  private:
+    using clock_type = std::chrono::steady_clock;
+    std::ofstream outFile;
+    const clock_type::time_point startTime;
+    std::string buffer;  //!< reused storage for serializing the messages
+    std::uint64_t messageCount{0};
+};
+
+/** load all the messages from a capture file
+@throw std::invalid_argument if the file cannot be read or is not a message capture*/
+std::vector<CapturedMessage> loadMessageCapture(const std::string& fileName);
+}  // namespace helics
@@ -13,17 +13,15 @@ SPDX-License-Identifier: BSD-3-Clause
 namespace helics {
 MessageTimer::MessageTimer(std::function<void(ActionMessage&&)> sFunction):
     sendFunction(std::move(sFunction)), contextPtr(AsioContextManager::getContextPointer()),
-    loopHandle(contextPtr->startContextLoop())
+    loopHandle(contextPtr->startContextLoop()), driver(contextPtr->getBaseContext())
 {
 }
 
-static void processTimerCallback(std::shared_ptr<MessageTimer> mtimer,
-                                 int32_t index,
-                                 const std::error_code& ec)
+static void processTimerCallback(std::shared_ptr<MessageTimer> mtimer, const std::error_code& ec)
 {
     if (ec != asio::error::operation_aborted) {
         try {
-            mtimer->sendMessage(index);
+            mtimer->processExpiredTimers();
         }
         catch (std::exception& e) {
             std::cerr << "exception caught from sendMessage:" << e.what() << std::endl;
@@ -38,24 +36,16 @@ int32_t MessageTimer::addTimerFromNow(std::chrono::nanoseconds time, ActionMessa
 
 int32_t MessageTimer::addTimer(time_type expirationTime, ActionMessage mess)
 {
-    // these two calls need to be before the lock
-    auto timer = std::make_shared<asio::steady_timer>(contextPtr->getBaseContext());
-    timer->expires_at(expirationTime);
-
     std::unique_lock<std::mutex> lock(timerLock);
 
-    auto index = static_cast<int32_t>(timers.size());
-    auto timerCallback = [ptr = shared_from_this(), index](const std::error_code& ec) {
-        processTimerCallback(ptr, index, ec);
-    };
+    auto index = static_cast<int32_t>(buffers.size());
     buffers.push_back(std::move(mess));
     expirationTimes.push_back(expirationTime);
-    timers.push_back(std::move(timer));
     if (expirationTime > std::chrono::steady_clock::now()) {
-        timers.back()->async_wait(timerCallback);
+        scheduleTimer(index, expirationTime);
     } else {
         lock.unlock();
-        timerCallback(std::error_code{});
+        sendMessage(index);
     }
 
     return index;
@@ -64,9 +54,9 @@ int32_t MessageTimer::addTimer(time_type expirationTime, ActionMessage mess)
 void MessageTimer::cancelTimer(int32_t index)
 {
     std::lock_guard<std::mutex> lock(timerLock);
-    if ((index >= 0) && (index < static_cast<int32_t>(timers.size()))) {
+    if ((index >= 0) && (index < static_cast<int32_t>(buffers.size()))) {
         buffers[index].setAction(CMD_IGNORE);
-        timers[index]->cancel();
+        wheel.cancel(index);
     }
 }
 
@@ -76,40 +66,32 @@ void MessageTimer::cancelAll()
     for (auto& buf : buffers) {
         buf.setAction(CMD_IGNORE);
     }
-    for (auto& tmr : timers) {
-        tmr->cancel();
-    }
+    wheel.clear();
+    driver.cancel();
+    armedTime = time_type::max();
 }
 
 void MessageTimer::updateTimer(int32_t timerIndex, time_type expirationTime, ActionMessage mess)
 {
     std::lock_guard<std::mutex> lock(timerLock);
-    if ((timerIndex >= 0) && (timerIndex < static_cast<int32_t>(timers.size()))) {
-        timers[timerIndex]->expires_at(expirationTime);
+    if ((timerIndex >= 0) && (timerIndex < static_cast<int32_t>(buffers.size()))) {
         expirationTimes[timerIndex] = expirationTime;
         buffers[timerIndex] = std::move(mess);
-
-        auto timerCallback = [ptr = shared_from_this(), timerIndex](const std::error_code& ec) {
-            processTimerCallback(ptr, timerIndex, ec);
-        };
-
-        timers[timerIndex]->async_wait(timerCallback);
+        scheduleTimer(timerIndex, expirationTime);
     }
 }
 
 bool MessageTimer::addTimeToTimer(int32_t timerIndex, std::chrono::nanoseconds time)
 {
     std::lock_guard<std::mutex> lock(timerLock);
-    if ((timerIndex >= 0) && (timerIndex < static_cast<int32_t>(timers.size()))) {
-        auto newTime = timers[timerIndex]->expires_at() + time;
-        timers[timerIndex]->expires_at(newTime);
-        auto timerCallback = [ptr = shared_from_this(), timerIndex](const std::error_code& ec) {
-            processTimerCallback(ptr, timerIndex, ec);
-        };
+    if ((timerIndex >= 0) && (timerIndex < static_cast<int32_t>(buffers.size()))) {
+        auto newTime = expirationTimes[timerIndex] + time;
         expirationTimes[timerIndex] = newTime;
-        auto ret = (buffers[timerIndex].action() != CMD_IGNORE);
-        timers[timerIndex]->async_wait(timerCallback);
-        return ret;
+        if (buffers[timerIndex].action() == CMD_IGNORE) {
+            return false;
+        }
+        scheduleTimer(timerIndex, newTime);
+        return true;
     }
     return false;
 }
@@ -117,15 +99,13 @@ bool MessageTimer::addTimeToTimer(int32_t timerIndex, std::chrono::nanoseconds t
 bool MessageTimer::updateTimer(int32_t timerIndex, time_type expirationTime)
 {
     std::lock_guard<std::mutex> lock(timerLock);
-    if ((timerIndex >= 0) && (timerIndex < static_cast<int32_t>(timers.size()))) {
-        timers[timerIndex]->expires_at(expirationTime);
-        auto timerCallback = [ptr = shared_from_this(), timerIndex](const std::error_code& ec) {
-            processTimerCallback(ptr, timerIndex, ec);
-        };
+    if ((timerIndex >= 0) && (timerIndex < static_cast<int32_t>(buffers.size()))) {
         expirationTimes[timerIndex] = expirationTime;
-        auto ret = (buffers[timerIndex].action() != CMD_IGNORE);
-        timers[timerIndex]->async_wait(timerCallback);
-        return ret;
+        if (buffers[timerIndex].action() == CMD_IGNORE) {
+            return false;
+        }
+        scheduleTimer(timerIndex, expirationTime);
+        return true;
     }
     return false;
 }
@@ -134,7 +114,7 @@ bool MessageTimer::updateTimer(int32_t timerIndex, time_type expirationTime)
 void MessageTimer::updateMessage(int32_t timerIndex, ActionMessage mess)
 {
     std::lock_guard<std::mutex> lock(timerLock);
-    if ((timerIndex >= 0) && (timerIndex < static_cast<int32_t>(timers.size()))) {
+    if ((timerIndex >= 0) && (timerIndex < static_cast<int32_t>(buffers.size()))) {
         buffers[timerIndex] = std::move(mess);
     }
 }
@@ -142,11 +122,12 @@ void MessageTimer::updateMessage(int32_t timerIndex, ActionMessage mess)
 void MessageTimer::sendMessage(int32_t timerIndex)
 {
     std::unique_lock<std::mutex> lock(timerLock);
-    if ((timerIndex >= 0) && (timerIndex < static_cast<int32_t>(timers.size()))) {
+    if ((timerIndex >= 0) && (timerIndex < static_cast<int32_t>(buffers.size()))) {
         if (std::chrono::steady_clock::now() >= expirationTimes[timerIndex]) {
             if (buffers[timerIndex].action() != CMD_IGNORE) {
                 ActionMessage buf = std::move(buffers[timerIndex]);
                 buffers[timerIndex].setAction(CMD_IGNORE);  // clear out the action
+                wheel.cancel(timerIndex);
                 lock.unlock();  // don't keep a lock while calling a callback
                 sendFunction(std::move(buf));
             }
@@ -154,4 +135,55 @@ void MessageTimer::sendMessage(int32_t timerIndex)
     }
 }
 
+void MessageTimer::processExpiredTimers()
+{
+    std::vector<ActionMessage> messages;
+    std::unique_lock<std::mutex> lock(timerLock);
+    armedTime = time_type::max();
+    auto now = std::chrono::steady_clock::now();
+    expired.clear();
+    wheel.advance(now, expired);
+    for (auto index : expired) {
+        if (buffers[index].action() == CMD_IGNORE) {
+            continue;
+        }
+        if (now < expirationTimes[index]) {
+            wheel.schedule(index, expirationTimes[index]);
+            continue;
+        }
+        messages.push_back(std::move(buffers[index]));
+        buffers[index].setAction(CMD_IGNORE);  // clear out the action
+    }
+    armTimer();
+    lock.unlock();  // don't keep a lock while calling a callback
+    for (auto& mess : messages) {
+        sendFunction(std::move(mess));
+    }
+}
+
+void MessageTimer::scheduleTimer(int32_t timerIndex, time_type expirationTime)
+{
+    if (wheel.empty()) {
+        // bring an idle wheel up to the current time so the new timer is placed near the bottom
+        expired.clear();
+        wheel.advance(std::chrono::steady_clock::now(), expired);
+    }
+    wheel.schedule(timerIndex, expirationTime);
+    armTimer();
+}
+
+void MessageTimer::armTimer()
+{
+    auto wakeTime = wheel.nextWakeTime();
+    if ((wakeTime == time_type::max()) || (wakeTime >= armedTime)) {
+        return;
+    }
+    armedTime = wakeTime;
+    // setting the expiration cancels any outstanding wait
+    driver.expires_at(wakeTime);
+    driver.async_wait([ptr = shared_from_this()](const std::error_code& ec) {
+        processTimerCallback(ptr, ec);
+    });
+}
+
 }  // namespace helics
@@ -8,6 +8,7 @@ SPDX-License-Identifier: BSD-3-Clause
 
 #include "../common/AsioContextManager.h"
 #include "ActionMessage.hpp"
+#include "TimerWheel.hpp"
 
 #include <asio/steady_timer.hpp>
 #include <memory>
@@ -16,6 +17,8 @@ SPDX-License-Identifier: BSD-3-Clause
 
 namespace helics {
 /** class containing a message timer for sending messages at particular points in time
+@details the timers are kept in a hierarchical timing wheel driven by a single asio timer, so
+adding, updating, and canceling timers do not create any asio objects and take constant time
  */
 class MessageTimer: public std::enable_shared_from_this<MessageTimer> {
   public:
@@ -45,17 +48,29 @@ class MessageTimer: public std::enable_shared_from_this<MessageTimer> {
     void updateMessage(int32_t timerIndex, ActionMessage mess);
     /** execute the send function associated with a message*/
     void sendMessage(int32_t timerIndex);
+    /** send the messages of all the expired timers*/
+    void processExpiredTimers();
 
   private:
+    /** put a timer in the wheel and make sure the asio timer wakes up in time for it
+    @details must be called with the lock held*/
+    void scheduleTimer(int32_t timerIndex, time_type expirationTime);
+    /** arm the asio timer for the next wake time of the wheel
+    @details must be called with the lock held*/
+    void armTimer();
+
     std::mutex timerLock;  //!< lock protecting the timer buffers
     std::vector<ActionMessage> buffers;
     std::vector<time_type> expirationTimes;
     const std::function<void(ActionMessage&&)>
         sendFunction;  //!< the callback to use when sending a message
-    std::vector<std::shared_ptr<asio::steady_timer>> timers;
+    TimerWheel wheel;  //!< the wheel containing the active timers
+    std::vector<int32_t> expired;  //!< buffer for the indices of the expired timers
     std::shared_ptr<AsioContextManager>
         contextPtr;  //!< context manager to for handling real time operations
     decltype(contextPtr->startContextLoop())
         loopHandle;  //!< loop controller for async real time operations
+    asio::steady_timer driver;  //!< the single asio timer driving the wheel
+    time_type armedTime{time_type::max()};  //!< the time the asio timer is set for
 };
 }  // namespace helics
@@ -0,0 +1,398 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "QuerySubscriptions.hpp"
+
+#include "../common/JsonProcessingFunctions.hpp"
+#include "flagOperations.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#ifndef HELICS_DISABLE_ASIO
+#    include "MessageTimer.hpp"
+#else
+namespace helics {
+class MessageTimer {
+};
+}  // namespace helics
+#endif
+
+namespace helics {
+/** the time to wait for the result of a subscription before registering it again*/
+static std::chrono::milliseconds responseTimeout(const QuerySubscription& subscription)
+{
+    return (std::max)(subscription.period * 4, std::chrono::milliseconds(1000));
+}
+
+QuerySubscriptions::QuerySubscriptions(std::function<void(ActionMessage&&)> sendFunction):
+    sendFunction(std::move(sendFunction))
+{
+}
+
+QuerySubscriptions::~QuerySubscriptions()
+{
+    clear();
+}
+
+void QuerySubscriptions::addSubscription(int32_t index, QuerySubscription subscription)
+{
+    if (subscription.period < std::chrono::milliseconds(1)) {
+        subscription.period = std::chrono::milliseconds(1);
+    }
+    removeSubscription(index);
+    subscriptions[index].subscription = std::move(subscription);
+}
+
+global_federate_id QuerySubscriptions::removeSubscription(int32_t index)
+{
+    auto fnd = subscriptions.find(index);
+    if (fnd == subscriptions.end()) {
+        return global_federate_id{};
+    }
+#ifndef HELICS_DISABLE_ASIO
+    if (timer && fnd->second.timerIndex >= 0) {
+        timer->cancelTimer(fnd->second.timerIndex);
+    }
+#endif
+    auto source = fnd->second.source;
+    subscriptions.erase(fnd);
+    return source;
+}
+
+void QuerySubscriptions::clear()
+{
+#ifndef HELICS_DISABLE_ASIO
+    if (timer) {
+        timer->cancelAll();
+    }
+#endif
+    subscriptions.clear();
+}
+
+std::vector<int32_t> QuerySubscriptions::getTickUpdates() const
+{
+    std::vector<int32_t> indices;
+#ifdef HELICS_DISABLE_ASIO
+    auto now = std::chrono::steady_clock::now();
+    for (const auto& sub : subscriptions) {
+        if (sub.second.confirmed) {
+            continue;
+        }
+        if (!sub.second.inFlight ||
+            now - sub.second.queryTime >= responseTimeout(sub.second.subscription)) {
+            indices.push_back(sub.first);
+        }
+    }
+#endif
+    return indices;
+}
+
+const QuerySubscription* QuerySubscriptions::startUpdate(int32_t index)
+{
+    auto fnd = subscriptions.find(index);
+    if (fnd == subscriptions.end()) {
+        return nullptr;
+    }
+    auto& info = fnd->second;
+    if (info.confirmed) {
+        return nullptr;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (info.inFlight) {
+        auto waiting = std::chrono::duration_cast<std::chrono::milliseconds>(now - info.queryTime);
+        if (waiting < responseTimeout(info.subscription)) {
+            scheduleUpdate(index, info, responseTimeout(info.subscription) - waiting);
+            return nullptr;
+        }
+        // the registration or its result was lost so it is sent again
+        ++info.timeouts;
+    }
+    info.inFlight = true;
+    info.queryTime = now;
+    ++info.queries;
+    scheduleUpdate(index, info, responseTimeout(info.subscription));
+    return &(info.subscription);
+}
+
+std::vector<int32_t> QuerySubscriptions::resetInFlight()
+{
+    std::vector<int32_t> indices;
+    for (auto& sub : subscriptions) {
+        if (sub.second.inFlight) {
+            sub.second.inFlight = false;
+            ++sub.second.timeouts;
+            indices.push_back(sub.first);
+        }
+    }
+    return indices;
+}
+
+bool QuerySubscriptions::processResult(int32_t index,
+                                       const std::string& result,
+                                       global_federate_id source)
+{
+    auto fnd = subscriptions.find(index);
+    if (fnd == subscriptions.end()) {
+        return false;
+    }
+    auto& info = fnd->second;
+    if (!info.confirmed && source.isValid()) {
+        info.source = source;
+        // the target sends any later changes so the registration timeout is no longer needed
+        info.confirmed = true;
+        info.inFlight = false;
+#ifndef HELICS_DISABLE_ASIO
+        if (timer && info.timerIndex >= 0) {
+            timer->cancelTimer(info.timerIndex);
+        }
+#endif
+    }
+    if (result != "#wait" &&
+        (!info.delivered || info.subscription.everyPeriod || result != info.lastResult)) {
+        info.lastResult = result;
+        info.delivered = true;
+        ++info.updates;
+        try {
+            info.subscription.callback(info.lastResult);
+        }
+        catch (...) {
+            // a subscriber that cannot handle the results does not get any more of them
+            removeSubscription(index);
+        }
+    }
+    return true;
+}
+
+std::string QuerySubscriptions::generateStatus() const
+{
+    Json::Value base;
+    base["subscriptions"] = Json::arrayValue;
+    for (const auto& sub : subscriptions) {
+        Json::Value subBlock;
+        subBlock["id"] = sub.first;
+        subBlock["target"] = sub.second.subscription.target;
+        subBlock["query"] = sub.second.subscription.query;
+        subBlock["period"] = static_cast<Json::Int64>(sub.second.subscription.period.count());
+        subBlock["every_period"] = sub.second.subscription.everyPeriod;
+        subBlock["confirmed"] = sub.second.confirmed;
+        if (sub.second.source.isValid()) {
+            subBlock["source"] = sub.second.source.baseValue();
+        }
+        subBlock["queries"] = static_cast<Json::UInt64>(sub.second.queries);
+        subBlock["updates"] = static_cast<Json::UInt64>(sub.second.updates);
+        subBlock["timeouts"] = static_cast<Json::UInt64>(sub.second.timeouts);
+        base["subscriptions"].append(std::move(subBlock));
+    }
+    return generateJsonString(base);
+}
+
+void QuerySubscriptions::scheduleUpdate(int32_t index,
+                                        SubscriptionInfo& info,
+                                        std::chrono::milliseconds delay)
+{
+#ifndef HELICS_DISABLE_ASIO
+    ActionMessage update(CMD_QUERY_SUBSCRIPTION);
+    update.messageID = index;
+    if (!timer) {
+        timer = std::make_shared<MessageTimer>(sendFunction);
+    }
+    if (info.timerIndex < 0) {
+        info.timerIndex = timer->addTimerFromNow(delay, std::move(update));
+    } else {
+        timer->updateTimer(info.timerIndex,
+                           std::chrono::steady_clock::now() + delay,
+                           std::move(update));
+    }
+#else
+    (void)index;
+    (void)info;
+    (void)delay;
+#endif
+}
+
+QueryWatchers::QueryWatchers(std::function<void(ActionMessage&&)> sendFunction):
+    sendFunction(std::move(sendFunction))
+{
+}
+
+QueryWatchers::~QueryWatchers()
+{
+    clear();
+}
+
+int32_t QueryWatchers::addWatcher(const ActionMessage& query, global_federate_id target)
+{
+    removeWatcher(query.source_id, query.messageID);
+    auto index = nextIndex++;
+    auto& watcher = watchers[index].watcher;
+    watcher.subscriber = query.source_id;
+    watcher.target = target;
+    watcher.messageID = query.messageID;
+    watcher.query = query.payload;
+    watcher.period = std::chrono::milliseconds((std::max)(query.getExtraData(), 1));
+    watcher.everyPeriod = checkActionFlag(query, indicator_flag);
+    return index;
+}
+
+void QueryWatchers::removeWatcher(global_federate_id subscriber, int32_t messageID)
+{
+    for (auto it = watchers.begin(); it != watchers.end(); ++it) {
+        if (it->second.watcher.subscriber == subscriber &&
+            it->second.watcher.messageID == messageID) {
+#ifndef HELICS_DISABLE_ASIO
+            if (timer && it->second.timerIndex >= 0) {
+                timer->cancelTimer(it->second.timerIndex);
+            }
+#endif
+            watchers.erase(it);
+            return;
+        }
+    }
+}
+
+void QueryWatchers::removeSubscriber(global_federate_id subscriber)
+{
+    auto it = watchers.begin();
+    while (it != watchers.end()) {
+        if (it->second.watcher.subscriber == subscriber) {
+#ifndef HELICS_DISABLE_ASIO
+            if (timer && it->second.timerIndex >= 0) {
+                timer->cancelTimer(it->second.timerIndex);
+            }
+#endif
+            it = watchers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void QueryWatchers::clear()
+{
+#ifndef HELICS_DISABLE_ASIO
+    if (timer) {
+        timer->cancelAll();
+    }
+#endif
+    watchers.clear();
+}
+
+void QueryWatchers::stateChanged(global_federate_id target)
+{
+    auto now = std::chrono::steady_clock::now();
+    for (auto& watch : watchers) {
+        auto& info = watch.second;
+        if (info.pending || info.watcher.target != target) {
+            continue;
+        }
+        info.pending = true;
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - info.updateTime);
+        if (elapsed >= info.watcher.period) {
+            ActionMessage update(CMD_QUERY_SUBSCRIPTION);
+            setActionFlag(update, indicator_flag);
+            update.messageID = watch.first;
+            sendFunction(std::move(update));
+        } else {
+            scheduleUpdate(watch.first, info, info.watcher.period - elapsed);
+        }
+    }
+}
+
+const QueryWatcher* QueryWatchers::startUpdate(int32_t index)
+{
+    auto fnd = watchers.find(index);
+    if (fnd == watchers.end()) {
+        return nullptr;
+    }
+    auto& info = fnd->second;
+    info.pending = info.watcher.everyPeriod;
+    info.updateTime = std::chrono::steady_clock::now();
+    ++info.evaluations;
+    if (info.watcher.everyPeriod) {
+        scheduleUpdate(index, info, info.watcher.period);
+    }
+    return &(info.watcher);
+}
+
+const QueryWatcher* QueryWatchers::updateResult(int32_t index, const std::string& result)
+{
+    auto fnd = watchers.find(index);
+    if (fnd == watchers.end() || result == "#wait") {
+        return nullptr;
+    }
+    auto& info = fnd->second;
+    if (info.sent && !info.watcher.everyPeriod && result == info.lastResult) {
+        return nullptr;
+    }
+    info.lastResult = result;
+    info.sent = true;
+    ++info.updates;
+    return &(info.watcher);
+}
+
+std::vector<int32_t> QueryWatchers::getTickUpdates() const
+{
+    std::vector<int32_t> indices;
+#ifdef HELICS_DISABLE_ASIO
+    auto now = std::chrono::steady_clock::now();
+    for (const auto& watch : watchers) {
+        if (watch.second.pending && now - watch.second.updateTime >= watch.second.watcher.period) {
+            indices.push_back(watch.first);
+        }
+    }
+#endif
+    return indices;
+}
+
+std::string QueryWatchers::generateStatus() const
+{
+    Json::Value base;
+    base["watchers"] = Json::arrayValue;
+    for (const auto& watch : watchers) {
+        Json::Value watchBlock;
+        watchBlock["id"] = watch.first;
+        watchBlock["subscriber"] = watch.second.watcher.subscriber.baseValue();
+        if (watch.second.watcher.target.isValid()) {
+            watchBlock["target"] = watch.second.watcher.target.baseValue();
+        }
+        watchBlock["query"] = watch.second.watcher.query;
+        watchBlock["period"] = static_cast<Json::Int64>(watch.second.watcher.period.count());
+        watchBlock["every_period"] = watch.second.watcher.everyPeriod;
+        watchBlock["evaluations"] = static_cast<Json::UInt64>(watch.second.evaluations);
+        watchBlock["updates"] = static_cast<Json::UInt64>(watch.second.updates);
+        base["watchers"].append(std::move(watchBlock));
+    }
+    return generateJsonString(base);
+}
+
+void QueryWatchers::scheduleUpdate(int32_t index,
+                                   WatcherInfo& info,
+                                   std::chrono::milliseconds delay)
+{
+#ifndef HELICS_DISABLE_ASIO
+    ActionMessage update(CMD_QUERY_SUBSCRIPTION);
+    setActionFlag(update, indicator_flag);
+    update.messageID = index;
+    if (!timer) {
+        timer = std::make_shared<MessageTimer>(sendFunction);
+    }
+    if (info.timerIndex < 0) {
+        info.timerIndex = timer->addTimerFromNow(delay, std::move(update));
+    } else {
+        timer->updateTimer(info.timerIndex,
+                           std::chrono::steady_clock::now() + delay,
+                           std::move(update));
+    }
+#else
+    (void)index;
+    (void)info;
+    (void)delay;
+#endif
+}
+
+}  // namespace helics
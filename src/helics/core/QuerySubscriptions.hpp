@@ -0,0 +1,177 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+
+#include "ActionMessage.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace helics {
+class MessageTimer;
+
+/** a query subscription made by a core or broker with the results pushed to a callback*/
+class QuerySubscription {
+  public:
+    std::string target;  //!< the target of the query
+    std::string query;  //!< the query string
+    std::function<void(const std::string&)> callback;  //!< the function receiving the results
+    std::chrono::milliseconds period{500};  //!< the minimum time between updates
+    bool everyPeriod{false};  //!< deliver the result every period even if it has not changed
+};
+
+/** class managing the query subscriptions made by a core or broker
+@details all the functions are expected to be called from the processing loop of the core or broker
+only.  A subscription is registered once with the core or broker answering the query, which sends
+the first result and then a new result whenever the state it watches changes.  The ActionMessages
+for a subscription carry the negative of the subscription index as a messageID so the results can
+be separated from regular queries.  A subscription without a first result is sent again after a
+timeout so a lost message does not stall it*/
+class QuerySubscriptions {
+  public:
+    /** construct with a function to send messages back to the processing loop*/
+    explicit QuerySubscriptions(std::function<void(ActionMessage&&)> sendFunction);
+    /** destructor to stop any timers*/
+    ~QuerySubscriptions();
+    /** add a new subscription
+    @details the registration should be started by the caller*/
+    void addSubscription(int32_t index, QuerySubscription subscription);
+    /** remove a subscription and stop its timer
+    @return the id of the core or broker sending the results, invalid if none arrived*/
+    global_federate_id removeSubscription(int32_t index);
+    /** remove all the subscriptions*/
+    void clear();
+    /** check if there are any subscriptions*/
+    bool empty() const { return subscriptions.empty(); }
+    /** get the subscriptions which should be registered again on a tick
+    @details this is only used if timers are not available, otherwise it is empty*/
+    std::vector<int32_t> getTickUpdates() const;
+    /** get a subscription that needs to be registered with its target
+    @details a timer is set to register it again if no result arrives within the response timeout
+    @return nullptr if the subscription does not exist, already has a result, or a registration is
+    outstanding and has not timed out*/
+    const QuerySubscription* startUpdate(int32_t index);
+    /** mark all the outstanding registrations as lost
+    @details used when a route is removed and the responses may never arrive
+    @return the indices of the subscriptions which should be registered again*/
+    std::vector<int32_t> resetInFlight();
+    /** process a query result for a subscription
+    @details a result from a watcher completes the registration, other results are delivered but
+    the registration is repeated after the response timeout
+    @param index the subscription index
+    @param result the query result
+    @param source the id of the core or broker holding the watcher, invalid if there is none
+    @return false if the subscription does not exist*/
+    bool processResult(int32_t index, const std::string& result, global_federate_id source);
+    /** generate a JSON description of the active subscriptions*/
+    std::string generateStatus() const;
+
+  private:
+    /** the runtime information for a subscription*/
+    class SubscriptionInfo {
+      public:
+        QuerySubscription subscription;
+        std::string lastResult;  //!< the last result delivered to the callback
+        global_federate_id source;  //!< the core or broker sending the results
+        std::uint64_t updates{0};  //!< the number of results delivered
+        std::uint64_t queries{0};  //!< the number of registrations sent
+        std::uint64_t timeouts{0};  //!< the number of registrations sent again without a result
+        std::chrono::steady_clock::time_point queryTime;  //!< the time of the last registration
+        int32_t timerIndex{-1};  //!< the index of the timer for the registration timeout
+        bool inFlight{false};  //!< a registration is waiting on a result
+        bool delivered{false};  //!< at least one result has been delivered
+        bool confirmed{false};  //!< the registration was accepted by the target
+    };
+    /** schedule a registration timeout for a subscription
+    @param delay the time from now of the timeout*/
+    void scheduleUpdate(int32_t index, SubscriptionInfo& info, std::chrono::milliseconds delay);
+
+    std::map<int32_t, SubscriptionInfo> subscriptions;
+    std::function<void(ActionMessage&&)> sendFunction;
+    std::shared_ptr<MessageTimer> timer;  //!< timer for the registration timeouts
+};
+
+/** a query subscription held by the core or broker answering the query*/
+class QueryWatcher {
+  public:
+    global_federate_id subscriber;  //!< the core or broker which made the subscription
+    global_federate_id target;  //!< the federate queried, invalid for the core or broker itself
+    int32_t messageID{0};  //!< the messageID for the results, the negative subscription index
+    std::string query;  //!< the query string
+    std::chrono::milliseconds period{500};  //!< the minimum time between results
+    bool everyPeriod{false};  //!< send the result every period even if it has not changed
+};
+
+/** class managing the query subscriptions held by a core or broker for the subscribers
+@details all the functions are expected to be called from the processing loop of the core or broker
+only.  A change in the state of a target marks its watchers, which are answered again through a
+CMD_QUERY_SUBSCRIPTION message with the indicator_flag set once at least a period has passed since
+their last result.  A result is only sent to the subscriber if it differs from the last one sent,
+unless every period was requested*/
+class QueryWatchers {
+  public:
+    /** construct with a function to send messages back to the processing loop*/
+    explicit QueryWatchers(std::function<void(ActionMessage&&)> sendFunction);
+    /** destructor to stop any timers*/
+    ~QueryWatchers();
+    /** add a watcher for a subscribing query, replacing an earlier one from the same subscription
+    @param query the CMD_QUERY or CMD_BROKER_QUERY making the subscription
+    @param target the federate queried, invalid for the core or broker itself
+    @return the index of the watcher*/
+    int32_t addWatcher(const ActionMessage& query, global_federate_id target);
+    /** remove the watcher for a subscription*/
+    void removeWatcher(global_federate_id subscriber, int32_t messageID);
+    /** remove all the watchers for a subscriber*/
+    void removeSubscriber(global_federate_id subscriber);
+    /** remove all the watchers*/
+    void clear();
+    /** check if there are any watchers*/
+    bool empty() const { return watchers.empty(); }
+    /** note a change in the state watched by the watchers of a target
+    @param target the federate which changed, invalid for the core or broker itself*/
+    void stateChanged(global_federate_id target);
+    /** get a watcher to answer
+    @details a watcher sending results every period is scheduled for the next period
+    @return nullptr if the watcher does not exist*/
+    const QueryWatcher* startUpdate(int32_t index);
+    /** record the result for a watcher
+    @return the watcher if the result should be sent to the subscriber, nullptr otherwise*/
+    const QueryWatcher* updateResult(int32_t index, const std::string& result);
+    /** get the watchers which should be answered on a tick
+    @details this is only used if timers are not available, otherwise it is empty*/
+    std::vector<int32_t> getTickUpdates() const;
+    /** generate a JSON description of the watchers*/
+    std::string generateStatus() const;
+
+  private:
+    /** the runtime information for a watcher*/
+    class WatcherInfo {
+      public:
+        QueryWatcher watcher;
+        std::string lastResult;  //!< the last result sent to the subscriber
+        std::uint64_t updates{0};  //!< the number of results sent
+        std::uint64_t evaluations{0};  //!< the number of times the query was answered
+        std::chrono::steady_clock::time_point updateTime;  //!< the time of the last answer
+        int32_t timerIndex{-1};  //!< the index of the timer for the next answer
+        bool pending{false};  //!< an answer is scheduled
+        bool sent{false};  //!< at least one result has been sent
+    };
+    /** schedule the next answer of a watcher
+    @param delay the time from now of the answer*/
+    void scheduleUpdate(int32_t index, WatcherInfo& info, std::chrono::milliseconds delay);
+
+    std::map<int32_t, WatcherInfo> watchers;
+    int32_t nextIndex{0};
+    std::function<void(ActionMessage&&)> sendFunction;
+    std::shared_ptr<MessageTimer> timer;  //!< timer for the delayed answers
+};
+}  // namespace helics
@@ -0,0 +1,96 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "RealTimePacer.hpp"
+
+#include "../common/JsonProcessingFunctions.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace helics {
+/** the smallest spin window to keep*/
+static constexpr std::chrono::nanoseconds minSpin{std::chrono::microseconds(50)};
+/** the largest spin window to allow*/
+static constexpr std::chrono::nanoseconds maxSpin{std::chrono::milliseconds(5)};
+
+void RealTimePacer::start(time_type startTime)
+{
+    start_clock_time = startTime;
+}
+
+bool RealTimePacer::waitForTime(Time simTime)
+{
+    if (simTime >= Time::maxVal()) {
+        return false;
+    }
+    return waitUntil(start_clock_time + simTime.to_ns());
+}
+
+bool RealTimePacer::waitUntil(time_type deadline)
+{
+    auto now = clock_type::now();
+    if (now >= deadline) {
+        return false;
+    }
+    auto sleepTarget = deadline - spin;
+    if (sleepTarget > now) {
+        std::this_thread::sleep_until(sleepTarget);
+        now = clock_type::now();
+        auto oversleep = std::chrono::duration_cast<std::chrono::nanoseconds>(now - sleepTarget);
+        if (oversleep > spin) {
+            spin = std::min(oversleep + oversleep / 4, maxSpin);
+        } else {
+            // decay slowly toward the observed oversleep so an occasional long wake keeps its margin
+            spin = std::max(spin - (spin - oversleep) / 16, minSpin);
+        }
+    }
+    while (now < deadline) {
+        std::this_thread::yield();
+        now = clock_type::now();
+    }
+    auto error = std::chrono::duration_cast<std::chrono::nanoseconds>(now - deadline).count();
+    ++waits;
+    auto delta = static_cast<double>(error) - jitterMean;
+    jitterMean += delta / static_cast<double>(waits);
+    jitterM2 += delta * (static_cast<double>(error) - jitterMean);
+    jitterMax = std::max(jitterMax, static_cast<std::int64_t>(error));
+    return true;
+}
+
+bool RealTimePacer::recordGrant(Time grantTime, Time allowedLag)
+{
+    ++grants;
+    auto lateness = (elapsed() - grantTime.to_ns()).count();
+    lastDrift = -lateness;
+    maxLateness = std::max(maxLateness, static_cast<std::int64_t>(lateness));
+    if (allowedLag == Time::maxVal()) {
+        return false;
+    }
+    if (lateness > (allowedLag.to_ns() + missTolerance).count()) {
+        ++misses;
+        return true;
+    }
+    return false;
+}
+
+void RealTimePacer::generateStatus(Json::Value& base) const
+{
+    base["grants"] = static_cast<Json::UInt64>(grants);
+    base["waits"] = static_cast<Json::UInt64>(waits);
+    base["deadline_misses"] = static_cast<Json::UInt64>(misses);
+    base["drift"] = static_cast<double>(lastDrift) * 1e-9;
+    base["max_lateness"] = static_cast<double>(maxLateness) * 1e-9;
+    base["jitter_mean"] = jitterMean * 1e-9;
+    base["jitter_max"] = static_cast<double>(jitterMax) * 1e-9;
+    base["jitter_stddev"] =
+        (waits > 1) ? std::sqrt(jitterM2 / static_cast<double>(waits - 1)) * 1e-9 : 0.0;
+    base["spin_window"] = static_cast<double>(spin.count()) * 1e-9;
+}
+
+}  // namespace helics
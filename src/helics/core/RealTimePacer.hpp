@@ -0,0 +1,74 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+
+#include "helics-time.hpp"
+#include "json/forwards.h"
+
+#include <chrono>
+#include <cstdint>
+
+namespace helics {
+/** class pacing the time grants of a realtime federate against the wall clock
+@details waits are made to absolute deadlines measured from a start time so errors do not accumulate
+over steps.  A wait sleeps until shortly before the deadline then spins for the remainder, the spin
+window adapts to the observed oversleep of the operating system so the spinning is limited to what is
+needed to hit the deadline.  Statistics on the wake up jitter, the drift from the wall clock, and
+missed deadlines are accumulated for queries*/
+class RealTimePacer {
+  public:
+    using clock_type = std::chrono::steady_clock;
+    using time_type = decltype(clock_type::now());
+    /** set the wall clock time corresponding to the start of the simulation*/
+    void start(time_type startTime = clock_type::now());
+    /** get the wall clock time the simulation started*/
+    time_type startTime() const { return start_clock_time; }
+    /** get the wall clock time elapsed since the start*/
+    std::chrono::nanoseconds elapsed(time_type now = clock_type::now()) const
+    {
+        return now - start_clock_time;
+    }
+    /** wait until a simulation time is reached on the wall clock
+    @param simTime the simulation time to wait for
+    @return true if a wait was required, false if the time had already passed*/
+    bool waitForTime(Time simTime);
+    /** wait until an absolute deadline
+    @return true if a wait was required, false if the deadline had already passed*/
+    bool waitUntil(time_type deadline);
+    /** record a time grant and check it against its deadline
+    @param grantTime the granted simulation time
+    @param allowedLag the amount the grant may trail the wall clock without being a miss
+    @return true if the grant missed its deadline*/
+    bool recordGrant(Time grantTime, Time allowedLag);
+    /** set the tolerance added to the allowed lag before a grant is considered a missed deadline*/
+    void setMissTolerance(std::chrono::nanoseconds tolerance) { missTolerance = tolerance; }
+    /** get the current spin window*/
+    std::chrono::nanoseconds spinWindow() const { return spin; }
+    /** get the number of deadlines missed*/
+    std::uint64_t deadlineMisses() const { return misses; }
+    /** get the number of grants recorded*/
+    std::uint64_t grantCount() const { return grants; }
+    /** get the largest wake up error in nanoseconds*/
+    std::int64_t maxJitter() const { return jitterMax; }
+    /** add the pacing statistics to a JSON object*/
+    void generateStatus(Json::Value& base) const;
+
+  private:
+    time_type start_clock_time{clock_type::now()};  //!< wall clock time of the simulation start
+    std::chrono::nanoseconds spin{std::chrono::milliseconds(1)};  //!< current spin window
+    std::chrono::nanoseconds missTolerance{
+        std::chrono::microseconds(250)};  //!< tolerance on the allowed lag before a miss
+    std::uint64_t waits{0};  //!< the number of waits made
+    std::uint64_t grants{0};  //!< the number of grants recorded
+    std::uint64_t misses{0};  //!< the number of grants later than the allowed lag
+    double jitterMean{0.0};  //!< mean wake up error in ns
+    double jitterM2{0.0};  //!< sum of squared differences from the mean wake up error
+    std::int64_t jitterMax{0};  //!< the largest wake up error in ns
+    std::int64_t lastDrift{0};  //!< the wall clock lead of the last grant over its time in ns
+    std::int64_t maxLateness{0};  //!< the largest amount a grant trailed the wall clock in ns
+};
+}  // namespace helics
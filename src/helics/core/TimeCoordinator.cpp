@@ -46,6 +46,9 @@ void TimeCoordinator::enteringExecMode(iteration_request mode)
     }
     iterating = mode;
     checkingExec = true;
+    if (info.coupled_iterations && !couplingProbesSent) {
+        sendCouplingProbes();
+    }
     ActionMessage execreq(CMD_EXEC_REQUEST);
     execreq.source_id = source_id;
     if (iterating != iteration_request::no_iterations) {
@@ -247,6 +250,7 @@ void TimeCoordinator::generateConfig(Json::Value& base) const
     base["uninterruptible"] = info.uninterruptible;
     base["wait_for_current_time_updates"] = info.wait_for_current_time_updates;
     base["restrictive_time_policy"] = info.restrictive_time_policy;
+    base["coupled_iterations"] = info.coupled_iterations;
     base["max_iterations"] = info.maxIterations;
 
     if (info.period > timeZero) {
@@ -266,6 +270,25 @@ void TimeCoordinator::generateConfig(Json::Value& base) const
     }
 }
 
+void TimeCoordinator::generateIterationStatus(Json::Value& base) const
+{
+    base["coupled_iterations"] = info.coupled_iterations;
+    base["iteration"] = iteration.load();
+    base["steps"] = iterationStats.steps;
+    base["iterations"] = iterationStats.iterations;
+    base["most_iterations"] = iterationStats.mostIterations;
+    base["last_iterations"] = iterationStats.lastIterations;
+    base["messages_sent"] = static_cast<Json::Int64>(iterationStats.messagesSent);
+    base["messages_skipped"] = static_cast<Json::Int64>(iterationStats.messagesSkipped);
+    base["dependencies"] = Json::arrayValue;
+    for (const auto& dep : dependencies) {
+        Json::Value depstat;
+        depstat["id"] = dep.fedID.baseValue();
+        depstat["converged"] = dep.hasConverged(time_granted);
+        base["dependencies"].append(depstat);
+    }
+}
+
 bool TimeCoordinator::hasActiveTimeDependencies() const
 {
     return dependencies.hasActiveTimeDependencies();
@@ -404,6 +427,13 @@ message_processing_result TimeCoordinator::checkTimeGrant()
     }
     if ((iterating == iteration_request::no_iterations) ||
         (time_exec > time_granted && iterating == iteration_request::iterate_if_needed)) {
+        if (iteration > 0) {
+            iterationStats.steps += 1;
+            iterationStats.iterations += iteration;
+            iterationStats.lastIterations = iteration;
+            iterationStats.mostIterations = std::max(iterationStats.mostIterations,
+                                                     iterationStats.lastIterations);
+        }
         iteration = 0;
         if (time_allow > time_exec) {
             updateTimeGrant();
@@ -442,7 +472,7 @@ message_processing_result TimeCoordinator::checkTimeGrant()
     return message_processing_result::continue_processing;
 }
 
-void TimeCoordinator::sendTimeRequest() const
+void TimeCoordinator::sendTimeRequest()
 {
     ActionMessage upd(CMD_TIME_REQUEST);
     upd.source_id = source_id;
@@ -454,13 +484,18 @@ void TimeCoordinator::sendTimeRequest() const
         setIterationFlags(upd, iterating);
         upd.counter = iteration;
     }
-    transmitTimingMessage(upd);
+    if (isIteratingAtGrant()) {
+        transmitIterationMessage(upd);
+    } else {
+        transmitTimingMessage(upd);
+    }
     //    printf("%d next=%f, exec=%f, Tdemin=%f\n", source_id, static_cast<double>(time_next),
     // static_cast<double>(time_exec), static_cast<double>(time_minDe));
 }
 
 void TimeCoordinator::updateTimeGrant()
 {
+    const bool iterationGrant = isIteratingAtGrant();
     if (iterating != iteration_request::force_iteration) {
         time_granted = time_exec;
         time_grantBase = time_granted;
@@ -472,7 +507,11 @@ void TimeCoordinator::updateTimeGrant()
     if (iterating != iteration_request::no_iterations) {
         dependencies.resetIteratingTimeRequests(time_exec);
     }
-    transmitTimingMessage(treq);
+    if (iterationGrant) {
+        transmitIterationMessage(treq);
+    } else {
+        transmitTimingMessage(treq);
+    }
     // printf("%d GRANT allow=%f next=%f, exec=%f, Tdemin=%f\n", source_id,
     // static_cast<double>(time_allow), static_cast<double>(time_next),
     // static_cast<double>(time_exec), static_cast<double>(time_minDe));
@@ -542,6 +581,11 @@ void TimeCoordinator::removeDependent(global_federate_id fedID)
     if (dep != dependents.end()) {
         if (*dep == fedID) {
             dependents.erase(dep);
+            auto ucd =
+                std::find(uncoupledDependents.begin(), uncoupledDependents.end(), fedID);
+            if (ucd != uncoupledDependents.end()) {
+                uncoupledDependents.erase(ucd);
+            }
             // remove the thread safe version
             auto dlock = dependent_federates.lock();
             auto res = std::find(dlock.begin(), dlock.end(), fedID);
@@ -562,12 +606,147 @@ std::vector<global_federate_id> TimeCoordinator::getDependencies() const
     return *dependency_federates.lock_shared();
 }
 
-void TimeCoordinator::transmitTimingMessage(ActionMessage& msg) const
+void TimeCoordinator::transmitTimingMessage(ActionMessage& msg)
 {
     for (auto dep : dependents) {
         msg.dest_id = dep;
         sendMessageFunction(msg);
     }
+    uncoupledHold = false;
+}
+
+bool TimeCoordinator::isIteratingAtGrant() const
+{
+    return executionMode && (iterating != iteration_request::no_iterations) &&
+        (time_exec == time_granted);
+}
+
+void TimeCoordinator::transmitIterationMessage(ActionMessage& msg)
+{
+    if (!info.coupled_iterations) {
+        iterationStats.messagesSent += static_cast<std::int64_t>(dependents.size());
+        transmitTimingMessage(msg);
+        return;
+    }
+    // the uncoupled dependents see a plain request at the granted time so they cannot advance past
+    // it, but do not take part in the iterations
+    ActionMessage hold(CMD_TIME_REQUEST);
+    hold.source_id = source_id;
+    hold.actionTime = time_granted;
+    hold.Te = time_granted;
+    hold.Tdemin = time_granted;
+    const bool isRequest = (msg.action() == CMD_TIME_REQUEST);
+    for (auto dep : dependents) {
+        // dependents are treated as coupled until their probe comes back without reaching this
+        // federate, brokers and cores are never probed so they always get the messages
+        if (std::find(uncoupledDependents.begin(), uncoupledDependents.end(), dep) ==
+            uncoupledDependents.end()) {
+            msg.dest_id = dep;
+            sendMessageFunction(msg);
+        } else if (uncoupledHold) {
+            ++iterationStats.messagesSkipped;
+            continue;
+        } else if (isRequest) {
+            hold.dest_id = dep;
+            sendMessageFunction(hold);
+        } else {
+            msg.dest_id = dep;
+            sendMessageFunction(msg);
+        }
+        ++iterationStats.messagesSent;
+    }
+    if (isRequest) {
+        uncoupledHold = true;
+    }
+}
+
+void TimeCoordinator::sendCouplingProbes()
+{
+    couplingProbesSent = true;
+    ActionMessage probe(CMD_TIME_COUPLING_PROBE);
+    probe.source_id = source_id;
+    probe.source_handle = interface_handle(source_id.baseValue());
+    for (auto dep : dependents) {
+        if (dep.isFederate()) {
+            probe.dest_id = dep;
+            probe.dest_handle = interface_handle(dep.baseValue());
+            sendMessageFunction(probe);
+        }
+    }
+}
+
+void TimeCoordinator::processCouplingMessage(const ActionMessage& cmd)
+{
+    // the origin and first hop of the probe are carried in the handle fields
+    const global_federate_id origin(cmd.source_handle.baseValue());
+    const global_federate_id hop(cmd.dest_handle.baseValue());
+    auto probe = std::find_if(couplingProbes.begin(),
+                              couplingProbes.end(),
+                              [origin, hop](const CouplingProbe& prb) {
+                                  return (prb.origin == origin) && (prb.hop == hop);
+                              });
+    ActionMessage ack(CMD_TIME_COUPLING_ACK);
+    ack.source_id = source_id;
+    ack.source_handle = cmd.source_handle;
+    ack.dest_handle = cmd.dest_handle;
+    if (cmd.action() == CMD_TIME_COUPLING_PROBE) {
+        ack.dest_id = cmd.source_id;
+        if (origin == source_id) {
+            setActionFlag(ack, indicator_flag);
+            sendMessageFunction(ack);
+            return;
+        }
+        if (probe != couplingProbes.end()) {
+            // the first copy of the probe reports anything reachable from here
+            sendMessageFunction(ack);
+            return;
+        }
+        CouplingProbe newProbe;
+        newProbe.origin = origin;
+        newProbe.hop = hop;
+        newProbe.parent = cmd.source_id;
+        ActionMessage fwd(cmd);
+        fwd.source_id = source_id;
+        for (auto dep : dependents) {
+            if (dep.isFederate()) {
+                fwd.dest_id = dep;
+                sendMessageFunction(fwd);
+                ++newProbe.pending;
+            } else {
+                // brokers and cores could forward the timing anywhere so assume a path back
+                newProbe.coupled = true;
+            }
+        }
+        if (newProbe.pending == 0) {
+            if (newProbe.coupled) {
+                setActionFlag(ack, indicator_flag);
+            }
+            sendMessageFunction(ack);
+        }
+        couplingProbes.push_back(newProbe);
+        return;
+    }
+    if (origin == source_id) {
+        if (!checkActionFlag(cmd, indicator_flag) &&
+            std::find(uncoupledDependents.begin(), uncoupledDependents.end(), hop) ==
+                uncoupledDependents.end()) {
+            uncoupledDependents.push_back(hop);
+        }
+        return;
+    }
+    if (probe == couplingProbes.end() || probe->pending <= 0) {
+        return;
+    }
+    if (checkActionFlag(cmd, indicator_flag)) {
+        probe->coupled = true;
+    }
+    if (--probe->pending == 0) {
+        ack.dest_id = probe->parent;
+        if (probe->coupled) {
+            setActionFlag(ack, indicator_flag);
+        }
+        sendMessageFunction(ack);
+    }
 }
 
 message_processing_result TimeCoordinator::checkExecEntry()
@@ -809,6 +988,9 @@ void TimeCoordinator::setOptionFlag(int optionFlag, bool value)
         case defs::flags::restrictive_time_policy:
             info.restrictive_time_policy = value;
             break;
+        case defs::flags::coupled_iterations:
+            info.coupled_iterations = value;
+            break;
         default:
             break;
     }
@@ -856,6 +1038,8 @@ bool TimeCoordinator::getOptionFlag(int optionFlag) const
             return info.wait_for_current_time_updates;
         case defs::flags::restrictive_time_policy:
             return info.restrictive_time_policy;
+        case defs::flags::coupled_iterations:
+            return info.coupled_iterations;
         default:
             throw(std::invalid_argument("flag not recognized"));
     }
@@ -12,6 +12,7 @@ SPDX-License-Identifier: BSD-3-Clause
 
 #include "json/forwards.h"
 #include <atomic>
+#include <cstdint>
 #include <deque>
 #include <functional>
 #include <string>
@@ -42,10 +43,34 @@ class tcoptions {
     bool wait_for_current_time_updates = false;
     bool uninterruptible = false;
     bool restrictive_time_policy = false;
-    // 1 byte gap
+    bool coupled_iterations = false;
     int maxIterations = 50;
 };
 
+/** statistics on the iterations of a time coordinator*/
+class IterationStatistics {
+  public:
+    std::int32_t steps{0};  //!< the number of time steps which needed iterations
+    std::int32_t iterations{0};  //!< the total number of iterations at all time steps
+    std::int32_t mostIterations{0};  //!< the most iterations at a single time step
+    std::int32_t lastIterations{0};  //!< the iterations at the last time step with iterations
+    std::int64_t messagesSent{0};  //!< timing messages sent to dependents during iterations
+    std::int64_t messagesSkipped{0};  //!< iteration messages not sent to uncoupled dependents
+};
+
+/** the state of a coupling probe passing through a federate
+@details a probe is started by a federate with the coupled_iterations option for each of its
+dependents and is forwarded once through every federate that depends on it, if it gets back to
+the starting federate the dependent is part of the strongly coupled set*/
+class CouplingProbe {
+  public:
+    global_federate_id origin;  //!< the federate which started the probe
+    global_federate_id hop;  //!< the dependent of the origin the probe was first sent to
+    global_federate_id parent;  //!< the federate the probe was first received from
+    std::int32_t pending{0};  //!< the number of forwarded probes not yet acknowledged
+    bool coupled{false};  //!< the probe reached the origin through this federate
+};
+
 /** class managing the coordination of time in HELICS
 the time coordinator manages dependencies and computes whether time can advance or enter execution
 mode
@@ -93,6 +118,14 @@ class TimeCoordinator {
   private:
     std::atomic<int32_t> iteration{0};  //!< iteration counter
     bool disconnected{false};
+    /** the dependents outside the coupled set have been sent a request holding them at the granted
+    time for the iterations*/
+    bool uncoupledHold{false};
+    bool couplingProbesSent{false};  //!< the coupling probes for the dependents have been sent
+    IterationStatistics iterationStats;  //!< statistics on the iterations
+    std::vector<CouplingProbe> couplingProbes;  //!< the coupling probes passed through
+    std::vector<global_federate_id>
+        uncoupledDependents;  //!< dependents with no path of dependents back to this federate
 
   public:
     /** default constructor*/
@@ -130,6 +163,8 @@ class TimeCoordinator {
     @details this will work properly even when a federate is processing
     */
     int32_t getCurrentIteration() const { return iteration.load(); }
+    /** get the statistics on the iterations*/
+    const IterationStatistics& getIterationStatistics() const { return iterationStats; }
     /** compute updates to time values
     @return true if they have been modified
     */
@@ -159,9 +194,19 @@ class TimeCoordinator {
     Time getNextPossibleTime() const;
     Time generateAllowedTime(Time testTime) const;
 
-    void sendTimeRequest() const;
+    void sendTimeRequest();
     void updateTimeGrant();
-    void transmitTimingMessage(ActionMessage& msg) const;
+    void transmitTimingMessage(ActionMessage& msg);
+    /** check if the coordinator is iterating at the granted time*/
+    bool isIteratingAtGrant() const;
+    /** transmit a timing message for an iteration at the granted time
+    @details with the coupled_iterations option only the dependents in the strongly coupled set get
+    the message, the others are sent a single non iterative request at the granted time which
+    holds them there until the iterations are finished*/
+    void transmitIterationMessage(ActionMessage& msg);
+    /** send a coupling probe to each federate dependent to find the ones which depend back on this
+    federate*/
+    void sendCouplingProbes();
 
     message_process_result processTimeBlockMessage(const ActionMessage& cmd);
 
@@ -177,6 +222,8 @@ class TimeCoordinator {
     void processConfigUpdateMessage(const ActionMessage& cmd);
     /** process a dependency update message*/
     void processDependencyUpdateMessage(const ActionMessage& cmd);
+    /** process a coupling probe or the acknowledgment of one*/
+    void processCouplingMessage(const ActionMessage& cmd);
     /** add a federate dependency
     @return true if it was actually added, false if the federate was already present
     */
@@ -220,5 +267,7 @@ class TimeCoordinator {
     bool hasActiveTimeDependencies() const;
     /** generate a configuration string(JSON)*/
     void generateConfig(Json::Value& base) const;
+    /** generate the iteration statistics and the convergence of the dependencies (JSON)*/
+    void generateIterationStatus(Json::Value& base) const;
 };
 }  // namespace helics
@@ -47,6 +47,13 @@ class DependencyInfo {
     dependencies
     @return the results of processing the message*/
     bool ProcessMessage(const ActionMessage& m);
+    /** check if the dependency has finished iterating at a time
+    @details the dependency has converged once its next possible time or its next event is past
+    the time, this is only used for reporting*/
+    bool hasConverged(Time iterationTime) const
+    {
+        return (Tnext > iterationTime) || (Te > iterationTime);
+    }
 };
 
 /** class for managing a set of dependencies*/
@@ -0,0 +1,253 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "TimerWheel.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace helics {
+constexpr int TimerWheel::levelCount;
+constexpr int TimerWheel::slotBits;
+constexpr int TimerWheel::slotCount;
+constexpr int TimerWheel::slotMask;
+
+TimerWheel::TimerWheel(std::chrono::nanoseconds resolution, time_type epoch):
+    tickSize(std::max(resolution, std::chrono::nanoseconds(1))), epochTime(epoch)
+{
+    clear();
+}
+
+void TimerWheel::schedule(int32_t index, time_type expiration)
+{
+    if (index < 0) {
+        return;
+    }
+    if (index >= static_cast<int32_t>(entries.size())) {
+        entries.resize(static_cast<std::size_t>(index) + 1);
+    }
+    if (entries[index].level >= 0) {
+        unlink(index);
+    } else {
+        ++activeCount;
+    }
+    entries[index].tick = toTick(expiration);
+    link(index);
+}
+
+void TimerWheel::cancel(int32_t index)
+{
+    if (isScheduled(index)) {
+        unlink(index);
+        --activeCount;
+    }
+}
+
+void TimerWheel::clear()
+{
+    for (auto& level : heads) {
+        level.fill(-1);
+    }
+    for (auto& bits : occupied) {
+        bits.fill(0);
+    }
+    for (auto& entry : entries) {
+        entry.level = -1;
+        entry.next = -1;
+        entry.prev = -1;
+    }
+    activeCount = 0;
+}
+
+bool TimerWheel::isScheduled(int32_t index) const
+{
+    return (index >= 0) && (index < static_cast<int32_t>(entries.size())) &&
+        (entries[index].level >= 0);
+}
+
+void TimerWheel::advance(time_type now, std::vector<int32_t>& expired)
+{
+    // timers scheduled for ticks which were already processed are expired first
+    while (heads[levelCount][0] >= 0) {
+        auto index = heads[levelCount][0];
+        unlink(index);
+        --activeCount;
+        expired.push_back(index);
+    }
+    auto target = toTickFloor(now);
+    while ((activeCount > 0) && (currentTick <= target)) {
+        if ((currentTick & slotMask) == 0) {
+            for (int level = 1; level < levelCount; ++level) {
+                cascade(level);
+                if (((currentTick >> (slotBits * level)) & slotMask) != 0) {
+                    break;
+                }
+            }
+        }
+        auto slot = static_cast<int>(currentTick & slotMask);
+        while (heads[0][slot] >= 0) {
+            auto index = heads[0][slot];
+            unlink(index);
+            --activeCount;
+            expired.push_back(index);
+        }
+        ++currentTick;
+        if (activeCount > 0) {
+            // skip over the ticks with nothing to process
+            currentTick = std::max(currentTick, std::min(nextWorkTick(), target + 1));
+        }
+    }
+    if ((activeCount == 0) && (currentTick <= target)) {
+        currentTick = target + 1;
+    }
+}
+
+TimerWheel::time_type TimerWheel::nextWakeTime() const
+{
+    if (activeCount == 0) {
+        return time_type::max();
+    }
+    auto tick = nextWorkTick();
+    auto maxTick = static_cast<std::uint64_t>((time_type::max() - epochTime) / tickSize);
+    if (tick >= maxTick) {
+        return time_type::max();
+    }
+    return epochTime + tickSize * static_cast<std::int64_t>(tick);
+}
+
+std::uint64_t TimerWheel::toTick(time_type time) const
+{
+    if (time <= epochTime) {
+        return 0;
+    }
+    auto diff = std::chrono::duration_cast<std::chrono::nanoseconds>(time - epochTime);
+    auto ticks = static_cast<std::uint64_t>(diff / tickSize);
+    return (diff % tickSize == std::chrono::nanoseconds(0)) ? ticks : ticks + 1;
+}
+
+std::uint64_t TimerWheel::toTickFloor(time_type time) const
+{
+    if (time <= epochTime) {
+        return 0;
+    }
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(time - epochTime) / tickSize);
+}
+
+void TimerWheel::link(int32_t index)
+{
+    auto& entry = entries[index];
+    int level{0};
+    std::uint64_t position{0};
+    auto delta = entry.tick - currentTick;
+    if (entry.tick < currentTick) {
+        level = levelCount;
+    } else {
+        while ((level < levelCount - 1) &&
+               (delta >= (std::uint64_t{1} << (slotBits * (level + 1))))) {
+            ++level;
+        }
+    }
+    if (level == levelCount) {
+        position = 0;
+    } else if (delta >= (std::uint64_t{1} << (slotBits * levelCount))) {
+        // beyond the span of the wheel so it is held in the last slot of the top level
+        position = (currentTick >> (slotBits * level)) + slotMask;
+    } else {
+        position = entry.tick >> (slotBits * level);
+    }
+    auto slot = static_cast<int>(position & slotMask);
+    entry.level = static_cast<int16_t>(level);
+    entry.slot = static_cast<int16_t>(slot);
+    entry.prev = -1;
+    entry.next = heads[level][slot];
+    if (entry.next >= 0) {
+        entries[entry.next].prev = index;
+    }
+    heads[level][slot] = index;
+    occupied[level][slot >> 6] |= (std::uint64_t{1} << (slot & 63));
+}
+
+void TimerWheel::unlink(int32_t index)
+{
+    auto& entry = entries[index];
+    if (entry.prev >= 0) {
+        entries[entry.prev].next = entry.next;
+    } else {
+        heads[entry.level][entry.slot] = entry.next;
+        if (entry.next < 0) {
+            occupied[entry.level][entry.slot >> 6] &= ~(std::uint64_t{1} << (entry.slot & 63));
+        }
+    }
+    if (entry.next >= 0) {
+        entries[entry.next].prev = entry.prev;
+    }
+    entry.next = -1;
+    entry.prev = -1;
+    entry.level = -1;
+}
+
+void TimerWheel::cascade(int level)
+{
+    auto slot = static_cast<int>((currentTick >> (slotBits * level)) & slotMask);
+    auto index = heads[level][slot];
+    heads[level][slot] = -1;
+    occupied[level][slot >> 6] &= ~(std::uint64_t{1} << (slot & 63));
+    while (index >= 0) {
+        auto next = entries[index].next;
+        link(index);
+        index = next;
+    }
+}
+
+std::uint64_t TimerWheel::nextWorkTick() const
+{
+    if (heads[levelCount][0] >= 0) {
+        return (currentTick > 0) ? currentTick - 1 : 0;
+    }
+    auto next = std::numeric_limits<std::uint64_t>::max();
+    auto offset =
+        nextSlotOffset(occupied[0], static_cast<int>(currentTick & slotMask), 0, slotMask);
+    if (offset >= 0) {
+        next = currentTick + static_cast<std::uint64_t>(offset);
+    }
+    for (int level = 1; level < levelCount; ++level) {
+        auto shift = slotBits * level;
+        auto position = currentTick >> shift;
+        // the current slot is cascaded now on a boundary, otherwise one full turn later
+        bool onBoundary = ((currentTick & ((std::uint64_t{1} << shift) - 1)) == 0);
+        offset = nextSlotOffset(occupied[level],
+                                static_cast<int>(position & slotMask),
+                                onBoundary ? 0 : 1,
+                                onBoundary ? slotMask : slotCount);
+        if (offset >= 0) {
+            next = std::min(next, (position + static_cast<std::uint64_t>(offset)) << shift);
+        }
+    }
+    return next;
+}
+
+int TimerWheel::nextSlotOffset(const SlotBits& bits, int start, int minOffset, int maxOffset)
+{
+    int offset = minOffset;
+    while (offset <= maxOffset) {
+        auto slot = (start + offset) & slotMask;
+        auto word = bits[slot >> 6] >> (slot & 63);
+        if (word == 0) {
+            offset += 64 - (slot & 63);
+            continue;
+        }
+        while ((word & 1U) == 0) {
+            word >>= 1U;
+            ++offset;
+        }
+        return (offset <= maxOffset) ? offset : -1;
+    }
+    return -1;
+}
+
+}  // namespace helics
@@ -0,0 +1,96 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace helics {
+/** hierarchical timing wheel tracking the expiration of a set of indexed timers
+@details time is divided into ticks of a fixed resolution and timers are kept in intrusive lists in
+one of 4 levels of 256 slots, each level covering 256 times the span of the level below.  Scheduling
+and canceling a timer are constant time operations and do not allocate once the storage for an
+index exists.  Timers in the higher levels are moved down a level as the wheel turns so a timer is
+only touched a few times before it expires.  Timers further out than the top level can cover are
+held in the last slot of the top level and rescheduled when it is reached. The wheel does no
+locking and has no notion of the current time beyond what is passed to it*/
+class TimerWheel {
+  public:
+    using time_type = decltype(std::chrono::steady_clock::now());
+    /** construct a timer wheel
+    @param resolution the duration of a single tick of the wheel
+    @param epoch the time corresponding to tick 0*/
+    explicit TimerWheel(std::chrono::nanoseconds resolution = std::chrono::microseconds(250),
+                        time_type epoch = std::chrono::steady_clock::now());
+    /** schedule or reschedule a timer
+    @details timers scheduled in the past expire on the next advance*/
+    void schedule(int32_t index, time_type expiration);
+    /** remove a timer from the wheel if it is scheduled*/
+    void cancel(int32_t index);
+    /** remove all the timers*/
+    void clear();
+    /** check if a timer is scheduled*/
+    bool isScheduled(int32_t index) const;
+    /** get the number of scheduled timers*/
+    std::size_t size() const { return activeCount; }
+    /** check if there are no scheduled timers*/
+    bool empty() const { return activeCount == 0; }
+    /** move the wheel forward to a time
+    @param now the current time
+    @param expired vector which the indices of the timers expiring are appended to*/
+    void advance(time_type now, std::vector<int32_t>& expired);
+    /** get the next time the wheel needs to be advanced
+    @return time_type::max() if there are no scheduled timers*/
+    time_type nextWakeTime() const;
+    /** get the tick resolution of the wheel*/
+    std::chrono::nanoseconds resolution() const { return tickSize; }
+
+  private:
+    static constexpr int levelCount{4};
+    static constexpr int slotBits{8};
+    static constexpr int slotCount{1 << slotBits};
+    static constexpr int slotMask{slotCount - 1};
+    /** the linkage of a single timer*/
+    struct Entry {
+        std::uint64_t tick{0};  //!< the tick the timer expires on
+        int32_t next{-1};  //!< the next timer in the same slot
+        int32_t prev{-1};  //!< the previous timer in the same slot
+        int16_t level{-1};  //!< the level the timer is in, -1 if not scheduled
+        int16_t slot{0};  //!< the slot within the level
+    };
+    /** bitmap of the slots containing timers*/
+    using SlotBits = std::array<std::uint64_t, slotCount / 64>;
+
+    /** convert a time to the first tick at or after it*/
+    std::uint64_t toTick(time_type time) const;
+    /** convert a time to the last tick at or before it*/
+    std::uint64_t toTickFloor(time_type time) const;
+    /** place a timer in the proper slot relative to the current tick*/
+    void link(int32_t index);
+    /** remove a timer from its slot*/
+    void unlink(int32_t index);
+    /** move the timers in the current slot of a level down to the lower levels*/
+    void cascade(int level);
+    /** get the next tick which requires any processing*/
+    std::uint64_t nextWorkTick() const;
+    /** find the offset from a starting slot of the first occupied slot
+    @details the slots wrap around so an offset of slotCount is the starting slot one turn later
+    @return -1 if there are no occupied slots between minOffset and maxOffset*/
+    static int nextSlotOffset(const SlotBits& bits, int start, int minOffset, int maxOffset);
+
+    const std::chrono::nanoseconds tickSize;  //!< the duration of each tick
+    const time_type epochTime;  //!< the time of tick 0
+    std::uint64_t currentTick{0};  //!< the next tick to be processed
+    std::size_t activeCount{0};  //!< the number of scheduled timers
+    std::vector<Entry> entries;  //!< the timer linkage indexed by timer index
+    /** the first timer in each slot, the extra level holds timers scheduled for a processed tick*/
+    std::array<std::array<int32_t, slotCount>, levelCount + 1> heads;
+    std::array<SlotBits, levelCount + 1> occupied;  //!< the slots in each level containing timers
+};
+}  // namespace helics
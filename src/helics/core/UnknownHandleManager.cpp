@@ -8,6 +8,8 @@ SPDX-License-Identifier: BSD-3-Clause
 
 #include "flagOperations.hpp"
 
+#include <set>
+
 namespace helics {
 /** add a missingPublication*/
 void UnknownHandleManager::addUnknownPublication(const std::string& key,
@@ -253,6 +255,101 @@ void UnknownHandleManager::processRequiredUnknowns(
     }
 }
 
+bool UnknownHandleManager::hasUnknown(const std::string& name, char type) const
+{
+    switch (type) {
+        case 'p':
+            return (unknown_publications.count(name) > 0) || (unknown_links.count(name) > 0);
+        case 'i':
+            return (unknown_inputs.count(name) > 0);
+        case 'e':
+            return (unknown_endpoints.count(name) > 0);
+        case 'f':
+            return (unknown_filters.count(name) > 0) || (unknown_src_filters.count(name) > 0) ||
+                (unknown_dest_filters.count(name) > 0);
+        default:
+            return false;
+    }
+}
+
+template<class MapType>
+static void addNames(std::set<std::string>& names, const MapType& tmap)
+{
+    for (const auto& unknown : tmap) {
+        names.insert(unknown.first);
+    }
+}
+
+void UnknownHandleManager::processUnknownNames(
+    std::function<void(const std::string&, char)> cfunc) const
+{
+    std::set<std::string> names;
+    addNames(names, unknown_publications);
+    addNames(names, unknown_links);
+    for (const auto& name : names) {
+        cfunc(name, 'p');
+    }
+    names.clear();
+    addNames(names, unknown_inputs);
+    for (const auto& name : names) {
+        cfunc(name, 'i');
+    }
+    names.clear();
+    addNames(names, unknown_endpoints);
+    for (const auto& name : names) {
+        cfunc(name, 'e');
+    }
+    names.clear();
+    addNames(names, unknown_filters);
+    addNames(names, unknown_src_filters);
+    addNames(names, unknown_dest_filters);
+    for (const auto& name : names) {
+        cfunc(name, 'f');
+    }
+}
+
+void UnknownHandleManager::processUnknowns(
+    std::function<void(const std::string&, char, global_handle, uint16_t)> cfunc) const
+{
+    for (auto& upub : unknown_publications) {
+        cfunc(upub.first, 'p', upub.second.first, upub.second.second);
+    }
+    for (auto& uept : unknown_endpoints) {
+        cfunc(uept.first, 'e', uept.second.first, uept.second.second);
+    }
+    for (auto& uinp : unknown_inputs) {
+        cfunc(uinp.first, 'i', uinp.second.first, uinp.second.second);
+    }
+    for (auto& ufilt : unknown_filters) {
+        cfunc(ufilt.first, 'f', ufilt.second.first, ufilt.second.second);
+    }
+}
+
+void UnknownHandleManager::processUnknownLinks(
+    std::function<void(const std::string&, char, const std::string&)> cfunc) const
+{
+    for (auto& ulink : unknown_links) {
+        cfunc(ulink.first, 'l', ulink.second);
+    }
+    for (auto& ufilt : unknown_src_filters) {
+        cfunc(ufilt.first, 's', ufilt.second);
+    }
+    for (auto& ufilt : unknown_dest_filters) {
+        cfunc(ufilt.first, 'd', ufilt.second);
+    }
+}
+
+void UnknownHandleManager::clear()
+{
+    unknown_publications.clear();
+    unknown_endpoints.clear();
+    unknown_inputs.clear();
+    unknown_filters.clear();
+    unknown_links.clear();
+    unknown_src_filters.clear();
+    unknown_dest_filters.clear();
+}
+
 /** specify a found input*/
 void UnknownHandleManager::clearInput(const std::string& newInput)
 {
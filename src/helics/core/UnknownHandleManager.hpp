@@ -100,6 +100,38 @@ class UnknownHandleManager {
     */
     void processNonOptionalUnknowns(
         std::function<void(const std::string& name, char type, global_handle)> cfunc) const;
+
+    /** check if anything is waiting for an interface
+    @param name the name of the interface
+    @param type 'p' for publication, 'i' for input, 'f' for filter, 'e' for endpoint, the links
+    are included with the publication or filter they start from
+    */
+    bool hasUnknown(const std::string& name, char type) const;
+
+    /** run a callback once for each interface name something is waiting for
+    @param cfunc a callback function with the signature of the name and a character with the type
+    as in hasUnknown
+    */
+    void processUnknownNames(std::function<void(const std::string& name, char type)> cfunc) const;
+
+    /** run a callback for each unknown target
+    @param cfunc a callback function with the signature of the name of the interface, a character
+    with the type as in hasUnknown, the global handle waiting for it, and the flags
+    */
+    void processUnknowns(
+        std::function<void(const std::string& name, char type, global_handle, uint16_t flags)>
+            cfunc) const;
+
+    /** run a callback for each link where neither side is known
+    @param cfunc a callback function with the signature of the publication or filter name, a
+    character with 'l' for a data link, 's' for a source filter link, or 'd' for a destination
+    filter link, and the name of the target
+    */
+    void processUnknownLinks(
+        std::function<void(const std::string& origin, char type, const std::string& target)>
+            cfunc) const;
+    /** remove all the unknowns*/
+    void clear();
 };
 
 }  // namespace helics
@@ -224,6 +224,31 @@ class NullFilterOperator final: public FilterOperator {
     }
 };
 
+/**
+ * FederateOperator abstract class
+ @details a FederateOperator holds the callbacks of a federate driven by the core, the callbacks are
+ run from the core callback threads instead of a user thread blocking on each time request
+ */
+class FederateOperator {
+  public:
+    /** default constructor*/
+    FederateOperator() = default;
+    /**virtual destructor*/
+    virtual ~FederateOperator() = default;
+    /** called when the federate enters initializing mode and again if entry to executing mode
+    iterates
+    @return the iteration request for entering executing mode*/
+    virtual iteration_request initializeOperations() = 0;
+    /** called on entry to executing mode and on each granted time
+    @return the next time to request and the iteration request, a time of Time::maxVal() finalizes
+    the federate*/
+    virtual std::pair<Time, iteration_request> operate(iteration_time newTime) = 0;
+    /** called once the federate has disconnected*/
+    virtual void finalize() = 0;
+    /** called if the federate encounters an error, finalize is called afterward*/
+    virtual void error_handler(int errorCode, const std::string& errorString) = 0;
+};
+
 /** helper template to check whether an index is actually valid for a particular vector
 @tparam SizedDataType a vector like data type that must have a size function
 @param testSize an index to test
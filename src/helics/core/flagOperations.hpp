@@ -36,6 +36,27 @@ enum operation_flags : uint16_t {
 constexpr uint16_t slow_responding_flag =
     14;  // overload of extra_flag4 indicating a federate, core or broker is slow responding
 
+constexpr uint16_t time_aggregation_flag =
+    13;  // overload of extra_flag3 indicating a federate registration lists its time aggregators
+
+constexpr uint16_t query_subscription_flag =
+    13;  // overload of extra_flag3 indicating a query registers or serves a query subscription
+
+constexpr uint16_t interface_directory_flag =
+    7;  // overload of extra_flag1 indicating a broker owns the interfaces registered below it
+
+constexpr uint16_t pattern_target_flag =
+    10;  // flag indicating the target of a named interface command is a name pattern
+
+constexpr uint16_t direct_value_flag =
+    7;  // overload of extra_flag1 indicating the data of a publication was delivered directly
+
+constexpr uint16_t compressed_payload_flag =
+    15;  // overload of nameless_interface_flag indicating a data payload is compressed
+
+constexpr uint16_t compression_capable_flag =
+    15;  // overload of nameless_interface_flag indicating a broker or core decodes compressed data
+
 /** template function to set a flag in an object containing a flags field
 @tparam FlagContainer an object with a .flags field
 @tparam FlagIndex a type that can be used as part of a shift to index into a flag object
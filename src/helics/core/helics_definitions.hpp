@@ -63,6 +63,9 @@ namespace defs {
         enable_init_entry = helics_flag_enable_init_entry,
         /** used to not display warnings on mismatched requested times*/
         ignore_time_mismatch_warnings = helics_flag_ignore_time_mismatch_warnings,
+        /** flag indicating that iterations are only exchanged with federates which are both
+         * dependencies and dependents*/
+        coupled_iterations = helics_flag_coupled_iterations,
         /** make all connections required*/
         connections_required = helics_handle_option_connection_required,
         /** make all connections optional*/
@@ -6,6 +6,7 @@ SPDX-License-Identifier: BSD-3-Clause
 */
 #pragma once
 
+#include "helics/common/BinaryLogger.hpp"
 #include "helics/helics-config.h"
 #include "helics/helics_enums.h"
 
@@ -85,3 +86,70 @@ enum log_level : int {
 #    define LOG_DATA_MESSAGES(id, ident, message)
 #    define LOG_TRACE(id, ident, message)
 #endif
+
+/** deferred formatting log macros, if a binary logger is active the raw arguments are recorded and
+formatted offline, otherwise the message is formatted and sent to the regular logger.  The format
+must be a string literal using only "{}" placeholders, and the arguments must be numbers or string
+literals*/
+#define LOG_DEFERRED(level, id, ident, fmtString, ...)                                             \
+    do {                                                                                           \
+        if (binaryLogger) {                                                                        \
+            static const auto binaryFormatId = helics::BinaryLogger::registerFormat(fmtString);    \
+            binaryLogger->record(level, id.baseValue(), binaryFormatId, __VA_ARGS__);              \
+        } else {                                                                                   \
+            sendToLogger(id, level, ident, fmt::format(fmtString, __VA_ARGS__));                   \
+        }                                                                                          \
+    } while (false)
+
+/** deferred log of an action message, the first placeholder of the format is the command which is
+recorded as the action type in a binary log and described with prettyPrintString otherwise*/
+#define LOG_DEFERRED_COMMAND(level, id, ident, fmtString, command, ...)                            \
+    do {                                                                                           \
+        if (binaryLogger) {                                                                        \
+            static const auto binaryFormatId = helics::BinaryLogger::registerFormat(fmtString);    \
+            binaryLogger->record(level,                                                            \
+                                 id.baseValue(),                                                   \
+                                 binaryFormatId,                                                   \
+                                 actionMessageType((command).action()),                            \
+                                 __VA_ARGS__);                                                     \
+        } else {                                                                                   \
+            sendToLogger(                                                                          \
+                id, level, ident, fmt::format(fmtString, prettyPrintString(command), __VA_ARGS__));\
+        }                                                                                          \
+    } while (false)
+
+#if defined(HELICS_ENABLE_LOGGING) && defined(HELICS_ENABLE_DEBUG_LOGGING)
+#    define LOG_TIMING_DEFERRED(id, ident, fmtString, ...)                                         \
+        do {                                                                                       \
+            if (maxLogLevel >= log_level::timing) {                                                \
+                LOG_DEFERRED(log_level::timing, id, ident, fmtString, __VA_ARGS__);                \
+            }                                                                                      \
+        } while (false)
+#    define LOG_DATA_MESSAGES_DEFERRED(id, ident, fmtString, ...)                                  \
+        do {                                                                                       \
+            if (maxLogLevel >= log_level::data) {                                                  \
+                LOG_DEFERRED(log_level::data, id, ident, fmtString, __VA_ARGS__);                  \
+            }                                                                                      \
+        } while (false)
+#else
+#    define LOG_TIMING_DEFERRED(id, ident, fmtString, ...)
+#    define LOG_DATA_MESSAGES_DEFERRED(id, ident, fmtString, ...)
+#endif
+
+#if defined(HELICS_ENABLE_LOGGING) && defined(HELICS_ENABLE_TRACE_LOGGING)
+#    define LOG_TRACE_DEFERRED(id, ident, fmtString, ...)                                          \
+        do {                                                                                       \
+            if (maxLogLevel >= log_level::trace) {                                                 \
+                LOG_DEFERRED(log_level::trace, id, ident, fmtString, __VA_ARGS__);                 \
+            }                                                                                      \
+        } while (false)
+#    define LOG_TRACE_DEFERRED_COMMAND(id, ident, fmtString, command, ...)                         \
+        do {                                                                                       \
+            if (maxLogLevel >= log_level::trace) {                                                 \
+                LOG_DEFERRED_COMMAND(log_level::trace, id, ident, fmtString, command, __VA_ARGS__);\
+            }                                                                                      \
+        } while (false)
+#else
+#    define LOG_TRACE_DEFERRED(id, ident, fmtString, ...)
+#    define LOG_TRACE_DEFERRED_COMMAND(id, ident, fmtString, command, ...)
+#endif
@@ -147,6 +147,13 @@ class Input {
         data.resize(actualSize);
         helicsInputGetVector(inp, data.data(), actualSize, HELICS_NULL_POINTER, hThrowOnError());
     }
+    /** get a pointer to the current vector value without copying it
+    @param[out] size the number of doubles in the vector
+    @return a pointer valid until a value is next retrieved from the input*/
+    const double* getVectorData(int& size)
+    {
+        return helicsInputGetVectorData(inp, &size, hThrowOnError());
+    }
 
     /** Check if an input is updated **/
     bool isUpdated() const { return (helicsInputIsUpdated(inp) > 0); }
@@ -27,6 +27,7 @@ set(helics_shared_public_headers
     ${HELICS_LIBRARY_SOURCE_DIR}/application_api/queryFunctions.hpp
     ${HELICS_LIBRARY_SOURCE_DIR}/application_api/FederateInfo.hpp
     ${HELICS_LIBRARY_SOURCE_DIR}/application_api/Inputs.hpp
+    ${HELICS_LIBRARY_SOURCE_DIR}/application_api/UnitConversionPlan.hpp
     ${HELICS_LIBRARY_SOURCE_DIR}/application_api/BrokerApp.hpp
     ${HELICS_LIBRARY_SOURCE_DIR}/application_api/CoreApp.hpp
     ${HELICS_LIBRARY_SOURCE_DIR}/application_api/timeOperations.hpp
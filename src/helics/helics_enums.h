@@ -121,7 +121,11 @@ typedef enum {
     /** used to not display warnings on mismatched requested times*/
     helics_flag_ignore_time_mismatch_warnings = 67,
     /** specify that a federate error should terminate the federation*/
-    helics_flag_terminate_on_error = 72
+    helics_flag_terminate_on_error = 72,
+    /** flag indicating that iterations at the current time are only exchanged with dependents
+       which have a chain of dependents leading back to the federate, other dependents see the
+       federate waiting at the current time until it stops iterating*/
+    helics_flag_coupled_iterations = 74
 } helics_federate_flags;
 
 /** log level definitions
@@ -6,10 +6,14 @@ SPDX-License-Identifier: BSD-3-Clause
 */
 #include "CommsInterface.hpp"
 
+#include "../common/ThreadAffinity.hpp"
 #include "../core/core-exceptions.hpp"
+#include "../core/flagOperations.hpp"
 #include "NetworkBrokerData.hpp"
+#include "PayloadCompression.hpp"
 #include "gmlc/utilities/stringOps.h"
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -110,6 +114,7 @@ void CommsInterface::loadNetworkInfo(const NetworkBrokerData& netInfo)
         interfaceNetwork = netInfo.interfaceNetwork;
         maxMessageSize = netInfo.maxMessageSize;
         maxMessageCount = netInfo.maxMessageCount;
+        commsCpus = netInfo.commsCpus;
         brokerInitString = netInfo.brokerInitString;
         autoBroker = netInfo.autobroker;
         switch (netInfo.server_mode) {
@@ -159,6 +164,14 @@ void CommsInterface::propertyUnLock()
 
 void CommsInterface::transmit(route_id rid, const ActionMessage& cmd)
 {
+    if (needsTransmitProcessing(rid, cmd)) {
+        transmit(rid, ActionMessage(cmd));
+        return;
+    }
+    if (directDispatch) {
+        directTransmit(rid, ActionMessage(cmd));
+        return;
+    }
     if (isPriorityCommand(cmd)) {
         txQueue.emplacePriority(rid, cmd);
     } else {
@@ -168,6 +181,13 @@ void CommsInterface::transmit(route_id rid, const ActionMessage& cmd)
 
 void CommsInterface::transmit(route_id rid, ActionMessage&& cmd)
 {
+    if (needsTransmitProcessing(rid, cmd)) {
+        transmitProcessing(cmd);
+    }
+    if (directDispatch) {
+        directTransmit(rid, std::move(cmd));
+        return;
+    }
     if (isPriorityCommand(cmd)) {
         txQueue.emplacePriority(rid, std::move(cmd));
     } else {
@@ -175,6 +195,70 @@ void CommsInterface::transmit(route_id rid, ActionMessage&& cmd)
     }
 }
 
+bool CommsInterface::needsTransmitProcessing(route_id rid, const ActionMessage& cmd) const
+{
+    switch (cmd.action()) {
+        case CMD_REG_BROKER:
+        case CMD_BROKER_ACK:
+            return true;
+        default:
+            break;
+    }
+    if (compressionCodec == 0 || cmd.payload.size() < compressionThreshold ||
+        !isCompressibleCommand(cmd)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(compressionLock);
+    return (compressedRoutes.find(rid) != compressedRoutes.end());
+}
+
+void CommsInterface::transmitProcessing(ActionMessage& cmd)
+{
+    switch (cmd.action()) {
+        case CMD_REG_BROKER:
+        case CMD_BROKER_ACK:
+            // any comms can decode compressed payloads whether or not it compresses its own
+            setActionFlag(cmd, compression_capable_flag);
+            break;
+        default:
+            if (compressPayload(cmd, compressionCodec)) {
+                ++compressedCount;
+            }
+            break;
+    }
+}
+
+bool CommsInterface::receiveProcessing(ActionMessage& cmd)
+{
+    switch (cmd.action()) {
+        case CMD_REG_BROKER:
+            if (checkActionFlag(cmd, compression_capable_flag)) {
+                clearActionFlag(cmd, compression_capable_flag);
+                // the route to the new broker or core is added after the registration is processed
+                std::lock_guard<std::mutex> lock(compressionLock);
+                compressionPeers.insert(cmd.getString(targetStringLoc));
+            }
+            return true;
+        case CMD_BROKER_ACK:
+            if (checkActionFlag(cmd, compression_capable_flag)) {
+                clearActionFlag(cmd, compression_capable_flag);
+                std::lock_guard<std::mutex> lock(compressionLock);
+                compressedRoutes.insert(parent_route_id);
+            }
+            return true;
+        default:
+            break;
+    }
+    if (checkActionFlag(cmd, compressed_payload_flag) && isCompressibleCommand(cmd)) {
+        if (!decompressPayload(cmd)) {
+            logError(std::string("unable to decompress the payload of a ") +
+                     prettyPrintString(cmd) + " message, the message was dropped");
+            return false;
+        }
+    }
+    return true;
+}
+
 void CommsInterface::addRoute(route_id rid, const std::string& routeInfo)
 {
     ActionMessage rt(CMD_PROTOCOL_PRIORITY);
@@ -182,6 +266,10 @@ void CommsInterface::addRoute(route_id rid, const std::string& routeInfo)
     rt.messageID = NEW_ROUTE;
     rt.setExtraData(rid.baseValue());
     transmit(control_route, std::move(rt));
+    std::lock_guard<std::mutex> lock(compressionLock);
+    if (compressionPeers.erase(routeInfo) > 0) {
+        compressedRoutes.insert(rid);
+    }
 }
 
 void CommsInterface::removeRoute(route_id rid)
@@ -190,6 +278,8 @@ void CommsInterface::removeRoute(route_id rid)
     rt.messageID = REMOVE_ROUTE;
     rt.setExtraData(rid.baseValue());
     transmit(control_route, rt);
+    std::lock_guard<std::mutex> lock(compressionLock);
+    compressedRoutes.erase(rid);
 }
 
 void CommsInterface::setTxStatus(connection_status txStatus)
@@ -279,8 +369,15 @@ bool CommsInterface::connect()
     if (randomID.empty()) {
         randomID = gmlc::utilities::randomString(10);
     }
+    if (directDispatch) {
+        syncLock.unlock();
+        return directConnect();
+    }
     if (!singleThread) {
         queue_watcher = std::thread([this] {
+            if (!commsCpus.empty() && !setThreadAffinity(commsCpus)) {
+                logWarning("unable to set the cpu affinity of the receiver");
+            }
             try {
                 queue_rx_function();
             }
@@ -292,6 +389,9 @@ bool CommsInterface::connect()
     }
 
     queue_transmitter = std::thread([this] {
+        if (!commsCpus.empty() && !setThreadAffinity(commsCpus)) {
+            logWarning("unable to set the cpu affinity of the transmitter");
+        }
         try {
             queue_tx_function();
         }
@@ -370,6 +470,12 @@ void CommsInterface::disconnect()
         }
     }
     requestDisconnect.store(true, std::memory_order::memory_order_release);
+    if (directDispatch) {
+        directDisconnect();
+        setRxStatus(connection_status::terminated);
+        setTxStatus(connection_status::terminated);
+        return;
+    }
 
     if (rx_status.load() <= connection_status::connected) {
         closeReceiver();
@@ -444,6 +550,25 @@ void CommsInterface::join_tx_rx_thread()
     }
 }
 
+bool CommsInterface::directConnect()
+{
+    logError("direct dispatch is not supported by this comms type");
+    setRxStatus(connection_status::error);
+    setTxStatus(connection_status::error);
+    return false;
+}
+
+void CommsInterface::directTransmit(route_id rid, ActionMessage&& cmd)
+{
+    if (isPriorityCommand(cmd)) {
+        txQueue.emplacePriority(rid, std::move(cmd));
+    } else {
+        txQueue.emplace(rid, std::move(cmd));
+    }
+}
+
+void CommsInterface::directDisconnect() {}
+
 bool CommsInterface::reconnect()
 {
     rx_status = connection_status::reconnecting;
@@ -477,7 +602,15 @@ bool CommsInterface::reconnect()
 void CommsInterface::setCallback(std::function<void(ActionMessage&&)> callback)
 {
     if (propertyLock()) {
-        ActionCallback = std::move(callback);
+        if (callback) {
+            ActionCallback = [this, callback = std::move(callback)](ActionMessage&& cmd) {
+                if (receiveProcessing(cmd)) {
+                    callback(std::move(cmd));
+                }
+            };
+        } else {
+            ActionCallback = nullptr;
+        }
         propertyUnLock();
     }
 }
@@ -513,6 +646,27 @@ void CommsInterface::setFlag(const std::string& flag, bool val)
     }
 }
 
+bool CommsInterface::setCompression(const std::string& codecName, int threshold)
+{
+    auto codecId = codecName.empty() ? std::uint8_t{0} : getPayloadCodecId(codecName);
+    if (!codecName.empty() && codecId == 0) {
+        logWarning(std::string("unrecognized compression codec :") + codecName);
+        return false;
+    }
+    if (propertyLock()) {
+        compressionCodec = codecId;
+        compressionThreshold = static_cast<std::size_t>(std::max(threshold, 0));
+        propertyUnLock();
+    }
+    return true;
+}
+
+bool CommsInterface::isCompressedRoute(route_id rid) const
+{
+    std::lock_guard<std::mutex> lock(compressionLock);
+    return (compressedRoutes.find(rid) != compressedRoutes.end());
+}
+
 void CommsInterface::setTimeout(std::chrono::milliseconds timeOut)
 {
     if (propertyLock()) {
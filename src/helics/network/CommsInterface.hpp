@@ -12,11 +12,16 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "gmlc/containers/BlockingPriorityQueue.hpp"
 #include "helics/core/ActionMessage.hpp"
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
 #include <thread>
 #include <utility>
+#include <vector>
 
 namespace helics {
 enum class interface_networks : char;
@@ -87,8 +92,20 @@ class CommsInterface {
     void setTimeout(std::chrono::milliseconds timeOut);
     /** set a flag for the comms system*/
     virtual void setFlag(const std::string& flag, bool val);
+    /** check if the comms delivers messages on the calling thread without a transmit thread*/
+    bool isDirectDispatch() const { return directDispatch; }
     /** enable or disable the server mode for the comms*/
     void setServerMode(bool serverActive);
+    /** compress the payload of large data messages sent to routes which support it
+    @param codecName the name of a registered payload codec, empty to disable compression
+    @param threshold the minimum payload size in bytes to compress
+    @return false if the codec is not registered*/
+    bool setCompression(const std::string& codecName, int threshold);
+    /** check if large payloads sent on a route are compressed, which requires the other side to
+    have advertised that it can decode them*/
+    bool isCompressedRoute(route_id rid) const;
+    /** get the number of payloads compressed for transmission*/
+    std::uint64_t getCompressedCount() const { return compressedCount.load(); }
 
     /** generate a log message as a warning*/
     void logWarning(const std::string& message) const;
@@ -136,6 +153,7 @@ class CommsInterface {
         4000};  // timeout for the initial connection to a broker or to bind a broker port(in ms)
     int maxMessageSize = 16 * 1024;  //!< the maximum message size for the queues (if needed)
     int maxMessageCount = 512;  //!< the maximum number of message to buffer (if needed)
+    std::vector<int> commsCpus;  //!< the cpus to run the communication threads on, empty for any
     std::atomic<bool> requestDisconnect{false};  //!< flag gets set when disconnect is called
     std::function<void(ActionMessage&&)>
         ActionCallback;  //!< the callback for what to do with a received message
@@ -148,6 +166,9 @@ class CommsInterface {
     std::atomic<bool> disconnecting{
         false};  //!< flag indicating that the comm system is in the process of disconnecting
     interface_networks interfaceNetwork = interface_networks::local;
+    /** transmit messages on the calling thread and run no threads, must be set before connecting
+    and is only supported by comms implementing the direct functions*/
+    bool directDispatch{false};
 
   private:
     std::thread queue_transmitter;  //!< single thread for sending data
@@ -159,6 +180,28 @@ class CommsInterface {
     virtual void closeReceiver();  //!< function to instruct the receiver loop to close
     virtual void reconnectTransmitter();  //!< function to reconnect the transmitter
     virtual void reconnectReceiver();  //!< function to reconnect the receiver
+    /** establish the connection on the calling thread when using direct dispatch
+    @return true if the connection was successful*/
+    virtual bool directConnect();
+    /** deliver a message on the calling thread when using direct dispatch*/
+    virtual void directTransmit(route_id rid, ActionMessage&& cmd);
+    /** release the connections when using direct dispatch*/
+    virtual void directDisconnect();
+    /** check if a transmitted message needs to be modified before it is queued*/
+    bool needsTransmitProcessing(route_id rid, const ActionMessage& cmd) const;
+    /** advertise compression support and compress the payload of a transmitted message*/
+    void transmitProcessing(ActionMessage& cmd);
+    /** process the compression negotiation and decompress the payload of a received message
+    @return false if the message should be dropped*/
+    bool receiveProcessing(ActionMessage& cmd);
+
+    std::uint8_t compressionCodec{0};  //!< the id of the codec to compress payloads with
+    std::size_t compressionThreshold{0};  //!< the minimum payload size to compress
+    mutable std::mutex compressionLock;  //!< lock protecting the compression routes and peers
+    std::set<route_id> compressedRoutes;  //!< routes accepting compressed payloads
+    std::set<std::string> compressionPeers;  //!< addresses of children accepting compression
+    std::atomic<std::uint64_t> compressedCount{0};  //!< the number of payloads compressed
+
   protected:
     void setTxStatus(connection_status txStatus);
     void setRxStatus(connection_status rxStatus);
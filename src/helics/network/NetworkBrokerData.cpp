@@ -7,6 +7,7 @@ SPDX-License-Identifier: BSD-3-Clause
 
 #include "NetworkBrokerData.hpp"
 
+#include "../common/ThreadAffinity.hpp"
 #include "gmlc/netif/NetIF.hpp"
 #include "helics/core/BrokerFactory.hpp"
 #include "helics/core/helicsCLI11.hpp"
@@ -21,6 +22,7 @@ SPDX-License-Identifier: BSD-3-Clause
 
 #include <algorithm>
 #include <iostream>
+#include <stdexcept>
 #include <utility>
 
 namespace helics {
@@ -88,6 +90,48 @@ std::shared_ptr<helicsCLI11App>
         ->check(CLI::PositiveNumber);
     nbparser->add_option("--networkretries", maxRetries, "the maximum number of network retries")
         ->capture_default_str();
+    nbparser
+        ->add_option(
+            "--io_threads",
+            ioThreads,
+            "the number of dedicated threads receiving data on server connections, connections are "
+            "spread over the threads and read through buffers shared by all connections on a "
+            "thread, 0 to use the shared context (tcp only)")
+        ->capture_default_str()
+        ->check(CLI::NonNegativeNumber);
+    nbparser->add_option_function<std::string>(
+        "--comms_cpus",
+        [this](const std::string& cpus) {
+            try {
+                commsCpus = parseCpuList(cpus);
+            }
+            catch (const std::invalid_argument& ia) {
+                throw(CLI::ValidationError(ia.what()));
+            }
+        },
+        "the cpus to run the transmit, receive, and dedicated io threads of the communication "
+        "interface on as a list of numbers and ranges such as \"0-3,8\"");
+    nbparser->add_option(
+        "--compression",
+        compression,
+        "compress the payload of large data messages sent to brokers and cores which support it "
+        "with the named codec (lz or lzshuffle for arrays of doubles)");
+    nbparser
+        ->add_option("--compression_threshold",
+                     compressionThreshold,
+                     "the minimum payload size in bytes to compress")
+        ->capture_default_str()
+        ->check(CLI::NonNegativeNumber);
+    nbparser->add_flag(
+        "--reliable",
+        reliableUdp,
+        "add sequence numbers, acknowledgements, and retransmission to transmitted datagrams and "
+        "fragment large messages so they are safe for time coordination traffic (udp only)");
+    nbparser->add_flag(
+        "--direct_dispatch",
+        directDispatch,
+        "move transmitted messages directly into the queue of the receiving core or broker on the "
+        "sending thread instead of through a transmit thread (inproc only)");
     nbparser->add_flag("--osport,--use_os_port",
                        use_os_port,
                        "specify that the ports should be allocated by the host operating system");
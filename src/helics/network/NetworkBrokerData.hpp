@@ -53,6 +53,10 @@ class NetworkBrokerData {
     int maxMessageSize{16 * 256};  //!< maximum message size
     int maxMessageCount{256};  //!< maximum message count
     int maxRetries{5};  //!< the maximum number of retries to establish a network connection
+    int ioThreads{0};  //!< the number of dedicated receive threads for a server (0 for shared)
+    std::vector<int> commsCpus;  //!< the cpus to run the communication threads on, empty for any
+    std::string compression;  //!< the name of the codec to compress large payloads with
+    int compressionThreshold{16 * 1024};  //!< the minimum payload size to compress
     interface_networks interfaceNetwork{interface_networks::local};
     bool reuse_address{false};  //!< allow reuse of binding address
     bool use_os_port{false};  //!< specify that any automatic port allocation should use operating
@@ -62,6 +66,8 @@ class NetworkBrokerData {
         false};  //!< flag indicating that the name should be appended to the address
     bool noAckConnection{false};  //!< flag indicating that a connection ack message is not required
                                   //!< for broker connections
+    bool reliableUdp{false};  //!< use sequencing, acknowledgement, and retransmission on udp
+    bool directDispatch{false};  //!< deliver messages on the sending thread with no comm threads
     server_mode_options server_mode{server_mode_options::unspecified};  //!< setup a server mode
   public:
     NetworkBrokerData() = default;
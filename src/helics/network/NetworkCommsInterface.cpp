@@ -77,6 +77,7 @@ bool NetworkCommsInterface::PortAllocator::isPortUsed(const std::string& host, i
 void NetworkCommsInterface::loadNetworkInfo(const NetworkBrokerData& netInfo)
 {
     CommsInterface::loadNetworkInfo(netInfo);
+    setCompression(netInfo.compression, netInfo.compressionThreshold);
     if (!propertyLock()) {
         return;
     }
@@ -0,0 +1,373 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#include "PayloadCompression.hpp"
+
+#include "../core/ActionMessage.hpp"
+#include "../core/flagOperations.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace helics {
+/** the size of the header on a compressed payload, the codec id and the original size*/
+static constexpr std::size_t compressedHeaderSize{5};
+/** the maximum ratio of decompressed to compressed size accepted from a compressed payload*/
+static constexpr std::size_t maxExpansionRatio{1024};
+
+static constexpr std::size_t minMatch{4};
+static constexpr std::size_t maxOffset{65535};
+/** the number of bytes at the end of a block which are always emitted as literals*/
+static constexpr std::size_t tailLiterals{12};
+static constexpr int hashLog{14};
+
+static std::uint32_t read32(const char* data)
+{
+    std::uint32_t val;
+    std::memcpy(&val, data, sizeof(val));
+    return val;
+}
+
+static std::uint32_t hashSequence(std::uint32_t val)
+{
+    return (val * 2654435761U) >> (32 - hashLog);
+}
+
+static void writeLength(std::string& output, std::size_t length)
+{
+    while (length >= 255) {
+        output.push_back(static_cast<char>(0xFF));
+        length -= 255;
+    }
+    output.push_back(static_cast<char>(length));
+}
+
+static bool readLength(const unsigned char*& ip, const unsigned char* iend, std::size_t& length)
+{
+    unsigned char val;
+    do {
+        if (ip >= iend) {
+            return false;
+        }
+        val = *ip++;
+        length += val;
+    } while (val == 255);
+    return true;
+}
+
+/** write a sequence of literals followed by a match, a match length of 0 indicates the final
+ * sequence*/
+static void writeSequence(std::string& output,
+                          const char* literals,
+                          std::size_t literalCount,
+                          std::size_t offset,
+                          std::size_t matchLength)
+{
+    auto token = static_cast<unsigned char>(std::min<std::size_t>(literalCount, 15) << 4U);
+    if (matchLength > 0) {
+        token |= static_cast<unsigned char>(std::min<std::size_t>(matchLength - minMatch, 15));
+    }
+    output.push_back(static_cast<char>(token));
+    if (literalCount >= 15) {
+        writeLength(output, literalCount - 15);
+    }
+    output.append(literals, literalCount);
+    if (matchLength == 0) {
+        return;
+    }
+    output.push_back(static_cast<char>(offset & 0xFFU));
+    output.push_back(static_cast<char>((offset >> 8U) & 0xFFU));
+    if (matchLength - minMatch >= 15) {
+        writeLength(output, matchLength - minMatch - 15);
+    }
+}
+
+/** a byte oriented lz77 compressor in the style of lz4
+@details each sequence is a token byte holding the literal count and match length, the literals,
+and a 2 byte offset to the match, the final sequence holds only literals*/
+class LzCodec final: public PayloadCodec {
+  public:
+    virtual bool compress(const char* data, std::size_t size, std::string& output) const override
+    {
+        std::vector<std::uint32_t> table(std::size_t{1} << hashLog, 0);
+        std::size_t anchor{0};
+        std::size_t pos{0};
+        const std::size_t limit = (size > tailLiterals) ? size - tailLiterals : 0;
+        while (pos < limit) {
+            auto val = read32(data + pos);
+            auto& entry = table[hashSequence(val)];
+            std::size_t candidate = entry;
+            entry = static_cast<std::uint32_t>(pos);
+            if (candidate >= pos || pos - candidate > maxOffset ||
+                read32(data + candidate) != val) {
+                // skip faster through data which is not matching
+                pos += 1 + ((pos - anchor) >> 6U);
+                continue;
+            }
+            std::size_t length{minMatch};
+            while (pos + length < size && data[candidate + length] == data[pos + length]) {
+                ++length;
+            }
+            while (pos > anchor && candidate > 0 && data[pos - 1] == data[candidate - 1]) {
+                --pos;
+                --candidate;
+                ++length;
+            }
+            writeSequence(output, data + anchor, pos - anchor, pos - candidate, length);
+            pos += length;
+            anchor = pos;
+            if (pos < limit) {
+                table[hashSequence(read32(data + pos - 2))] = static_cast<std::uint32_t>(pos - 2);
+            }
+        }
+        writeSequence(output, data + anchor, size - anchor, 0, 0);
+        return true;
+    }
+
+    virtual bool decompress(const char* data,
+                            std::size_t size,
+                            char* output,
+                            std::size_t outputSize) const override
+    {
+        const auto* ip = reinterpret_cast<const unsigned char*>(data);
+        const auto* iend = ip + size;
+        std::size_t op{0};
+        while (true) {
+            if (ip >= iend) {
+                return false;
+            }
+            auto token = *ip++;
+            std::size_t literalCount = token >> 4U;
+            if (literalCount == 15 && !readLength(ip, iend, literalCount)) {
+                return false;
+            }
+            if (literalCount > static_cast<std::size_t>(iend - ip) ||
+                literalCount > outputSize - op) {
+                return false;
+            }
+            std::memcpy(output + op, ip, literalCount);
+            ip += literalCount;
+            op += literalCount;
+            if (ip == iend) {
+                break;
+            }
+            if (iend - ip < 2) {
+                return false;
+            }
+            std::size_t offset = static_cast<std::size_t>(ip[0]) |
+                (static_cast<std::size_t>(ip[1]) << 8U);
+            ip += 2;
+            if (offset == 0 || offset > op) {
+                return false;
+            }
+            std::size_t length = token & 0x0FU;
+            if (length == 15 && !readLength(ip, iend, length)) {
+                return false;
+            }
+            length += minMatch;
+            if (length > outputSize - op) {
+                return false;
+            }
+            // overlapping matches repeat the last offset bytes, so copy in growing blocks which
+            // never overlap the block being written
+            const char* source = output + op - offset;
+            std::size_t span = offset;
+            std::size_t remaining = length;
+            while (remaining > 0) {
+                auto block = std::min(span, remaining);
+                std::memcpy(output + op, source, block);
+                op += block;
+                remaining -= block;
+                span += block;
+            }
+        }
+        return op == outputSize;
+    }
+};
+
+/** the lz codec applied after grouping the bytes of 8 byte values by position
+@details the high order bytes of doubles in an array tend to be similar so grouping them exposes
+much longer matches, any bytes past the last full value are left in place*/
+class LzShuffleCodec final: public PayloadCodec {
+  public:
+    virtual bool compress(const char* data, std::size_t size, std::string& output) const override
+    {
+        std::string shuffled(size, '\0');
+        const std::size_t count = size / stride;
+        for (std::size_t ii = 0; ii < count; ++ii) {
+            for (std::size_t jj = 0; jj < stride; ++jj) {
+                shuffled[jj * count + ii] = data[ii * stride + jj];
+            }
+        }
+        std::copy(data + count * stride, data + size, &shuffled[0] + count * stride);
+        return lz.compress(shuffled.data(), size, output);
+    }
+
+    virtual bool decompress(const char* data,
+                            std::size_t size,
+                            char* output,
+                            std::size_t outputSize) const override
+    {
+        std::string shuffled(outputSize, '\0');
+        if (!lz.decompress(data, size, &shuffled[0], outputSize)) {
+            return false;
+        }
+        const std::size_t count = outputSize / stride;
+        for (std::size_t ii = 0; ii < count; ++ii) {
+            for (std::size_t jj = 0; jj < stride; ++jj) {
+                output[ii * stride + jj] = shuffled[jj * count + ii];
+            }
+        }
+        std::copy(shuffled.begin() + count * stride, shuffled.end(), output + count * stride);
+        return true;
+    }
+
+  private:
+    static constexpr std::size_t stride{8};
+    LzCodec lz;
+};
+
+/** class holding the registered codecs
+@details this needs to be a static member of a function call so it is initialized before use*/
+class CodecRegistry {
+  public:
+    static CodecRegistry& instance()
+    {
+        static CodecRegistry registry;
+        return registry;
+    }
+    void add(const std::string& name, std::uint8_t id, std::shared_ptr<PayloadCodec> codec)
+    {
+        if (id == 0 || !codec) {
+            throw(std::invalid_argument("payload codecs must have a nonzero id"));
+        }
+        std::lock_guard<std::mutex> lock(registryLock);
+        if (names.find(name) != names.end() || codecs.find(id) != codecs.end()) {
+            throw(std::invalid_argument("payload codec " + name + " is already registered"));
+        }
+        names.emplace(name, id);
+        codecs.emplace(id, std::move(codec));
+    }
+    std::uint8_t getId(const std::string& name) const
+    {
+        std::lock_guard<std::mutex> lock(registryLock);
+        auto fnd = names.find(name);
+        return (fnd != names.end()) ? fnd->second : std::uint8_t{0};
+    }
+    std::shared_ptr<const PayloadCodec> get(std::uint8_t id) const
+    {
+        std::lock_guard<std::mutex> lock(registryLock);
+        auto fnd = codecs.find(id);
+        return (fnd != codecs.end()) ? fnd->second : nullptr;
+    }
+
+  private:
+    CodecRegistry()
+    {
+        names.emplace("lz", lzCodecId);
+        codecs.emplace(lzCodecId, std::make_shared<LzCodec>());
+        names.emplace("lzshuffle", lzShuffleCodecId);
+        codecs.emplace(lzShuffleCodecId, std::make_shared<LzShuffleCodec>());
+    }
+    mutable std::mutex registryLock;
+    std::map<std::string, std::uint8_t> names;
+    std::map<std::uint8_t, std::shared_ptr<const PayloadCodec>> codecs;
+};
+
+void registerPayloadCodec(const std::string& name,
+                          std::uint8_t id,
+                          std::shared_ptr<PayloadCodec> codec)
+{
+    CodecRegistry::instance().add(name, id, std::move(codec));
+}
+
+std::uint8_t getPayloadCodecId(const std::string& name)
+{
+    return CodecRegistry::instance().getId(name);
+}
+
+std::shared_ptr<const PayloadCodec> getPayloadCodec(std::uint8_t id)
+{
+    return CodecRegistry::instance().get(id);
+}
+
+bool isCompressibleCommand(const ActionMessage& cmd) noexcept
+{
+    switch (cmd.action()) {
+        case CMD_PUB:
+        case CMD_SEND_MESSAGE:
+        case CMD_SEND_FOR_FILTER:
+        case CMD_SEND_FOR_FILTER_AND_RETURN:
+        case CMD_SEND_FOR_DEST_FILTER_AND_RETURN:
+        case CMD_FILTER_RESULT:
+        case CMD_DEST_FILTER_RESULT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool compressPayload(ActionMessage& cmd, std::uint8_t codecId)
+{
+    const auto size = cmd.payload.size();
+    if (size > 0xFFFFFFFFU || checkActionFlag(cmd, compressed_payload_flag)) {
+        return false;
+    }
+    auto codec = getPayloadCodec(codecId);
+    if (!codec) {
+        return false;
+    }
+    std::string buffer;
+    buffer.reserve(size / 2 + compressedHeaderSize);
+    buffer.push_back(static_cast<char>(codecId));
+    buffer.push_back(static_cast<char>((size >> 24U) & 0xFFU));
+    buffer.push_back(static_cast<char>((size >> 16U) & 0xFFU));
+    buffer.push_back(static_cast<char>((size >> 8U) & 0xFFU));
+    buffer.push_back(static_cast<char>(size & 0xFFU));
+    if (!codec->compress(cmd.payload.data(), size, buffer) || buffer.size() >= size) {
+        return false;
+    }
+    cmd.payload = std::move(buffer);
+    setActionFlag(cmd, compressed_payload_flag);
+    return true;
+}
+
+bool decompressPayload(ActionMessage& cmd)
+{
+    const auto& payload = cmd.payload;
+    if (payload.size() < compressedHeaderSize) {
+        return false;
+    }
+    auto codec = getPayloadCodec(static_cast<std::uint8_t>(payload[0]));
+    if (!codec) {
+        return false;
+    }
+    std::size_t size{0};
+    for (std::size_t ii = 1; ii < compressedHeaderSize; ++ii) {
+        size = (size << 8U) | static_cast<unsigned char>(payload[ii]);
+    }
+    // reject sizes which could not have come from the codecs to limit the allocation
+    if (size / maxExpansionRatio > payload.size()) {
+        return false;
+    }
+    std::string buffer(size, '\0');
+    if (!codec->decompress(payload.data() + compressedHeaderSize,
+                           payload.size() - compressedHeaderSize,
+                           &buffer[0],
+                           size)) {
+        return false;
+    }
+    cmd.payload = std::move(buffer);
+    clearActionFlag(cmd, compressed_payload_flag);
+    return true;
+}
+
+}  // namespace helics
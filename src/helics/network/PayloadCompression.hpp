@@ -0,0 +1,76 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace helics {
+class ActionMessage;
+
+/** interface for a codec used to compress the payload of messages sent over the network
+@details codecs are identified on the wire by a single byte id so the same codec must be registered
+under the same id on both sides of a connection*/
+class PayloadCodec {
+  public:
+    virtual ~PayloadCodec() = default;
+    /** compress a block of data
+    @param data the data to compress
+    @param size the number of bytes in data
+    @param output the string to append the compressed data to
+    @return true if the data was compressed*/
+    virtual bool compress(const char* data, std::size_t size, std::string& output) const = 0;
+    /** decompress a block of data
+    @param data the compressed data
+    @param size the number of bytes of compressed data
+    @param output the location to write the decompressed data
+    @param outputSize the exact size of the decompressed data
+    @return false if the data was not valid or did not decompress to outputSize bytes*/
+    virtual bool decompress(const char* data,
+                            std::size_t size,
+                            char* output,
+                            std::size_t outputSize) const = 0;
+};
+
+/** the id of the built in lz77 codec, a fast byte oriented compressor*/
+constexpr std::uint8_t lzCodecId{1};
+/** the id of the built in codec which transposes the bytes of 8 byte values before applying the lz
+codec, which works much better on arrays of doubles*/
+constexpr std::uint8_t lzShuffleCodecId{2};
+/** the first id available for user defined codecs, lower values are reserved*/
+constexpr std::uint8_t firstUserCodecId{16};
+
+/** register a codec for use in payload compression
+@param name the name used to select the codec
+@param id the id identifying the codec in compressed payloads
+@param codec the codec to register
+@throw std::invalid_argument if the id is 0 or the name or id is already in use*/
+void registerPayloadCodec(const std::string& name,
+                          std::uint8_t id,
+                          std::shared_ptr<PayloadCodec> codec);
+/** get the id of a codec from its name
+@return the id of the codec or 0 if no codec of that name is registered*/
+std::uint8_t getPayloadCodecId(const std::string& name);
+/** get a registered codec from its id
+@return a pointer to the codec or nullptr if no codec is registered with that id*/
+std::shared_ptr<const PayloadCodec> getPayloadCodec(std::uint8_t id);
+
+/** check if a command carries a payload which can be compressed*/
+bool isCompressibleCommand(const ActionMessage& cmd) noexcept;
+/** compress the payload of a message
+@details the payload is only replaced if compression makes it smaller, in which case the
+compressed_payload_flag is set
+@param cmd the message to compress
+@param codecId the id of the codec to use
+@return true if the payload was compressed*/
+bool compressPayload(ActionMessage& cmd, std::uint8_t codecId);
+/** restore the payload of a message with the compressed_payload_flag set
+@return false if the payload could not be decompressed, in which case the message is unchanged*/
+bool decompressPayload(ActionMessage& cmd);
+
+}  // namespace helics
@@ -42,12 +42,25 @@ namespace inproc {
         //{
         //    autoPortNumber = false;
         //}
+        directDispatch = netInfo.directDispatch;
         propertyUnLock();
     }
 
+    void InprocComms::setFlag(const std::string& flag, bool val)
+    {
+        if (flag == "direct_dispatch") {
+            if (propertyLock()) {
+                directDispatch = val;
+                propertyUnLock();
+            }
+        } else {
+            CommsInterface::setFlag(flag, val);
+        }
+    }
+
     void InprocComms::queue_rx_function() {}
 
-    void InprocComms::queue_tx_function()
+    bool InprocComms::establishBrokerConnection()
     {
         using std::chrono::milliseconds;
         // make sure the link to the localTargetAddress is in place
@@ -57,19 +70,18 @@ namespace inproc {
                     if (!BrokerFactory::copyBrokerIdentifier(name, localTargetAddress)) {
                         setRxStatus(connection_status::error);
                         setTxStatus(connection_status::error);
-                        return;
+                        return false;
                     }
                 }
             } else {
                 if (!BrokerFactory::copyBrokerIdentifier(name, localTargetAddress)) {
                     setRxStatus(connection_status::error);
                     setTxStatus(connection_status::error);
-                    return;
+                    return false;
                 }
             }
         }
         setRxStatus(connection_status::connected);
-        std::shared_ptr<CoreBroker> tbroker;
 
         if (brokerName.empty()) {
             if (!brokerTargetAddress.empty()) {
@@ -91,7 +103,7 @@ namespace inproc {
                         if (totalSleep > connectionTimeout) {
                             setTxStatus(connection_status::error);
                             setRxStatus(connection_status::error);
-                            return;
+                            return false;
                         }
                         std::this_thread::sleep_for(milliseconds(200));
                         totalSleep += milliseconds(200);
@@ -106,7 +118,7 @@ namespace inproc {
                         if (totalSleep > milliseconds(connectionTimeout)) {
                             setTxStatus(connection_status::error);
                             setRxStatus(connection_status::error);
-                            return;
+                            return false;
                         }
                     }
                 }
@@ -125,7 +137,7 @@ namespace inproc {
                         if (totalSleep > connectionTimeout) {
                             setTxStatus(connection_status::error);
                             setRxStatus(connection_status::error);
-                            return;
+                            return false;
                         }
                         std::this_thread::sleep_for(milliseconds(200));
                         totalSleep += milliseconds(200);
@@ -143,83 +155,89 @@ namespace inproc {
         }
 
         setTxStatus(connection_status::connected);
-        std::map<route_id, std::shared_ptr<BrokerBase>> routes;
-        bool haltLoop{false};
-        while (!haltLoop) {
-            route_id rid;
-            ActionMessage cmd;
+        return true;
+    }
 
-            std::tie(rid, cmd) = txQueue.pop();
-            bool processed = false;
-            if (isProtocolCommand(cmd)) {
-                if (rid == control_route) {
-                    switch (cmd.messageID) {
-                        case NEW_ROUTE: {
-                            auto& newroute = cmd.payload;
-                            bool foundRoute = false;
-                            auto core = CoreFactory::findCore(newroute);
-                            if (core) {
-                                auto tcore = std::dynamic_pointer_cast<CommonCore>(core);
-                                if (tcore) {
-                                    routes.emplace(route_id{cmd.getExtraData()}, std::move(tcore));
-                                    foundRoute = true;
-                                }
-                            }
-                            auto brk = BrokerFactory::findBroker(newroute);
-
-                            if (brk) {
-                                auto cbrk = std::dynamic_pointer_cast<CoreBroker>(brk);
-                                if (cbrk) {
-                                    routes.emplace(route_id{cmd.getExtraData()}, std::move(cbrk));
-                                    foundRoute = true;
-                                }
+    bool InprocComms::processMessage(route_id rid, ActionMessage& cmd)
+    {
+        if (isProtocolCommand(cmd)) {
+            if (rid == control_route) {
+                switch (cmd.messageID) {
+                    case NEW_ROUTE: {
+                        auto& newroute = cmd.payload;
+                        bool foundRoute = false;
+                        auto core = CoreFactory::findCore(newroute);
+                        if (core) {
+                            auto tcore = std::dynamic_pointer_cast<CommonCore>(core);
+                            if (tcore) {
+                                routes.emplace(route_id{cmd.getExtraData()}, std::move(tcore));
+                                foundRoute = true;
                             }
-                            if (!foundRoute) {
-                                logError(std::string("unable to establish Route to ") + newroute);
+                        }
+                        auto brk = BrokerFactory::findBroker(newroute);
+
+                        if (brk) {
+                            auto cbrk = std::dynamic_pointer_cast<CoreBroker>(brk);
+                            if (cbrk) {
+                                routes.emplace(route_id{cmd.getExtraData()}, std::move(cbrk));
+                                foundRoute = true;
                             }
-                            processed = true;
-                        } break;
-                        case REMOVE_ROUTE:
-                            routes.erase(route_id{cmd.getExtraData()});
-                            processed = true;
-                            break;
-                        case CLOSE_RECEIVER:
-                            setRxStatus(connection_status::terminated);
-                            processed = true;
-                            break;
-                        case DISCONNECT:
-                            haltLoop = true;
-                            continue;
+                        }
+                        if (!foundRoute) {
+                            logError(std::string("unable to establish Route to ") + newroute);
+                        }
+                        return true;
                     }
+                    case REMOVE_ROUTE:
+                        routes.erase(route_id{cmd.getExtraData()});
+                        return true;
+                    case CLOSE_RECEIVER:
+                        setRxStatus(connection_status::terminated);
+                        return true;
+                    case DISCONNECT:
+                        return false;
                 }
             }
-            if (processed) {
-                continue;
-            }
+        }
 
-            if (rid == parent_route_id) {
+        if (rid == parent_route_id) {
+            if (tbroker) {
+                tbroker->addActionMessage(std::move(cmd));
+            } else {
+                logWarning(fmt::format(
+                    "message directed to broker of comm system with no broker, message dropped {}",
+                    prettyPrintString(cmd)));
+            }
+        } else {
+            auto rt_find = routes.find(rid);
+            if (rt_find != routes.end()) {
+                rt_find->second->addActionMessage(std::move(cmd));
+            } else {
                 if (tbroker) {
                     tbroker->addActionMessage(std::move(cmd));
                 } else {
-                    logWarning(fmt::format(
-                        "message directed to broker of comm system with no broker, message dropped {}",
-                        prettyPrintString(cmd)));
-                }
-            } else {
-                auto rt_find = routes.find(rid);
-                if (rt_find != routes.end()) {
-                    rt_find->second->addActionMessage(std::move(cmd));
-                } else {
-                    if (tbroker) {
-                        tbroker->addActionMessage(std::move(cmd));
-                    } else {
-                        if (!isDisconnectCommand(cmd)) {
-                            logWarning(std::string("unknown route, message dropped ") +
-                                       prettyPrintString(cmd));
-                        }
+                    if (!isDisconnectCommand(cmd)) {
+                        logWarning(std::string("unknown route, message dropped ") +
+                                   prettyPrintString(cmd));
                     }
                 }
             }
+        }
+        return true;
+    }
+
+    void InprocComms::queue_tx_function()
+    {
+        if (!establishBrokerConnection()) {
+            return;
+        }
+        bool haltLoop{false};
+        while (!haltLoop) {
+            route_id rid;
+            ActionMessage cmd;
+
+            std::tie(rid, cmd) = txQueue.pop();
+            haltLoop = !processMessage(rid, cmd);
         }  // while (!haltLoop)
 
         routes.clear();
@@ -228,6 +246,52 @@ namespace inproc {
         setTxStatus(connection_status::terminated);
     }
 
+    bool InprocComms::directConnect()
+    {
+        if (!establishBrokerConnection()) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(dispatchLock);
+        // anything sent before the connection was established is delivered in order
+        auto queued = txQueue.try_pop();
+        while (queued) {
+            if (!processMessage(queued->first, queued->second)) {
+                routes.clear();
+                tbroker = nullptr;
+                return true;
+            }
+            queued = txQueue.try_pop();
+        }
+        dispatchReady = true;
+        return true;
+    }
+
+    void InprocComms::directTransmit(route_id rid, ActionMessage&& cmd)
+    {
+        std::lock_guard<std::mutex> lock(dispatchLock);
+        if (!dispatchReady) {
+            if (isPriorityCommand(cmd)) {
+                txQueue.emplacePriority(rid, std::move(cmd));
+            } else {
+                txQueue.emplace(rid, std::move(cmd));
+            }
+            return;
+        }
+        if (!processMessage(rid, cmd)) {
+            dispatchReady = false;
+            routes.clear();
+            tbroker = nullptr;
+        }
+    }
+
+    void InprocComms::directDisconnect()
+    {
+        std::lock_guard<std::mutex> lock(dispatchLock);
+        dispatchReady = false;
+        routes.clear();
+        tbroker = nullptr;
+    }
+
     std::string InprocComms::getAddress() const { return localTargetAddress; }
 
 }  // namespace inproc
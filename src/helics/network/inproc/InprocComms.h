@@ -10,10 +10,15 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "helics/helics-config.h"
 
 #include <future>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 
 namespace helics {
+class BrokerBase;
+class CoreBroker;
 namespace inproc {
     /** implementation for the communication interface that uses ZMQ messages to communicate*/
     class InprocComms final: public CommsInterface {
@@ -24,10 +29,28 @@ namespace inproc {
         ~InprocComms();
 
         virtual void loadNetworkInfo(const NetworkBrokerData& netInfo) override;
+        /** set a flag on the comms, "direct_dispatch" hands messages straight to the receiving
+        core or broker on the calling thread*/
+        virtual void setFlag(const std::string& flag, bool val) override;
 
       private:
         virtual void queue_rx_function() override;  //!< the functional loop for the receive queue
         virtual void queue_tx_function() override;  //!< the loop for transmitting data
+        virtual bool directConnect() override;
+        virtual void directTransmit(route_id rid, ActionMessage&& cmd) override;
+        virtual void directDisconnect() override;
+        /** link the local address and find the broker to connect with
+        @return true if the connection was established*/
+        bool establishBrokerConnection();
+        /** deliver a message or process a control message
+        @return false if the comms should halt*/
+        bool processMessage(route_id rid, ActionMessage& cmd);
+
+        std::shared_ptr<CoreBroker> tbroker;  //!< the broker to send messages to
+        std::map<route_id, std::shared_ptr<BrokerBase>> routes;  //!< the other known routes
+        std::mutex dispatchLock;  //!< protects the routes when dispatching directly
+        bool dispatchReady{false};  //!< the direct dispatch connection is established
+
       public:
         /** return a dummy port number*/
         int getPort() const { return -1; }
@@ -47,6 +47,17 @@ namespace mpi {
             ->ignore_underscore();
         hApp->add_option("--broker_tag,--tag", brokerTag, "mpi tag of a broker using mpi")
             ->ignore_underscore();
+        hApp->add_option("--compression",
+                         compression,
+                         "compress the payload of large data messages sent to brokers and cores "
+                         "which support it with the named codec (lz or lzshuffle for arrays of "
+                         "doubles)");
+        hApp->add_option("--compression_threshold",
+                         compressionThreshold,
+                         "the minimum payload size in bytes to compress")
+            ->ignore_underscore()
+            ->capture_default_str()
+            ->check(CLI::NonNegativeNumber);
         hApp->add_callback([this]() {
             brokerAddress = std::to_string(brokerRank) + ":" + std::to_string(brokerTag);
         });
@@ -65,6 +76,7 @@ namespace mpi {
         }
 
         comms->setName(getIdentifier());
+        comms->setCompression(compression, compressionThreshold);
 
         return comms->connect();
     }
@@ -35,6 +35,8 @@ namespace mpi {
         std::string brokerAddress;  //!< the mpi rank:tag of the broker
         int brokerRank{0};
         int brokerTag{0};
+        std::string compression;  //!< the name of the codec to compress large payloads with
+        int compressionThreshold{16 * 1024};  //!< the minimum payload size to compress
         virtual bool brokerConnect() override;
     };
 
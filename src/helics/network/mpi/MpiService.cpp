@@ -7,13 +7,29 @@ SPDX-License-Identifier: BSD-3-Clause
 
 #include "MpiService.h"
 
+#include <algorithm>
+#include <array>
+#include <climits>
 #include <iostream>
+#include <numeric>
+#include <utility>
 
 namespace helics {
 namespace mpi {
     MPI_Comm MpiService::mpiCommunicator = MPI_COMM_NULL;
     bool MpiService::startServiceThread = true;
 
+    constexpr int MpiService::eagerMessageSize;
+    constexpr int MpiService::eagerReceiveCount;
+    constexpr std::chrono::milliseconds MpiService::idleSpinTime;
+    constexpr std::chrono::microseconds MpiService::maxIdleSleep;
+
+    /** the first byte of a header announcing a rendezvous payload, serialized ActionMessages never
+    start with this value*/
+    static constexpr char rendezvousMarker{'\xE6'};
+    /** the size of a rendezvous header, the marker and the size of the payload*/
+    static constexpr int rendezvousHeaderSize{5};
+
     MpiService& MpiService::getInstance()
     {
         static MpiService instance;
@@ -61,6 +77,9 @@ namespace mpi {
 
             // set commRank to our process rank
             MPI_Comm_rank(mpiCommunicator, &commRank);
+            MPI_Comm_size(mpiCommunicator, &commSize);
+
+            postReceives();
         }
 
         // signal that we have finished starting
@@ -69,10 +88,22 @@ namespace mpi {
         std::cout << "Started MPI service loop for rank " << commRank << std::endl;
 
         // Run as long as we have something in the send queue or the chance of getting something
+        // the service thread is the only one making MPI calls so it can't block in an MPI wait,
+        // instead it keeps polling with yields through the gaps between steps of a co-simulation
+        // and only sleeps for maxIdleSleep between passes once nothing has happened for
+        // idleSpinTime
+        auto lastActivity = std::chrono::steady_clock::now();
         while (!stop_service || comms_connected > 0 || !(txMessageQueue.empty())) {
             // send/receive MPI messages
-            sendAndReceiveMessages();
-            std::this_thread::yield();
+            if (sendAndReceiveMessages() || !txMessageQueue.empty()) {
+                lastActivity = std::chrono::steady_clock::now();
+                continue;
+            }
+            if (std::chrono::steady_clock::now() - lastActivity < idleSpinTime) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(maxIdleSleep);
+            }
         }
 
         MPI_Barrier(mpiCommunicator);
@@ -104,6 +135,13 @@ namespace mpi {
         comms.push_back(comm);
         comms_connected++;
         auto tag = comms.size() - 1;
+        auto unclaimed = unclaimedMessages.find(static_cast<int>(tag));
+        if (unclaimed != unclaimedMessages.end()) {
+            for (auto& message : unclaimed->second) {
+                comm->getRxMessageQueue().emplace(message.data(), message.size());
+            }
+            unclaimedMessages.erase(unclaimed);
+        }
         dataLock.unlock();
         // If somehow this gets called while MPI is still initializing, wait until MPI
         // initialization completes
@@ -157,6 +195,15 @@ namespace mpi {
         return commRank;
     }
 
+    int MpiService::getSize()
+    {
+        while (startup_flag && !stop_service) {
+            ;
+        }
+
+        return commSize;
+    }
+
     int MpiService::getTag(MpiComms* comm)
     {
         std::unique_lock<std::mutex> dataLock(mpiDataLock);
@@ -199,135 +246,274 @@ namespace mpi {
         return true;
     }
 
-    void MpiService::sendAndReceiveMessages()
+    void MpiService::postReceives()
     {
-        // Eventually this entire loop should be redone
-        // Using fixed size chunks for sending messages would allow posting blocks of irecv requests
-        // If we know that a message will get received, a blocking MPI_Wait_any could be used for
-        // send requests Also, a method of doing time synchronization using MPI reductions should be
-        // added
-        std::list<std::pair<MPI_Request, std::vector<char>>> send_requests;
-        std::unique_lock<std::mutex> mpilock(mpiDataLock);
-        for (unsigned int i = 0; i < comms.size(); i++) {
-            // Skip any nullptr entries
-            if (comms[i] == nullptr) {
-                continue;
-            }
-
-            // Handle receives for the MpiComms object
-            int message_waiting = 1;
-            MPI_Status status;
-
-            while (message_waiting != 0) {
-                // Check if there is a messages waiting
-                MPI_Iprobe(MPI_ANY_SOURCE, i, mpiCommunicator, &message_waiting, &status);
-
-                if (message_waiting != 0) {
-                    // Get the size of the message waiting to be received
-                    int recv_size;
-                    std::vector<char> buffer;
-                    MPI_Get_count(&status, MPI_CHAR, &recv_size);
-                    buffer.resize(recv_size);
+        // the messages go on duplicates of the communicator so they never match receives made by
+        // the user on a communicator they passed in
+        MPI_Comm_dup(mpiCommunicator, &messageCommunicator);
+        MPI_Comm_dup(mpiCommunicator, &dataCommunicator);
+
+        receiveRequests.assign(eagerReceiveCount, MPI_REQUEST_NULL);
+        receiveBuffers.assign(eagerReceiveCount, std::vector<char>(eagerMessageSize));
+        receiveOrder.assign(eagerReceiveCount, 0);
+        for (int ii = 0; ii < eagerReceiveCount; ++ii) {
+            MPI_Recv_init(receiveBuffers[ii].data(),
+                          eagerMessageSize,
+                          MPI_CHAR,
+                          MPI_ANY_SOURCE,
+                          MPI_ANY_TAG,
+                          messageCommunicator,
+                          &receiveRequests[ii]);
+            // MPI_Startall does not define the order the receives are posted in so start them
+            // one at a time
+            MPI_Start(&receiveRequests[ii]);
+            receiveOrder[ii] = receiveCounter++;
+        }
+    }
 
-                    // Post an asynchronous receive
-                    MPI_Request req;
-                    MPI_Irecv(buffer.data(),
-                              static_cast<int>(buffer.size()),
-                              MPI_CHAR,
-                              status.MPI_SOURCE,
-                              status.MPI_TAG,
-                              mpiCommunicator,
-                              &req);
-
-                    // Wait until the asynchronous receive request has finished
-                    int message_received = 0;
-                    while (message_received == 0) {
-                        MPI_Test(&req, &message_received, MPI_STATUS_IGNORE);
-                    }
+    bool MpiService::sendAndReceiveMessages()
+    {
+        if (receiveRequests.empty()) {
+            if (messageCommunicator != MPI_COMM_NULL || mpiCommunicator == MPI_COMM_NULL) {
+                return false;
+            }
+            postReceives();
+        }
+        const bool received = receiveMessages();
+        const bool sent = sendMessages();
+        return received || sent;
+    }
 
-                    // Deserialized the received action message
-                    ActionMessage M(buffer);
+    bool MpiService::receiveMessages()
+    {
+        bool activity{false};
+        std::array<int, eagerReceiveCount> indices;
+        std::array<MPI_Status, eagerReceiveCount> statuses;
+        int completed{0};
+        MPI_Testsome(eagerReceiveCount,
+                     receiveRequests.data(),
+                     &completed,
+                     indices.data(),
+                     statuses.data());
+        if (completed != MPI_UNDEFINED && completed > 0) {
+            activity = true;
+            // receives match messages in the order they were posted so handle them in that order
+            // to keep the messages from each rank in order
+            std::array<int, eagerReceiveCount> order;
+            std::iota(order.begin(), order.begin() + completed, 0);
+            std::sort(order.begin(), order.begin() + completed, [this, &indices](int a, int b) {
+                return receiveOrder[indices[a]] < receiveOrder[indices[b]];
+            });
+            for (int ii = 0; ii < completed; ++ii) {
+                const auto index = indices[order[ii]];
+                auto& status = statuses[order[ii]];
+                int size{0};
+                MPI_Get_count(&status, MPI_CHAR, &size);
+                processEagerMessage(
+                    status.MPI_SOURCE, status.MPI_TAG, receiveBuffers[index].data(), size);
+                // repost the receive
+                MPI_Start(&receiveRequests[index]);
+                receiveOrder[index] = receiveCounter++;
+            }
+        }
 
-                    // Add to the received message queue for the MpiComms object
-                    if (comms[i] != nullptr) {
-                        comms[i]->getRxMessageQueue().push(M);
+        // deliver the completed rendezvous payloads and the messages queued behind them
+        for (auto& source : pendingReceives) {
+            auto& queue = source.second;
+            while (!queue.empty()) {
+                auto& front = queue.front();
+                if (front.request != MPI_REQUEST_NULL) {
+                    int done{0};
+                    MPI_Test(&front.request, &done, MPI_STATUS_IGNORE);
+                    if (done == 0) {
+                        break;
                     }
                 }
+                deliverMessage(front.tag, front.buffer.data(), front.buffer.size());
+                queue.pop_front();
+                activity = true;
             }
         }
+        return activity;
+    }
 
-        mpilock.unlock();
+    void MpiService::processEagerMessage(int source, int tag, const char* data, int size)
+    {
+        auto& queue = pendingReceives[source];
+        if (size == rendezvousHeaderSize && data[0] == rendezvousMarker) {
+            int payloadSize{0};
+            for (int ii = 1; ii < rendezvousHeaderSize; ++ii) {
+                payloadSize = (payloadSize << 8) | static_cast<unsigned char>(data[ii]);
+            }
+            queue.emplace_back();
+            auto& pending = queue.back();
+            pending.tag = tag;
+            pending.buffer.resize(payloadSize);
+            // the payload is sent right after the header so it is the next message from the source
+            // with this tag on the data communicator
+            MPI_Irecv(pending.buffer.data(),
+                      payloadSize,
+                      MPI_CHAR,
+                      source,
+                      tag,
+                      dataCommunicator,
+                      &pending.request);
+        } else if (queue.empty()) {
+            deliverMessage(tag, data, size);
+        } else {
+            // hold the message until the payloads received before it are delivered
+            queue.emplace_back();
+            auto& pending = queue.back();
+            pending.tag = tag;
+            pending.buffer.assign(data, data + size);
+        }
+    }
+
+    bool MpiService::sendMessages()
+    {
         // Send messages from the queue
+        bool activity{false};
         auto sendMsg = txMessageQueue.try_pop();
         while (sendMsg) {
-            // std::vector<char> msg;
-            // std::string address;
-            // std::tie (address, msg) = sendMsg.value ();
-
-            MPI_Request req;
-            auto sendRequestData =
-                std::pair<MPI_Request, std::vector<char>>(req, std::move(sendMsg->second));
-
+            activity = true;
             int destRank = sendMsg->first.first;
             int destTag = sendMsg->first.second;
-
-            if (destRank != commRank) {
-                send_requests.push_back(std::move(sendRequestData));
-                auto& sreq = send_requests.back();
-                // Send the message using asynchronous send
-                MPI_Isend(sreq.second.data(),
-                          static_cast<int>(sreq.second.size()),
-                          MPI_CHAR,
-                          destRank,
-                          destTag,
-                          mpiCommunicator,
-                          &sreq.first);
+            auto& data = sendMsg->second;
+
+            if (destRank == commRank) {
+                // Add the message directly to the destination rx queue (same process)
+                deliverMessage(destTag, data.data(), data.size());
+            } else if (data.size() > static_cast<std::size_t>(INT_MAX)) {
+                std::cerr << "MPI message of " << data.size() << " bytes is too large to send"
+                          << std::endl;
+            } else if (data.size() > static_cast<std::size_t>(eagerMessageSize)) {
+                // send a header on the eager path so the receiver can allocate the buffer and
+                // post a receive for the payload
+                const auto size = static_cast<std::uint32_t>(data.size());
+                std::vector<char> header{rendezvousMarker,
+                                         static_cast<char>((size >> 24U) & 0xFFU),
+                                         static_cast<char>((size >> 16U) & 0xFFU),
+                                         static_cast<char>((size >> 8U) & 0xFFU),
+                                         static_cast<char>(size & 0xFFU)};
+                startSend(std::move(header), destRank, destTag, messageCommunicator);
+                startSend(std::move(data), destRank, destTag, dataCommunicator);
             } else {
-                mpilock.lock();
-                if (comms[destTag] != nullptr) {
-                    // Add the message directly to the destination rx queue (same process)
-                    ActionMessage M(sendRequestData.second);
-                    comms[destTag]->getRxMessageQueue().push(M);
-                }
-                mpilock.unlock();
+                startSend(std::move(data), destRank, destTag, messageCommunicator);
             }
             sendMsg = txMessageQueue.try_pop();
         }
 
-        send_requests.remove_if([](std::pair<MPI_Request, std::vector<char>>& req) {
-            int send_finished;
-            MPI_Test(&req.first, &send_finished, MPI_STATUS_IGNORE);
-
-            if (send_finished == 1) {
-                // Any cleanup needed here? Freeing the vector or MPI_Request?
+        if (sendRequests.empty()) {
+            return activity;
+        }
+        // release the buffers of the sends which have finished
+        std::vector<int> indices(sendRequests.size());
+        int completed{0};
+        MPI_Testsome(static_cast<int>(sendRequests.size()),
+                     sendRequests.data(),
+                     &completed,
+                     indices.data(),
+                     MPI_STATUSES_IGNORE);
+        if (completed == MPI_UNDEFINED || completed == 0) {
+            return activity;
+        }
+        // completed requests are set to MPI_REQUEST_NULL
+        std::size_t active{0};
+        for (std::size_t ii = 0; ii < sendRequests.size(); ++ii) {
+            if (sendRequests[ii] != MPI_REQUEST_NULL) {
+                if (active != ii) {
+                    sendRequests[active] = sendRequests[ii];
+                    sendBuffers[active] = std::move(sendBuffers[ii]);
+                }
+                ++active;
             }
+        }
+        sendRequests.resize(active);
+        sendBuffers.resize(active);
+        return true;
+    }
 
-            return (send_finished == 1);
-        });
+    void MpiService::startSend(std::vector<char> data,
+                               int destRank,
+                               int destTag,
+                               MPI_Comm communicator)
+    {
+        sendBuffers.push_back(std::move(data));
+        sendRequests.push_back(MPI_REQUEST_NULL);
+        auto& buffer = sendBuffers.back();
+        MPI_Isend(buffer.data(),
+                  static_cast<int>(buffer.size()),
+                  MPI_CHAR,
+                  destRank,
+                  destTag,
+                  communicator,
+                  &sendRequests.back());
+    }
+
+    void MpiService::deliverMessage(int tag, const char* data, std::size_t size)
+    {
+        std::lock_guard<std::mutex> mpilock(mpiDataLock);
+        if (tag < 0) {
+            return;
+        }
+        if (static_cast<std::size_t>(tag) >= comms.size()) {
+            // the MpiComms on this rank may not have been added yet
+            unclaimedMessages[tag].emplace_back(data, data + size);
+        } else if (comms[tag] != nullptr) {
+            comms[tag]->getRxMessageQueue().emplace(data, size);
+        }
     }
 
     void MpiService::drainRemainingMessages()
     {
+        // stop the outstanding receives, anything they already matched is dropped
+        for (auto& request : receiveRequests) {
+            MPI_Cancel(&request);
+            MPI_Wait(&request, MPI_STATUS_IGNORE);
+            MPI_Request_free(&request);
+        }
+        receiveRequests.clear();
+        for (auto& source : pendingReceives) {
+            for (auto& pending : source.second) {
+                if (pending.request != MPI_REQUEST_NULL) {
+                    MPI_Cancel(&pending.request);
+                    MPI_Wait(&pending.request, MPI_STATUS_IGNORE);
+                }
+            }
+        }
+        pendingReceives.clear();
+        // ranks which have shut down will not receive the remaining sends so don't wait on them,
+        // the buffers are kept until the service is destroyed
+        for (auto& request : sendRequests) {
+            MPI_Request_free(&request);
+        }
+        sendRequests.clear();
+
         // Post receives for any waiting sends
-        int message_waiting = 1;
-        MPI_Status status;
-        while (message_waiting != 0) {
-            MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, mpiCommunicator, &message_waiting, &status);
-            if (message_waiting != 0) {
-                // Get the size of the message waiting to be received
-                int recv_size;
-                std::vector<char> buffer;
-                MPI_Get_count(&status, MPI_CHAR, &recv_size);
-                buffer.resize(recv_size);
-
-                // Receive the message
-                MPI_Recv(buffer.data(),
-                         static_cast<int>(buffer.size()),
-                         MPI_CHAR,
-                         status.MPI_SOURCE,
-                         status.MPI_TAG,
-                         mpiCommunicator,
-                         &status);
+        for (auto communicator : {messageCommunicator, dataCommunicator}) {
+            if (communicator == MPI_COMM_NULL) {
+                continue;
+            }
+            int message_waiting = 1;
+            MPI_Status status;
+            while (message_waiting != 0) {
+                MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, communicator, &message_waiting, &status);
+                if (message_waiting != 0) {
+                    // Get the size of the message waiting to be received
+                    int recv_size;
+                    std::vector<char> buffer;
+                    MPI_Get_count(&status, MPI_CHAR, &recv_size);
+                    buffer.resize(recv_size);
+
+                    // Receive the message
+                    MPI_Recv(buffer.data(),
+                             recv_size,
+                             MPI_CHAR,
+                             status.MPI_SOURCE,
+                             status.MPI_TAG,
+                             communicator,
+                             &status);
+                }
             }
         }
     }
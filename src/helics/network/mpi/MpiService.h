@@ -12,8 +12,11 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "helics/helics-config.h"
 
 #include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
 #include <functional>
-#include <list>
+#include <map>
 #include <memory>
 #include <mpi.h>
 #include <mutex>
@@ -24,7 +27,12 @@ SPDX-License-Identifier: BSD-3-Clause
 
 namespace helics {
 namespace mpi {
-    /** service for using MPI to communicate*/
+    /** service for using MPI to communicate
+    @details all MPI calls are made from a single service thread which keeps many sends and
+    receives in flight at once.  Messages up to eagerMessageSize are received directly into a set
+    of persistent receives posted ahead of time, larger messages send a small header on the eager
+    path and the payload on a separate communicator, received into a buffer allocated once the
+    size is known.  Messages from each rank are delivered in the order they were sent*/
     class MpiService {
       public:
         /** deleted copy constructor*/
@@ -40,6 +48,8 @@ namespace mpi {
         void removeMpiComms(MpiComms* comm);
         std::string getAddress(MpiComms* comm);
         int getRank();
+        /** get the number of ranks in the communicator*/
+        int getSize();
         int getTag(MpiComms* comm);
 
         void sendMessage(std::pair<int, int> address, std::vector<char> message)
@@ -47,22 +57,54 @@ namespace mpi {
             txMessageQueue.emplace(address, std::move(message));
         }
 
-        void sendAndReceiveMessages();
+        /** make one pass over the sends and receives
+        @return true if any message was sent or received or any send finished*/
+        bool sendAndReceiveMessages();
         void drainRemainingMessages();
 
+        /** the largest message sent on the eager path*/
+        static constexpr int eagerMessageSize{8192};
+        /** the number of persistent receives posted for eager messages*/
+        static constexpr int eagerReceiveCount{32};
+        /** the time without any activity before the service loop sleeps between passes*/
+        static constexpr std::chrono::milliseconds idleSpinTime{10};
+        /** the time the service loop sleeps between passes once it is idle*/
+        static constexpr std::chrono::microseconds maxIdleSleep{5};
+
       private:
         MpiService() = default;
         ~MpiService();
 
         int commRank = -1;
+        int commSize = 0;
         static MPI_Comm mpiCommunicator;
         static bool startServiceThread;
 
-        std::mutex mpiDataLock;  //!< lock for the comms and send_requests
+        std::mutex mpiDataLock;  //!< lock for the comms
         std::vector<MpiComms*> comms;
+        /** messages received for tags no MpiComms has been added for yet*/
+        std::map<int, std::vector<std::vector<char>>> unclaimedMessages;
         gmlc::containers::BlockingQueue<std::pair<std::pair<int, int>, std::vector<char>>>
             txMessageQueue;
 
+        /** a rendezvous payload being received*/
+        struct PendingReceive {
+            int tag{0};  //!< the tag of the MpiComms the message is for
+            std::vector<char> buffer;  //!< the message data
+            MPI_Request request{MPI_REQUEST_NULL};  //!< the request receiving the payload
+        };
+        MPI_Comm messageCommunicator{MPI_COMM_NULL};  //!< communicator for eager messages
+        MPI_Comm dataCommunicator{MPI_COMM_NULL};  //!< communicator for rendezvous payloads
+        std::vector<MPI_Request> receiveRequests;  //!< the persistent eager receives
+        std::vector<std::vector<char>> receiveBuffers;  //!< the buffers for the eager receives
+        /** the order the eager receives were started, which is the order they match messages*/
+        std::vector<std::uint64_t> receiveOrder;
+        std::uint64_t receiveCounter{0};
+        /** messages queued behind an incomplete rendezvous receive from the same rank*/
+        std::map<int, std::deque<PendingReceive>> pendingReceives;
+        std::vector<MPI_Request> sendRequests;  //!< the sends in flight
+        std::vector<std::vector<char>> sendBuffers;  //!< the data for each send in flight
+
         bool helics_initialized_mpi{false};
         std::atomic<int> comms_connected{0};
         std::atomic<bool> startup_flag{false};
@@ -71,6 +113,19 @@ namespace mpi {
 
         void startService();
         void serviceLoop();
+        /** create the communicators and post the eager receives*/
+        void postReceives();
+        /** check the receives and deliver the completed messages
+        @return true if any message was received*/
+        bool receiveMessages();
+        /** handle a message received on the eager path*/
+        void processEagerMessage(int source, int tag, const char* data, int size);
+        /** send the queued messages and release the buffers of finished sends
+        @return true if any message was sent or any send finished*/
+        bool sendMessages();
+        void startSend(std::vector<char> data, int destRank, int destTag, MPI_Comm communicator);
+        /** deliver a message to the rx queue of an MpiComms*/
+        void deliverMessage(int tag, const char* data, std::size_t size);
 
         bool initMPI();
     };
@@ -15,6 +15,7 @@ SPDX-License-Identifier: BSD-3-Clause
 
 #include <map>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -34,6 +35,7 @@ namespace tcp {
             return;
         }
         reuse_address = netInfo.reuse_address;
+        ioThreads = netInfo.ioThreads;
         propertyUnLock();
     }
 
@@ -96,7 +98,6 @@ namespace tcp {
             }
             used_total += used;
         }
-
         return used_total;
     }
 
@@ -153,6 +154,22 @@ namespace tcp {
             }
         }
         auto contextLoop = ioctx->startContextLoop();
+        // a fixed set of single threaded contexts, each reading its connections through one buffer
+        std::vector<std::string> ioContextNames;
+        std::vector<AsioContextManager::LoopHandle> ioLoops;
+        if (ioThreads > 0) {
+            std::vector<asio::io_context*> connectionContexts;
+            for (int ii = 0; ii < ioThreads; ++ii) {
+                ioContextNames.push_back(name + "_tcp_io_" + std::to_string(ii));
+                auto ctx = AsioContextManager::getContextPointer(ioContextNames.back());
+                if (!commsCpus.empty()) {
+                    AsioContextManager::setContextAffinity(ioContextNames.back(), commsCpus);
+                }
+                connectionContexts.push_back(&ctx->getBaseContext());
+                ioLoops.push_back(ctx->startContextLoop());
+            }
+            server->setConnectionContexts(std::move(connectionContexts));
+        }
         server->setDataCall(
             [this](const TcpConnection::pointer& connection, const char* data, size_t datasize) {
                 return dataReceive(connection.get(), data, datasize);
@@ -180,6 +197,10 @@ namespace tcp {
         disconnecting = true;
         std::this_thread::sleep_for(std::chrono::milliseconds(50));
         server->close();
+        ioLoops.clear();
+        for (auto& ctxName : ioContextNames) {
+            AsioContextManager::closeContext(ctxName);
+        }
         setRxStatus(connection_status::terminated);
     }
 
@@ -37,6 +37,7 @@ namespace tcp {
 
       private:
         bool reuse_address = false;
+        int ioThreads{0};  //!< the number of dedicated threads for receiving on server connections
         virtual int getDefaultBrokerPort() const override;
         virtual void queue_rx_function() override;  //!< the functional loop for the receive queue
         virtual void queue_tx_function() override;  //!< the loop for transmitting data
@@ -36,12 +36,19 @@ namespace tcp {
                 receivingHalt.activate();
             }
             if (!triggerhalt) {
-                socket_.async_receive(asio::buffer(data.data() + residBufferSize,
-                                                   data.size() - residBufferSize),
-                                      [ptr = shared_from_this()](const std::error_code& err,
-                                                                 size_t bytes) {
-                                          ptr->handle_read(err, bytes);
-                                      });
+                if (pooledBufferSize > 0) {
+                    socket_.async_wait(asio::ip::tcp::socket::wait_read,
+                                       [ptr = shared_from_this()](const std::error_code& err) {
+                                           ptr->handle_ready(err);
+                                       });
+                } else {
+                    socket_.async_receive(asio::buffer(data.data() + residBufferSize,
+                                                       data.size() - residBufferSize),
+                                          [ptr = shared_from_this()](
+                                              const std::error_code& err, size_t bytes) {
+                                              ptr->handle_read(err, bytes);
+                                          });
+                }
                 if (triggerhalt) {
                     // cancel previous operation if triggerhalt is now active
                     socket_.cancel();
@@ -76,6 +83,18 @@ namespace tcp {
         }
     }
 
+    void TcpConnection::setPooledReceive(size_t nominalBufferSize)
+    {
+        if (state.load() == connection_state_t::prestart) {
+            pooledBufferSize = (std::max)(nominalBufferSize, size_t(1024));
+            residBufferSize = 0;
+            data.clear();
+            data.shrink_to_fit();
+        } else {
+            throw(std::runtime_error("cannot set pooled receive after socket is started"));
+        }
+    }
+
     void TcpConnection::setLoggingFunction(
         std::function<void(int loglevel, const std::string& logMessage)> logFunc)
     {
@@ -150,6 +169,79 @@ namespace tcp {
         }
     }
 
+    /** get the receive buffer shared by all pooled connections handled on the current thread
+    @param minSize the minimum size needed for the buffer*/
+    static std::vector<char>& threadReceiveBuffer(size_t minSize)
+    {
+        static thread_local std::vector<char> buffer;
+        if (buffer.size() < minSize) {
+            buffer.resize(minSize);
+        }
+        return buffer;
+    }
+
+    void TcpConnection::handle_ready(const std::error_code& error)
+    {
+        if (triggerhalt.load(std::memory_order_acquire)) {
+            state = connection_state_t::halted;
+            receivingHalt.trigger();
+            return;
+        }
+        if (error) {
+            // nothing was read so the error path of handle_read has no data to process
+            handle_read(error, 0);
+            return;
+        }
+        const size_t resid = residBufferSize;
+        char* readBuffer{nullptr};
+        size_t readSize{0};
+        if (resid == 0) {
+            // complete messages are processed directly out of the shared buffer
+            auto& buffer = threadReceiveBuffer(pooledBufferSize);
+            readBuffer = buffer.data();
+            readSize = buffer.size();
+        } else {
+            // an incomplete message continues in the connection buffer at the end of the residual
+            // data, which grows geometrically so a large message is not copied on every read
+            if (data.size() < resid + pooledBufferSize) {
+                data.resize((std::max)(data.size() * 2, resid + pooledBufferSize));
+            }
+            readBuffer = data.data();
+            readSize = data.size() - resid;
+        }
+        std::error_code readError;
+        auto bytes = socket_.read_some(asio::buffer(readBuffer + resid, readSize), readError);
+        if (readError == asio::error::would_block || readError == asio::error::try_again) {
+            state = connection_state_t::waiting;
+            startReceive();
+            return;
+        }
+        const size_t total = resid + bytes;
+        auto used = (bytes > 0) ? dataCall(shared_from_this(), readBuffer, total) : size_t(0);
+        if (used >= total) {
+            residBufferSize = 0;
+            if (data.capacity() > 4 * pooledBufferSize) {
+                // a large message expanded the connection buffer so release it once it completes
+                data.clear();
+                data.shrink_to_fit();
+            }
+        } else if (resid == 0) {
+            data.assign(readBuffer + used, readBuffer + total);
+            residBufferSize = total - used;
+        } else {
+            if (used > 0) {
+                std::copy(data.data() + used, data.data() + total, data.data());
+            }
+            residBufferSize = total - used;
+        }
+        if (readError) {
+            handle_read(readError, 0);
+            return;
+        }
+        state = connection_state_t::waiting;
+        startReceive();
+    }
+
     // asio::socket_base::linger optionLinger(true, 2);
     // socket_.set_option(optionLinger, ec);
     void TcpConnection::close()
@@ -648,7 +740,7 @@ namespace tcp {
         }
         bool success = true;
         for (auto& acc : acceptors) {
-            if (!acc->start(TcpConnection::create(ioctx, bufferSize))) {
+            if (!acc->start(newConnection())) {
                 std::cout << "acceptor has failed to start" << std::endl;
                 success = false;
             }
@@ -681,7 +773,18 @@ namespace tcp {
                 return;
             }
         }
-        acc->start(TcpConnection::create(ioctx, bufferSize));
+        acc->start(newConnection());
+    }
+
+    TcpConnection::pointer TcpServer::newConnection()
+    {
+        if (connectionContexts.empty()) {
+            return TcpConnection::create(ioctx, bufferSize);
+        }
+        auto index = contextIndex++ % connectionContexts.size();
+        auto conn = TcpConnection::create(*connectionContexts[index], 0);
+        conn->setPooledReceive(bufferSize);
+        return conn;
     }
 
     TcpConnection::pointer TcpServer::findSocket(int connectorID) const
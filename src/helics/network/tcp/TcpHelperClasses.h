@@ -67,6 +67,12 @@ namespace tcp {
         /** set a logging function */
         void setLoggingFunction(
             std::function<void(int loglevel, const std::string& logMessage)> logFunc);
+        /** receive data through a buffer shared by all pooled connections on the same thread
+        @details the connection waits for the socket to be readable then reads into the buffer of
+        the thread handling it, only an incomplete trailing message is stored with the connection.
+        Must be called before the connection is started
+        @param nominalBufferSize the size of the shared buffer for each thread*/
+        void setPooledReceive(size_t nominalBufferSize);
         /** send raw data
     @throws std::system_error on failure*/
         size_t send(const void* buffer, size_t dataLength);
@@ -146,6 +152,8 @@ namespace tcp {
                       size_t bufferSize);
         /** function for handling the asynchronous return from a read request*/
         void handle_read(const std::error_code& error, size_t bytes_transferred);
+        /** function for handling the socket becoming readable in pooled receive mode*/
+        void handle_ready(const std::error_code& error);
         void handle_read(
             size_t message_size,
             const std::error_code& error,
@@ -160,7 +168,9 @@ namespace tcp {
         std::atomic<size_t> residBufferSize{0};
         asio::ip::tcp::socket socket_;
         asio::io_context& context_;
+        /// the receive buffer, or just the incomplete trailing message in pooled mode
         std::vector<char> data;
+        size_t pooledBufferSize{0};  //!< the size of the thread buffer in pooled mode (0 if off)
         std::atomic<bool> triggerhalt{false};
         const bool connecting{false};
         gmlc::concurrency::TriggerVariable receivingHalt;
@@ -301,6 +311,16 @@ namespace tcp {
         {
             errorCall = std::move(errorFunc);
         }
+        /** spread new connections over a fixed set of contexts using pooled receive buffers
+        @details each context should be run by a single thread so the receive buffer of that thread
+        is shared by all the connections assigned to it.  Must be called before the server is
+        started
+        @param contexts the contexts for handling connections, if empty the server context is used
+        */
+        void setConnectionContexts(std::vector<asio::io_context*> contexts)
+        {
+            connectionContexts = std::move(contexts);
+        }
         void handle_accept(TcpAcceptor::pointer acc, TcpConnection::pointer new_connection);
         /** get a socket by it identification code*/
         TcpConnection::pointer findSocket(int connectorID) const;
@@ -319,7 +339,12 @@ namespace tcp {
         TcpServer(asio::io_context& io_context, uint16_t portNum, int nominalBufferSize);
 
         void initialConnect();
+        /** generate a connection for an acceptor to fill*/
+        TcpConnection::pointer newConnection();
         asio::io_context& ioctx;
+        /// contexts to spread connections over in pooled receive mode
+        std::vector<asio::io_context*> connectionContexts;
+        std::atomic<size_t> contextIndex{0};  //!< the next connection context to use
         mutable std::mutex accepting;
         std::vector<TcpAcceptor::pointer> acceptors;
         std::vector<asio::ip::tcp::endpoint> endpoints;
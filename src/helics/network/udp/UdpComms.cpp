@@ -11,14 +11,25 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "../../core/ActionMessage.hpp"
 #include "../NetworkBrokerData.hpp"
 #include "../networkDefaults.hpp"
+#include "UdpReliability.h"
 
+#include <algorithm>
+#include <array>
+#include <cerrno>
 #include <asio/ip/udp.hpp>
+#include <cstring>
+#include <deque>
 #include <map>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
 
+#ifdef __linux__
+#    include <sys/socket.h>
+#endif
+
 namespace helics {
 namespace udp {
     using asio::ip::udp;
@@ -40,9 +51,22 @@ namespace udp {
 
         promisePort = std::promise<int>();
         futurePort = promisePort.get_future();
+        reliableTransmission = netInfo.reliableUdp;
 
         propertyUnLock();
     }
+
+    void UdpComms::setFlag(const std::string& flag, bool val)
+    {
+        if (flag == "reliable") {
+            if (propertyLock()) {
+                reliableTransmission = val;
+                propertyUnLock();
+            }
+        } else {
+            NetworkCommsInterface::setFlag(flag, val);
+        }
+    }
     /** destructor*/
     UdpComms::~UdpComms() { disconnect(); }
 
@@ -51,6 +75,123 @@ namespace udp {
         return (net != interface_networks::ipv6) ? udp::v4() : udp::v6();
     }
 
+    /** the maximum number of datagrams sent or received in a single call*/
+    static constexpr std::size_t maxBatchCount{64};
+    /** a datagram waiting to be sent and its destination*/
+    using datagram = std::pair<asio::const_buffer, udp::endpoint>;
+
+    /** receive a batch of datagrams, blocking until at least one is available
+    @return the number of datagrams received*/
+    static std::size_t receiveBatch(udp::socket& socket,
+                                    std::vector<std::vector<char>>& buffers,
+                                    std::vector<std::size_t>& sizes,
+                                    std::vector<udp::endpoint>& sources,
+                                    std::error_code& error)
+    {
+#ifdef __linux__
+        std::array<mmsghdr, maxBatchCount> headers;
+        std::array<iovec, maxBatchCount> vectors;
+        auto count = std::min(buffers.size(), maxBatchCount);
+        for (std::size_t ii = 0; ii < count; ++ii) {
+            vectors[ii].iov_base = buffers[ii].data();
+            vectors[ii].iov_len = buffers[ii].size();
+            std::memset(&headers[ii], 0, sizeof(mmsghdr));
+            headers[ii].msg_hdr.msg_name = sources[ii].data();
+            headers[ii].msg_hdr.msg_namelen = static_cast<socklen_t>(sources[ii].capacity());
+            headers[ii].msg_hdr.msg_iov = &vectors[ii];
+            headers[ii].msg_hdr.msg_iovlen = 1;
+        }
+        while (true) {
+            auto res = ::recvmmsg(socket.native_handle(),
+                                  headers.data(),
+                                  static_cast<unsigned int>(count),
+                                  MSG_WAITFORONE,
+                                  nullptr);
+            if (res >= 0) {
+                for (int ii = 0; ii < res; ++ii) {
+                    sizes[ii] = headers[ii].msg_len;
+                    sources[ii].resize(headers[ii].msg_hdr.msg_namelen);
+                }
+                return static_cast<std::size_t>(res);
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                socket.wait(udp::socket::wait_read, error);
+                if (error) {
+                    return 0;
+                }
+            } else if (errno != EINTR) {
+                error = std::error_code(errno, std::system_category());
+                return 0;
+            }
+        }
+#else
+        sizes[0] = socket.receive_from(asio::buffer(buffers[0]), sources[0], 0, error);
+        if (error) {
+            return 0;
+        }
+        std::size_t count{1};
+        std::error_code ignored_error;
+        while (count < buffers.size() && socket.available(ignored_error) > 0) {
+            sizes[count] =
+                socket.receive_from(asio::buffer(buffers[count]), sources[count], 0, error);
+            if (error) {
+                break;
+            }
+            ++count;
+        }
+        return count;
+#endif
+    }
+
+    /** send a set of datagrams with as few system calls as possible
+    @details a failure on one datagram does not prevent the rest being sent, error is set to the
+    last failure*/
+    static void sendBatch(udp::socket& socket,
+                          const std::vector<datagram>& datagrams,
+                          std::error_code& error)
+    {
+#ifdef __linux__
+        std::array<mmsghdr, maxBatchCount> headers;
+        std::array<iovec, maxBatchCount> vectors;
+        std::size_t sent{0};
+        while (sent < datagrams.size()) {
+            auto count = std::min(datagrams.size() - sent, maxBatchCount);
+            for (std::size_t ii = 0; ii < count; ++ii) {
+                const auto& dgram = datagrams[sent + ii];
+                vectors[ii].iov_base = const_cast<void*>(dgram.first.data());
+                vectors[ii].iov_len = dgram.first.size();
+                std::memset(&headers[ii], 0, sizeof(mmsghdr));
+                headers[ii].msg_hdr.msg_name = const_cast<sockaddr*>(dgram.second.data());
+                headers[ii].msg_hdr.msg_namelen = static_cast<socklen_t>(dgram.second.size());
+                headers[ii].msg_hdr.msg_iov = &vectors[ii];
+                headers[ii].msg_hdr.msg_iovlen = 1;
+            }
+            auto res = ::sendmmsg(
+                socket.native_handle(), headers.data(), static_cast<unsigned int>(count), 0);
+            if (res > 0) {
+                sent += static_cast<std::size_t>(res);
+            } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                socket.wait(udp::socket::wait_write, error);
+                if (error) {
+                    return;
+                }
+            } else if (errno != EINTR) {
+                // skip the datagram that failed
+                error = std::error_code(errno, std::system_category());
+                ++sent;
+            }
+        }
+#else
+        std::error_code sendError;
+        for (const auto& dgram : datagrams) {
+            socket.send_to(asio::buffer(dgram.first), dgram.second, 0, sendError);
+            if (sendError) {
+                error = sendError;
+            }
+        }
+#endif
+    }
+
     void UdpComms::queue_rx_function()
     {
         if (PortNumber < 0) {
@@ -120,42 +261,90 @@ namespace udp {
             }
         }
 
-        std::vector<char> data(10192);
-        udp::endpoint remote_endp;
+        std::vector<std::vector<char>> buffers(maxBatchCount, std::vector<char>(10192));
+        std::vector<std::size_t> sizes(maxBatchCount);
+        std::vector<udp::endpoint> sources(maxBatchCount);
+        std::map<udp::endpoint, ReliableReceiver> receivers;
+        std::vector<std::map<udp::endpoint, ReliableReceiver>::iterator> ackPending;
+        std::vector<std::string> messages;
+        std::vector<std::string> acks;
+        std::vector<datagram> outgoing;
         std::error_code error;
         std::error_code ignored_error;
-        setRxStatus(connection_status::connected);
-        while (true) {
-            auto len = socket.receive_from(asio::buffer(data), remote_endp, 0, error);
-            if (error) {
-                setRxStatus(connection_status::error);
-                return;
-            }
+        // returns false if the receiver should close
+        auto processMessage = [&](const char* data, std::size_t len, const udp::endpoint& remote) {
             if (len == 5) {
-                std::string str(data.data(), len);
+                std::string str(data, len);
                 if (str == "close") {
-                    break;
+                    return false;
                 }
             }
-            ActionMessage M(data.data(), len);
+            ActionMessage M(data, len);
             if (!isValidCommand(M)) {
                 logWarning("invalid command received udp");
-                continue;
+                return true;
             }
             if (isProtocolCommand(M)) {
                 if (M.messageID == CLOSE_RECEIVER) {
-                    break;
+                    return false;
                 }
                 auto reply = generateReplyToIncomingMessage(M);
                 if (reply.messageID == DISCONNECT) {
-                    break;
+                    return false;
                 }
                 if (reply.action() != CMD_IGNORE) {
-                    socket.send_to(asio::buffer(reply.to_string()), remote_endp, 0, ignored_error);
+                    socket.send_to(asio::buffer(reply.to_string()), remote, 0, ignored_error);
                 }
             } else {
                 ActionCallback(std::move(M));
             }
+            return true;
+        };
+        setRxStatus(connection_status::connected);
+        bool continueProcessing{true};
+        while (continueProcessing) {
+            auto count = receiveBatch(socket, buffers, sizes, sources, error);
+            if (error) {
+                setRxStatus(connection_status::error);
+                return;
+            }
+            for (std::size_t ii = 0; ii < count && continueProcessing; ++ii) {
+                const char* data = buffers[ii].data();
+                if (!isReliablePacket(data, sizes[ii])) {
+                    continueProcessing = processMessage(data, sizes[ii], sources[ii]);
+                    continue;
+                }
+                auto receiver = receivers.emplace(sources[ii], ReliableReceiver{}).first;
+                bool acknowledge = !receiver->second.ackPending();
+                messages.clear();
+                if (!receiver->second.processPacket(data, sizes[ii], messages)) {
+                    continue;
+                }
+                if (acknowledge) {
+                    ackPending.push_back(receiver);
+                }
+                for (const auto& message : messages) {
+                    continueProcessing =
+                        processMessage(message.data(), message.size(), sources[ii]);
+                    if (!continueProcessing) {
+                        break;
+                    }
+                }
+            }
+            if (ackPending.empty()) {
+                continue;
+            }
+            // acknowledge everything received in the batch with a single datagram per source
+            acks.clear();
+            outgoing.clear();
+            for (auto& receiver : ackPending) {
+                acks.push_back(receiver->second.generateAck());
+            }
+            for (std::size_t ii = 0; ii < acks.size(); ++ii) {
+                outgoing.emplace_back(asio::buffer(acks[ii]), ackPending[ii]->first);
+            }
+            ackPending.clear();
+            sendBatch(socket, outgoing, ignored_error);
         }
         disconnecting = true;
         setRxStatus(connection_status::terminated);
@@ -319,14 +508,98 @@ namespace udp {
             rxEndpoint = *result;
         }
 
-        setTxStatus(connection_status::connected);
-        bool continueProcessing{true};
-        while (continueProcessing) {
-            route_id rid;
-            ActionMessage cmd;
+        std::map<udp::endpoint, ReliableSender> senders;
+        // storage for the datagrams sent outside the reliable protocol
+        std::deque<std::string> plainData;
+        std::vector<datagram> outgoing;
+        std::vector<const std::string*> packets;
+        std::vector<std::vector<char>> ackBuffers(maxBatchCount, std::vector<char>(2048));
+        std::vector<std::size_t> ackSizes(maxBatchCount);
+        std::vector<udp::endpoint> ackSources(maxBatchCount);
 
-            std::tie(rid, cmd) = txQueue.pop();
-            bool processed = false;
+        auto sendPlain = [&](std::string data, const udp::endpoint& destination) {
+            plainData.push_back(std::move(data));
+            outgoing.emplace_back(asio::buffer(plainData.back()), destination);
+        };
+        auto sendMessage = [&](const ActionMessage& cmd, const udp::endpoint& destination) {
+            if (!reliableTransmission) {
+                sendPlain(cmd.to_string(), destination);
+                return;
+            }
+            try {
+                senders[destination].addMessage(cmd.to_string());
+            }
+            catch (const std::invalid_argument&) {
+                logWarning(std::string("(udp) message too large to send, message dropped ") +
+                           prettyPrintString(cmd));
+            }
+        };
+        // process acknowledgements and send all the queued and retransmitted datagrams
+        auto flush = [&]() {
+            std::error_code ackError;
+            while (!senders.empty() && transmitSocket.available(ackError) > 0) {
+                auto count =
+                    receiveBatch(transmitSocket, ackBuffers, ackSizes, ackSources, ackError);
+                if (ackError) {
+                    break;
+                }
+                auto now = ReliableSender::clock_type::now();
+                for (std::size_t ii = 0; ii < count; ++ii) {
+                    auto sender = senders.find(ackSources[ii]);
+                    if (sender != senders.end()) {
+                        sender->second.processAck(ackBuffers[ii].data(), ackSizes[ii], now);
+                    }
+                }
+            }
+            auto now = ReliableSender::clock_type::now();
+            for (auto& sender : senders) {
+                packets.clear();
+                sender.second.collectPackets(now, packets);
+                if (sender.second.failed()) {
+                    logError(fmt::format(
+                        "(udp) no acknowledgement from {}:{} after repeated retransmissions, {} "
+                        "datagrams dropped",
+                        sender.first.address().to_string(),
+                        sender.first.port(),
+                        sender.second.outstanding()));
+                    sender.second.clear();
+                    continue;
+                }
+                for (const auto* packet : packets) {
+                    outgoing.emplace_back(asio::buffer(*packet), sender.first);
+                }
+            }
+            if (!outgoing.empty()) {
+                std::error_code sendError;
+                sendBatch(transmitSocket, outgoing, sendError);
+                if (sendError) {
+                    logWarning(fmt::format("transmit failure {}", sendError.message()));
+                }
+            }
+            outgoing.clear();
+            plainData.clear();
+        };
+        // get the time to wait for new messages before the next retransmission is due
+        auto retransmitWait = [&]() {
+            auto now = ReliableSender::clock_type::now();
+            auto next = ReliableSender::clock_type::time_point::max();
+            for (const auto& sender : senders) {
+                if (sender.second.windowFull()) {
+                    // poll for the acknowledgements which open the window
+                    next = std::min(next, now + std::chrono::milliseconds(1));
+                }
+                next = std::min(next, sender.second.nextTimeout());
+            }
+            if (next == ReliableSender::clock_type::time_point::max()) {
+                return std::chrono::milliseconds::max();
+            }
+            return (next <= now) ?
+                std::chrono::milliseconds(0) :
+                std::chrono::duration_cast<std::chrono::milliseconds>(next - now) +
+                    std::chrono::milliseconds(1);
+        };
+        // returns false if the transmit loop should stop
+        auto transmitCommand = [&](route_id rid, ActionMessage& cmd) {
             if (isProtocolCommand(cmd)) {
                 if (rid == control_route) {
                     switch (cmd.messageID) {
@@ -346,80 +619,38 @@ namespace udp {
                             catch (std::exception&) {
                                 // TODO(someone): do something???
                             }
-                            processed = true;
-                        } break;
+                            return true;
+                        }
                         case REMOVE_ROUTE:
                             routes.erase(route_id{cmd.getExtraData()});
-                            processed = true;
-                            break;
+                            return true;
                         case CLOSE_RECEIVER:
-                            transmitSocket.send_to(asio::buffer(cmd.to_string()),
-                                                   rxEndpoint,
-                                                   0,
-                                                   error);
-                            if (error) {
-                                logError(fmt::format(
-                                    "transmit failure on sending 'close' to receiver  {}",
-                                    error.message()));
-                            }
+                            sendPlain(cmd.to_string(), rxEndpoint);
                             closingRx = true;
-                            processed = true;
-                            break;
+                            return true;
                         case DISCONNECT:
-                            continueProcessing = false;
-                            processed = true;
-                            break;
+                            return false;
                     }
                 }
             }
-            if (processed) {
-                continue;
-            }
 
             if (rid == parent_route_id) {
                 if (hasBroker) {
-                    transmitSocket.send_to(asio::buffer(cmd.to_string()),
-                                           broker_endpoint,
-                                           0,
-                                           error);
-                    if (error) {
-                        logWarning(
-                            fmt::format("transmit failure sending to broker  {}", error.message()));
-                    }
+                    sendMessage(cmd, broker_endpoint);
                 } else {
                     logWarning(fmt::format(
                         "message directed to broker of comm system with no broker, message dropped {}",
                         prettyPrintString(cmd)));
                 }
             } else if (rid == control_route) {  // send to rx thread loop
-                transmitSocket.send_to(asio::buffer(cmd.to_string()), rxEndpoint, 0, error);
-                if (error) {
-                    logWarning(
-                        fmt::format("transmit failure sending control message to receiver  {}",
-                                    error.message()));
-                }
+                sendPlain(cmd.to_string(), rxEndpoint);
             } else {
                 auto rt_find = routes.find(rid);
                 if (rt_find != routes.end()) {
-                    transmitSocket.send_to(asio::buffer(cmd.to_string()),
-                                           rt_find->second,
-                                           0,
-                                           error);
-                    if (error) {
-                        logWarning(fmt::format("transmit failure sending to route {}:{}",
-                                               rid.baseValue(),
-                                               error.message()));
-                    }
+                    sendMessage(cmd, rt_find->second);
                 } else {
                     if (hasBroker) {
-                        transmitSocket.send_to(asio::buffer(cmd.to_string()),
-                                               broker_endpoint,
-                                               0,
-                                               error);
-                        if (error) {
-                            logWarning(fmt::format("transmit failure sending to broker  {}",
-                                                   error.message()));
-                        }
+                        sendMessage(cmd, broker_endpoint);
                     } else {
                         if (!isDisconnectCommand(cmd)) {
                             logWarning(std::string("(udp) unknown route, message dropped ") +
@@ -428,6 +659,41 @@ namespace udp {
                     }
                 }
             }
+            return true;
+        };
+
+        setTxStatus(connection_status::connected);
+        bool continueProcessing{true};
+        while (continueProcessing) {
+            decltype(txQueue.try_pop()) mess;
+            auto wait = retransmitWait();
+            if (wait == std::chrono::milliseconds::max()) {
+                mess = txQueue.pop();
+            } else {
+                mess = txQueue.pop(wait);
+            }
+            // gather everything already queued into a single batch of datagrams
+            std::size_t batched{0};
+            while (mess) {
+                continueProcessing = transmitCommand(mess->first, mess->second);
+                if (!continueProcessing || ++batched >= maxBatchCount) {
+                    break;
+                }
+                mess = txQueue.try_pop();
+            }
+            flush();
+        }
+        if (!senders.empty()) {
+            // give the last reliable datagrams a chance to be acknowledged before closing
+            auto stopTime = ReliableSender::clock_type::now() +
+                std::min(connectionTimeout, std::chrono::milliseconds(1000));
+            while (ReliableSender::clock_type::now() < stopTime &&
+                   std::any_of(senders.begin(), senders.end(), [](const auto& sender) {
+                       return !sender.second.empty();
+                   })) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                flush();
+            }
         }
         routes.clear();
         if (getRxStatus() == connection_status::connected) {
@@ -28,6 +28,8 @@ namespace udp {
         ~UdpComms();
 
         virtual void loadNetworkInfo(const NetworkBrokerData& netInfo) override;
+        /** set a flag on the communication system, "reliable" enables the reliable protocol*/
+        virtual void setFlag(const std::string& flag, bool val) override;
 
       private:
         virtual int getDefaultBrokerPort() const override;
@@ -38,6 +40,8 @@ namespace udp {
         // promise and future for communicating port number from tx_thread to rx_thread
         std::promise<int> promisePort;
         std::future<int> futurePort;
+        /** send datagrams with sequence numbers, acknowledgement, and retransmission*/
+        bool reliableTransmission{false};
 
       public:
     };
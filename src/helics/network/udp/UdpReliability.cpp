@@ -0,0 +1,344 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#include "UdpReliability.h"
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+
+namespace helics {
+namespace udp {
+    static constexpr char reliableProtocolVersion{2};
+    /** the maximum number of datagrams buffered beyond a gap in the sequence*/
+    static constexpr std::uint64_t maxOutOfOrder{4096};
+    /** the maximum number of missing sequence numbers reported in an acknowledgement*/
+    static constexpr std::uint16_t maxNacks{64};
+    static constexpr std::chrono::milliseconds maxRetransmitTimeout{5000};
+    /** the number of earlier sessions a receiver remembers so their late datagrams are dropped*/
+    static constexpr std::size_t maxRetiredSessions{16};
+
+    static void writeUint32(char* data, std::uint32_t val)
+    {
+        data[0] = static_cast<char>((val >> 24U) & 0xFFU);
+        data[1] = static_cast<char>((val >> 16U) & 0xFFU);
+        data[2] = static_cast<char>((val >> 8U) & 0xFFU);
+        data[3] = static_cast<char>(val & 0xFFU);
+    }
+
+    static std::uint32_t readUint32(const char* data)
+    {
+        return (static_cast<std::uint32_t>(static_cast<unsigned char>(data[0])) << 24U) |
+            (static_cast<std::uint32_t>(static_cast<unsigned char>(data[1])) << 16U) |
+            (static_cast<std::uint32_t>(static_cast<unsigned char>(data[2])) << 8U) |
+            static_cast<std::uint32_t>(static_cast<unsigned char>(data[3]));
+    }
+
+    static void writeUint16(char* data, std::uint16_t val)
+    {
+        data[0] = static_cast<char>((val >> 8U) & 0xFFU);
+        data[1] = static_cast<char>(val & 0xFFU);
+    }
+
+    static std::uint16_t readUint16(const char* data)
+    {
+        return static_cast<std::uint16_t>(
+            (static_cast<unsigned int>(static_cast<unsigned char>(data[0])) << 8U) |
+            static_cast<unsigned int>(static_cast<unsigned char>(data[1])));
+    }
+
+    /** generate a random non zero id different from the previous one*/
+    static std::uint32_t generateId(std::uint32_t previous)
+    {
+        std::random_device rdev;
+        std::uint32_t id{0};
+        while (id == 0 || id == previous) {
+            id = static_cast<std::uint32_t>(rdev()) ^
+                static_cast<std::uint32_t>(
+                     std::chrono::steady_clock::now().time_since_epoch().count());
+        }
+        return id;
+    }
+
+    /** write the header of a reliable datagram
+    @details the layout is marker, type, version, reserved, session(4), sequence(4), fragment
+    index(2), fragment count(2) with all values big endian.  Acknowledgements use the sequence for
+    the cumulative acknowledgement and the fragment count for the number of missing sequences, the
+    header is followed by the receiver epoch(4) and the missing sequence numbers*/
+    static void writeHeader(char* data,
+                            reliable_packet_type type,
+                            std::uint32_t session,
+                            std::uint32_t sequence,
+                            std::uint16_t index,
+                            std::uint16_t count)
+    {
+        data[0] = reliablePacketMarker;
+        data[1] = static_cast<char>(type);
+        data[2] = reliableProtocolVersion;
+        data[3] = 0;
+        writeUint32(data + 4, session);
+        writeUint32(data + 8, sequence);
+        writeUint16(data + 12, index);
+        writeUint16(data + 14, count);
+    }
+
+    ReliableSender::ReliableSender(std::size_t datagramSize,
+                                   std::uint32_t windowSize_,
+                                   std::chrono::milliseconds retransmitTimeout,
+                                   int maxRetransmits_):
+        maxPayload(std::max<std::size_t>(datagramSize, reliableHeaderSize + 1) -
+                   reliableHeaderSize),
+        windowSize(std::max<std::uint32_t>(windowSize_, 1)), initialTimeout(retransmitTimeout),
+        maxRetransmits(maxRetransmits_)
+    {
+        sessionId = generateId(0);
+    }
+
+    void ReliableSender::addMessage(const std::string& message)
+    {
+        auto fragments = std::max<std::size_t>((message.size() + maxPayload - 1) / maxPayload, 1);
+        if (fragments > 0xFFFFU) {
+            throw(std::invalid_argument("message is too large to fragment"));
+        }
+        auto count = static_cast<std::uint16_t>(fragments);
+        for (std::uint16_t index = 0; index < count; ++index) {
+            auto offset = static_cast<std::size_t>(index) * maxPayload;
+            auto size = std::min(maxPayload, message.size() - offset);
+            window.emplace_back();
+            auto& packet = window.back().data;
+            packet.resize(reliableHeaderSize + size);
+            writeHeader(&packet[0],
+                        reliable_packet_type::data,
+                        sessionId,
+                        baseSequence + static_cast<std::uint32_t>(window.size() - 1),
+                        index,
+                        count);
+            std::copy_n(message.data() + offset, size, &packet[reliableHeaderSize]);
+        }
+    }
+
+    bool ReliableSender::processAck(const char* data, std::size_t size, clock_type::time_point now)
+    {
+        if (!isReliablePacket(data, size) ||
+            getReliablePacketType(data) != reliable_packet_type::ack ||
+            data[2] != reliableProtocolVersion) {
+            return false;
+        }
+        auto nackCount = readUint16(data + 14);
+        if (size < reliableHeaderSize + 4U + 4U * nackCount) {
+            return false;
+        }
+        if (readUint32(data + 4) != sessionId) {
+            // acknowledgements for an earlier session
+            return false;
+        }
+        auto epoch = readUint32(data + reliableHeaderSize);
+        if (receiverEpoch == 0) {
+            receiverEpoch = epoch;
+        } else if (epoch != receiverEpoch) {
+            // the receiver was restarted and lost track of the session, so send everything not
+            // yet acknowledged again in a new session it can follow from the start
+            receiverEpoch = epoch;
+            restartSession();
+            return true;
+        }
+        auto acked = readUint32(data + 8) - baseSequence;
+        if (acked <= window.size()) {
+            window.erase(window.begin(), window.begin() + acked);
+            baseSequence += acked;
+        }
+        for (std::uint16_t ii = 0; ii < nackCount; ++ii) {
+            auto index = readUint32(data + reliableHeaderSize + 4U + 4U * ii) - baseSequence;
+            if (index >= std::min<std::size_t>(window.size(), windowSize)) {
+                continue;
+            }
+            auto& packet = window[index];
+            // ignore reports from acknowledgements generated before the last transmission
+            if (packet.transmissions > 0 && now - packet.sendTime >= initialTimeout / 4) {
+                packet.resend = true;
+            }
+        }
+        return true;
+    }
+
+    void ReliableSender::collectPackets(clock_type::time_point now,
+                                        std::vector<const std::string*>& packets)
+    {
+        auto limit = std::min<std::size_t>(window.size(), windowSize);
+        for (std::size_t ii = 0; ii < limit; ++ii) {
+            auto& packet = window[ii];
+            if (packet.transmissions == 0) {
+                packet.timeout = initialTimeout;
+            } else if (packet.resend || now >= packet.sendTime + packet.timeout) {
+                if (packet.transmissions > maxRetransmits) {
+                    hasFailed = true;
+                    continue;
+                }
+                if (!packet.resend) {
+                    packet.timeout = std::min(packet.timeout * 2, maxRetransmitTimeout);
+                }
+                ++retransmitCount;
+            } else {
+                continue;
+            }
+            packet.sendTime = now;
+            packet.resend = false;
+            ++packet.transmissions;
+            packets.push_back(&packet.data);
+        }
+    }
+
+    ReliableSender::clock_type::time_point ReliableSender::nextTimeout() const
+    {
+        auto next = clock_type::time_point::max();
+        auto limit = std::min<std::size_t>(window.size(), windowSize);
+        for (std::size_t ii = 0; ii < limit; ++ii) {
+            const auto& packet = window[ii];
+            if (packet.transmissions == 0 || packet.resend) {
+                return clock_type::time_point::min();
+            }
+            next = std::min(next, packet.sendTime + packet.timeout);
+        }
+        return next;
+    }
+
+    void ReliableSender::clear()
+    {
+        window.clear();
+        restartSession();
+        hasFailed = false;
+    }
+
+    void ReliableSender::restartSession()
+    {
+        sessionId = generateId(sessionId);
+        baseSequence = 0;
+        std::uint32_t sequence{0};
+        for (auto& packet : window) {
+            writeUint32(&packet.data[4], sessionId);
+            writeUint32(&packet.data[8], sequence++);
+            packet.transmissions = 0;
+            packet.resend = false;
+        }
+    }
+
+    ReliableReceiver::ReliableReceiver(): epoch(generateId(0)) {}
+
+    bool ReliableReceiver::processPacket(const char* data,
+                                         std::size_t size,
+                                         std::vector<std::string>& messages)
+    {
+        if (!isReliablePacket(data, size) ||
+            getReliablePacketType(data) != reliable_packet_type::data ||
+            data[2] != reliableProtocolVersion) {
+            return false;
+        }
+        auto session = readUint32(data + 4);
+        if (session != sessionId) {
+            if (std::find(retiredSessions.begin(), retiredSessions.end(), session) !=
+                retiredSessions.end()) {
+                // a late datagram from a session the sender has abandoned
+                return true;
+            }
+            // the sender was restarted or dropped its last session, start over with the new one
+            if (sessionId != 0) {
+                retiredSessions.push_back(sessionId);
+                if (retiredSessions.size() > maxRetiredSessions) {
+                    retiredSessions.pop_front();
+                }
+            }
+            sessionId = session;
+            expected = 0;
+            outOfOrder.clear();
+            partial.clear();
+            nextFragment = 0;
+        }
+        pendingAck = true;
+        auto offset = static_cast<std::int32_t>(readUint32(data + 8) -
+                                                static_cast<std::uint32_t>(expected));
+        if (offset < 0) {
+            // a duplicate of something already delivered, the acknowledgement was likely lost
+            return true;
+        }
+        if (offset > 0) {
+            if (static_cast<std::uint64_t>(offset) < maxOutOfOrder) {
+                outOfOrder.emplace(expected + static_cast<std::uint64_t>(offset),
+                                   std::string(data, size));
+            }
+            return true;
+        }
+        deliver(data, size, messages);
+        ++expected;
+        while (!outOfOrder.empty() && outOfOrder.begin()->first == expected) {
+            const auto& packet = outOfOrder.begin()->second;
+            deliver(packet.data(), packet.size(), messages);
+            outOfOrder.erase(outOfOrder.begin());
+            ++expected;
+        }
+        return true;
+    }
+
+    void ReliableReceiver::deliver(const char* data,
+                                   std::size_t size,
+                                   std::vector<std::string>& messages)
+    {
+        auto index = readUint16(data + 12);
+        auto count = readUint16(data + 14);
+        if (count <= 1) {
+            partial.clear();
+            nextFragment = 0;
+            messages.emplace_back(data + reliableHeaderSize, size - reliableHeaderSize);
+            return;
+        }
+        if (index == 0) {
+            partial.assign(data + reliableHeaderSize, size - reliableHeaderSize);
+        } else if (index == nextFragment) {
+            partial.append(data + reliableHeaderSize, size - reliableHeaderSize);
+        } else {
+            // the start of the message was delivered to an earlier receiver so it is lost
+            partial.clear();
+            nextFragment = 0;
+            return;
+        }
+        nextFragment = static_cast<std::uint16_t>(index + 1);
+        if (nextFragment == count) {
+            messages.push_back(std::move(partial));
+            partial.clear();
+            nextFragment = 0;
+        }
+    }
+
+    std::string ReliableReceiver::generateAck()
+    {
+        std::vector<std::uint32_t> missing;
+        auto sequence = expected;
+        for (const auto& packet : outOfOrder) {
+            while (sequence < packet.first && missing.size() < maxNacks) {
+                missing.push_back(static_cast<std::uint32_t>(sequence));
+                ++sequence;
+            }
+            if (missing.size() >= maxNacks) {
+                break;
+            }
+            sequence = packet.first + 1;
+        }
+        std::string ack(reliableHeaderSize + 4 + 4 * missing.size(), '\0');
+        writeHeader(&ack[0],
+                    reliable_packet_type::ack,
+                    sessionId,
+                    static_cast<std::uint32_t>(expected),
+                    0,
+                    static_cast<std::uint16_t>(missing.size()));
+        writeUint32(&ack[reliableHeaderSize], epoch);
+        for (std::size_t ii = 0; ii < missing.size(); ++ii) {
+            writeUint32(&ack[reliableHeaderSize + 4 + 4 * ii], missing[ii]);
+        }
+        pendingAck = false;
+        return ack;
+    }
+
+}  // namespace udp
+}  // namespace helics
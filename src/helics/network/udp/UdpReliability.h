@@ -0,0 +1,150 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace helics {
+namespace udp {
+    /** the first byte of a datagram using the reliable protocol
+    @details serialized ActionMessages start with 0, 1, or 0xF3 so both can share a socket*/
+    constexpr char reliablePacketMarker = '\xE5';
+    /** the size of the header on each reliable datagram*/
+    constexpr std::size_t reliableHeaderSize = 16;
+    /** the default maximum datagram size, sized to avoid IP fragmentation on a 1500 byte MTU*/
+    constexpr std::size_t defaultReliableDatagramSize = 1472;
+
+    /** the types of reliable datagrams*/
+    enum class reliable_packet_type : std::uint8_t {
+        data = 0,  //!< a message or fragment of a message
+        ack = 1,  //!< a cumulative acknowledgement with a list of missing sequence numbers
+    };
+
+    /** check if a datagram uses the reliable protocol*/
+    inline bool isReliablePacket(const char* data, std::size_t size)
+    {
+        return (size >= reliableHeaderSize) && (data[0] == reliablePacketMarker);
+    }
+    /** get the type of a reliable datagram*/
+    inline reliable_packet_type getReliablePacketType(const char* data)
+    {
+        return static_cast<reliable_packet_type>(data[1]);
+    }
+
+    /** the sending half of the reliable udp protocol for a single destination
+    @details messages are split into sequenced datagrams which are held until acknowledged and
+    retransmitted on timeout or when the receiver reports them missing.  The object does no I/O
+    itself, the caller sends the datagrams returned from collectPackets and passes in any
+    acknowledgements received.  Each sender picks a random session id and numbers its datagrams
+    from 0 within the session, a new session is started on clear() or when the acknowledgements
+    show the receiver was restarted*/
+    class ReliableSender {
+      public:
+        using clock_type = std::chrono::steady_clock;
+        /** constructor
+        @param datagramSize the maximum size of each datagram including the header
+        @param windowSize the maximum number of unacknowledged datagrams in flight
+        @param retransmitTimeout the initial time to wait for an acknowledgement, doubles on each
+        retransmission of a datagram
+        @param maxRetransmits the number of retransmissions before the destination is considered
+        unreachable*/
+        explicit ReliableSender(
+            std::size_t datagramSize = defaultReliableDatagramSize,
+            std::uint32_t windowSize = 256,
+            std::chrono::milliseconds retransmitTimeout = std::chrono::milliseconds(100),
+            int maxRetransmits = 12);
+        /** add a serialized message to transmit, fragmenting it as needed*/
+        void addMessage(const std::string& message);
+        /** process an acknowledgement datagram from the receiver
+        @return true if the datagram was a valid acknowledgement for the current session*/
+        bool processAck(const char* data, std::size_t size, clock_type::time_point now);
+        /** append the datagrams which need to be sent or resent now to packets
+        @details the pointers remain valid until the next call to processAck or addMessage*/
+        void collectPackets(clock_type::time_point now, std::vector<const std::string*>& packets);
+        /** get the time the next datagram is due to be sent
+        @details time_point::min() if datagrams are waiting to be sent and time_point::max() if
+        nothing is outstanding*/
+        clock_type::time_point nextTimeout() const;
+        /** check if there are datagrams waiting on space in the window*/
+        bool windowFull() const { return window.size() > windowSize; }
+        /** check if everything has been acknowledged*/
+        bool empty() const { return window.empty(); }
+        /** check if a datagram has exceeded the maximum number of retransmissions*/
+        bool failed() const { return hasFailed; }
+        /** drop all pending datagrams and start a new session*/
+        void clear();
+        /** get the number of datagrams not yet acknowledged*/
+        std::size_t outstanding() const { return window.size(); }
+        /** get the total number of retransmitted datagrams*/
+        std::uint64_t retransmissions() const { return retransmitCount; }
+        /** get the current session id*/
+        std::uint32_t session() const { return sessionId; }
+
+      private:
+        struct Packet {
+            std::string data;  //!< the datagram including the header
+            clock_type::time_point sendTime;  //!< the last time the datagram was sent
+            std::chrono::milliseconds timeout{0};  //!< the current retransmission timeout
+            int transmissions{0};  //!< the number of times the datagram has been sent
+            bool resend{false};  //!< the receiver reported the datagram missing
+        };
+        /** move the unacknowledged datagrams to a new session starting at sequence 0*/
+        void restartSession();
+        std::deque<Packet> window;  //!< unacknowledged datagrams, the first is baseSequence
+        std::uint32_t baseSequence{0};  //!< the sequence number of the first datagram in window
+        std::uint32_t sessionId{0};  //!< the session id written into each datagram
+        std::uint32_t receiverEpoch{0};  //!< the epoch of the receiver, 0 if not yet known
+        const std::size_t maxPayload;  //!< the maximum data per datagram
+        const std::uint32_t windowSize;
+        const std::chrono::milliseconds initialTimeout;
+        const int maxRetransmits;
+        std::uint64_t retransmitCount{0};
+        bool hasFailed{false};
+    };
+
+    /** the receiving half of the reliable udp protocol for a single source
+    @details datagrams are reordered and duplicates dropped, and fragmented messages are
+    reassembled before being delivered.  A datagram from a new session resets the receiver, the
+    datagrams of sessions it replaced are dropped.  Each receiver has a random epoch sent back in
+    the acknowledgements so a sender can tell if the receiver was restarted*/
+    class ReliableReceiver {
+      public:
+        ReliableReceiver();
+        /** process a data datagram
+        @param data the datagram
+        @param size the size of the datagram
+        @param messages any messages completed by the datagram are appended in order
+        @return false if the datagram was not a valid data datagram*/
+        bool processPacket(const char* data, std::size_t size, std::vector<std::string>& messages);
+        /** check if an acknowledgement should be sent*/
+        bool ackPending() const { return pendingAck; }
+        /** generate an acknowledgement datagram and clear the pending flag*/
+        std::string generateAck();
+        /** get the next sequence number expected in order*/
+        std::uint64_t expectedSequence() const { return expected; }
+        /** get the session id of the sender*/
+        std::uint32_t session() const { return sessionId; }
+
+      private:
+        void deliver(const char* data, std::size_t size, std::vector<std::string>& messages);
+        std::uint64_t expected{0};  //!< the extended sequence number of the next datagram
+        std::map<std::uint64_t, std::string> outOfOrder;  //!< datagrams received after a gap
+        std::string partial;  //!< the fragments received of the current message
+        std::deque<std::uint32_t> retiredSessions;  //!< earlier sessions of the sender
+        std::uint32_t sessionId{0};  //!< the current session of the sender, 0 if none yet
+        const std::uint32_t epoch;  //!< the random id of this receiver
+        std::uint16_t nextFragment{0};  //!< the index of the next fragment of partial
+        bool pendingAck{false};
+    };
+
+}  // namespace udp
+}  // namespace helics
@@ -101,7 +101,12 @@ namespace zeromq {
                     status = -1;
                     break;
                 case CONNECTION_ACK:
-                    setTxStatus(connection_status::connected);
+                    // acknowledgements of a superseded request are ignored, brokers which do
+                    // not echo the correlation id send 0
+                    if (M.sequenceID == connectionRequestId || M.sequenceID == 0) {
+                        connectionRequestId = 0;
+                        setTxStatus(connection_status::connected);
+                    }
                     break;
                 case DISCONNECT:
                     disconnecting = true;
@@ -122,11 +127,12 @@ namespace zeromq {
                     break;
                 case CONNECTION_INFORMATION:
                     if (serverMode) {
+                        // a repeated request overwrites the earlier one
                         auto sdata = M.getStringData();
                         if (sdata.size() == 3) {
-                            connection_info.emplace(M.name, sdata[2]);
+                            connection_info[sdata[2]] = M.name;
                         } else {
-                            connection_info.emplace(M.name, M.payload);
+                            connection_info[M.payload] = M.name;
                         }
                         status = 3;
                     }
@@ -193,16 +199,47 @@ namespace zeromq {
             setTxStatus(connection_status::error);
             return -1;
         }
+        // a new id for each connection so acknowledgements meant for an earlier broker are ignored
+        static std::atomic<std::uint32_t> requestCounter{0};
+        connectionRequestId = ++requestCounter;
+        if (connectionRequestId == 0) {
+            connectionRequestId = ++requestCounter;
+        }
+        connectionRequestAttempts = 0;
+        sendConnectionRequest(brokerConnection);
+        return 0;
+    }
+
+    void ZmqCommsSS::sendConnectionRequest(zmq::socket_t& brokerConnection)
+    {
         std::vector<char> buffer;
         // generate a local protocol connection string to send it's identity
         ActionMessage cmessage(CMD_PROTOCOL);
         cmessage.messageID = CONNECTION_INFORMATION;
+        cmessage.sequenceID = connectionRequestId;
         cmessage.name = name;
         cmessage.setStringData(brokerName, brokerInitString, getAddress());
         cmessage.to_vector(buffer);
         brokerConnection.send(zmq::const_buffer(buffer.data(), buffer.size()),
                               zmq::send_flags::dontwait);
-        return 0;
+        connectionRequestTime = std::chrono::steady_clock::now();
+        ++connectionRequestAttempts;
+    }
+
+    bool ZmqCommsSS::checkConnectionRequest(zmq::socket_t& brokerConnection)
+    {
+        if (connectionRequestId == 0 ||
+            std::chrono::steady_clock::now() - connectionRequestTime < connectionTimeout) {
+            return true;
+        }
+        if (connectionRequestAttempts > maxRetries) {
+            logError(
+                "zmq broker connection timed out, the max number of retries has been exceeded");
+            return false;
+        }
+        logWarning("zmq broker connection timed out, resending connection request");
+        sendConnectionRequest(brokerConnection);
+        return true;
     }
 
     int ZmqCommsSS::initializeBrokerConnections(zmq::socket_t& brokerSocket,
@@ -243,17 +280,15 @@ namespace zeromq {
             case CONNECTION_INFORMATION:
                 // Shouldn't reach here ideally
                 if (serverMode) {
-                    connection_info.emplace(cmd.name, cmd.payload);
+                    connection_info[cmd.payload] = cmd.name;
                 }
                 break;
-            case NEW_ROUTE:
-                for (auto& mc : connection_info) {
-                    if (mc.second == cmd.payload) {
-                        routes.emplace(route_id(cmd.getExtraData()), mc.first);
-                        break;
-                    }
+            case NEW_ROUTE: {
+                auto connection = connection_info.find(cmd.payload);
+                if (connection != connection_info.end()) {
+                    routes.emplace(route_id(cmd.getExtraData()), connection->second);
                 }
-                break;
+            } break;
             case REMOVE_ROUTE:
                 routes.erase(route_id(cmd.getExtraData()));
                 break;
@@ -311,7 +346,7 @@ namespace zeromq {
 
         // contains mapping between route id and core name
         std::map<route_id, std::string> routes;
-        // contains mapping between core name and address
+        // contains mapping between address and core name
         std::map<std::string, std::string> connection_info;
 
         if (brokerPort < 0) {
@@ -348,6 +383,7 @@ namespace zeromq {
         int status{0};
 
         bool haltLoop{false};
+        bool connectionFailed{false};
         //  std::vector<ActionMessage> txlist;
         while (!haltLoop) {
             route_id rid;
@@ -429,9 +465,15 @@ namespace zeromq {
                 }
             }
 
+            if (hasBroker && !checkConnectionRequest(brokerConnection)) {
+                connectionFailed = true;
+                break;
+            }
+
             count = 0;
             rc = 1;
-            while ((rc > 0) && (count < 5)) {
+            // drain the waiting messages so a burst of connections is not served a few per loop
+            while ((rc > 0) && (count < TX_RX_MSG_COUNT)) {
                 rc = zmq::poll(poller, 0L);
 
                 if (rc > 0) {
@@ -467,9 +509,10 @@ namespace zeromq {
         if (hasBroker) {
             brokerConnection.close();
         }
-        setTxStatus(connection_status::terminated);
+        setTxStatus(connectionFailed ? connection_status::error : connection_status::terminated);
         if (getRxStatus() == connection_status::connected) {
-            setRxStatus(connection_status::terminated);
+            setRxStatus(connectionFailed ? connection_status::error :
+                                           connection_status::terminated);
         }
     }
 
@@ -487,6 +530,9 @@ namespace zeromq {
         if (status == 3) {
             ActionMessage rep(CMD_PROTOCOL);
             rep.messageID = CONNECTION_ACK;
+            // echo the correlation id so the requester can match the acknowledgement
+            ActionMessage request(static_cast<char*>(msg2.data()), msg2.size());
+            rep.sequenceID = request.sequenceID;
             socket.send(msg1, zmq::send_flags::sndmore);
             socket.send(std::string{}, zmq::send_flags::sndmore);
             socket.send(rep.to_string(), zmq::send_flags::dontwait);
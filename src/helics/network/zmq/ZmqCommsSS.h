@@ -10,6 +10,8 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "../NetworkCommsInterface.hpp"
 
 #include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <map>
 #include <set>
 #include <string>
@@ -58,6 +60,18 @@ namespace zeromq {
 
         int initializeBrokerConnections(zmq::socket_t& brokerSocket,
                                         zmq::socket_t& brokerConnection);
+        /** resend the connection request if it has not been acknowledged within the timeout
+        @return false if the maximum number of retries has been exceeded*/
+        bool checkConnectionRequest(zmq::socket_t& brokerConnection);
+        /** send the connection information to the broker tagged with the current correlation id*/
+        void sendConnectionRequest(zmq::socket_t& brokerConnection);
+
+        /** correlation id of the outstanding connection request, echoed in the acknowledgement*/
+        std::uint32_t connectionRequestId{0};
+        /** the number of times the current connection request has been sent*/
+        int connectionRequestAttempts{0};
+        /** the time the connection request was last sent*/
+        std::chrono::steady_clock::time_point connectionRequestTime;
     };
 
 }  // namespace zeromq
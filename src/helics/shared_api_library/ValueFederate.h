@@ -635,6 +635,26 @@ HELICS_EXPORT int helicsInputGetVectorSize(helics_input ipt);
  */
 HELICS_EXPORT void helicsInputGetVector(helics_input ipt, double data[], int maxlen, int* actualSize, helics_error* err);
 
+/**
+ * Get a pointer to the vector value of an input without copying the data.
+ *
+ * @details The pointer refers to storage owned by the input and remains valid until a value is next retrieved from the input
+ * or the federate is freed.
+ *
+ * @param ipt The input to get the result for.
+ * @forcpponly
+ * @param[out] vectorSize Location to place the number of doubles in the vector.
+ * @param[in,out] err An error object that will contain an error code and string if any error occurred during the execution of the function.
+ *
+ * @return A pointer to the first element of the vector, NULL if the vector is empty or on error.
+ * @endforcpponly
+ *
+ * @beginPythonOnly
+ * @return a memoryview of floating point values holding its own copy of the vector which numpy.asarray can wrap without copying
+ * @endPythonOnly
+ */
+HELICS_EXPORT const double* helicsInputGetVectorData(helics_input ipt, int* vectorSize, helics_error* err);
+
 /**
  * Get a named point from a subscription.
  *
@@ -932,6 +932,31 @@ void helicsInputGetVector(helics_input inp, double data[], int maxlen, int* actu
     // LCOV_EXCL_STOP
 }
 
+const double* helicsInputGetVectorData(helics_input inp, int* vectorSize, helics_error* err)
+{
+    auto* inpObj = verifyInput(inp, err);
+    if (vectorSize != nullptr) {
+        *vectorSize = 0;
+    }
+    if (inpObj == nullptr) {
+        return nullptr;
+    }
+    try {
+        const auto& V = inpObj->inputPtr->getValueRef<std::vector<double>>();
+        inpObj->inputPtr->clearUpdate();
+        if (vectorSize != nullptr) {
+            *vectorSize = static_cast<int>(V.size());
+        }
+        return (V.empty()) ? nullptr : V.data();
+    }
+    // LCOV_EXCL_START
+    catch (...) {
+        helicsErrorHandler(err);
+        return nullptr;
+    }
+    // LCOV_EXCL_STOP
+}
+
 void helicsInputGetNamedPoint(helics_input inp, char* outputString, int maxStringLen, int* actualLength, double* val, helics_error* err)
 {
     auto* inpObj = verifyInput(inp, err);
@@ -98,6 +98,90 @@ HELICS_EXPORT void helicsFilterSetCustomCallback(helics_filter filter,
                                                  void* userdata,
                                                  helics_error* err);
 
+/**
+ * Subscribe to the results of a query made through a federate.
+ *
+ * @details The target of the query sends a new result whenever its state changes and the result is different.
+ *          The callback is executed on the core's processing thread so it should return quickly and must not make blocking calls into
+ *          HELICS.  A query object can have one active subscription, subscribing again replaces the previous subscription.
+ *
+ * @param query The query object defining the target and query string.
+ * @param fed The federate to make the query through.
+ * @param period The minimum time in seconds between results.
+ * @param everyPeriod Set to helics_true to call the callback every period even if the result has not changed.
+ * @param update A callback with signature void(const char *, int, void *);
+ *               the function arguments are the query result, the length of the result, and a pointer to user data.
+ * @param userdata A pointer to user data that is passed to the function when executing.
+ * @forcpponly
+ * @param[in,out] err A pointer to an error object for catching errors.
+ * @endforcpponly
+ */
+HELICS_EXPORT void helicsQuerySubscribe(helics_query query,
+                                        helics_federate fed,
+                                        double period,
+                                        helics_bool everyPeriod,
+                                        void (*update)(const char* result, int resultSize, void* userData),
+                                        void* userdata,
+                                        helics_error* err);
+
+/**
+ * Subscribe to the results of a query made directly on a core.
+ *
+ * @details Operates the same as /ref helicsQuerySubscribe with the query made from the core.
+ *
+ * @param query The query object defining the target and query string.
+ * @param core The core to make the query through.
+ * @param period The minimum time in seconds between results.
+ * @param everyPeriod Set to helics_true to call the callback every period even if the result has not changed.
+ * @param update A callback with signature void(const char *, int, void *);
+ *               the function arguments are the query result, the length of the result, and a pointer to user data.
+ * @param userdata A pointer to user data that is passed to the function when executing.
+ * @forcpponly
+ * @param[in,out] err A pointer to an error object for catching errors.
+ * @endforcpponly
+ */
+HELICS_EXPORT void helicsQueryCoreSubscribe(helics_query query,
+                                            helics_core core,
+                                            double period,
+                                            helics_bool everyPeriod,
+                                            void (*update)(const char* result, int resultSize, void* userData),
+                                            void* userdata,
+                                            helics_error* err);
+
+/**
+ * Subscribe to the results of a query made directly on a broker.
+ *
+ * @details Operates the same as /ref helicsQuerySubscribe with the query made from the broker.
+ *
+ * @param query The query object defining the target and query string.
+ * @param broker The broker to make the query through.
+ * @param period The minimum time in seconds between results.
+ * @param everyPeriod Set to helics_true to call the callback every period even if the result has not changed.
+ * @param update A callback with signature void(const char *, int, void *);
+ *               the function arguments are the query result, the length of the result, and a pointer to user data.
+ * @param userdata A pointer to user data that is passed to the function when executing.
+ * @forcpponly
+ * @param[in,out] err A pointer to an error object for catching errors.
+ * @endforcpponly
+ */
+HELICS_EXPORT void helicsQueryBrokerSubscribe(helics_query query,
+                                              helics_broker broker,
+                                              double period,
+                                              helics_bool everyPeriod,
+                                              void (*update)(const char* result, int resultSize, void* userData),
+                                              void* userdata,
+                                              helics_error* err);
+
+/**
+ * Stop the updates from a query subscription.
+ *
+ * @details The callback may still be called until the core or broker processes the request.  Freeing a query also stops its
+ *          subscription.
+ *
+ * @param query The query object with an active subscription.
+ */
+HELICS_EXPORT void helicsQueryUnsubscribe(helics_query query);
+
 #ifdef __cplusplus
 } /* end of extern "C" { */
 #endif
@@ -12,10 +12,12 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "../core/helicsVersion.hpp"
 #include "../helics.hpp"
 #include "helics.h"
+#include "helicsCallbacks.h"
 #include "helics/helics-config.h"
 #include "internal/api_objects.h"
 
 #include <atomic>
+#include <functional>
 #include <future>
 #include <memory>
 #include <mutex>
@@ -962,6 +964,137 @@ void helicsQuerySetQueryString(helics_query query, const char* queryString, heli
     queryObj->query = AS_STRING(queryString);
 }
 
+using subscriptionUpdate = void (*)(const char* result, int resultSize, void* userdata);
+
+static std::function<void(const std::string&)> makeSubscriptionCallback(subscriptionUpdate update, void* userdata)
+{
+    return [update, userdata](const std::string& result) {
+        update(result.c_str(), static_cast<int>(result.size()), userdata);
+    };
+}
+
+static constexpr const char* invalidSubscriptionCallback = "query subscriptions require a callback";
+
+void helicsQuerySubscribe(helics_query query,
+                          helics_federate fed,
+                          double period,
+                          helics_bool everyPeriod,
+                          void (*update)(const char* result, int resultSize, void* userdata),
+                          void* userdata,
+                          helics_error* err)
+{
+    auto fedObj = getFedSharedPtr(fed, err);
+    if (fedObj == nullptr) {
+        return;
+    }
+    auto* queryObj = getQueryObj(query, err);
+    if (queryObj == nullptr) {
+        return;
+    }
+    if (update == nullptr) {
+        assignError(err, helics_error_invalid_argument, invalidSubscriptionCallback);
+        return;
+    }
+    try {
+        helicsQueryUnsubscribe(query);
+        auto index = fedObj->subscribeQuery(queryObj->target,
+                                            queryObj->query,
+                                            makeSubscriptionCallback(update, userdata),
+                                            helics::Time(period),
+                                            (everyPeriod != helics_false));
+        queryObj->stopSubscription = [fedObj, index]() { fedObj->unsubscribeQuery(index); };
+    }
+    catch (...) {
+        helicsErrorHandler(err);
+    }
+}
+
+void helicsQueryCoreSubscribe(helics_query query,
+                              helics_core core,
+                              double period,
+                              helics_bool everyPeriod,
+                              void (*update)(const char* result, int resultSize, void* userdata),
+                              void* userdata,
+                              helics_error* err)
+{
+    auto coreObj = getCoreSharedPtr(core, err);
+    if (coreObj == nullptr) {
+        return;
+    }
+    auto* queryObj = getQueryObj(query, err);
+    if (queryObj == nullptr) {
+        return;
+    }
+    if (update == nullptr) {
+        assignError(err, helics_error_invalid_argument, invalidSubscriptionCallback);
+        return;
+    }
+    try {
+        helicsQueryUnsubscribe(query);
+        auto index = coreObj->subscribeQuery(queryObj->target,
+                                             queryObj->query,
+                                             makeSubscriptionCallback(update, userdata),
+                                             helics::Time(period).to_ms(),
+                                             (everyPeriod != helics_false));
+        queryObj->stopSubscription = [coreObj, index]() { coreObj->unsubscribeQuery(index); };
+    }
+    catch (...) {
+        helicsErrorHandler(err);
+    }
+}
+
+void helicsQueryBrokerSubscribe(helics_query query,
+                                helics_broker broker,
+                                double period,
+                                helics_bool everyPeriod,
+                                void (*update)(const char* result, int resultSize, void* userdata),
+                                void* userdata,
+                                helics_error* err)
+{
+    auto* brokerObj = helics::getBrokerObject(broker, err);
+    if (brokerObj == nullptr) {
+        return;
+    }
+    auto* queryObj = getQueryObj(query, err);
+    if (queryObj == nullptr) {
+        return;
+    }
+    if (update == nullptr) {
+        assignError(err, helics_error_invalid_argument, invalidSubscriptionCallback);
+        return;
+    }
+    try {
+        helicsQueryUnsubscribe(query);
+        auto brk = brokerObj->brokerptr;
+        auto index = brk->subscribeQuery(queryObj->target,
+                                         queryObj->query,
+                                         makeSubscriptionCallback(update, userdata),
+                                         helics::Time(period).to_ms(),
+                                         (everyPeriod != helics_false));
+        queryObj->stopSubscription = [brk, index]() { brk->unsubscribeQuery(index); };
+    }
+    catch (...) {
+        helicsErrorHandler(err);
+    }
+}
+
+void helicsQueryUnsubscribe(helics_query query)
+{
+    auto* queryObj = getQueryObj(query, nullptr);
+    if (queryObj == nullptr || !queryObj->stopSubscription) {
+        return;
+    }
+    auto stop = std::move(queryObj->stopSubscription);
+    queryObj->stopSubscription = nullptr;
+    try {
+        stop();
+    }
+    // LCOV_EXCL_START
+    catch (...) {
+    }
+    // LCOV_EXCL_STOP
+}
+
 void helicsQueryFree(helics_query query)
 {
     auto* queryObj = getQueryObj(query, nullptr);
@@ -969,6 +1102,7 @@ void helicsQueryFree(helics_query query)
         //  fprintf(stderr, "invalid query object\n");
         return;
     }
+    helicsQueryUnsubscribe(query);
     queryObj->valid = 0;
     delete queryObj;
 }
@@ -13,6 +13,7 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "gmlc/concurrency/TripWire.hpp"
 
 #include <deque>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -141,6 +142,7 @@ class QueryObject {
     std::string response;  //!< the response to the query
     std::shared_ptr<Federate> activeFed;  //!< pointer to the fed with the active Query
     query_id_t asyncIndexCode;  //!< the index to use for the queryComplete call
+    std::function<void()> stopSubscription;  //!< function to stop an active query subscription
     bool activeAsync{false};
     int valid{0};
 };
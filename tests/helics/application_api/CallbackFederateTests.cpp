@@ -0,0 +1,122 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "helics/application_api/CallbackFederate.hpp"
+#include "helics/application_api/Inputs.hpp"
+#include "helics/application_api/Publications.hpp"
+#include "helics/core/BrokerFactory.hpp"
+#include "helics/core/CoreFactory.hpp"
+#include "helics/core/core-exceptions.hpp"
+#include "helics/core/helics_definitions.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+/** these test cases test out federates executed by the core callback threads
+ */
+
+#define CORE_TYPE_TO_TEST helics::core_type::TEST
+
+TEST(callback_federate_tests, time_steps)
+{
+    helics::FederateInfo fi(CORE_TYPE_TO_TEST);
+    fi.coreInitString = "--autobroker";
+
+    helics::CallbackFederate fed("cb1", fi);
+    std::vector<helics::Time> grants;
+    bool initialized{false};
+    bool finalized{false};
+    fed.setInitializeCallback([&initialized]() {
+        initialized = true;
+        return helics::iteration_request::no_iterations;
+    });
+    fed.setStepCallback([&grants](helics::Time granted) {
+        grants.push_back(granted);
+        return (granted < 3.0) ? granted + 1.0 : helics::Time::maxVal();
+    });
+    fed.setFinalizeCallback([&finalized]() { finalized = true; });
+    fed.startExecution();
+    fed.waitForCompletion();
+
+    EXPECT_TRUE(fed.isCompleted());
+    EXPECT_TRUE(initialized);
+    EXPECT_TRUE(finalized);
+    ASSERT_EQ(grants.size(), 4U);
+    EXPECT_EQ(grants.front(), helics::timeZero);
+    EXPECT_EQ(grants.back(), 3.0);
+    EXPECT_TRUE(fed.getCurrentMode() == helics::Federate::modes::finalize);
+    EXPECT_THROW(fed.startExecution(), helics::InvalidFunctionCall);
+}
+
+TEST(callback_federate_tests, shared_thread)
+{
+    auto brk = helics::BrokerFactory::create(CORE_TYPE_TO_TEST, "cbb", "-f 2");
+    helics::FederateInfo fi(CORE_TYPE_TO_TEST);
+    fi.coreInitString = "--broker=cbb --callback_threads=1";
+    auto core = helics::CoreFactory::create(CORE_TYPE_TO_TEST, "cbcore", fi.coreInitString);
+
+    helics::CallbackFederate fed1("cb1", core, fi);
+    helics::CallbackFederate fed2("cb2", core, fi);
+    auto& pub = fed1.registerGlobalPublication<double>("pub");
+    auto& in = fed2.registerSubscription("pub");
+    in.setDefault(0.0);
+
+    fed1.setStepCallback([&pub](helics::Time granted) {
+        pub.publish(static_cast<double>(granted) + 1.0);
+        return (granted < 4.0) ? granted + 1.0 : helics::Time::maxVal();
+    });
+    std::vector<double> received;
+    fed2.setStepCallback([&in, &received](helics::Time granted) {
+        if (in.isUpdated()) {
+            received.push_back(in.getValue<double>());
+        }
+        return (granted < 5.0) ? granted + 1.0 : helics::Time::maxVal();
+    });
+    // both federates block on each other so this deadlocks if either one holds the thread
+    fed1.startExecution();
+    fed2.startExecution();
+    fed1.waitForCompletion();
+    fed2.waitForCompletion();
+
+    ASSERT_EQ(received.size(), 5U);
+    EXPECT_DOUBLE_EQ(received.front(), 1.0);
+    EXPECT_DOUBLE_EQ(received.back(), 5.0);
+    core.reset();
+    brk->waitForDisconnect();
+}
+
+TEST(callback_federate_tests, non_std_exception)
+{
+    helics::FederateInfo fi(CORE_TYPE_TO_TEST);
+    fi.coreInitString = "--autobroker";
+
+    helics::CallbackFederate fed("cb_throw", fi);
+    int errorCode{0};
+    bool finalized{false};
+    fed.setStepCallback([](helics::Time granted) -> helics::Time {
+        if (granted >= 1.0) {
+            // anything can be thrown from user code running on the core thread
+            throw 5;
+        }
+        return granted + 1.0;
+    });
+    fed.setErrorCallback([&errorCode](int code, const std::string& /*message*/) {
+        errorCode = code;
+        throw 7;
+    });
+    fed.setFinalizeCallback([&finalized]() {
+        finalized = true;
+        throw 9;
+    });
+    fed.startExecution();
+    fed.waitForCompletion();
+
+    EXPECT_TRUE(fed.isCompleted());
+    EXPECT_EQ(errorCode, helics::defs::errors::execution_failure);
+    EXPECT_TRUE(finalized);
+}
@@ -13,8 +13,12 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "helics/common/JsonProcessingFunctions.hpp"
 #include "helics/core/helics_definitions.hpp"
 
+#include <algorithm>
+#include <complex>
 #include <future>
 #include <gtest/gtest.h>
+#include <string>
+#include <vector>
 #ifndef HELICS_SHARED_LIBRARY
 #    include "testFixtures.hpp"
 #else
@@ -378,6 +382,43 @@ TEST_F(multiInput, average)
     vFed1->finalize();
 }
 
+TEST_F(multiInput, sum_many)
+{
+    using namespace helics;
+    SetupTest<ValueFederate>("test", 1, 1.0);
+    auto vFed1 = GetFederateAs<ValueFederate>(0);
+
+    std::vector<Publication*> pubs;
+    auto& in1 = vFed1->registerInput<double>("");
+    for (int ii = 0; ii < 50; ++ii) {
+        auto pname = std::string("pub") + std::to_string(ii);
+        pubs.push_back(&vFed1->registerGlobalPublication<double>(pname));
+        in1.addTarget(pname);
+    }
+    auto& in2 = vFed1->registerInput<double>("");
+    for (int ii = 0; ii < 50; ++ii) {
+        in2.addTarget(std::string("pub") + std::to_string(ii));
+    }
+    in1.setOption(helics::defs::multi_input_handling_method,
+                  helics::multi_input_handling_method::sum_operation);
+    in2.setOption(helics::defs::multi_input_handling_method,
+                  helics::multi_input_handling_method::max_operation);
+    vFed1->enterExecutingMode();
+
+    double sum{0.0};
+    double mx{-1e9};
+    for (int ii = 0; ii < 50; ++ii) {
+        double v = 0.1 * static_cast<double>(ii) + 1.0 / 3.0;
+        pubs[ii]->publish(v);
+        sum += v;
+        mx = std::max(mx, v);
+    }
+    vFed1->requestNextStep();
+    EXPECT_DOUBLE_EQ(in1.getValue<double>(), sum);
+    EXPECT_DOUBLE_EQ(in2.getValue<double>(), mx);
+    vFed1->finalize();
+}
+
 TEST_F(multiInput, diff)
 {
     using namespace helics;
@@ -525,6 +566,116 @@ TEST_F(multiInput, vectorizeComplex)
     vFed1->finalize();
 }
 
+TEST_F(multiInput, sum_complex_vector)
+{
+    using namespace helics;
+    SetupTest<ValueFederate>("test", 1, 1.0);
+    auto vFed1 = GetFederateAs<ValueFederate>(0);
+
+    std::vector<Publication*> cpubs;
+    std::vector<Publication*> vpubs;
+    auto& in1 = vFed1->registerInput<double>("");
+    auto& in2 = vFed1->registerInput<double>("");
+    auto& in3 = vFed1->registerInput<std::vector<double>>("");
+    for (int ii = 0; ii < 10; ++ii) {
+        auto pname = std::string("cpub") + std::to_string(ii);
+        cpubs.push_back(&vFed1->registerGlobalPublication<std::complex<double>>(pname));
+        in1.addTarget(pname);
+        in2.addTarget(pname);
+    }
+    for (int ii = 0; ii < 10; ++ii) {
+        auto pname = std::string("vpub") + std::to_string(ii);
+        vpubs.push_back(&vFed1->registerGlobalPublication<std::vector<double>>(pname));
+        in1.addTarget(pname);
+        in2.addTarget(pname);
+        in3.addTarget(pname);
+    }
+    in1.setOption(helics::defs::multi_input_handling_method,
+                  helics::multi_input_handling_method::sum_operation);
+    in2.setOption(helics::defs::multi_input_handling_method,
+                  helics::multi_input_handling_method::average_operation);
+    in3.setOption(helics::defs::multi_input_handling_method,
+                  helics::multi_input_handling_method::diff_operation);
+    vFed1->enterExecutingMode();
+
+    // complex values add both the real and imaginary parts to the sum like the vector conversion
+    double sum{0.0};
+    int count{0};
+    for (int ii = 0; ii < 10; ++ii) {
+        std::complex<double> cval{0.5 * ii, -0.25 * ii};
+        cpubs[ii]->publish(cval);
+        sum += cval.real() + cval.imag();
+        count += 2;
+    }
+    std::vector<double> elements;
+    for (int ii = 0; ii < 10; ++ii) {
+        std::vector<double> vval{static_cast<double>(ii), 0.5, -1.0};
+        vpubs[ii]->publish(vval);
+        for (auto val : vval) {
+            sum += val;
+        }
+        count += 3;
+        elements.insert(elements.end(), vval.begin(), vval.end());
+    }
+    vFed1->requestNextStep();
+    EXPECT_DOUBLE_EQ(in1.getValue<double>(), sum);
+    EXPECT_DOUBLE_EQ(in2.getValue<double>(), sum / static_cast<double>(count));
+
+    std::vector<double> diffs;
+    for (size_t ii = 1; ii < elements.size(); ++ii) {
+        diffs.push_back(elements[ii - 1] - elements[ii]);
+    }
+    auto val = in3.getValue<std::vector<double>>();
+    ASSERT_EQ(val.size(), diffs.size());
+    for (size_t ii = 0; ii < diffs.size(); ++ii) {
+        EXPECT_DOUBLE_EQ(val[ii], diffs[ii]);
+    }
+    vFed1->finalize();
+}
+
+TEST_F(multiInput, vectorize_complex_many)
+{
+    using namespace helics;
+    SetupTest<ValueFederate>("test", 1, 1.0);
+    auto vFed1 = GetFederateAs<ValueFederate>(0);
+
+    std::vector<Publication*> pubs;
+    auto& in1 = vFed1->registerInput<std::vector<std::complex<double>>>("");
+    for (int ii = 0; ii < 20; ++ii) {
+        auto pname = std::string("pub") + std::to_string(ii);
+        if (ii % 4 == 3) {
+            pubs.push_back(&vFed1->registerGlobalPublication(pname, "complex_vector"));
+        } else {
+            pubs.push_back(&vFed1->registerGlobalPublication<std::complex<double>>(pname));
+        }
+        in1.addTarget(pname);
+    }
+    in1.setOption(helics::defs::multi_input_handling_method,
+                  helics::multi_input_handling_method::vectorize_operation);
+    vFed1->enterExecutingMode();
+
+    std::vector<std::complex<double>> expected;
+    for (int ii = 0; ii < 20; ++ii) {
+        std::complex<double> cval{1.0 + ii, -0.5 * ii};
+        if (ii % 4 == 3) {
+            std::vector<std::complex<double>> cvect{cval, std::conj(cval)};
+            pubs[ii]->publish(cvect);
+            expected.insert(expected.end(), cvect.begin(), cvect.end());
+        } else {
+            pubs[ii]->publish(cval);
+            expected.push_back(cval);
+        }
+    }
+    vFed1->requestNextStep();
+    auto val = in1.getValue<std::vector<std::complex<double>>>();
+    ASSERT_EQ(val.size(), expected.size());
+    for (size_t ii = 0; ii < expected.size(); ++ii) {
+        EXPECT_DOUBLE_EQ(val[ii].real(), expected[ii].real());
+        EXPECT_DOUBLE_EQ(val[ii].imag(), expected[ii].imag());
+    }
+    vFed1->finalize();
+}
+
 TEST_F(multiInput, max_units)
 {
     using namespace helics;
@@ -612,3 +763,74 @@ TEST_F(multiInput, file_config_toml)
 
     vFed.finalize();
 }
+
+TEST_F(multiInput, target_pattern)
+{
+    using namespace helics;
+    SetupTest<ValueFederate>("test", 2, 1.0);
+    auto vFed1 = GetFederateAs<ValueFederate>(0);
+    auto vFed2 = GetFederateAs<ValueFederate>(1);
+
+    // the pattern is added before any of the publications exist
+    auto& in1 = vFed2->registerInput<double>("");
+    in1.addTargetPattern("grid/feeder*/meter?/power");
+    in1.setOption(helics::defs::multi_input_handling_method,
+                  helics::multi_input_handling_method::sum_operation);
+
+    auto& pub1 = vFed1->registerGlobalPublication<double>("grid/feeder1/meter1/power");
+    auto& pub2 = vFed1->registerGlobalPublication<double>("grid/feeder12/meter3/power");
+    auto& pub3 = vFed1->registerGlobalPublication<double>("grid/feeder2/meter1/voltage");
+    auto& pub4 = vFed1->registerGlobalPublication<double>("grid/feeder2/meter10/power");
+
+    vFed1->enterExecutingModeAsync();
+    vFed2->enterExecutingMode();
+    vFed1->enterExecutingModeComplete();
+
+    pub1.publish(1.0);
+    pub2.publish(2.0);
+    pub3.publish(4.0);
+    pub4.publish(8.0);
+    vFed1->requestTimeAsync(1.0);
+    vFed2->requestTime(1.0);
+    vFed1->requestTimeComplete();
+
+    EXPECT_DOUBLE_EQ(in1.getValue<double>(), 3.0);
+    vFed1->finalize();
+    vFed2->finalize();
+}
+
+TEST_F(multiInput, target_pattern_existing)
+{
+    using namespace helics;
+    SetupTest<ValueFederate>("test", 2, 1.0);
+    auto vFed1 = GetFederateAs<ValueFederate>(0);
+    auto vFed2 = GetFederateAs<ValueFederate>(1);
+
+    // the publications exist before the first pattern so the root builds its name index from the
+    // interfaces it already knows about
+    auto& pub1 = vFed1->registerGlobalPublication<double>("grid/feeder1/meter1/power");
+    auto& pub2 = vFed1->registerGlobalPublication<double>("grid/feeder2/meter1/voltage");
+    vFed1->query("root", "publications");
+
+    auto& in1 = vFed2->registerInput<double>("");
+    in1.addTargetPattern("grid/feeder*/meter?/power");
+    in1.setOption(helics::defs::multi_input_handling_method,
+                  helics::multi_input_handling_method::sum_operation);
+    // a later publication is matched through the index
+    auto& pub3 = vFed1->registerGlobalPublication<double>("grid/feeder3/meter2/power");
+
+    vFed1->enterExecutingModeAsync();
+    vFed2->enterExecutingMode();
+    vFed1->enterExecutingModeComplete();
+
+    pub1.publish(1.0);
+    pub2.publish(2.0);
+    pub3.publish(4.0);
+    vFed1->requestTimeAsync(1.0);
+    vFed2->requestTime(1.0);
+    vFed1->requestTimeComplete();
+
+    EXPECT_DOUBLE_EQ(in1.getValue<double>(), 5.0);
+    vFed1->finalize();
+    vFed2->finalize();
+}
@@ -1082,3 +1082,39 @@ TEST(valuefederate, indexed_targets)
 
     Fed1->finalize();
 }
+
+TEST(valuefederate, local_value_delivery)
+{
+    // values to inputs in the same core are delivered directly unless disabled
+    for (const char* deliveryOption : {"", " --no_direct_values"}) {
+        helics::FederateInfo fi(helics::core_type::TEST);
+        fi.coreInitString = std::string("-f 2 --autobroker") + deliveryOption;
+
+        auto Fed1 = std::make_shared<helics::ValueFederate>("vfed1", fi);
+        auto Fed2 = std::make_shared<helics::ValueFederate>("vfed2", Fed1->getCorePointer(), fi);
+        auto& pub = Fed1->registerGlobalPublication<std::string>("pub");
+        auto& in1 = Fed1->registerSubscription("pub");
+        auto& in2 = Fed2->registerSubscription("pub");
+        Fed1->enterExecutingModeAsync();
+        Fed2->enterExecutingMode();
+        Fed1->enterExecutingModeComplete();
+
+        pub.publish("value1");
+        Fed1->requestTimeAsync(1.0);
+        Fed2->requestTime(1.0);
+        Fed1->requestTimeComplete();
+        EXPECT_EQ(in1.getValue<std::string>(), "value1");
+        EXPECT_EQ(in2.getValue<std::string>(), "value1");
+
+        pub.publish("value2");
+        pub.publish("value3");
+        Fed1->requestTimeAsync(2.0);
+        Fed2->requestTime(2.0);
+        Fed1->requestTimeComplete();
+        EXPECT_EQ(in1.getValue<std::string>(), "value3");
+        EXPECT_EQ(in2.getValue<std::string>(), "value3");
+
+        Fed1->finalize();
+        Fed2->finalize();
+    }
+}
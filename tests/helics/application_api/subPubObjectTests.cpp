@@ -569,3 +569,60 @@ TEST(inputObject, units)
     EXPECT_NEAR(val3, 40.0, 0.0001);
     vFed->finalize();
 }
+
+TEST(inputObject, units_vector)
+{
+    helics::FederateInfo fi(CORE_TYPE_TO_TEST);
+    fi.coreInitString = "--autobroker";
+
+    auto vFed = std::make_shared<helics::ValueFederate>("test1", fi);
+
+    auto& subObj1 = vFed->registerSubscription("pub1");
+    auto& subObj2 = vFed->registerSubscription("pub2", "degF");
+    auto& p1 = vFed->registerGlobalPublication<std::vector<double>>("pub1", "m");
+    auto& p2 = vFed->registerGlobalPublication<double>("pub2", "degC");
+
+    vFed->enterExecutingMode();
+    p1.publish(std::vector<double>{1.0, 2.5, -3.0}, "km");
+    p2.publish(100.0);
+
+    vFed->requestTime(1.0);
+
+    auto val1 = subObj1.getValue<std::vector<double>>();
+    ASSERT_EQ(val1.size(), 3U);
+    EXPECT_NEAR(val1[0], 1000.0, 0.0001);
+    EXPECT_NEAR(val1[1], 2500.0, 0.0001);
+    EXPECT_NEAR(val1[2], -3000.0, 0.0001);
+    EXPECT_NEAR(subObj2.getValue<double>(), 212.0, 0.0001);
+
+    // same units as the publication should pass through unchanged
+    p1.publish(std::vector<double>{1.0, 2.5}, "m");
+    p2.publish(0.0);
+    vFed->requestTime(2.0);
+    val1 = subObj1.getValue<std::vector<double>>();
+    ASSERT_EQ(val1.size(), 2U);
+    EXPECT_EQ(val1[0], 1.0);
+    EXPECT_EQ(val1[1], 2.5);
+    EXPECT_NEAR(subObj2.getValue<double>(), 32.0, 0.0001);
+    vFed->finalize();
+}
+
+TEST(inputObject, unit_conversion_plan)
+{
+    auto meter = std::make_shared<units::precise_unit>(units::precise::m);
+    auto km = std::make_shared<units::precise_unit>(units::precise::km);
+    helics::UnitConversionPlan plan1(meter, meter);
+    EXPECT_TRUE(plan1.isActive());
+    EXPECT_TRUE(plan1.isIdentity());
+    EXPECT_EQ(plan1.apply(4.5), 4.5);
+
+    helics::UnitConversionPlan plan2(km, meter);
+    EXPECT_FALSE(plan2.isIdentity());
+    std::vector<double> vals{1.0, 2.0, 3.5};
+    plan2.apply(vals);
+    EXPECT_NEAR(vals[2], 3500.0, 1e-9);
+
+    helics::UnitConversionPlan plan3(nullptr, meter);
+    EXPECT_FALSE(plan3.isActive());
+    EXPECT_EQ(plan3.apply(2.0), 2.0);
+}
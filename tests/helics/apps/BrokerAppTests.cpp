@@ -207,6 +207,63 @@ TEST(BrokerAppTests, help)
     helics::CoreFactory::terminateAllCores();
 }
 
+TEST(BrokerAppTests, broker_tree)
+{
+    helics::BrokerApp app(helics::core_type::TEST,
+                          "brktree",
+                          "--expected_cores=6 --max_fanout=2 --federates=3");
+    EXPECT_TRUE(app.isConnected());
+    const auto& tree = app.getBrokerTree();
+    ASSERT_FALSE(tree.empty());
+    // two brokers below the root and three brokers with two cores each
+    EXPECT_NE(tree.find("brktree_sub4"), std::string::npos);
+    EXPECT_EQ(tree.find("brktree_sub5"), std::string::npos);
+    EXPECT_EQ(app.query("global", "broker_tree"), tree);
+
+    std::vector<std::shared_ptr<helics::Federate>> feds;
+    for (int ii = 2; ii < 5; ++ii) {
+        helics::FederateInfo fi;
+        fi.broker = "brktree_sub" + std::to_string(ii);
+        fi.coreType = helics::core_type::TEST;
+        feds.push_back(std::make_shared<helics::Federate>("tfed" + std::to_string(ii), fi));
+    }
+    for (auto& fed : feds) {
+        fed->enterExecutingModeAsync();
+    }
+    for (auto& fed : feds) {
+        fed->enterExecutingModeComplete();
+        EXPECT_EQ(fed->getCurrentMode(), helics::Federate::modes::executing);
+    }
+    for (auto& fed : feds) {
+        fed->finalize();
+    }
+    feds.clear();
+    EXPECT_TRUE(app.waitForDisconnect(std::chrono::milliseconds(2000)));
+    app.reset();
+}
+
+TEST(BrokerAppTests, broker_tree_key)
+{
+    // the sub-brokers must carry the broker key of the root to be able to connect to it
+    helics::BrokerApp app(helics::core_type::TEST,
+                          "brktreekey",
+                          "--expected_cores=4 --max_fanout=2 --key=tree_key");
+    EXPECT_TRUE(app.isConnected());
+    ASSERT_FALSE(app.getBrokerTree().empty());
+
+    helics::FederateInfo fi;
+    fi.broker = "brktreekey_sub0";
+    fi.coreType = helics::core_type::TEST;
+    fi.coreInitString = "--key=tree_key";
+    auto fed = std::make_shared<helics::Federate>("tkfed", fi);
+    fed->enterExecutingMode();
+    EXPECT_EQ(fed->getCurrentMode(), helics::Federate::modes::executing);
+    fed->finalize();
+    fed.reset();
+    EXPECT_TRUE(app.waitForDisconnect(std::chrono::milliseconds(2000)));
+    app.reset();
+}
+
 TEST(BrokerAppTests, file_logging_p2)
 {
     helics::BrokerApp app("--name=loggerBrk1 --type=test");
@@ -0,0 +1,63 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#include "helics/common/BinaryLogger.hpp"
+
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace helics;
+
+TEST(binaryLogger, ring_buffer)
+{
+    BinaryLogRing ring(3);
+    BinaryLogRecord record;
+    for (int ii = 0; ii < 4; ++ii) {
+        record.source = ii;
+        EXPECT_TRUE(ring.push(record));
+    }
+    EXPECT_FALSE(ring.push(record));
+    EXPECT_EQ(ring.dropped(), 1U);
+    for (int ii = 0; ii < 4; ++ii) {
+        ASSERT_TRUE(ring.pop(record));
+        EXPECT_EQ(record.source, ii);
+    }
+    EXPECT_FALSE(ring.pop(record));
+}
+
+TEST(binaryLogger, record_and_decode)
+{
+    const std::string file{"binary_log_test.hlog"};
+    auto grantFormat = BinaryLogger::registerFormat("Granted Time={} for {}");
+    auto cmdFormat = BinaryLogger::registerFormat("|| cmd:{} from {} {{{}}}");
+    EXPECT_EQ(BinaryLogger::registerFormat("Granted Time={} for {}"), grantFormat);
+    EXPECT_NE(grantFormat, cmdFormat);
+    {
+        BinaryLogger logger(file);
+        logger.record(5, 131072, grantFormat, 2.5, "fed1");
+        std::thread other([&]() { logger.record(7, 1, cmdFormat, "cmd_time_request", -3, 17U); });
+        other.join();
+        logger.flush();
+        EXPECT_EQ(logger.recordsWritten(), 2U);
+        EXPECT_EQ(logger.recordsDropped(), 0U);
+    }
+    std::ifstream input(file, std::ios::binary);
+    std::ostringstream output;
+    EXPECT_EQ(decodeBinaryLog(input, output), 2U);
+    auto text = output.str();
+    EXPECT_NE(text.find("timing (131072) Granted Time=2.5 for fed1"), std::string::npos);
+    EXPECT_NE(text.find("trace (1) || cmd:cmd_time_request from -3 {17}"), std::string::npos);
+    input.close();
+    std::remove(file.c_str());
+
+    std::istringstream bad("not a log file");
+    EXPECT_THROW(decodeBinaryLog(bad, output), std::invalid_argument);
+}
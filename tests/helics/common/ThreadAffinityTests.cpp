@@ -0,0 +1,50 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#include "helics/common/ThreadAffinity.hpp"
+
+#include "gtest/gtest.h"
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace helics;
+
+TEST(threadAffinity, parse_cpu_list)
+{
+    EXPECT_EQ(parseCpuList("3"), (std::vector<int>{3}));
+    EXPECT_EQ(parseCpuList("0-3,8"), (std::vector<int>{0, 1, 2, 3, 8}));
+    EXPECT_EQ(parseCpuList(" 8, 2-3 ,2"), (std::vector<int>{2, 3, 8}));
+    EXPECT_TRUE(parseCpuList("").empty());
+}
+
+TEST(threadAffinity, parse_cpu_list_errors)
+{
+    EXPECT_THROW(parseCpuList("a"), std::invalid_argument);
+    EXPECT_THROW(parseCpuList("1-"), std::invalid_argument);
+    EXPECT_THROW(parseCpuList("3-1"), std::invalid_argument);
+    EXPECT_THROW(parseCpuList("1,,2"), std::invalid_argument);
+    EXPECT_THROW(parseCpuList("1,"), std::invalid_argument);
+    EXPECT_THROW(parseCpuList("-2"), std::invalid_argument);
+    EXPECT_THROW(parseCpuList("100000"), std::invalid_argument);
+}
+
+TEST(threadAffinity, empty_set)
+{
+    EXPECT_FALSE(setThreadAffinity(std::vector<int>{}));
+}
+
+TEST(threadAffinity, parse_context_threads)
+{
+    EXPECT_EQ(parseContextThreads("4"), (std::pair<std::string, int>{"", 4}));
+    EXPECT_EQ(parseContextThreads("io:2"), (std::pair<std::string, int>{"io", 2}));
+    EXPECT_EQ(parseContextThreads("a:b:3"), (std::pair<std::string, int>{"a:b", 3}));
+    EXPECT_THROW(parseContextThreads("io:"), std::invalid_argument);
+    EXPECT_THROW(parseContextThreads("io:x"), std::invalid_argument);
+    EXPECT_THROW(parseContextThreads("io:0"), std::invalid_argument);
+    EXPECT_THROW(parseContextThreads("1000"), std::invalid_argument);
+}
@@ -0,0 +1,80 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#include "helics/core/BrokerTreePlanner.hpp"
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <vector>
+
+using namespace helics;
+
+TEST(brokerTree, no_tree_needed)
+{
+    auto plan = generateBrokerTreePlan(8, 8);
+    EXPECT_EQ(plan.levels, 0);
+    EXPECT_TRUE(plan.brokerParents.empty());
+    ASSERT_EQ(plan.coreAssignments.size(), 8U);
+    for (auto assignment : plan.coreAssignments) {
+        EXPECT_EQ(assignment, -1);
+    }
+
+    plan = generateBrokerTreePlan(0, 8);
+    EXPECT_TRUE(plan.coreAssignments.empty());
+}
+
+TEST(brokerTree, fanout_limits)
+{
+    auto plan = generateBrokerTreePlan(2000, 32);
+    // 63 brokers for the cores and 2 above them to connect to the root
+    EXPECT_EQ(plan.levels, 2);
+    ASSERT_EQ(plan.brokerParents.size(), 65U);
+    ASSERT_EQ(plan.coreAssignments.size(), 2000U);
+
+    std::vector<int> connections(plan.brokerParents.size(), 0);
+    int rootConnections{0};
+    for (std::size_t ii = 0; ii < plan.brokerParents.size(); ++ii) {
+        auto parent = plan.brokerParents[ii];
+        if (parent < 0) {
+            ++rootConnections;
+        } else {
+            // parents must come before their children so they can be created first
+            EXPECT_LT(parent, static_cast<int>(ii));
+            ++connections[parent];
+        }
+    }
+    for (auto assignment : plan.coreAssignments) {
+        ASSERT_GE(assignment, 0);
+        ++connections[assignment];
+    }
+    EXPECT_EQ(rootConnections, 2);
+    EXPECT_LE(*std::max_element(connections.begin(), connections.end()), 32);
+    EXPECT_EQ(plan.brokerLoads[0] + plan.brokerLoads[1], 2000.0);
+}
+
+TEST(brokerTree, load_balance)
+{
+    // one heavy core and several light ones
+    std::vector<double> loads{10.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0};
+    auto plan = generateBrokerTreePlan(8, 4, loads);
+    EXPECT_EQ(plan.levels, 1);
+    ASSERT_EQ(plan.brokerParents.size(), 2U);
+    auto heavyBroker = plan.coreAssignments[0];
+    auto heavyCount =
+        std::count(plan.coreAssignments.begin(), plan.coreAssignments.end(), heavyBroker);
+    // the fanout limit forces the remaining light cores onto the heavy broker
+    EXPECT_EQ(heavyCount, 4);
+    EXPECT_DOUBLE_EQ(plan.brokerLoads[heavyBroker], 13.0);
+    EXPECT_DOUBLE_EQ(plan.brokerLoads[1 - heavyBroker], 4.0);
+
+    plan = generateBrokerTreePlan(8, 7, loads);
+    heavyBroker = plan.coreAssignments[0];
+    heavyCount =
+        std::count(plan.coreAssignments.begin(), plan.coreAssignments.end(), heavyBroker);
+    // with room on the brokers the heavy core is kept by itself
+    EXPECT_EQ(heavyCount, 1);
+    EXPECT_DOUBLE_EQ(plan.brokerLoads[1 - heavyBroker], 7.0);
+}
@@ -0,0 +1,126 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#include "helics/common/JsonProcessingFunctions.hpp"
+#include "helics/core/ActionMessage.hpp"
+#include "helics/core/FlightRecorder.hpp"
+
+#include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+using namespace helics;
+
+TEST(flightRecorder, wrap_around)
+{
+    FlightRecorder recorder(5);
+    EXPECT_EQ(recorder.capacity(), 8U);
+    ActionMessage cmd(CMD_TIME_REQUEST);
+    for (int ii = 0; ii < 20; ++ii) {
+        cmd.messageID = ii;
+        cmd.actionTime = Time(static_cast<std::int64_t>(ii), time_units::sec);
+        recorder.record(cmd);
+    }
+    EXPECT_EQ(recorder.recordCount(), 20U);
+    auto records = recorder.snapshot();
+    ASSERT_EQ(records.size(), 8U);
+    EXPECT_EQ(records.front().messageID, 12);
+    EXPECT_EQ(records.back().messageID, 19);
+    EXPECT_EQ(records.back().action, static_cast<int32_t>(CMD_TIME_REQUEST));
+    EXPECT_EQ(records.back().actionTime,
+              Time(static_cast<std::int64_t>(19), time_units::sec).getBaseTimeCode());
+    EXPECT_LE(records.front().timestamp, records.back().timestamp);
+
+    Json::Value base;
+    recorder.generateRecords(base, 3);
+    EXPECT_EQ(base["count"].asUInt64(), 20U);
+    ASSERT_EQ(base["records"].size(), 3U);
+    EXPECT_EQ(base["records"][2]["message_id"].asInt(), 19);
+    EXPECT_EQ(base["records"][2]["action"].asString(), "time_request");
+}
+
+TEST(flightRecorder, dump_and_decode)
+{
+    FlightRecorder recorder(16);
+    ActionMessage cmd(CMD_PUB, global_federate_id(131072), global_federate_id(131073));
+    cmd.payload = "test payload";
+    recorder.record(cmd);
+    cmd.setAction(CMD_TIME_GRANT);
+    cmd.actionTime = 2.5;
+    recorder.record(cmd);
+
+    std::stringstream dump;
+    recorder.dump(dump);
+    std::ostringstream output;
+    EXPECT_EQ(decodeFlightRecorderDump(dump, output), 2U);
+    auto text = output.str();
+    EXPECT_NE(text.find("2 messages recorded"), std::string::npos);
+    EXPECT_NE(text.find("pub from 131072"), std::string::npos);
+    EXPECT_NE(text.find("size=12"), std::string::npos);
+    EXPECT_NE(text.find("time=2.5"), std::string::npos);
+
+    std::istringstream bad("not a dump");
+    EXPECT_THROW(decodeFlightRecorderDump(bad, output), std::invalid_argument);
+}
+
+TEST(flightRecorder, dump_requests)
+{
+    const std::string file{"flight_recorder_request.hfr"};
+    std::remove(file.c_str());
+    FlightRecorder recorder(16);
+    recorder.record(ActionMessage(CMD_TIME_REQUEST));
+    recorder.enableSignalDump(file);
+
+    auto count = FlightRecorder::dumpRequestCount();
+    FlightRecorder::requestDump();
+    EXPECT_NE(FlightRecorder::dumpRequestCount(), count);
+    // the dump is written by the watcher thread without any further records
+    std::ifstream dump;
+    for (int ii = 0; ii < 50 && !dump.is_open(); ++ii) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        dump.open(file, std::ios::binary);
+    }
+    ASSERT_TRUE(dump.is_open());
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    std::ostringstream output;
+    EXPECT_EQ(decodeFlightRecorderDump(dump, output), 1U);
+    dump.close();
+    std::remove(file.c_str());
+}
+
+TEST(flightRecorder, concurrent_snapshot)
+{
+    FlightRecorder recorder(64);
+    std::atomic<bool> done{false};
+    std::thread writer([&recorder, &done]() {
+        ActionMessage cmd(CMD_TIME_REQUEST);
+        for (int ii = 0; ii < 200000; ++ii) {
+            cmd.messageID = ii;
+            cmd.counter = static_cast<std::uint16_t>(ii);
+            recorder.record(cmd);
+        }
+        done.store(true);
+    });
+    while (!done.load()) {
+        auto records = recorder.snapshot();
+        EXPECT_LE(records.size(), recorder.capacity());
+        for (std::size_t ii = 0; ii < records.size(); ++ii) {
+            // a torn record would mix fields from different messages
+            EXPECT_EQ(static_cast<std::uint16_t>(records[ii].messageID), records[ii].counter);
+            if (ii > 0) {
+                EXPECT_LT(records[ii - 1].messageID, records[ii].messageID);
+            }
+        }
+    }
+    writer.join();
+    EXPECT_EQ(recorder.snapshot().size(), recorder.capacity());
+}
@@ -6,8 +6,10 @@ SPDX-License-Identifier: BSD-3-Clause
 */
 #include "helics/core/ActionMessage.hpp"
 #include "helics/core/ForwardingTimeCoordinator.hpp"
+#include "helics/core/flagOperations.hpp"
 
 #include "gtest/gtest.h"
+#include <vector>
 
 using namespace helics;
 
@@ -221,3 +223,101 @@ TEST(ftc_tests, timing_test1)
     EXPECT_EQ(lastMessage.Tdemin, 0.5);
     EXPECT_TRUE(lastMessage.action() == CMD_TIME_REQUEST);
 }
+
+TEST(ftc_tests, aggregate_ignores_own_time)
+{
+    ForwardingTimeCoordinator ftc;
+    ftc.aggregating = true;
+    global_federate_id fed2(2);
+    global_federate_id fed3(3);
+    ftc.addDependency(fed2);
+    ftc.addDependency(fed3);
+    getFTCtoExecMode(ftc);
+    // both federates depend on each other through the aggregating coordinator
+    ftc.addDependent(fed2);
+    ftc.addDependent(fed3);
+    std::vector<ActionMessage> messages;
+    ftc.source_id = global_federate_id(1);
+    ftc.setMessageSender([&messages](const helics::ActionMessage& mess) {
+        messages.push_back(mess);
+    });
+
+    ActionMessage timeUpdate(CMD_TIME_REQUEST, fed2, global_federate_id(1));
+    timeUpdate.actionTime = 1.0;
+    timeUpdate.Te = 1.0;
+    timeUpdate.Tdemin = 1.0;
+    EXPECT_TRUE(ftc.processTimeMessage(timeUpdate));
+    ftc.updateTimeFactors();
+    EXPECT_TRUE(messages.empty());
+
+    timeUpdate.source_id = fed3;
+    timeUpdate.actionTime = 3.0;
+    timeUpdate.Te = 3.0;
+    timeUpdate.Tdemin = 3.0;
+    EXPECT_TRUE(ftc.processTimeMessage(timeUpdate));
+    ftc.updateTimeFactors();
+    EXPECT_EQ(ftc.getNextTime(), 1.0);
+    // fed2 is the minimum so it should only see the time of fed3 and fed3 is already past the
+    // aggregate time so it does not need an update
+    ASSERT_EQ(messages.size(), 1U);
+    EXPECT_TRUE(messages[0].dest_id == fed2);
+    EXPECT_TRUE(messages[0].action() == CMD_TIME_REQUEST);
+    EXPECT_EQ(messages[0].actionTime, 3.0);
+    EXPECT_EQ(messages[0].Tdemin, 3.0);
+}
+
+TEST(ftc_tests, aggregate_iteration)
+{
+    ForwardingTimeCoordinator ftc;
+    ftc.aggregating = true;
+    global_federate_id fed2(2);
+    global_federate_id fed3(3);
+    global_federate_id fed5(5);
+    ftc.addDependency(fed2);
+    ftc.addDependency(fed3);
+    getFTCtoExecMode(ftc);
+
+    ftc.addDependent(fed5);
+    std::vector<ActionMessage> messages;
+    ftc.source_id = global_federate_id(1);
+    ftc.setMessageSender([&messages](const helics::ActionMessage& mess) {
+        messages.push_back(mess);
+    });
+
+    ActionMessage timeUpdate(CMD_TIME_REQUEST, fed3, global_federate_id(1));
+    timeUpdate.actionTime = 3.0;
+    timeUpdate.Te = 3.0;
+    timeUpdate.Tdemin = 3.0;
+    EXPECT_TRUE(ftc.processTimeMessage(timeUpdate));
+    ftc.updateTimeFactors();
+    EXPECT_TRUE(messages.empty());
+
+    timeUpdate.source_id = fed2;
+    timeUpdate.actionTime = 1.0;
+    timeUpdate.Te = 1.0;
+    timeUpdate.Tdemin = 1.0;
+    setActionFlag(timeUpdate, iteration_requested_flag);
+    EXPECT_TRUE(ftc.processTimeMessage(timeUpdate));
+    ftc.updateTimeFactors();
+    ASSERT_EQ(messages.size(), 1U);
+    EXPECT_TRUE(messages[0].dest_id == fed5);
+    EXPECT_EQ(messages[0].actionTime, 1.0);
+    EXPECT_TRUE(checkActionFlag(messages[0], iteration_requested_flag));
+
+    // a repeated iterative request must be passed on since the dependents reset it on a grant
+    EXPECT_TRUE(ftc.processTimeMessage(timeUpdate));
+    ftc.updateTimeFactors();
+    ASSERT_EQ(messages.size(), 2U);
+    EXPECT_EQ(messages[1].actionTime, 1.0);
+    EXPECT_TRUE(checkActionFlag(messages[1], iteration_requested_flag));
+
+    clearActionFlag(timeUpdate, iteration_requested_flag);
+    timeUpdate.actionTime = 2.0;
+    timeUpdate.Te = 2.0;
+    timeUpdate.Tdemin = 2.0;
+    EXPECT_TRUE(ftc.processTimeMessage(timeUpdate));
+    ftc.updateTimeFactors();
+    ASSERT_EQ(messages.size(), 3U);
+    EXPECT_EQ(messages[2].actionTime, 2.0);
+    EXPECT_FALSE(checkActionFlag(messages[2], iteration_requested_flag));
+}
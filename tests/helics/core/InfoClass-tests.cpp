@@ -325,3 +325,66 @@ TEST(InfoClass_tests, inputinfo_test)
     ret_data = subI.getData(0);
     EXPECT_EQ(ret_data->to_string(), "time one");
 }
+
+TEST(InfoClass_tests, inputinfo_clear_sources)
+{
+    helics::InputInfo subI(helics::global_handle(helics::global_federate_id(5),
+                                                 helics::interface_handle(13)),
+                           "key",
+                           "type",
+                           "units");
+    helics::global_handle firstHandle(helics::global_federate_id(5), helics::interface_handle(45));
+    helics::global_handle secondHandle(helics::global_federate_id(6), helics::interface_handle(45));
+    subI.addSource(firstHandle, "first", "double", std::string());
+    subI.addSource(secondHandle, "second", "double", std::string());
+    EXPECT_TRUE(subI.addData(secondHandle, 1.0, 0, std::make_shared<helics::data_block>("old")));
+
+    subI.clearSources();
+    EXPECT_TRUE(subI.input_sources.empty());
+    EXPECT_FALSE(subI.addData(secondHandle, 1.0, 0, std::make_shared<helics::data_block>("no")));
+
+    // a source added again after the clear gets a fresh index
+    subI.addSource(secondHandle, "second", "double", std::string());
+    ASSERT_EQ(subI.source_info.size(), 1U);
+    EXPECT_EQ(subI.source_info[0].key, "second");
+    EXPECT_FALSE(subI.addData(firstHandle, 2.0, 0, std::make_shared<helics::data_block>("no")));
+    EXPECT_TRUE(subI.addData(secondHandle, 2.0, 0, std::make_shared<helics::data_block>("new")));
+    subI.updateTimeInclusive(2.0);
+    ASSERT_TRUE(subI.getData(0));
+    EXPECT_EQ(subI.getData(0)->to_string(), "new");
+}
+
+TEST(InfoClass_tests, inputinfo_queue_order)
+{
+    helics::InputInfo subI(helics::global_handle(helics::global_federate_id(5),
+                                                 helics::interface_handle(13)),
+                           "key",
+                           "type",
+                           "units");
+    helics::global_handle testHandle(helics::global_federate_id(5), helics::interface_handle(45));
+    helics::global_handle otherHandle(helics::global_federate_id(6), helics::interface_handle(45));
+    subI.addSource(testHandle, "", "double", std::string());
+    EXPECT_FALSE(subI.addData(otherHandle, 1.0, 0, std::make_shared<helics::data_block>("no")));
+
+    // queue future values out of order across enough grants to wrap the buffer
+    for (int ii = 0; ii < 20; ++ii) {
+        helics::Time base = 10.0 * ii;
+        EXPECT_TRUE(subI.addData(testHandle,
+                                 base + 3.0,
+                                 0,
+                                 std::make_shared<helics::data_block>("three")));
+        subI.addData(testHandle, base + 1.0, 0, std::make_shared<helics::data_block>("one"));
+        subI.addData(testHandle, base + 2.0, 0, std::make_shared<helics::data_block>("two"));
+        subI.addData(testHandle, base + 1.0, 0, std::make_shared<helics::data_block>("one b"));
+        EXPECT_EQ(subI.nextValueTime(), base + 1.0);
+
+        subI.updateTimeInclusive(base + 1.0);
+        EXPECT_EQ(subI.getData(0)->to_string(), "one b");
+        EXPECT_EQ(subI.nextValueTime(), base + 2.0);
+        subI.updateTimeUpTo(base + 2.5);
+        EXPECT_EQ(subI.getData(0)->to_string(), "two");
+        subI.updateTimeInclusive(base + 5.0);
+        EXPECT_EQ(subI.getData(0)->to_string(), "three");
+        EXPECT_EQ(subI.nextValueTime(), helics::Time::maxVal());
+    }
+}
@@ -0,0 +1,40 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#include "helics/core/InterfaceDirectory.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace helics;
+
+TEST(interfaceDirectory, add_find)
+{
+    InterfaceDirectory dir;
+    EXPECT_TRUE(dir.empty());
+    EXPECT_TRUE(dir.addInterface(handle_type::publication, "pub1", global_broker_id(5)));
+    EXPECT_TRUE(dir.addInterface(handle_type::endpoint, "pub1", global_broker_id(6)));
+    EXPECT_FALSE(dir.addInterface(handle_type::publication, "pub1", global_broker_id(7)));
+    EXPECT_EQ(dir.size(), 2U);
+
+    EXPECT_EQ(dir.findOwner(handle_type::publication, "pub1"), global_broker_id(5));
+    EXPECT_EQ(dir.findOwner(handle_type::endpoint, "pub1"), global_broker_id(6));
+    EXPECT_FALSE(dir.findOwner(handle_type::input, "pub1").isValid());
+    EXPECT_FALSE(dir.findOwner(handle_type::publication, "pub2").isValid());
+}
+
+TEST(interfaceDirectory, remove_owner)
+{
+    InterfaceDirectory dir;
+    dir.addInterface(handle_type::publication, "pub1", global_broker_id(5));
+    dir.addInterface(handle_type::input, "inp1", global_broker_id(5));
+    dir.addInterface(handle_type::filter, "filt1", global_broker_id(6));
+    dir.removeOwner(global_broker_id(5));
+    EXPECT_EQ(dir.size(), 1U);
+    EXPECT_FALSE(dir.findOwner(handle_type::publication, "pub1").isValid());
+    EXPECT_EQ(dir.findOwner(handle_type::filter, "filt1"), global_broker_id(6));
+    dir.removeOwner(global_broker_id(6));
+    EXPECT_TRUE(dir.empty());
+}
@@ -0,0 +1,92 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#include "helics/core/InterfaceNameIndex.hpp"
+
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+
+using namespace helics;
+
+TEST(interfaceNameIndex, pattern_match)
+{
+    EXPECT_TRUE(isNamePattern("grid/*"));
+    EXPECT_TRUE(isNamePattern("meter?"));
+    EXPECT_FALSE(isNamePattern("grid/feeder1"));
+
+    EXPECT_TRUE(matchNamePattern("grid/feeder*/meter*/power", "grid/feeder1/meter22/power"));
+    EXPECT_FALSE(matchNamePattern("grid/feeder*/meter*/power", "grid/feeder1/meter22/powers"));
+    EXPECT_TRUE(matchNamePattern("*", ""));
+    EXPECT_TRUE(matchNamePattern("a?c", "abc"));
+    EXPECT_FALSE(matchNamePattern("a?c", "ac"));
+    EXPECT_TRUE(matchNamePattern("a*b*c", "aXbYbZc"));
+}
+
+TEST(interfaceNameIndex, find_interfaces)
+{
+    InterfaceNameIndex index;
+    EXPECT_TRUE(index.addInterface(handle_type::publication, "grid/feeder1/meter1/power"));
+    EXPECT_TRUE(index.addInterface(handle_type::publication, "grid/feeder2/meter1/power"));
+    EXPECT_TRUE(index.addInterface(handle_type::publication, "grid/feeder2/meter1/voltage"));
+    EXPECT_TRUE(index.addInterface(handle_type::input, "grid/feeder2/meter1/power"));
+    EXPECT_FALSE(index.addInterface(handle_type::input, "grid/feeder2/meter1/power"));
+    EXPECT_EQ(index.interfaceCount(), 4U);
+
+    auto matches = index.findInterfaces(handle_type::publication, "grid/feeder*/meter*/power");
+    std::vector<std::string> expected{"grid/feeder1/meter1/power", "grid/feeder2/meter1/power"};
+    EXPECT_EQ(matches, expected);
+    EXPECT_EQ(index.findInterfaces(handle_type::publication, "*").size(), 3U);
+    EXPECT_EQ(index.findInterfaces(handle_type::input, "*").size(), 1U);
+    EXPECT_TRUE(index.findInterfaces(handle_type::endpoint, "*").empty());
+    EXPECT_EQ(index.findInterfaces(handle_type::publication, "grid/feeder2/meter1/voltage").size(),
+              1U);
+}
+
+TEST(interfaceNameIndex, find_patterns)
+{
+    InterfaceNameIndex index;
+    EXPECT_TRUE(index.findPatterns(handle_type::publication, "grid/a/power").empty());
+    index.addPattern(handle_type::publication, "grid/*/power", 3);
+    index.addPattern(handle_type::publication, "*", 4);
+    index.addPattern(handle_type::input, "*", 5);
+    EXPECT_EQ(index.patternCount(), 3U);
+
+    auto ids = index.findPatterns(handle_type::publication, "grid/a/power");
+    ASSERT_EQ(ids.size(), 2U);
+    EXPECT_EQ(ids[0], 4);
+    EXPECT_EQ(ids[1], 3);
+    ids = index.findPatterns(handle_type::publication, "other");
+    ASSERT_EQ(ids.size(), 1U);
+    EXPECT_EQ(ids[0], 4);
+    ids = index.findPatterns(handle_type::input, "grid/a/power");
+    ASSERT_EQ(ids.size(), 1U);
+    EXPECT_EQ(ids[0], 5);
+}
+
+TEST(interfaceNameIndex, remove_patterns)
+{
+    InterfaceNameIndex index;
+    index.addPattern(handle_type::publication, "grid/*/power", 3);
+    index.addPattern(handle_type::publication, "grid/*/power", 4);
+    index.addPattern(handle_type::publication, "*", 5);
+    index.removePattern(handle_type::publication, "grid/*/power", 3);
+    // a pattern with a different id or type is left alone
+    index.removePattern(handle_type::input, "*", 5);
+    EXPECT_EQ(index.patternCount(), 2U);
+
+    auto ids = index.findPatterns(handle_type::publication, "grid/a/power");
+    ASSERT_EQ(ids.size(), 2U);
+    EXPECT_EQ(ids[0], 5);
+    EXPECT_EQ(ids[1], 4);
+
+    EXPECT_TRUE(index.addInterface(handle_type::publication, "grid/a/power"));
+    index.clear();
+    EXPECT_EQ(index.patternCount(), 0U);
+    EXPECT_EQ(index.interfaceCount(), 0U);
+    EXPECT_TRUE(index.findPatterns(handle_type::publication, "grid/a/power").empty());
+    EXPECT_TRUE(index.addInterface(handle_type::publication, "grid/a/power"));
+}
@@ -0,0 +1,55 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#include "helics/core/MessageCapture.hpp"
+
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+using namespace helics;
+
+TEST(messageCapture, write_and_load)
+{
+    const std::string file{"message_capture_test.hmc"};
+    {
+        MessageCaptureWriter writer(file);
+        ActionMessage cmd(CMD_PUB, global_federate_id(131072), global_federate_id(131073));
+        cmd.payload = "test value";
+        cmd.actionTime = 1.5;
+        writer.write(cmd);
+        ActionMessage reg(CMD_REG_FED);
+        reg.name = "fed1";
+        reg.setStringData("extra string");
+        writer.write(reg);
+        writer.write(ActionMessage(CMD_TIME_REQUEST));
+        EXPECT_EQ(writer.count(), 3U);
+    }
+    auto messages = loadMessageCapture(file);
+    ASSERT_EQ(messages.size(), 3U);
+    EXPECT_EQ(messages[0].message.action(), CMD_PUB);
+    EXPECT_EQ(messages[0].message.payload, "test value");
+    EXPECT_EQ(messages[0].message.actionTime, Time(1.5));
+    EXPECT_EQ(messages[0].message.source_id, global_federate_id(131072));
+    EXPECT_EQ(messages[1].message.name, "fed1");
+    EXPECT_EQ(messages[1].message.getString(0), "extra string");
+    EXPECT_EQ(messages[2].message.action(), CMD_TIME_REQUEST);
+    EXPECT_LE(messages[0].timestamp, messages[2].timestamp);
+    std::remove(file.c_str());
+}
+
+TEST(messageCapture, invalid_file)
+{
+    const std::string file{"message_capture_invalid.hmc"};
+    {
+        std::ofstream out(file);
+        out << "not a capture file";
+    }
+    EXPECT_THROW(loadMessageCapture(file), std::invalid_argument);
+    std::remove(file.c_str());
+    EXPECT_THROW(loadMessageCapture("nonexistent_capture.hmc"), std::invalid_argument);
+}
@@ -0,0 +1,64 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#include "helics/common/JsonProcessingFunctions.hpp"
+#include "helics/core/RealTimePacer.hpp"
+
+#include "gtest/gtest.h"
+#include <chrono>
+#include <cstdint>
+
+using namespace helics;
+
+TEST(realTimePacer_ci_skip, absolute_deadlines)
+{
+    RealTimePacer pacer;
+    pacer.start();
+    // 1 ms steps should not accumulate any error
+    for (int ii = 1; ii <= 20; ++ii) {
+        Time step(static_cast<std::int64_t>(ii), time_units::ms);
+        EXPECT_TRUE(pacer.waitForTime(step));
+        auto elapsed = pacer.elapsed();
+        EXPECT_GE(elapsed, step.to_ns());
+        EXPECT_FALSE(pacer.recordGrant(step, timeZero));
+    }
+    auto elapsed = pacer.elapsed();
+    EXPECT_LT(elapsed, std::chrono::milliseconds(25));
+    EXPECT_EQ(pacer.grantCount(), 20U);
+    EXPECT_LT(pacer.maxJitter(), 500000);
+}
+
+TEST(realTimePacer, past_deadlines)
+{
+    RealTimePacer pacer;
+    pacer.start(RealTimePacer::clock_type::now() - std::chrono::milliseconds(100));
+    EXPECT_FALSE(pacer.waitForTime(Time(0.05)));
+    EXPECT_FALSE(pacer.waitForTime(Time::maxVal()));
+    // a grant 50ms behind the wall clock misses with a 10ms allowed lag
+    EXPECT_TRUE(pacer.recordGrant(Time(0.05), Time(0.01)));
+    EXPECT_FALSE(pacer.recordGrant(Time(0.05), Time(0.5)));
+    EXPECT_FALSE(pacer.recordGrant(Time(0.05), Time::maxVal()));
+    EXPECT_EQ(pacer.deadlineMisses(), 1U);
+    EXPECT_EQ(pacer.grantCount(), 3U);
+
+    Json::Value status;
+    pacer.generateStatus(status);
+    EXPECT_EQ(status["deadline_misses"].asUInt64(), 1U);
+    EXPECT_EQ(status["waits"].asUInt64(), 0U);
+    EXPECT_GE(status["max_lateness"].asDouble(), 0.05);
+    EXPECT_LT(status["drift"].asDouble(), 0.0);
+}
+
+TEST(realTimePacer, spin_window_bounds)
+{
+    RealTimePacer pacer;
+    pacer.start();
+    for (int ii = 1; ii <= 10; ++ii) {
+        pacer.waitForTime(Time(static_cast<std::int64_t>(ii) * 3, time_units::ms));
+    }
+    EXPECT_GE(pacer.spinWindow(), std::chrono::microseconds(50));
+    EXPECT_LE(pacer.spinWindow(), std::chrono::milliseconds(5));
+}
@@ -6,8 +6,11 @@ SPDX-License-Identifier: BSD-3-Clause
 */
 #include "helics/core/ActionMessage.hpp"
 #include "helics/core/TimeCoordinator.hpp"
+#include "helics/core/flagOperations.hpp"
+#include "helics/core/helics_definitions.hpp"
 
 #include "gtest/gtest.h"
+#include <vector>
 
 using namespace helics;
 
@@ -138,3 +141,190 @@ TEST(timeCoord_tests, dependent_test_message)
     EXPECT_EQ(deps.size(), 1U);
     EXPECT_TRUE(deps[0] == fed3);
 }
+
+TEST(timeCoord_tests, coupled_iterations)
+{
+    // the federate ids need to be in the federate range to be treated as federates
+    const global_federate_id fedA(0x0002'0000);
+    const global_federate_id fedB(0x0002'0001);
+    const global_federate_id fedC(0x0002'0002);
+    std::vector<ActionMessage> sent;
+    TimeCoordinator ftc([&sent](const ActionMessage& msg) { sent.push_back(msg); });
+    ftc.source_id = fedA;
+    ftc.setOptionFlag(defs::flags::coupled_iterations, true);
+    EXPECT_TRUE(ftc.getOptionFlag(defs::flags::coupled_iterations));
+    // fedB is coupled to fedA, fedC only depends on fedA
+    ftc.addDependency(fedB);
+    ftc.addDependent(fedB);
+    ftc.addDependent(fedC);
+
+    ftc.enteringExecMode(iteration_request::no_iterations);
+    // each dependent is probed for a path back to fedA
+    int probes = 0;
+    for (auto& msg : sent) {
+        if (msg.action() == CMD_TIME_COUPLING_PROBE) {
+            EXPECT_EQ(msg.source_handle.baseValue(), fedA.baseValue());
+            EXPECT_EQ(msg.dest_handle.baseValue(), msg.dest_id.baseValue());
+            ++probes;
+        }
+    }
+    EXPECT_EQ(probes, 2);
+    ActionMessage ack(CMD_TIME_COUPLING_ACK);
+    ack.source_id = fedB;
+    ack.dest_id = fedA;
+    ack.source_handle = interface_handle(fedA.baseValue());
+    ack.dest_handle = interface_handle(fedB.baseValue());
+    setActionFlag(ack, indicator_flag);
+    ftc.processCouplingMessage(ack);
+    ack.source_id = fedC;
+    ack.dest_handle = interface_handle(fedC.baseValue());
+    clearActionFlag(ack, indicator_flag);
+    ftc.processCouplingMessage(ack);
+
+    ActionMessage execReq(CMD_EXEC_REQUEST);
+    execReq.source_id = fedB;
+    ftc.processTimeMessage(execReq);
+    EXPECT_EQ(ftc.checkExecEntry(), message_processing_result::next_step);
+
+    sent.clear();
+    ftc.timeRequest(1.0, iteration_request::iterate_if_needed, timeZero, Time::maxVal());
+    ASSERT_EQ(sent.size(), 2U);
+    for (auto& msg : sent) {
+        EXPECT_EQ(msg.action(), CMD_TIME_REQUEST);
+        EXPECT_EQ(msg.actionTime, timeZero);
+        // fedC is held at the granted time without taking part in the iterations
+        EXPECT_EQ(checkActionFlag(msg, iteration_requested_flag), msg.dest_id == fedB);
+    }
+
+    sent.clear();
+    ActionMessage timeReq(CMD_TIME_REQUEST);
+    timeReq.source_id = fedB;
+    timeReq.actionTime = timeZero;
+    timeReq.Te = timeZero;
+    timeReq.Tdemin = timeZero;
+    setIterationFlags(timeReq, iteration_request::iterate_if_needed);
+    ftc.processTimeMessage(timeReq);
+    EXPECT_EQ(ftc.checkTimeGrant(), message_processing_result::iterating);
+    EXPECT_EQ(ftc.getCurrentIteration(), 1);
+    ASSERT_EQ(sent.size(), 1U);
+    EXPECT_EQ(sent[0].action(), CMD_TIME_GRANT);
+    EXPECT_TRUE(sent[0].dest_id == fedB);
+
+    // a converged request goes to all the dependents
+    sent.clear();
+    ftc.timeRequest(1.0, iteration_request::iterate_if_needed, Time::maxVal(), Time::maxVal());
+    ASSERT_EQ(sent.size(), 2U);
+    EXPECT_TRUE(sent[1].dest_id == fedC);
+    EXPECT_EQ(sent[1].Te, 1.0);
+
+    auto& stats = ftc.getIterationStatistics();
+    EXPECT_EQ(stats.messagesSent, 3);
+    EXPECT_EQ(stats.messagesSkipped, 1);
+}
+
+TEST(timeCoord_tests, coupling_probe_forwarding)
+{
+    const global_federate_id fedA(0x0002'0000);
+    const global_federate_id fedB(0x0002'0001);
+    const global_federate_id fedC(0x0002'0002);
+    std::vector<ActionMessage> sent;
+    TimeCoordinator ftc([&sent](const ActionMessage& msg) { sent.push_back(msg); });
+    ftc.source_id = fedB;
+    // a ring fedA->fedB->fedC->fedA where fedB is not a direct dependency of fedA
+    ftc.addDependency(fedA);
+    ftc.addDependent(fedC);
+
+    ActionMessage probe(CMD_TIME_COUPLING_PROBE);
+    probe.source_id = fedA;
+    probe.dest_id = fedB;
+    probe.source_handle = interface_handle(fedA.baseValue());
+    probe.dest_handle = interface_handle(fedB.baseValue());
+    ftc.processCouplingMessage(probe);
+    ASSERT_EQ(sent.size(), 1U);
+    EXPECT_EQ(sent[0].action(), CMD_TIME_COUPLING_PROBE);
+    EXPECT_TRUE(sent[0].dest_id == fedC);
+    EXPECT_TRUE(sent[0].source_id == fedB);
+    EXPECT_EQ(sent[0].source_handle.baseValue(), fedA.baseValue());
+
+    // a second copy of the same probe is acknowledged without being forwarded again
+    sent.clear();
+    probe.source_id = fedC;
+    ftc.processCouplingMessage(probe);
+    ASSERT_EQ(sent.size(), 1U);
+    EXPECT_EQ(sent[0].action(), CMD_TIME_COUPLING_ACK);
+    EXPECT_TRUE(sent[0].dest_id == fedC);
+    EXPECT_FALSE(checkActionFlag(sent[0], indicator_flag));
+
+    // fedC got back to fedA so fedB reports the path to fedA
+    sent.clear();
+    ActionMessage ack(CMD_TIME_COUPLING_ACK);
+    ack.source_id = fedC;
+    ack.dest_id = fedB;
+    ack.source_handle = probe.source_handle;
+    ack.dest_handle = probe.dest_handle;
+    setActionFlag(ack, indicator_flag);
+    ftc.processCouplingMessage(ack);
+    ASSERT_EQ(sent.size(), 1U);
+    EXPECT_EQ(sent[0].action(), CMD_TIME_COUPLING_ACK);
+    EXPECT_TRUE(sent[0].dest_id == fedA);
+    EXPECT_TRUE(checkActionFlag(sent[0], indicator_flag));
+
+    // a probe started by fedB is answered as soon as it gets back to fedB
+    sent.clear();
+    probe.source_id = fedA;
+    probe.source_handle = interface_handle(fedB.baseValue());
+    probe.dest_handle = interface_handle(fedC.baseValue());
+    ftc.processCouplingMessage(probe);
+    ASSERT_EQ(sent.size(), 1U);
+    EXPECT_EQ(sent[0].action(), CMD_TIME_COUPLING_ACK);
+    EXPECT_TRUE(sent[0].dest_id == fedA);
+    EXPECT_TRUE(checkActionFlag(sent[0], indicator_flag));
+}
+
+TEST(timeCoord_tests, iteration_statistics)
+{
+    const global_federate_id fedA(0x0002'0000);
+    const global_federate_id fedB(0x0002'0001);
+    std::vector<ActionMessage> sent;
+    TimeCoordinator ftc([&sent](const ActionMessage& msg) { sent.push_back(msg); });
+    ftc.source_id = fedA;
+    ftc.addDependency(fedB);
+    ftc.addDependent(fedB);
+
+    ftc.enteringExecMode(iteration_request::no_iterations);
+    ActionMessage execReq(CMD_EXEC_REQUEST);
+    execReq.source_id = fedB;
+    ftc.processTimeMessage(execReq);
+    EXPECT_EQ(ftc.checkExecEntry(), message_processing_result::next_step);
+
+    ActionMessage timeReq(CMD_TIME_REQUEST);
+    timeReq.source_id = fedB;
+    timeReq.actionTime = timeZero;
+    timeReq.Te = timeZero;
+    timeReq.Tdemin = timeZero;
+    setIterationFlags(timeReq, iteration_request::iterate_if_needed);
+    for (int ii = 1; ii <= 3; ++ii) {
+        ftc.timeRequest(1.0, iteration_request::iterate_if_needed, timeZero, Time::maxVal());
+        ftc.processTimeMessage(timeReq);
+        EXPECT_EQ(ftc.checkTimeGrant(), message_processing_result::iterating);
+        EXPECT_EQ(ftc.getCurrentIteration(), ii);
+    }
+    EXPECT_EQ(ftc.getIterationStatistics().steps, 0);
+
+    ftc.timeRequest(1.0, iteration_request::iterate_if_needed, Time::maxVal(), Time::maxVal());
+    ActionMessage grant(CMD_TIME_GRANT);
+    grant.source_id = fedB;
+    grant.actionTime = 1.0;
+    ftc.processTimeMessage(grant);
+    EXPECT_EQ(ftc.checkTimeGrant(), message_processing_result::next_step);
+    EXPECT_EQ(ftc.getGrantedTime(), 1.0);
+
+    const auto& stats = ftc.getIterationStatistics();
+    EXPECT_EQ(stats.steps, 1);
+    EXPECT_EQ(stats.iterations, 3);
+    EXPECT_EQ(stats.mostIterations, 3);
+    EXPECT_EQ(stats.lastIterations, 3);
+    // without coupled iterations every dependent gets the iteration messages
+    EXPECT_EQ(stats.messagesSkipped, 0);
+    EXPECT_GT(stats.messagesSent, 0);
+}
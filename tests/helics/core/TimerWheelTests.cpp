@@ -0,0 +1,125 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#include "helics/core/TimerWheel.hpp"
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+using namespace helics;
+using namespace std::literals::chrono_literals;
+
+TEST(timerWheel, expiration_order)
+{
+    auto epoch = std::chrono::steady_clock::now();
+    TimerWheel wheel(1ms, epoch);
+    EXPECT_TRUE(wheel.empty());
+    EXPECT_EQ(wheel.nextWakeTime(), TimerWheel::time_type::max());
+
+    wheel.schedule(0, epoch + 10ms);
+    wheel.schedule(1, epoch + 5ms);
+    wheel.schedule(2, epoch + 700ms);
+    EXPECT_EQ(wheel.size(), 3U);
+    EXPECT_EQ(wheel.nextWakeTime(), epoch + 5ms);
+
+    std::vector<int32_t> expired;
+    wheel.advance(epoch + 4ms, expired);
+    EXPECT_TRUE(expired.empty());
+    wheel.advance(epoch + 5ms, expired);
+    ASSERT_EQ(expired.size(), 1U);
+    EXPECT_EQ(expired[0], 1);
+    wheel.advance(epoch + 100ms, expired);
+    ASSERT_EQ(expired.size(), 2U);
+    EXPECT_EQ(expired[1], 0);
+    EXPECT_TRUE(wheel.isScheduled(2));
+    EXPECT_FALSE(wheel.isScheduled(0));
+    // the timer in the second level never expires early
+    EXPECT_LE(wheel.nextWakeTime(), epoch + 700ms);
+    wheel.advance(epoch + 699ms, expired);
+    EXPECT_EQ(expired.size(), 2U);
+    wheel.advance(epoch + 700ms, expired);
+    ASSERT_EQ(expired.size(), 3U);
+    EXPECT_EQ(expired[2], 2);
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(timerWheel, cancel_and_reschedule)
+{
+    auto epoch = std::chrono::steady_clock::now();
+    TimerWheel wheel(1ms, epoch);
+    wheel.schedule(3, epoch + 20ms);
+    wheel.schedule(4, epoch + 20ms);
+    wheel.schedule(5, epoch + 20ms);
+    wheel.cancel(4);
+    EXPECT_EQ(wheel.size(), 2U);
+    wheel.schedule(5, epoch + 2s);
+    EXPECT_EQ(wheel.size(), 2U);
+
+    std::vector<int32_t> expired;
+    wheel.advance(epoch + 30ms, expired);
+    ASSERT_EQ(expired.size(), 1U);
+    EXPECT_EQ(expired[0], 3);
+    // a timer in the past expires on the next advance
+    wheel.schedule(4, epoch);
+    wheel.advance(epoch + 30ms, expired);
+    ASSERT_EQ(expired.size(), 2U);
+    EXPECT_EQ(expired[1], 4);
+
+    wheel.clear();
+    EXPECT_TRUE(wheel.empty());
+    EXPECT_FALSE(wheel.isScheduled(5));
+    wheel.advance(epoch + 3s, expired);
+    EXPECT_EQ(expired.size(), 2U);
+}
+
+TEST(timerWheel, long_range)
+{
+    auto epoch = std::chrono::steady_clock::now();
+    TimerWheel wheel(1ms, epoch);
+    std::vector<std::chrono::milliseconds> delays{
+        1ms, 255ms, 256ms, 257ms, 65535ms, 65536ms, 70000ms, 16777216ms, 5000000000ms};
+    for (std::size_t ii = 0; ii < delays.size(); ++ii) {
+        wheel.schedule(static_cast<int32_t>(ii), epoch + delays[ii]);
+    }
+    std::vector<int32_t> expired;
+    for (std::size_t ii = 0; ii < delays.size(); ++ii) {
+        auto wake = wheel.nextWakeTime();
+        EXPECT_LE(wake, epoch + delays[ii]);
+        // step through the wake times the same way a driving timer would
+        while (expired.size() == ii) {
+            wheel.advance(wheel.nextWakeTime(), expired);
+        }
+        ASSERT_EQ(expired.size(), ii + 1);
+        EXPECT_EQ(expired.back(), static_cast<int32_t>(ii));
+        EXPECT_GE(wheel.nextWakeTime(), epoch + delays[ii]);
+    }
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(timerWheel, many_timers)
+{
+    auto epoch = std::chrono::steady_clock::now();
+    TimerWheel wheel(250us, epoch);
+    for (int32_t ii = 0; ii < 10000; ++ii) {
+        wheel.schedule(ii, epoch + std::chrono::microseconds((ii * 7919) % 5000000));
+    }
+    for (int32_t ii = 0; ii < 10000; ii += 2) {
+        wheel.cancel(ii);
+    }
+    EXPECT_EQ(wheel.size(), 5000U);
+    std::vector<int32_t> expired;
+    auto now = epoch;
+    while (!wheel.empty()) {
+        now += 10ms;
+        wheel.advance(now, expired);
+    }
+    ASSERT_EQ(expired.size(), 5000U);
+    EXPECT_TRUE(std::all_of(expired.begin(), expired.end(), [](int32_t index) {
+        return (index % 2) == 1;
+    }));
+}
@@ -0,0 +1,81 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#include "helics/core/UnknownHandleManager.hpp"
+
+#include "gtest/gtest.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace helics;
+
+static const global_handle handle1(global_federate_id(5), interface_handle(1));
+static const global_handle handle2(global_federate_id(5), interface_handle(2));
+static const global_handle handle3(global_federate_id(6), interface_handle(1));
+
+TEST(unknownHandles, has_unknown)
+{
+    UnknownHandleManager unknowns;
+    unknowns.addUnknownPublication("pub1", handle1, 0);
+    unknowns.addDataLink("pub2", "inp1");
+    unknowns.addSourceFilterLink("filt1", "ept1");
+
+    EXPECT_TRUE(unknowns.hasUnknown("pub1", 'p'));
+    EXPECT_TRUE(unknowns.hasUnknown("pub2", 'p'));
+    EXPECT_TRUE(unknowns.hasUnknown("filt1", 'f'));
+    EXPECT_FALSE(unknowns.hasUnknown("pub1", 'i'));
+    EXPECT_FALSE(unknowns.hasUnknown("inp1", 'i'));
+    EXPECT_FALSE(unknowns.hasUnknown("ept1", 'e'));
+
+    unknowns.clear();
+    EXPECT_FALSE(unknowns.hasUnknowns());
+    EXPECT_FALSE(unknowns.hasUnknown("pub1", 'p'));
+}
+
+TEST(unknownHandles, unknown_names)
+{
+    UnknownHandleManager unknowns;
+    unknowns.addUnknownPublication("pub1", handle1, 0);
+    unknowns.addUnknownPublication("pub1", handle3, 0);
+    unknowns.addDataLink("pub1", "inp1");
+    unknowns.addUnknownEndpoint("ept1", handle2, 0);
+
+    std::vector<std::pair<std::string, char>> names;
+    unknowns.processUnknownNames(
+        [&names](const std::string& name, char type) { names.emplace_back(name, type); });
+    ASSERT_EQ(names.size(), 2U);
+    EXPECT_EQ(names[0], std::make_pair(std::string("pub1"), 'p'));
+    EXPECT_EQ(names[1], std::make_pair(std::string("ept1"), 'e'));
+}
+
+TEST(unknownHandles, process_unknowns)
+{
+    UnknownHandleManager unknowns;
+    unknowns.addUnknownInput("inp1", handle1, 3);
+    unknowns.addDataLink("pub1", "inp2");
+    unknowns.addDestinationFilterLink("filt1", "ept1");
+
+    int count = 0;
+    unknowns.processUnknowns(
+        [&count](const std::string& name, char type, global_handle handle, uint16_t flags) {
+            EXPECT_EQ(name, "inp1");
+            EXPECT_EQ(type, 'i');
+            EXPECT_EQ(handle, handle1);
+            EXPECT_EQ(flags, 3);
+            ++count;
+        });
+    EXPECT_EQ(count, 1);
+
+    std::vector<std::string> links;
+    unknowns.processUnknownLinks(
+        [&links](const std::string& origin, char type, const std::string& target) {
+            links.push_back(origin + type + target);
+        });
+    ASSERT_EQ(links.size(), 2U);
+    EXPECT_EQ(links[0], "pub1linp2");
+    EXPECT_EQ(links[1], "filt1dept1");
+}
@@ -185,6 +185,46 @@ TEST(InprocCore_tests, send_receive_test)
     helics::CoreFactory::cleanUpCores();
 }
 
+TEST(InprocCore_tests, direct_dispatch_test)
+{
+    auto broker = helics::BrokerFactory::create(helics::core_type::INPROC,
+                                                "--name=direct_brk --direct_dispatch");
+    ASSERT_TRUE(broker);
+    EXPECT_TRUE(broker->isConnected());
+    auto core = create(helics::core_type::INPROC, "--broker=direct_brk --direct_dispatch");
+
+    ASSERT_TRUE(core != nullptr);
+    core->connect();
+    ASSERT_TRUE(core->isConnected());
+    auto id = core->registerFederate("sim1", helics::CoreFederateInfo());
+    core->setTimeProperty(id, helics_property_time_delta, 1.0);
+
+    auto end1 = core->registerEndpoint(id, "end1", "type");
+    auto end2 = core->registerEndpoint(id, "end2", "type");
+
+    core->enterInitializingMode(id);
+    core->enterExecutingMode(id);
+
+    std::string str1 = "hello world";
+    core->timeRequest(id, 50.0);
+    core->send(end1, "end2", str1.data(), str1.size());
+
+    core->timeRequest(id, 100.0);
+    EXPECT_EQ(core->receiveCount(end2), 1u);
+    auto msg = core->receive(end2);
+    ASSERT_TRUE(msg);
+    EXPECT_EQ(msg->data.to_string(), str1);
+    core->finalize(id);
+    core->disconnect();
+    broker->disconnect();
+    EXPECT_FALSE(core->isConnected());
+    EXPECT_FALSE(broker->isConnected());
+    core = nullptr;
+    broker = nullptr;
+    helics::CoreFactory::cleanUpCores();
+    helics::BrokerFactory::cleanUpBrokers();
+}
+
 TEST(InprocCore_tests, messagefilter_callback_test)
 {
     // Create filter operator
@@ -1,10 +1,142 @@
 /*
-Copyright (c) 2017-2018,
+Copyright (c) 2017-2020,
 Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
-Energy, LLC All rights reserved. See LICENSE file and DISCLAIMER for more details.
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
 */
+#include "helics/core/ActionMessage.hpp"
 #include "helics/helics-config.h"
+#include "helics/network/mpi/MpiComms.h"
+#include "helics/network/mpi/MpiService.h"
 
 #include "gtest/gtest.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::literals::chrono_literals;
 
 TEST(MpiCore_tests, init_test) {}
+
+/** each rank sends to the next rank so this runs on any number of ranks, with a single rank the
+messages are delivered locally*/
+TEST(MpiCore_tests, transmit_in_order)
+{
+    std::mutex receivedLock;
+    std::vector<int32_t> ids;
+    std::vector<std::size_t> sizes;
+
+    helics::mpi::MpiComms comm;
+    auto& service = helics::mpi::MpiService::getInstance();
+    const int rank = service.getRank();
+    const int size = service.getSize();
+    ASSERT_GT(size, 0);
+    // the comms are created in the same order on every rank so they have the same tag
+    auto address = comm.getAddress();
+    auto tag = address.substr(address.find_last_of(':') + 1);
+
+    comm.setName("mpi_order_test");
+    comm.setCallback([&](helics::ActionMessage&& m) {
+        std::lock_guard<std::mutex> lock(receivedLock);
+        ids.push_back(m.messageID);
+        sizes.push_back(m.payload.size());
+    });
+    ASSERT_TRUE(comm.connect());
+    comm.addRoute(helics::route_id{1}, std::to_string((rank + 1) % size) + ":" + tag);
+
+    const int count{40};
+    for (int ii = 0; ii < count; ++ii) {
+        helics::ActionMessage cmd(helics::CMD_SEND_MESSAGE);
+        cmd.messageID = ii;
+        // alternate between messages on the eager path and ones large enough for the rendezvous
+        // path which could be overtaken if the ordering were not preserved
+        auto payloadSize = (ii % 2 == 0) ? 50 : 10 * helics::mpi::MpiService::eagerMessageSize;
+        cmd.payload.assign(payloadSize, static_cast<char>('a' + ii % 26));
+        comm.transmit(helics::route_id{1}, cmd);
+    }
+
+    for (int ii = 0; ii < 100; ++ii) {
+        std::unique_lock<std::mutex> lock(receivedLock);
+        if (ids.size() >= static_cast<std::size_t>(count)) {
+            break;
+        }
+        lock.unlock();
+        std::this_thread::sleep_for(100ms);
+    }
+    std::unique_lock<std::mutex> lock(receivedLock);
+    ASSERT_EQ(ids.size(), static_cast<std::size_t>(count));
+    for (int ii = 0; ii < count; ++ii) {
+        EXPECT_EQ(ids[ii], ii);
+    }
+    EXPECT_EQ(sizes[0], 50U);
+    EXPECT_EQ(sizes[1], static_cast<std::size_t>(10 * helics::mpi::MpiService::eagerMessageSize));
+    lock.unlock();
+
+    comm.disconnect();
+    EXPECT_FALSE(comm.isConnected());
+}
+
+/** rank 0 sends a ping to rank 1 after the service loop has been idle and waits for the reply,
+with a single rank it replies to itself*/
+TEST(MpiCore_tests, idle_round_trip_latency)
+{
+    std::mutex receivedLock;
+    std::condition_variable receivedCondition;
+    int pings{0};
+    int pongs{0};
+
+    helics::mpi::MpiComms comm;
+    auto& service = helics::mpi::MpiService::getInstance();
+    const int rank = service.getRank();
+    const int size = service.getSize();
+    auto address = comm.getAddress();
+    auto tag = address.substr(address.find_last_of(':') + 1);
+
+    comm.setName("mpi_latency_test");
+    comm.setCallback([&](helics::ActionMessage&& m) {
+        if (m.counter == 0) {
+            // a ping so send it back
+            m.counter = 1;
+            comm.transmit(helics::route_id{2}, m);
+            std::lock_guard<std::mutex> lock(receivedLock);
+            ++pings;
+        } else {
+            std::lock_guard<std::mutex> lock(receivedLock);
+            ++pongs;
+        }
+        receivedCondition.notify_all();
+    });
+    ASSERT_TRUE(comm.connect());
+    comm.addRoute(helics::route_id{1}, std::to_string(1 % size) + ":" + tag);
+    comm.addRoute(helics::route_id{2}, "0:" + tag);
+
+    const int count{20};
+    if (rank == 0) {
+        std::vector<double> roundTrips;
+        for (int ii = 0; ii < count; ++ii) {
+            // wait long enough for the service loops to stop spinning
+            std::this_thread::sleep_for(helics::mpi::MpiService::idleSpinTime * 2);
+            helics::ActionMessage ping(helics::CMD_SEND_MESSAGE);
+            ping.messageID = ii;
+            auto start = std::chrono::steady_clock::now();
+            comm.transmit(helics::route_id{1}, ping);
+            std::unique_lock<std::mutex> lock(receivedLock);
+            ASSERT_TRUE(receivedCondition.wait_for(lock, 5s, [&]() { return pongs > ii; }));
+            roundTrips.push_back(
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+        std::sort(roundTrips.begin(), roundTrips.end());
+        // an idle service loop must not add more than a few microseconds to each hop
+        EXPECT_LT(roundTrips[count / 2], 0.001);
+    }
+    if (rank == 1 % size) {
+        std::unique_lock<std::mutex> lock(receivedLock);
+        EXPECT_TRUE(receivedCondition.wait_for(lock, 10s, [&]() { return pings >= count; }));
+    }
+
+    comm.disconnect();
+}
@@ -0,0 +1,195 @@
+/*
+Copyright (c) 2017-2020,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable
+Energy, LLC.  See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#include "helics/core/ActionMessage.hpp"
+#include "helics/core/flagOperations.hpp"
+#include "helics/network/PayloadCompression.hpp"
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static std::string randomBytes(std::size_t size)
+{
+    std::mt19937 gen(static_cast<unsigned int>(size));
+    std::uniform_int_distribution<int> dist(0, 255);
+    std::string data(size, '\0');
+    for (auto& byte : data) {
+        byte = static_cast<char>(dist(gen));
+    }
+    return data;
+}
+
+static std::string doubleBytes(std::size_t count)
+{
+    std::vector<double> vals(count);
+    for (std::size_t ii = 0; ii < count; ++ii) {
+        vals[ii] = std::round(std::sin(static_cast<double>(ii) * 0.01) * 1000.0) / 8.0;
+    }
+    return std::string(reinterpret_cast<const char*>(vals.data()), count * sizeof(double));
+}
+
+static std::string textBytes(std::size_t size)
+{
+    std::string data;
+    while (data.size() < size) {
+        data.append("the time grant was delayed by the dependency on federate ");
+        data.append(std::to_string(data.size() % 97));
+    }
+    data.resize(size);
+    return data;
+}
+
+class compression_tests: public ::testing::TestWithParam<const char*> {
+};
+
+TEST_P(compression_tests, round_trip)
+{
+    auto codec = helics::getPayloadCodec(helics::getPayloadCodecId(GetParam()));
+    ASSERT_TRUE(codec);
+    for (std::size_t size : {0, 1, 7, 8, 13, 100, 4096, 70000, 300000}) {
+        for (const auto& data : {randomBytes(size), doubleBytes(size / 8), textBytes(size)}) {
+            std::string compressed;
+            ASSERT_TRUE(codec->compress(data.data(), data.size(), compressed));
+            std::string output(data.size(), '\0');
+            EXPECT_TRUE(
+                codec->decompress(compressed.data(), compressed.size(), &output[0], data.size()))
+                << "size " << data.size();
+            EXPECT_EQ(output, data);
+        }
+    }
+}
+
+TEST_P(compression_tests, invalid_data)
+{
+    auto codec = helics::getPayloadCodec(helics::getPayloadCodecId(GetParam()));
+    ASSERT_TRUE(codec);
+    auto data = textBytes(5000);
+    std::string compressed;
+    codec->compress(data.data(), data.size(), compressed);
+    EXPECT_LT(compressed.size(), data.size());
+    std::string output(data.size(), '\0');
+    // the output size must match exactly
+    EXPECT_FALSE(
+        codec->decompress(compressed.data(), compressed.size(), &output[0], data.size() - 1));
+    // truncated data
+    EXPECT_FALSE(
+        codec->decompress(compressed.data(), compressed.size() / 2, &output[0], data.size()));
+    EXPECT_FALSE(codec->decompress(compressed.data(), 0, &output[0], data.size()));
+    // corrupted data must never write outside the output
+    std::mt19937 gen(4);
+    for (int ii = 0; ii < 200; ++ii) {
+        auto corrupt = compressed;
+        corrupt[gen() % corrupt.size()] ^= static_cast<char>(1U << (gen() % 8U));
+        codec->decompress(corrupt.data(), corrupt.size(), &output[0], data.size());
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(compression, compression_tests, ::testing::Values("lz", "lzshuffle"));
+
+TEST(compression, action_message)
+{
+    helics::ActionMessage cmd(helics::CMD_PUB);
+    cmd.payload = doubleBytes(4096);
+    auto original = cmd.payload;
+    EXPECT_TRUE(helics::compressPayload(cmd, helics::lzShuffleCodecId));
+    EXPECT_TRUE(checkActionFlag(cmd, compressed_payload_flag));
+    EXPECT_LT(cmd.payload.size(), original.size());
+    // the compressed payload survives serialization
+    helics::ActionMessage received(cmd.to_string());
+    EXPECT_TRUE(checkActionFlag(received, compressed_payload_flag));
+    EXPECT_TRUE(helics::decompressPayload(received));
+    EXPECT_FALSE(checkActionFlag(received, compressed_payload_flag));
+    EXPECT_EQ(received.payload, original);
+}
+
+TEST(compression, incompressible)
+{
+    helics::ActionMessage cmd(helics::CMD_SEND_MESSAGE);
+    cmd.payload = randomBytes(2000);
+    auto original = cmd.payload;
+    // the payload is left alone if it does not get smaller
+    EXPECT_FALSE(helics::compressPayload(cmd, helics::lzCodecId));
+    EXPECT_FALSE(checkActionFlag(cmd, compressed_payload_flag));
+    EXPECT_EQ(cmd.payload, original);
+    EXPECT_FALSE(helics::compressPayload(cmd, 200));
+
+    EXPECT_TRUE(helics::isCompressibleCommand(cmd));
+    EXPECT_FALSE(helics::isCompressibleCommand(helics::ActionMessage(helics::CMD_TIME_REQUEST)));
+}
+
+TEST(compression, invalid_payload)
+{
+    helics::ActionMessage cmd(helics::CMD_PUB);
+    cmd.payload = std::string("\x01\x00\x00", 3);
+    EXPECT_FALSE(helics::decompressPayload(cmd));
+    // unknown codec
+    cmd.payload = std::string("\xF0\x00\x00\x00\x01\x10\x61", 7);
+    EXPECT_FALSE(helics::decompressPayload(cmd));
+    // original size too large for the compressed data
+    cmd.payload = std::string("\x01\x7F\xFF\xFF\xFF\xF0\x61", 7);
+    EXPECT_FALSE(helics::decompressPayload(cmd));
+    EXPECT_EQ(cmd.payload.size(), 7U);
+}
+
+/** a run length codec to test user defined codecs*/
+class RunLengthCodec: public helics::PayloadCodec {
+  public:
+    virtual bool compress(const char* data, std::size_t size, std::string& output) const override
+    {
+        std::size_t ii = 0;
+        while (ii < size) {
+            std::size_t run = 1;
+            while (ii + run < size && run < 255 && data[ii + run] == data[ii]) {
+                ++run;
+            }
+            output.push_back(static_cast<char>(run));
+            output.push_back(data[ii]);
+            ii += run;
+        }
+        return true;
+    }
+    virtual bool decompress(const char* data,
+                            std::size_t size,
+                            char* output,
+                            std::size_t outputSize) const override
+    {
+        std::size_t op = 0;
+        for (std::size_t ii = 0; ii + 1 < size; ii += 2) {
+            auto run = static_cast<unsigned char>(data[ii]);
+            if (run > outputSize - op) {
+                return false;
+            }
+            std::fill(output + op, output + op + run, data[ii + 1]);
+            op += run;
+        }
+        return (size % 2 == 0) && (op == outputSize);
+    }
+};
+
+TEST(compression, user_codec)
+{
+    EXPECT_EQ(helics::getPayloadCodecId("rle"), 0);
+    auto codec = std::make_shared<RunLengthCodec>();
+    helics::registerPayloadCodec("rle", helics::firstUserCodecId, codec);
+    EXPECT_EQ(helics::getPayloadCodecId("rle"), helics::firstUserCodecId);
+    EXPECT_THROW(helics::registerPayloadCodec("rle", 40, codec), std::invalid_argument);
+    EXPECT_THROW(helics::registerPayloadCodec("rle2", helics::lzCodecId, codec),
+                 std::invalid_argument);
+    EXPECT_THROW(helics::registerPayloadCodec("rle3", 0, codec), std::invalid_argument);
+
+    helics::ActionMessage cmd(helics::CMD_PUB);
+    cmd.payload = std::string(300, 'a') + std::string(40, 'b') + "cdef";
+    auto original = cmd.payload;
+    EXPECT_TRUE(helics::compressPayload(cmd, helics::firstUserCodecId));
+    EXPECT_TRUE(helics::decompressPayload(cmd));
+    EXPECT_EQ(cmd.payload, original);
+}
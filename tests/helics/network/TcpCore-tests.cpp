@@ -11,6 +11,7 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "helics/core/Core.hpp"
 #include "helics/core/CoreFactory.hpp"
 #include "helics/core/core-types.hpp"
+#include "helics/core/flagOperations.hpp"
 #include "helics/network/networkDefaults.hpp"
 #include "helics/network/tcp/TcpBroker.h"
 #include "helics/network/tcp/TcpComms.h"
@@ -20,6 +21,7 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "gtest/gtest.h"
 #include <future>
 #include <numeric>
+#include <vector>
 
 using namespace std::literals::chrono_literals;
 
@@ -269,6 +271,87 @@ TEST(TcpCore, tcpServerConnections1)
     server->close();
 }
 
+TEST(TcpCore, tcpServerPooledConnections)
+{
+    std::atomic<int> counter{0};
+    std::string host = "127.0.0.1";
+
+    auto srv = AsioContextManager::getContextPointer();
+    auto io1 = AsioContextManager::getContextPointer("tcp_pool_test1");
+    auto io2 = AsioContextManager::getContextPointer("tcp_pool_test2");
+    auto server = helics::tcp::TcpServer::create(srv->getBaseContext(), host, 24167, false, 1024);
+    ASSERT_TRUE(server->isReady());
+    server->setConnectionContexts({&io1->getBaseContext(), &io2->getBaseContext()});
+    auto contextLoop = srv->startContextLoop();
+    auto ioLoop1 = io1->startContextLoop();
+    auto ioLoop2 = io2->startContextLoop();
+    std::atomic<bool> validData{true};
+
+    // 30 byte blocks do not evenly divide the buffer so messages are split between reads
+    auto dataCheck = [&counter, &validData](const helics::tcp::TcpConnection::pointer& /*unused*/,
+                                            const char* datablock,
+                                            size_t datasize) {
+        size_t used = 0;
+        while (datasize - used >= 30) {
+            ++counter;
+            for (int ii = 1; ii < 30; ++ii) {
+                if (ii + datablock[used + 0] != datablock[used + ii]) {
+                    validData = false;
+                }
+            }
+            used += 30;
+        }
+
+        return used;
+    };
+
+    server->setDataCall(dataCheck);
+    server->start();
+
+    std::vector<helics::tcp::TcpConnection::pointer> connections;
+    for (int ii = 0; ii < 6; ++ii) {
+        connections.push_back(
+            helics::tcp::TcpConnection::create(srv->getBaseContext(), host, "24167", 1024));
+        ASSERT_TRUE(connections.back());
+        EXPECT_TRUE(connections.back()->waitUntilConnected(1000ms));
+    }
+
+    auto transmitFunc = [](const helics::tcp::TcpConnection::pointer& obj) {
+        std::vector<char> dataB(30 * 50);
+        for (char ii = 0; ii < 50; ++ii) {
+            std::iota(dataB.begin() + ii * 30, dataB.begin() + (ii + 1) * 30, ii);
+        }
+        // send in uneven pieces
+        obj->send(dataB.data(), 1000);
+        obj->send(dataB.data() + 1000, 500);
+    };
+    std::vector<std::thread> threads;
+    for (auto& conn : connections) {
+        threads.emplace_back(transmitFunc, conn);
+    }
+    for (auto& thr : threads) {
+        thr.join();
+    }
+    int cnt = 0;
+    while (counter < 300) {
+        std::this_thread::sleep_for(50ms);
+        ++cnt;
+        if (cnt > 20) {
+            break;
+        }
+    }
+    EXPECT_EQ(counter, 300);
+    EXPECT_TRUE(validData);
+    for (auto& conn : connections) {
+        conn->close();
+    }
+    server->close();
+    ioLoop1.reset();
+    ioLoop2.reset();
+    AsioContextManager::closeContext("tcp_pool_test1");
+    AsioContextManager::closeContext("tcp_pool_test2");
+}
+
 TEST(TcpCore, tcpComm_transmit_through)
 {
     std::this_thread::sleep_for(300ms);
@@ -419,6 +502,113 @@ TEST(TcpCore, tcpComm_transmit_add_route)
     std::this_thread::sleep_for(100ms);
 }
 
+TEST(TcpCore, tcpComm_transmit_compressed)
+{
+    std::this_thread::sleep_for(300ms);
+    std::atomic<int> counter{0};
+    std::atomic<int> counter2{0};
+    std::atomic<int> counter3{0};
+    guarded<helics::ActionMessage> act;
+    guarded<helics::ActionMessage> act2;
+    guarded<helics::ActionMessage> act3;
+
+    std::string host = "localhost";
+    helics::tcp::TcpComms comm;
+    comm.loadTargetInfo(host, host);
+    comm.setFlag("reuse_address", true);
+    helics::tcp::TcpComms comm2;
+    comm2.loadTargetInfo(host, std::string());
+    // comm3 never registers so it never advertises that it can decode compressed payloads
+    helics::tcp::TcpComms comm3;
+    comm3.loadTargetInfo(host, host);
+    comm3.setFlag("reuse_address", true);
+    comm3.setBrokerPort(DEFAULT_TCP_BROKER_PORT_NUMBER + 3);
+    comm3.setName("test3");
+    comm3.setPortNumber(23921);
+
+    comm.setBrokerPort(DEFAULT_TCP_BROKER_PORT_NUMBER + 3);
+    comm.setName("tests");
+    comm2.setName("test2");
+    comm2.setPortNumber(DEFAULT_TCP_BROKER_PORT_NUMBER + 3);
+    comm2.setFlag("reuse_address", true);
+    comm.setPortNumber(TCP_SECONDARY_PORT);
+    EXPECT_TRUE(comm.setCompression("lzshuffle", 256));
+    EXPECT_TRUE(comm2.setCompression("lz", 256));
+    EXPECT_FALSE(comm2.setCompression("unknown_codec", 256));
+
+    comm.setCallback([&counter, &act](helics::ActionMessage&& m) {
+        ++counter;
+        act = std::move(m);
+    });
+    comm2.setCallback([&counter2, &act2](helics::ActionMessage&& m) {
+        ++counter2;
+        act2 = std::move(m);
+    });
+    comm3.setCallback([&counter3, &act3](helics::ActionMessage&& m) {
+        ++counter3;
+        act3 = std::move(m);
+    });
+
+    ASSERT_TRUE(comm2.connect());
+    ASSERT_TRUE(comm.connect());
+    ASSERT_TRUE(comm3.connect());
+
+    std::vector<double> vals(4000);
+    std::iota(vals.begin(), vals.end(), 0.0);
+    std::string data(reinterpret_cast<const char*>(vals.data()), vals.size() * sizeof(double));
+
+    // the registration advertises that compressed payloads are accepted
+    helics::ActionMessage reg(helics::CMD_REG_BROKER);
+    reg.name = "tests";
+    reg.setString(helics::targetStringLoc, comm.getAddress());
+    comm.transmit(helics::parent_route_id, reg);
+    std::this_thread::sleep_for(250ms);
+    ASSERT_EQ(counter2, 1);
+    EXPECT_TRUE(act2.lock()->action() == helics::CMD_REG_BROKER);
+    EXPECT_FALSE(checkActionFlag(*act2.lock(), compression_capable_flag));
+    comm2.addRoute(helics::route_id(3), comm.getAddress());
+
+    comm2.transmit(helics::route_id(3), helics::ActionMessage(helics::CMD_BROKER_ACK));
+    std::this_thread::sleep_for(250ms);
+    ASSERT_EQ(counter, 1);
+    EXPECT_TRUE(act.lock()->action() == helics::CMD_BROKER_ACK);
+    EXPECT_TRUE(comm.isCompressedRoute(helics::parent_route_id));
+    EXPECT_TRUE(comm2.isCompressedRoute(helics::route_id(3)));
+
+    helics::ActionMessage pub(helics::CMD_PUB);
+    pub.payload = data;
+    comm.transmit(helics::parent_route_id, pub);
+    comm2.transmit(helics::route_id(3), pub);
+    std::this_thread::sleep_for(250ms);
+    if (counter2 != 2 || counter != 2) {
+        std::this_thread::sleep_for(500ms);
+    }
+    ASSERT_EQ(counter2, 2);
+    EXPECT_EQ(act2.lock()->payload, data);
+    EXPECT_FALSE(checkActionFlag(*act2.lock(), compressed_payload_flag));
+    ASSERT_EQ(counter, 2);
+    EXPECT_EQ(act.lock()->payload, data);
+    // both directions of the negotiated route were compressed
+    EXPECT_EQ(comm.getCompressedCount(), 1U);
+    EXPECT_EQ(comm2.getCompressedCount(), 1U);
+
+    comm2.addRoute(helics::route_id(4), comm3.getAddress());
+    EXPECT_FALSE(comm2.isCompressedRoute(helics::route_id(4)));
+    comm2.transmit(helics::route_id(4), pub);
+    std::this_thread::sleep_for(250ms);
+    if (counter3 != 1) {
+        std::this_thread::sleep_for(500ms);
+    }
+    ASSERT_EQ(counter3, 1);
+    EXPECT_EQ(act3.lock()->payload, data);
+    EXPECT_EQ(comm2.getCompressedCount(), 1U);
+
+    comm.disconnect();
+    comm3.disconnect();
+    comm2.disconnect();
+    std::this_thread::sleep_for(100ms);
+}
+
 TEST(TcpCore, tcpCore_initialization)
 {
     std::this_thread::sleep_for(300ms);
@@ -509,6 +699,31 @@ TEST(TcpCore, tcpCore_core_broker_default)
     helics::BrokerFactory::cleanUpBrokers(100ms);
 }
 
+TEST(TcpCore, tcpCore_core_broker_io_threads)
+{
+    std::this_thread::sleep_for(300ms);
+
+    auto broker = helics::BrokerFactory::create(helics::core_type::TCP,
+                                                "--reuse_address --io_threads=2");
+    ASSERT_TRUE(broker);
+    auto core1 = helics::CoreFactory::create(helics::core_type::TCP, "--reuse_address");
+    auto core2 = helics::CoreFactory::create(helics::core_type::TCP, "--reuse_address");
+    ASSERT_TRUE(core1);
+    ASSERT_TRUE(core2);
+    EXPECT_TRUE(broker->isConnected());
+    EXPECT_TRUE(core1->connect());
+    EXPECT_TRUE(core2->connect());
+
+    core1->disconnect();
+    core2->disconnect();
+    broker->disconnect();
+    core1 = nullptr;
+    core2 = nullptr;
+    broker = nullptr;
+    helics::CoreFactory::cleanUpCores(100ms);
+    helics::BrokerFactory::cleanUpBrokers(100ms);
+}
+
 TEST(TcpCore, commFactory)
 {
     auto comm = helics::CommFactory::create("tcp");
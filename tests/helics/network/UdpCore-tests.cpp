@@ -14,10 +14,12 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "helics/network/udp/UdpBroker.h"
 #include "helics/network/udp/UdpComms.h"
 #include "helics/network/udp/UdpCore.h"
+#include "helics/network/udp/UdpReliability.h"
 
 #include "gtest/gtest.h"
 #include <asio/ip/udp.hpp>
 #include <future>
+#include <memory>
 
 using namespace std::literals::chrono_literals;
 
@@ -363,3 +365,306 @@ TEST(UdpCore, commFactory)
     EXPECT_TRUE(dynamic_cast<helics::udp::UdpComms*>(comm.get()) != nullptr);
     EXPECT_TRUE(dynamic_cast<helics::udp::UdpComms*>(comm2.get()) != nullptr);
 }
+
+TEST(UdpCore, reliable_fragment_reorder)
+{
+    helics::udp::ReliableSender sender(200);
+    helics::udp::ReliableReceiver receiver;
+    std::string large(1000, 'a');
+    for (std::size_t ii = 0; ii < large.size(); ++ii) {
+        large[ii] = static_cast<char>('a' + ii % 26);
+    }
+    sender.addMessage("first");
+    sender.addMessage(large);
+    std::vector<const std::string*> packets;
+    auto now = helics::udp::ReliableSender::clock_type::now();
+    sender.collectPackets(now, packets);
+    ASSERT_EQ(packets.size(), 7U);
+
+    std::vector<std::string> messages;
+    // deliver everything but the first packet in reverse order
+    for (auto packet = packets.rbegin(); packet != packets.rend() - 1; ++packet) {
+        EXPECT_TRUE(receiver.processPacket((*packet)->data(), (*packet)->size(), messages));
+    }
+    EXPECT_TRUE(messages.empty());
+    auto ack = receiver.generateAck();
+    EXPECT_FALSE(receiver.ackPending());
+    EXPECT_TRUE(sender.processAck(ack.data(), ack.size(), now + std::chrono::milliseconds(50)));
+    EXPECT_EQ(sender.outstanding(), 7U);
+
+    // the missing packet was reported so it is sent again without waiting for the timeout
+    packets.clear();
+    sender.collectPackets(now + std::chrono::milliseconds(50), packets);
+    ASSERT_EQ(packets.size(), 1U);
+    EXPECT_EQ(sender.retransmissions(), 1U);
+    EXPECT_TRUE(receiver.processPacket(packets[0]->data(), packets[0]->size(), messages));
+    ASSERT_EQ(messages.size(), 2U);
+    EXPECT_EQ(messages[0], "first");
+    EXPECT_EQ(messages[1], large);
+
+    // duplicates are dropped but still acknowledged
+    EXPECT_TRUE(receiver.processPacket(packets[0]->data(), packets[0]->size(), messages));
+    EXPECT_EQ(messages.size(), 2U);
+    EXPECT_TRUE(receiver.ackPending());
+    ack = receiver.generateAck();
+    EXPECT_TRUE(sender.processAck(ack.data(), ack.size(), now + std::chrono::milliseconds(50)));
+    EXPECT_TRUE(sender.empty());
+}
+
+TEST(UdpCore, reliable_retransmit_timeout)
+{
+    helics::udp::ReliableSender sender(helics::udp::defaultReliableDatagramSize,
+                                       4,
+                                       std::chrono::milliseconds(10),
+                                       2);
+    for (int ii = 0; ii < 6; ++ii) {
+        sender.addMessage(std::to_string(ii));
+    }
+    EXPECT_TRUE(sender.windowFull());
+    std::vector<const std::string*> packets;
+    auto now = helics::udp::ReliableSender::clock_type::now();
+    sender.collectPackets(now, packets);
+    // only the window is sent
+    EXPECT_EQ(packets.size(), 4U);
+    EXPECT_EQ(sender.nextTimeout(), now + std::chrono::milliseconds(10));
+    packets.clear();
+    sender.collectPackets(now + std::chrono::milliseconds(5), packets);
+    EXPECT_TRUE(packets.empty());
+
+    sender.collectPackets(now + std::chrono::milliseconds(10), packets);
+    EXPECT_EQ(packets.size(), 4U);
+    // the timeout doubles on each retransmission
+    EXPECT_EQ(sender.nextTimeout(), now + std::chrono::milliseconds(30));
+    packets.clear();
+    sender.collectPackets(now + std::chrono::milliseconds(30), packets);
+    EXPECT_EQ(packets.size(), 4U);
+    EXPECT_FALSE(sender.failed());
+    packets.clear();
+    sender.collectPackets(now + std::chrono::milliseconds(70), packets);
+    EXPECT_TRUE(packets.empty());
+    EXPECT_TRUE(sender.failed());
+    sender.clear();
+    EXPECT_TRUE(sender.empty());
+    EXPECT_FALSE(sender.failed());
+}
+
+TEST(UdpCore, reliable_packet_loss)
+{
+    helics::udp::ReliableSender sender(200, 8, std::chrono::milliseconds(10), 20);
+    helics::udp::ReliableReceiver receiver;
+    std::vector<std::string> sent;
+    for (int ii = 0; ii < 40; ++ii) {
+        sent.push_back(std::string(static_cast<std::size_t>(ii) * 37, 'x') + std::to_string(ii));
+        sender.addMessage(sent.back());
+    }
+    std::vector<std::string> messages;
+    std::vector<const std::string*> packets;
+    auto now = helics::udp::ReliableSender::clock_type::now();
+    int dropCount{0};
+    for (int cycle = 0; cycle < 500 && !sender.empty(); ++cycle) {
+        packets.clear();
+        sender.collectPackets(now, packets);
+        for (const auto* packet : packets) {
+            // lose every third datagram
+            if (++dropCount % 3 == 0) {
+                continue;
+            }
+            EXPECT_TRUE(receiver.processPacket(packet->data(), packet->size(), messages));
+        }
+        if (receiver.ackPending()) {
+            auto ack = receiver.generateAck();
+            // and every fifth acknowledgement
+            if (cycle % 5 != 4) {
+                EXPECT_TRUE(sender.processAck(ack.data(), ack.size(), now));
+            }
+        }
+        now += std::chrono::milliseconds(10);
+    }
+    EXPECT_TRUE(sender.empty());
+    EXPECT_FALSE(sender.failed());
+    EXPECT_GT(sender.retransmissions(), 0U);
+    EXPECT_EQ(messages, sent);
+}
+
+TEST(UdpCore, reliable_sender_restart)
+{
+    auto oldSender = std::make_unique<helics::udp::ReliableSender>();
+    helics::udp::ReliableReceiver receiver;
+    std::vector<std::string> messages;
+    std::vector<const std::string*> packets;
+    auto now = helics::udp::ReliableSender::clock_type::now();
+    for (int ii = 0; ii < 3; ++ii) {
+        oldSender->addMessage("old" + std::to_string(ii));
+    }
+    oldSender->collectPackets(now, packets);
+    ASSERT_EQ(packets.size(), 3U);
+    for (const auto* packet : packets) {
+        EXPECT_TRUE(receiver.processPacket(packet->data(), packet->size(), messages));
+    }
+    EXPECT_EQ(messages.size(), 3U);
+    auto oldPacket = *packets.back();
+
+    // a restarted peer on the same address starts over at sequence 0 in a new session
+    helics::udp::ReliableSender newSender;
+    EXPECT_NE(newSender.session(), oldSender->session());
+    oldSender.reset();
+    newSender.addMessage("new");
+    packets.clear();
+    newSender.collectPackets(now, packets);
+    ASSERT_EQ(packets.size(), 1U);
+    EXPECT_TRUE(receiver.processPacket(packets[0]->data(), packets[0]->size(), messages));
+    ASSERT_EQ(messages.size(), 4U);
+    EXPECT_EQ(messages.back(), "new");
+    EXPECT_EQ(receiver.session(), newSender.session());
+    auto ack = receiver.generateAck();
+    EXPECT_TRUE(newSender.processAck(ack.data(), ack.size(), now));
+    EXPECT_TRUE(newSender.empty());
+
+    // late datagrams from the old session are dropped
+    EXPECT_TRUE(receiver.processPacket(oldPacket.data(), oldPacket.size(), messages));
+    EXPECT_EQ(messages.size(), 4U);
+    EXPECT_EQ(receiver.session(), newSender.session());
+}
+
+TEST(UdpCore, reliable_clear_resync)
+{
+    helics::udp::ReliableSender sender(helics::udp::defaultReliableDatagramSize,
+                                       16,
+                                       std::chrono::milliseconds(10),
+                                       1);
+    helics::udp::ReliableReceiver receiver;
+    std::vector<std::string> messages;
+    std::vector<const std::string*> packets;
+    auto now = helics::udp::ReliableSender::clock_type::now();
+    sender.addMessage("delivered");
+    sender.collectPackets(now, packets);
+    EXPECT_TRUE(receiver.processPacket(packets[0]->data(), packets[0]->size(), messages));
+    auto ack = receiver.generateAck();
+    EXPECT_TRUE(sender.processAck(ack.data(), ack.size(), now));
+
+    // nothing gets through until the sender gives up
+    sender.addMessage("lost1");
+    sender.addMessage("lost2");
+    for (int ii = 0; ii < 4 && !sender.failed(); ++ii) {
+        packets.clear();
+        sender.collectPackets(now, packets);
+        now += std::chrono::milliseconds(50);
+    }
+    ASSERT_TRUE(sender.failed());
+    auto session = sender.session();
+    sender.clear();
+    EXPECT_NE(sender.session(), session);
+    // acknowledgements for the old session are ignored
+    EXPECT_FALSE(sender.processAck(ack.data(), ack.size(), now));
+
+    // the receiver follows the new session instead of waiting for the dropped datagrams
+    sender.addMessage("after");
+    packets.clear();
+    sender.collectPackets(now, packets);
+    ASSERT_EQ(packets.size(), 1U);
+    EXPECT_TRUE(receiver.processPacket(packets[0]->data(), packets[0]->size(), messages));
+    ASSERT_EQ(messages.size(), 2U);
+    EXPECT_EQ(messages[1], "after");
+    ack = receiver.generateAck();
+    EXPECT_TRUE(sender.processAck(ack.data(), ack.size(), now));
+    EXPECT_TRUE(sender.empty());
+}
+
+TEST(UdpCore, reliable_receiver_restart)
+{
+    helics::udp::ReliableSender sender(200);
+    auto oldReceiver = std::make_unique<helics::udp::ReliableReceiver>();
+    std::vector<std::string> messages;
+    std::vector<const std::string*> packets;
+    auto now = helics::udp::ReliableSender::clock_type::now();
+    sender.addMessage("first");
+    // a message in 3 fragments
+    sender.addMessage(std::string(500, 'f'));
+    sender.collectPackets(now, packets);
+    ASSERT_EQ(packets.size(), 4U);
+    // the old receiver gets the first message and the first fragment before it restarts
+    for (std::size_t ii = 0; ii < 2; ++ii) {
+        EXPECT_TRUE(oldReceiver->processPacket(packets[ii]->data(), packets[ii]->size(), messages));
+    }
+    auto ack = oldReceiver->generateAck();
+    EXPECT_TRUE(sender.processAck(ack.data(), ack.size(), now));
+    EXPECT_EQ(sender.outstanding(), 2U);
+    oldReceiver.reset();
+
+    helics::udp::ReliableReceiver newReceiver;
+    messages.clear();
+    sender.addMessage("last");
+    packets.clear();
+    sender.collectPackets(now, packets);
+    ASSERT_EQ(packets.size(), 1U);
+    EXPECT_TRUE(newReceiver.processPacket(packets[0]->data(), packets[0]->size(), messages));
+    EXPECT_TRUE(messages.empty());
+    // the acknowledgement from a new receiver moves the outstanding datagrams to a new session
+    auto session = sender.session();
+    ack = newReceiver.generateAck();
+    EXPECT_TRUE(sender.processAck(ack.data(), ack.size(), now));
+    EXPECT_NE(sender.session(), session);
+    packets.clear();
+    sender.collectPackets(now, packets);
+    ASSERT_EQ(packets.size(), 3U);
+    for (const auto* packet : packets) {
+        EXPECT_TRUE(newReceiver.processPacket(packet->data(), packet->size(), messages));
+    }
+    // the message whose start went to the old receiver is dropped instead of delivered partially
+    ASSERT_EQ(messages.size(), 1U);
+    EXPECT_EQ(messages[0], "last");
+    ack = newReceiver.generateAck();
+    EXPECT_TRUE(sender.processAck(ack.data(), ack.size(), now));
+    EXPECT_TRUE(sender.empty());
+}
+
+TEST(UdpCore, udpComm_transmit_through_reliable)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    std::atomic<int> counter2{0};
+    guarded<helics::ActionMessage> act2;
+
+    std::string host = "localhost";
+    helics::udp::UdpComms comm;
+    comm.loadTargetInfo(host, host);
+    helics::udp::UdpComms comm2;
+    comm2.loadTargetInfo(host, "");
+
+    comm.setBrokerPort(UDP_BROKER_PORT);
+    comm.setName("tests");
+    comm.setFlag("reliable", true);
+    comm2.setName("test2");
+    comm2.setPortNumber(UDP_BROKER_PORT);
+    comm.setPortNumber(UDP_SECONDARY_PORT);
+
+    comm.setCallback([](const helics::ActionMessage& /*m*/) {});
+    comm2.setCallback([&counter2, &act2](const helics::ActionMessage& m) {
+        ++counter2;
+        act2 = m;
+    });
+
+    auto connected_fut = std::async(std::launch::async, [&comm] { return comm.connect(); });
+
+    bool connected = comm2.connect();
+    ASSERT_TRUE(connected);
+    connected = connected_fut.get();
+    ASSERT_TRUE(connected);
+
+    // larger than a single datagram so it must be fragmented
+    helics::ActionMessage cmd(helics::CMD_SEND_MESSAGE);
+    cmd.payload = std::string(20000, 'r');
+    comm.transmit(helics::parent_route_id, helics::CMD_ACK);
+    comm.transmit(helics::parent_route_id, cmd);
+
+    std::this_thread::sleep_for(250ms);
+    if (counter2 != 2) {
+        std::this_thread::sleep_for(500ms);
+    }
+    ASSERT_EQ(counter2, 2);
+    EXPECT_TRUE(act2.lock()->action() == helics::CMD_SEND_MESSAGE);
+    EXPECT_EQ(act2.lock()->payload.size(), 20000U);
+
+    comm.disconnect();
+    comm2.disconnect();
+    std::this_thread::sleep_for(100ms);
+}
@@ -19,8 +19,12 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "helics/network/zmq/ZmqCore.h"
 
 #include "gtest/gtest.h"
+#include <cstdint>
 #include <future>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
 
 using namespace std::literals::chrono_literals;
 
@@ -166,6 +170,129 @@ TEST(ZMQSSCore, addroute)
     std::this_thread::sleep_for(100ms);
 }
 
+/** several comms connecting at the same time, each request is acknowledged and the broker
+resolves the routes to them by address*/
+TEST(ZMQSSCore, pipelined_connections)
+{
+    std::this_thread::sleep_for(400ms);
+    constexpr int commCount{6};
+    std::atomic<int> brokerCounter{0};
+    std::vector<std::atomic<int>> counters(commCount);
+
+    helics::zeromq::ZmqCommsSS broker;
+    broker.loadTargetInfo(host, std::string());
+    broker.setName("test_broker");
+    broker.setPortNumber(DEFAULT_ZMQSS_BROKER_PORT_NUMBER);
+    broker.setServerMode(true);
+    broker.setCallback([&brokerCounter](const helics::ActionMessage& /*m*/) { ++brokerCounter; });
+
+    std::vector<std::unique_ptr<helics::zeromq::ZmqCommsSS>> comms;
+    for (int ii = 0; ii < commCount; ++ii) {
+        comms.push_back(std::make_unique<helics::zeromq::ZmqCommsSS>());
+        auto& comm = *comms.back();
+        comm.loadTargetInfo(host, host);
+        comm.setBrokerPort(DEFAULT_ZMQSS_BROKER_PORT_NUMBER);
+        comm.setName("pipe" + std::to_string(ii));
+        comm.setServerMode(false);
+        comm.setCallback([&counters, ii](const helics::ActionMessage& /*m*/) { ++counters[ii]; });
+    }
+    std::vector<std::future<bool>> connections;
+    for (auto& comm : comms) {
+        connections.push_back(std::async(std::launch::async, [&comm] { return comm->connect(); }));
+    }
+    ASSERT_TRUE(broker.connect());
+    for (auto& connection : connections) {
+        EXPECT_TRUE(connection.get());
+    }
+
+    for (int ii = 0; ii < commCount; ++ii) {
+        comms[ii]->transmit(helics::parent_route_id, helics::CMD_ACK);
+        broker.addRoute(helics::route_id(ii + 2), comms[ii]->getAddress());
+        broker.transmit(helics::route_id(ii + 2), helics::CMD_ACK);
+    }
+    int cnt{0};
+    while (brokerCounter < commCount && cnt++ < 20) {
+        std::this_thread::sleep_for(100ms);
+    }
+    EXPECT_EQ(brokerCounter, commCount);
+    for (int ii = 0; ii < commCount; ++ii) {
+        cnt = 0;
+        while (counters[ii] == 0 && cnt++ < 20) {
+            std::this_thread::sleep_for(100ms);
+        }
+        EXPECT_EQ(counters[ii], 1) << "comm " << ii << " did not get its message";
+    }
+
+    for (auto& comm : comms) {
+        comm->disconnect();
+        EXPECT_FALSE(comm->isConnected());
+    }
+    broker.disconnect();
+    EXPECT_FALSE(broker.isConnected());
+    std::this_thread::sleep_for(100ms);
+}
+
+/** a broker which misses the first connection request, the request is resent with the same
+correlation id and an acknowledgement with another id is ignored*/
+TEST(ZMQSSCore, resent_connection_request)
+{
+    std::this_thread::sleep_for(400ms);
+    auto ctx = ZmqContextManager::getContextPointer();
+    zmq::socket_t routerSocket(ctx->getContext(), ZMQ_ROUTER);
+    routerSocket.setsockopt(ZMQ_LINGER, 100);
+    routerSocket.setsockopt(ZMQ_RCVTIMEO, 3000);
+    routerSocket.bind(std::string(host) + ":" + std::to_string(DEFAULT_ZMQSS_BROKER_PORT_NUMBER));
+
+    helics::zeromq::ZmqCommsSS comm;
+    comm.loadTargetInfo(host, host);
+    comm.setBrokerPort(DEFAULT_ZMQSS_BROKER_PORT_NUMBER);
+    comm.setName("resend_comm");
+    comm.setServerMode(false);
+    comm.setTimeout(300ms);
+    comm.setCallback([](const helics::ActionMessage& /*m*/) {});
+    auto connected = std::async(std::launch::async, [&comm] { return comm.connect(); });
+
+    auto receiveRequest = [&routerSocket](zmq::message_t& identity) {
+        zmq::message_t data;
+        EXPECT_TRUE(routerSocket.recv(identity));
+        EXPECT_TRUE(routerSocket.recv(data));
+        return helics::ActionMessage(static_cast<char*>(data.data()), data.size());
+    };
+    auto sendAck = [&routerSocket](zmq::message_t& identity, std::uint32_t sequence) {
+        helics::ActionMessage ack(helics::CMD_PROTOCOL);
+        ack.messageID = CONNECTION_ACK;
+        ack.sequenceID = sequence;
+        routerSocket.send(identity, zmq::send_flags::sndmore);
+        routerSocket.send(std::string{}, zmq::send_flags::sndmore);
+        routerSocket.send(ack.to_string(), zmq::send_flags::dontwait);
+    };
+
+    // the first request goes unanswered
+    zmq::message_t identity;
+    auto first = receiveRequest(identity);
+    EXPECT_EQ(first.messageID, CONNECTION_INFORMATION);
+    EXPECT_EQ(first.name, "resend_comm");
+    EXPECT_NE(first.sequenceID, 0U);
+
+    auto second = receiveRequest(identity);
+    EXPECT_EQ(second.messageID, CONNECTION_INFORMATION);
+    EXPECT_EQ(second.sequenceID, first.sequenceID);
+
+    // an acknowledgement of some other request does not complete the connection
+    sendAck(identity, first.sequenceID + 1);
+    EXPECT_EQ(connected.wait_for(200ms), std::future_status::timeout);
+    EXPECT_FALSE(comm.isConnected());
+
+    sendAck(identity, first.sequenceID);
+    ASSERT_EQ(connected.wait_for(2s), std::future_status::ready);
+    EXPECT_TRUE(connected.get());
+
+    comm.disconnect();
+    EXPECT_FALSE(comm.isConnected());
+    routerSocket.close();
+    std::this_thread::sleep_for(100ms);
+}
+
 TEST(ZMQSSCore, initialization)
 {
     std::atomic<int> counter{0};
@@ -8,6 +8,7 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "helics/network/NetworkBrokerData.hpp"
 
 #include "gtest/gtest.h"
+#include <vector>
 
 TEST(networkData_tests, basic_test)
 {
@@ -23,6 +24,28 @@ TEST(networkData_tests, basic_test)
     EXPECT_EQ(bdata.portNumber, 45);
 }
 
+TEST(networkData_tests, comms_cpus)
+{
+    helics::NetworkBrokerData bdata;
+    auto parser = bdata.commandLineParser("local");
+    parser->quiet = true;
+    EXPECT_TRUE(parser->helics_parse("--comms_cpus=4-6,1") ==
+                helics::helicsCLI11App::parse_output::ok);
+    EXPECT_EQ(bdata.commsCpus, (std::vector<int>{1, 4, 5, 6}));
+    EXPECT_TRUE(parser->helics_parse("--comms_cpus=3-1") ==
+                helics::helicsCLI11App::parse_output::parse_error);
+}
+
+TEST(networkData_tests, compression)
+{
+    helics::NetworkBrokerData bdata;
+    auto parser = bdata.commandLineParser("local");
+    EXPECT_TRUE(bdata.compression.empty());
+    parser->helics_parse("--compression=lzshuffle --compression_threshold=4096");
+    EXPECT_EQ(bdata.compression, "lzshuffle");
+    EXPECT_EQ(bdata.compressionThreshold, 4096);
+}
+
 TEST(networkData_tests, networkbrokerdata_stripProtocol_test)
 {
     EXPECT_EQ(helics::stripProtocol("tcp://127.0.0.1"), "127.0.0.1");
@@ -6,8 +6,14 @@ SPDX-License-Identifier: BSD-3-Clause
 */
 
 #include "ctestFixtures.hpp"
+#include "helics/shared_api_library/helicsCallbacks.h"
 
+#include <chrono>
 #include <gtest/gtest.h>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 class query_tests: public ::testing::TestWithParam<const char*>, public FederateTestFixture {
 };
@@ -92,3 +98,102 @@ TEST_P(query_tests, broker_queries)
 }
 
 INSTANTIATE_TEST_SUITE_P(query_tests, query_tests, ::testing::ValuesIn(core_types));
+
+/** collector for the results of a query subscription*/
+struct subscriptionResults {
+    std::mutex lock;
+    std::vector<std::string> results;
+
+    /** get the number of results received*/
+    size_t count()
+    {
+        std::lock_guard<std::mutex> lk(lock);
+        return results.size();
+    }
+    /** wait for at least a number of results to arrive*/
+    bool waitFor(size_t expected)
+    {
+        for (int ii = 0; ii < 200; ++ii) {
+            if (count() >= expected) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return false;
+    }
+    /** get the last result received*/
+    std::string last()
+    {
+        std::lock_guard<std::mutex> lk(lock);
+        return (results.empty()) ? std::string{} : results.back();
+    }
+};
+
+static void subscriptionUpdate(const char* result, int resultSize, void* userData)
+{
+    auto* res = reinterpret_cast<subscriptionResults*>(userData);
+    std::lock_guard<std::mutex> lk(res->lock);
+    res->results.emplace_back(result, static_cast<size_t>(resultSize));
+}
+
+class query_subscription_tests: public ::testing::Test, public FederateTestFixture {
+};
+
+TEST_F(query_subscription_tests, subscribe)
+{
+    SetupTest(helicsCreateValueFederate, "test", 2);
+    auto vFed1 = GetFederateAt(0);
+    auto vFed2 = GetFederateAt(1);
+    CE(auto core = helicsFederateGetCoreObject(vFed1, &err));
+
+    subscriptionResults fedResults;
+    subscriptionResults coreResults;
+    subscriptionResults brokerResults;
+    auto q1 = helicsCreateQuery("root", "federates");
+    auto q2 = helicsCreateQuery("root", "federates");
+    auto q3 = helicsCreateQuery("broker", "isconnected");
+
+    CE(helicsQuerySubscribe(q1, vFed1, 0.02, helics_true, subscriptionUpdate, &fedResults, &err));
+    CE(helicsQueryCoreSubscribe(
+        q2, core, 0.02, helics_true, subscriptionUpdate, &coreResults, &err));
+    CE(helicsQueryBrokerSubscribe(
+        q3, brokers[0], 0.02, helics_true, subscriptionUpdate, &brokerResults, &err));
+
+    // the results are delivered every period without any further calls
+    EXPECT_TRUE(fedResults.waitFor(2));
+    EXPECT_TRUE(coreResults.waitFor(2));
+    EXPECT_TRUE(brokerResults.waitFor(2));
+    EXPECT_EQ(fedResults.last(), "[fed0;fed1]");
+    EXPECT_EQ(coreResults.last(), "[fed0;fed1]");
+    EXPECT_EQ(brokerResults.last(), "true");
+
+    // a callback is required
+    helicsQuerySubscribe(q1, vFed1, 0.02, helics_false, nullptr, nullptr, &err);
+    EXPECT_EQ(err.error_code, helics_error_invalid_argument);
+    helicsErrorClear(&err);
+
+    helicsQueryUnsubscribe(q3);
+    // updates already in flight can still arrive until the broker processes the request
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    auto brokerCount = brokerResults.count();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_EQ(brokerResults.count(), brokerCount);
+    // unsubscribing again does nothing
+    helicsQueryUnsubscribe(q3);
+
+    // freeing the queries also stops the subscriptions
+    helicsQueryFree(q1);
+    helicsQueryFree(q2);
+    helicsQueryFree(q3);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    auto fedCount = fedResults.count();
+    auto coreCount = coreResults.count();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_EQ(fedResults.count(), fedCount);
+    EXPECT_EQ(coreResults.count(), coreCount);
+
+    helicsCoreFree(core);
+    CE(helicsFederateFinalizeAsync(vFed1, &err));
+    CE(helicsFederateFinalize(vFed2, &err));
+    CE(helicsFederateFinalizeComplete(vFed1, &err));
+}
@@ -2757,6 +2757,24 @@ TEST(evil_input_test, helicsInputGetVector)
     EXPECT_NE(err.error_code, 0);
 }
 
+TEST(evil_input_test, helicsInputGetVectorData)
+{
+    // const double* helicsInputGetVectorData(helics_input ipt, int* vectorSize, helics_error* err);
+    char rdata[256];
+    auto evil_input = reinterpret_cast<helics_input>(rdata);
+    auto err = helicsErrorInitialize();
+    err.error_code = 45;
+    int actLen = -56;
+    EXPECT_EQ(helicsInputGetVectorData(nullptr, &actLen, &err), nullptr);
+    EXPECT_EQ(err.error_code, 45);
+    EXPECT_EQ(actLen, 0);
+    helicsErrorClear(&err);
+    actLen = -56;
+    EXPECT_EQ(helicsInputGetVectorData(evil_input, &actLen, &err), nullptr);
+    EXPECT_EQ(actLen, 0);
+    EXPECT_NE(err.error_code, 0);
+}
+
 TEST(evil_input_test, helicsInputGetNamedPoint)
 {
     // void helicsInputGetNamedPoint(helics_input ipt, char* outputString, int maxStringLen, int*
@@ -753,6 +753,17 @@ void runFederateTestVectorD(const char* core,
         //  std::cout << testValue2[i] << "\n";
     }
 
+    // the same value without copying
+    const double* vdata = helicsInputGetVectorData(subid, &actualLen, &err);
+    EXPECT_EQ(err.error_code, 0);
+    EXPECT_EQ(actualLen, len2);
+    if (len2 > 0) {
+        ASSERT_NE(vdata, nullptr);
+        for (int i = 0; i < len2; i++) {
+            EXPECT_EQ(vdata[i], testValue2[i]);
+        }
+    }
+
     CE(helicsFederateFinalize(vFed, &err));
     delete[] val;
 }
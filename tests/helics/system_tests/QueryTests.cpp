@@ -15,7 +15,9 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "helics/core/helicsVersion.hpp"
 
 #include "gtest/gtest.h"
+#include <mutex>
 #include <thread>
+#include <vector>
 
 struct query: public FederateTestFixture, public ::testing::Test {
 };
@@ -515,6 +517,51 @@ TEST_F(query, data_flow_graph_concurrent)
     helics::cleanupHelicsLibrary();
 }
 
+TEST_F(query, data_flow_graph_cache)
+{
+    SetupTest<helics::ValueFederate>("test", 2);
+    auto vFed1 = GetFederateAs<helics::ValueFederate>(0);
+    auto vFed2 = GetFederateAs<helics::ValueFederate>(1);
+
+    auto core = vFed1->getCorePointer();
+    auto res = core->query("root", "data_flow_graph");
+    auto val = loadJsonStr(res);
+    EXPECT_EQ(val["cores"][0]["federates"].size(), 2U);
+
+    auto cache = loadJsonStr(core->query("root", "query_cache"));
+    EXPECT_TRUE(cache["caches"]["data_flow_graph"]["valid"].asBool());
+    auto version = cache["version"].asUInt64();
+    // a repeated query is answered from the cache
+    EXPECT_EQ(core->query("root", "data_flow_graph"), res);
+
+    // new interfaces and links change the structure so the cached result is replaced
+    vFed1->registerGlobalInput<double>("ipt1");
+    auto& p1 = vFed2->registerGlobalPublication<double>("pub1");
+    p1.addTarget("ipt1");
+    vFed1->enterInitializingModeAsync();
+    vFed2->enterInitializingMode();
+    vFed1->enterInitializingModeComplete();
+    cache = loadJsonStr(core->query("root", "query_cache"));
+    EXPECT_FALSE(cache["caches"]["data_flow_graph"]["valid"].asBool());
+    EXPECT_GT(cache["version"].asUInt64(), version);
+
+    res = core->query("root", "data_flow_graph");
+    val = loadJsonStr(res);
+    auto v1 = val["cores"][0]["federates"][0];
+    auto v2 = val["cores"][0]["federates"][1];
+    if (v1["id"].asInt() > v2["id"].asInt()) {
+        std::swap(v1, v2);
+    }
+    EXPECT_EQ(v1["inputs"][0]["sources"].size(), 1U);
+    EXPECT_EQ(v2["publications"][0]["targets"].size(), 1U);
+    cache = loadJsonStr(core->query("root", "query_cache"));
+    EXPECT_TRUE(cache["caches"]["data_flow_graph"]["valid"].asBool());
+    core = nullptr;
+    vFed1->finalize();
+    vFed2->finalize();
+    helics::cleanupHelicsLibrary();
+}
+
 TEST_F(query, updates_indices)
 {
     SetupTest<helics::ValueFederate>("test", 1);
@@ -699,6 +746,127 @@ TEST_F(query, update_values_all)
     helics::cleanupHelicsLibrary();
 }
 
+TEST_F(query, subscribed_query)
+{
+    SetupTest<helics::ValueFederate>("test", 2);
+    auto vFed1 = GetFederateAs<helics::ValueFederate>(0);
+    auto vFed2 = GetFederateAs<helics::ValueFederate>(1);
+
+    std::mutex resultLock;
+    std::vector<std::string> results;
+    auto id = vFed1->subscribeQuery(
+        "fed1",
+        "current_state",
+        [&](const std::string& res) {
+            std::lock_guard<std::mutex> lock(resultLock);
+            results.push_back(res);
+        },
+        0.05);
+    auto waitForResults = [&](std::size_t count) {
+        for (int ii = 0; ii < 100; ++ii) {
+            {
+                std::lock_guard<std::mutex> lock(resultLock);
+                if (results.size() >= count) {
+                    return true;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        return false;
+    };
+    ASSERT_TRUE(waitForResults(1U));
+
+    auto status = loadJsonStr(vFed1->query("core", "query_subscriptions"));
+    ASSERT_EQ(status["subscriptions"].size(), 1U);
+    EXPECT_EQ(status["subscriptions"][0]["target"].asString(), "fed1");
+    EXPECT_EQ(status["subscriptions"][0]["query"].asString(), "current_state");
+
+    vFed1->enterExecutingModeAsync();
+    vFed2->enterExecutingMode();
+    vFed1->enterExecutingModeComplete();
+    // the state change of the target produces a new result
+    ASSERT_TRUE(waitForResults(2U));
+    {
+        std::lock_guard<std::mutex> lock(resultLock);
+        EXPECT_NE(results.front(), results.back());
+        EXPECT_EQ(loadJsonStr(results.back())["name"].asString(), "fed1");
+    }
+    // the results are pushed by the target so the subscription was only registered once
+    status = loadJsonStr(vFed1->query("core", "query_subscriptions"));
+    ASSERT_EQ(status["subscriptions"].size(), 1U);
+    EXPECT_TRUE(status["subscriptions"][0]["confirmed"].asBool());
+    EXPECT_EQ(status["subscriptions"][0]["queries"].asInt(), 1);
+    auto watchers = loadJsonStr(vFed1->query("core", "query_watchers"));
+    ASSERT_EQ(watchers["watchers"].size(), 1U);
+    EXPECT_EQ(watchers["watchers"][0]["query"].asString(), "current_state");
+    EXPECT_GE(watchers["watchers"][0]["updates"].asInt(), 2);
+
+    vFed1->unsubscribeQuery(id);
+    status = loadJsonStr(vFed1->query("core", "query_subscriptions"));
+    EXPECT_EQ(status["subscriptions"].size(), 0U);
+    watchers = loadJsonStr(vFed1->query("core", "query_watchers"));
+    EXPECT_EQ(watchers["watchers"].size(), 0U);
+    vFed1->finalize();
+    vFed2->finalize();
+    helics::cleanupHelicsLibrary();
+}
+
+TEST_F(query, subscribed_query_root)
+{
+    SetupTest<helics::ValueFederate>("test", 2);
+    auto vFed1 = GetFederateAs<helics::ValueFederate>(0);
+    auto vFed2 = GetFederateAs<helics::ValueFederate>(1);
+
+    std::mutex resultLock;
+    std::vector<std::string> results;
+    auto id = vFed1->subscribeQuery(
+        "root",
+        "global_time",
+        [&](const std::string& res) {
+            std::lock_guard<std::mutex> lock(resultLock);
+            results.push_back(res);
+        },
+        0.01);
+    auto waitForGrant = [&](double grantTime) {
+        for (int ii = 0; ii < 100; ++ii) {
+            {
+                std::lock_guard<std::mutex> lock(resultLock);
+                if (!results.empty()) {
+                    auto val = loadJsonStr(results.back());
+                    const auto& feds = val["cores"][0]["federates"];
+                    if (feds.size() == 2U && feds[0]["granted_time"].asDouble() == grantTime &&
+                        feds[1]["granted_time"].asDouble() == grantTime) {
+                        return true;
+                    }
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        return false;
+    };
+    vFed1->enterExecutingModeAsync();
+    vFed2->enterExecutingMode();
+    vFed1->enterExecutingModeComplete();
+    EXPECT_TRUE(waitForGrant(0.0));
+
+    // the time grants inside the core reach the root broker without it querying again
+    vFed2->requestTimeAsync(1.0);
+    vFed1->requestTime(1.0);
+    vFed2->requestTimeComplete();
+    EXPECT_TRUE(waitForGrant(1.0));
+
+    auto status = loadJsonStr(vFed1->query("core", "query_subscriptions"));
+    ASSERT_EQ(status["subscriptions"].size(), 1U);
+    EXPECT_EQ(status["subscriptions"][0]["queries"].asInt(), 1);
+    auto watchers = loadJsonStr(vFed1->query("root", "query_watchers"));
+    EXPECT_EQ(watchers["watchers"].size(), 1U);
+
+    vFed1->unsubscribeQuery(id);
+    vFed1->finalize();
+    vFed2->finalize();
+    helics::cleanupHelicsLibrary();
+}
+
 #ifdef ENABLE_ZMQ_CORE
 TEST_F(query, query_subscriptions)
 {
@@ -11,6 +11,7 @@ SPDX-License-Identifier: BSD-3-Clause
 /** these test cases test out the value converters
  */
 #include "../application_api/testFixtures.hpp"
+#include "helics/common/JsonProcessingFunctions.hpp"
 #include "helics/helics.hpp"
 
 #include <future>
@@ -238,3 +239,163 @@ TEST_F(timing_tests2,ring_test3)
 }
 
 */
+
+/** the time dependencies between subtrees are routed through brokers aggregating time*/
+TEST_F(timing_tests2, aggregate_time_grants)
+{
+    auto root = AddBroker("test", "-f 3 --root");
+    auto brk1 = AddBroker("test", "--broker=" + root->getIdentifier() + " --aggregate_time");
+    auto brk2 = AddBroker("test", "--broker=" + root->getIdentifier() + " --aggregate_time");
+    ASSERT_TRUE(brk1->isConnected());
+    ASSERT_TRUE(brk2->isConnected());
+
+    helics::FederateInfo fi(helics::core_type::TEST);
+    fi.coreInitString = "-f 1 --broker=" + brk1->getIdentifier();
+    auto vFed1 = std::make_shared<helics::ValueFederate>("agg_fed1", fi);
+    fi.coreInitString = "-f 1 --broker=" + brk2->getIdentifier();
+    auto vFed2 = std::make_shared<helics::ValueFederate>("agg_fed2", fi);
+    fi.coreInitString = "-f 1 --broker=" + brk2->getIdentifier();
+    auto vFed3 = std::make_shared<helics::ValueFederate>("agg_fed3", fi);
+    federates.push_back(vFed1);
+    federates.push_back(vFed2);
+    federates.push_back(vFed3);
+
+    // two links between the same pair of federates in different subtrees
+    auto& pub1 = vFed1->registerGlobalPublication<double>("agg_pub1");
+    auto& pub1b = vFed1->registerGlobalPublication<double>("agg_pub1b");
+    auto& pub2 = vFed2->registerGlobalPublication<double>("agg_pub2");
+    auto& sub1 = vFed2->registerSubscription("agg_pub1");
+    auto& sub1b = vFed2->registerSubscription("agg_pub1b");
+    auto& sub2 = vFed3->registerSubscription("agg_pub2");
+
+    vFed1->enterExecutingModeAsync();
+    vFed2->enterExecutingModeAsync();
+    vFed3->enterExecutingMode();
+    vFed1->enterExecutingModeComplete();
+    vFed2->enterExecutingModeComplete();
+
+    vFed2->requestTimeAsync(5.0);
+    vFed3->requestTimeAsync(5.0);
+    EXPECT_EQ(vFed1->requestTime(2.0), 2.0);
+    pub1.publish(2.5);
+    pub1b.publish(3.5);
+    vFed1->requestTimeAsync(4.0);
+
+    // the values from the other subtree must hold the federates at the time they were sent
+    EXPECT_EQ(vFed2->requestTimeComplete(), 2.0);
+    EXPECT_DOUBLE_EQ(sub1.getValue<double>(), 2.5);
+    EXPECT_DOUBLE_EQ(sub1b.getValue<double>(), 3.5);
+    pub2.publish(7.0);
+    vFed2->requestTimeAsync(5.0);
+    EXPECT_EQ(vFed3->requestTimeComplete(), 2.0);
+    EXPECT_DOUBLE_EQ(sub2.getValue<double>(), 7.0);
+    vFed3->requestTimeAsync(5.0);
+
+    EXPECT_EQ(vFed1->requestTimeComplete(), 4.0);
+    vFed1->finalize();
+    EXPECT_EQ(vFed2->requestTimeComplete(), 5.0);
+    vFed2->finalize();
+    EXPECT_EQ(vFed3->requestTimeComplete(), 5.0);
+    vFed3->finalize();
+}
+
+/** nested aggregating brokers each stand for their own subtree toward their parent*/
+TEST_F(timing_tests2, aggregate_time_three_levels)
+{
+    auto root = AddBroker("test", "-f 3 --root");
+    auto top1 = AddBroker("test", "--broker=" + root->getIdentifier() + " --aggregate_time");
+    auto top2 = AddBroker("test", "--broker=" + root->getIdentifier() + " --aggregate_time");
+    auto mid = AddBroker("test", "--broker=" + top1->getIdentifier() + " --aggregate_time");
+    ASSERT_TRUE(top1->isConnected());
+    ASSERT_TRUE(top2->isConnected());
+    ASSERT_TRUE(mid->isConnected());
+
+    helics::FederateInfo fi(helics::core_type::TEST);
+    fi.coreInitString = "-f 1 --broker=" + mid->getIdentifier();
+    auto vFed1 = std::make_shared<helics::ValueFederate>("agg3_fed1", fi);
+    fi.coreInitString = "-f 1 --broker=" + top1->getIdentifier();
+    auto vFed2 = std::make_shared<helics::ValueFederate>("agg3_fed2", fi);
+    fi.coreInitString = "-f 1 --broker=" + top2->getIdentifier();
+    auto vFed3 = std::make_shared<helics::ValueFederate>("agg3_fed3", fi);
+    federates.push_back(vFed1);
+    federates.push_back(vFed2);
+    federates.push_back(vFed3);
+
+    // one link leaving only the middle subtree and one leaving both levels of it
+    auto& pub1 = vFed1->registerGlobalPublication<double>("agg3_pub1");
+    auto& sub2 = vFed2->registerSubscription("agg3_pub1");
+    auto& sub3 = vFed3->registerSubscription("agg3_pub1");
+
+    vFed1->enterExecutingModeAsync();
+    vFed2->enterExecutingModeAsync();
+    vFed3->enterExecutingMode();
+    vFed1->enterExecutingModeComplete();
+    vFed2->enterExecutingModeComplete();
+
+    // the middle broker stands for the federate below it toward its parent
+    auto midDeps = loadJsonStr(mid->query(mid->getIdentifier(), "dependencies"));
+    auto topDeps = loadJsonStr(top1->query(top1->getIdentifier(), "dependencies"));
+    ASSERT_EQ(midDeps["dependencies"].size(), 1U);
+    EXPECT_EQ(topDeps["dependencies"].size(), 1U);
+    EXPECT_EQ(topDeps["dependencies"][0].asInt(), midDeps["id"].asInt());
+
+    vFed2->requestTimeAsync(5.0);
+    vFed3->requestTimeAsync(5.0);
+    EXPECT_EQ(vFed1->requestTime(2.0), 2.0);
+    pub1.publish(2.5);
+    vFed1->requestTimeAsync(4.0);
+
+    EXPECT_EQ(vFed2->requestTimeComplete(), 2.0);
+    EXPECT_DOUBLE_EQ(sub2.getValue<double>(), 2.5);
+    EXPECT_EQ(vFed3->requestTimeComplete(), 2.0);
+    EXPECT_DOUBLE_EQ(sub3.getValue<double>(), 2.5);
+    vFed2->requestTimeAsync(5.0);
+    vFed3->requestTimeAsync(5.0);
+
+    EXPECT_EQ(vFed1->requestTimeComplete(), 4.0);
+    vFed1->finalize();
+    EXPECT_EQ(vFed2->requestTimeComplete(), 5.0);
+    vFed2->finalize();
+    EXPECT_EQ(vFed3->requestTimeComplete(), 5.0);
+    vFed3->finalize();
+}
+
+/** iterations between federates in different subtrees pass through the aggregating brokers*/
+TEST_F(timing_tests2, aggregate_time_iteration)
+{
+    auto root = AddBroker("test", "-f 2 --root");
+    auto brk1 = AddBroker("test", "--broker=" + root->getIdentifier() + " --aggregate_time");
+    auto brk2 = AddBroker("test", "--broker=" + root->getIdentifier() + " --aggregate_time");
+    ASSERT_TRUE(brk1->isConnected());
+    ASSERT_TRUE(brk2->isConnected());
+
+    helics::FederateInfo fi(helics::core_type::TEST);
+    fi.setProperty(helics_property_time_period, 1.0);
+    fi.coreInitString = "-f 1 --broker=" + brk1->getIdentifier();
+    auto vFed1 = std::make_shared<helics::ValueFederate>("aggit_fed1", fi);
+    fi.coreInitString = "-f 1 --broker=" + brk2->getIdentifier();
+    auto vFed2 = std::make_shared<helics::ValueFederate>("aggit_fed2", fi);
+    federates.push_back(vFed1);
+    federates.push_back(vFed2);
+
+    auto& pub = vFed1->registerGlobalPublication<double>("aggit_pub");
+    auto& sub = vFed2->registerSubscription("aggit_pub");
+
+    vFed1->enterExecutingModeAsync();
+    vFed2->enterExecutingMode();
+    vFed1->enterExecutingModeComplete();
+    pub.publish(27.0);
+
+    vFed1->requestTimeAsync(1.0);
+    auto comp = vFed2->requestTimeIterative(1.0, helics::iteration_request::iterate_if_needed);
+    EXPECT_TRUE(comp.state == helics::iteration_result::iterating);
+    EXPECT_EQ(comp.grantedTime, helics::timeZero);
+    EXPECT_DOUBLE_EQ(sub.getValue<double>(), 27.0);
+
+    comp = vFed2->requestTimeIterative(1.0, helics::iteration_request::iterate_if_needed);
+    EXPECT_TRUE(comp.state == helics::iteration_result::next_step);
+    EXPECT_EQ(comp.grantedTime, 1.0);
+    EXPECT_EQ(vFed1->requestTimeComplete(), 1.0);
+    vFed1->finalize();
+    vFed2->finalize();
+}
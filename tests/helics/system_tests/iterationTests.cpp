@@ -15,8 +15,11 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "helics/application_api/Publications.hpp"
 #include "helics/application_api/Subscriptions.hpp"
 #include "helics/application_api/ValueConverter.hpp"
+#include "helics/common/JsonProcessingFunctions.hpp"
 
 #include <future>
+#include <map>
+#include <string>
 
 struct iteration_tests: public FederateTestFixture, public ::testing::Test {
 };
@@ -341,3 +344,185 @@ TEST_F(iteration_tests, test_iteration_counter)
         }
     }
 }
+
+/** collect the iteration statistics of each federate in a global_iterations result*/
+static void collectIterationStats(const Json::Value& val, std::map<std::string, Json::Value>& stats)
+{
+    if (val.isObject()) {
+        if (val.isMember("steps")) {
+            stats[val["name"].asString()] = val;
+        }
+        for (const auto& member : val) {
+            collectIterationStats(member, stats);
+        }
+    } else if (val.isArray()) {
+        for (const auto& element : val) {
+            collectIterationStats(element, stats);
+        }
+    }
+}
+
+TEST_F(iteration_tests, coupled_iterations_downstream)
+{
+    SetupTest<helics::ValueFederate>("test", 3, 1.0);
+    auto vFed1 = GetFederateAs<helics::ValueFederate>(0);
+    auto vFed2 = GetFederateAs<helics::ValueFederate>(1);
+    auto vFed3 = GetFederateAs<helics::ValueFederate>(2);
+    // fed0 and fed1 are coupled, fed2 only consumes the output of fed0
+    auto pub1 =
+        helics::Publication(helics::GLOBAL, vFed1.get(), "pub1", helics::data_type::helics_int);
+    auto& sub1 = vFed2->registerSubscription("pub1");
+    auto pub2 =
+        helics::Publication(helics::GLOBAL, vFed2.get(), "pub2", helics::data_type::helics_int);
+    auto& sub2 = vFed1->registerSubscription("pub2");
+    auto& sub3 = vFed3->registerSubscription("pub1");
+    vFed1->setProperty(helics_property_time_period, 1.0);
+    vFed2->setProperty(helics_property_time_period, 1.0);
+    vFed3->setProperty(helics_property_time_period, 1.0);
+    vFed1->setFlagOption(helics_flag_coupled_iterations);
+    vFed2->setFlagOption(helics_flag_coupled_iterations);
+
+    vFed1->enterExecutingModeAsync();
+    vFed2->enterExecutingModeAsync();
+    vFed3->enterExecutingMode();
+    vFed1->enterExecutingModeComplete();
+    vFed2->enterExecutingModeComplete();
+
+    vFed3->requestTimeAsync(1.0);
+    int64_t c1 = 0;
+    int64_t c2 = 0;
+    pub1.publish(c1);
+    pub2.publish(c2);
+    while (c1 <= 10) {
+        EXPECT_EQ(sub1.getValue<int64_t>(), c1);
+        EXPECT_EQ(sub2.getValue<int64_t>(), c2);
+        ++c1;
+        ++c2;
+        if (c1 <= 10) {
+            pub1.publish(c1);
+            pub2.publish(c2);
+        }
+
+        vFed1->requestTimeIterativeAsync(1.0, helics::iteration_request::iterate_if_needed);
+        auto res = vFed2->requestTimeIterative(1.0, helics::iteration_request::iterate_if_needed);
+        auto res1 = vFed1->requestTimeIterativeComplete();
+        if (c1 <= 10) {
+            EXPECT_TRUE(res.state == helics::iteration_result::iterating);
+            EXPECT_TRUE(res1.state == helics::iteration_result::iterating);
+            EXPECT_EQ(res1.grantedTime, 0.0);
+            // the downstream federate is held at time 0 while the coupled federates iterate
+            EXPECT_FALSE(vFed3->isAsyncOperationCompleted());
+        } else {
+            EXPECT_TRUE(res.state == helics::iteration_result::next_step);
+            EXPECT_TRUE(res1.state == helics::iteration_result::next_step);
+            EXPECT_EQ(res1.grantedTime, 1.0);
+        }
+    }
+    // and released once they converge
+    auto granted = vFed3->requestTimeComplete();
+    EXPECT_EQ(granted, 1.0);
+    EXPECT_EQ(sub3.getValue<int64_t>(), 10);
+
+    auto val = loadJsonStr(vFed1->query("iterations"));
+    EXPECT_TRUE(val["coupled_iterations"].asBool());
+    EXPECT_EQ(val["steps"].asInt(), 1);
+    EXPECT_EQ(val["iterations"].asInt(), 10);
+    EXPECT_EQ(val["most_iterations"].asInt(), 10);
+    EXPECT_EQ(val["last_iterations"].asInt(), 10);
+    EXPECT_GT(val["messages_sent"].asInt64(), 0);
+    // fed2 saw one request holding it instead of every iteration
+    EXPECT_GT(val["messages_skipped"].asInt64(), 0);
+    ASSERT_EQ(val["dependencies"].size(), 1U);
+    EXPECT_TRUE(val["dependencies"][0].isMember("id"));
+    EXPECT_TRUE(val["dependencies"][0]["converged"].isBool());
+
+    std::map<std::string, Json::Value> stats;
+    collectIterationStats(loadJsonStr(vFed1->query("root", "global_iterations")), stats);
+    ASSERT_EQ(stats.size(), 3U);
+    EXPECT_EQ(val["dependencies"][0]["id"].asInt(), stats[vFed2->getName()]["id"].asInt());
+    EXPECT_EQ(stats[vFed1->getName()]["iterations"].asInt(), 10);
+    EXPECT_EQ(stats[vFed2->getName()]["steps"].asInt(), 1);
+    EXPECT_EQ(stats[vFed2->getName()]["iterations"].asInt(), 10);
+    // fed1 only has a coupled dependent so nothing was skipped
+    EXPECT_EQ(stats[vFed2->getName()]["messages_skipped"].asInt64(), 0);
+    EXPECT_EQ(stats[vFed3->getName()]["steps"].asInt(), 0);
+    EXPECT_FALSE(stats[vFed3->getName()]["coupled_iterations"].asBool());
+
+    vFed1->finalize();
+    vFed2->finalize();
+    vFed3->finalize();
+}
+
+TEST_F(iteration_tests, coupled_iterations_ring)
+{
+    SetupTest<helics::ValueFederate>("test", 3, 1.0);
+    auto vFed1 = GetFederateAs<helics::ValueFederate>(0);
+    auto vFed2 = GetFederateAs<helics::ValueFederate>(1);
+    auto vFed3 = GetFederateAs<helics::ValueFederate>(2);
+    // fed0->fed1->fed2->fed0, none of the dependents is also a direct dependency but all three
+    // are strongly coupled
+    auto pub1 =
+        helics::Publication(helics::GLOBAL, vFed1.get(), "pub1", helics::data_type::helics_int);
+    auto pub2 =
+        helics::Publication(helics::GLOBAL, vFed2.get(), "pub2", helics::data_type::helics_int);
+    auto pub3 =
+        helics::Publication(helics::GLOBAL, vFed3.get(), "pub3", helics::data_type::helics_int);
+    auto& sub1 = vFed2->registerSubscription("pub1");
+    auto& sub2 = vFed3->registerSubscription("pub2");
+    auto& sub3 = vFed1->registerSubscription("pub3");
+    for (const auto& fed : {vFed1, vFed2, vFed3}) {
+        fed->setProperty(helics_property_time_period, 1.0);
+        fed->setFlagOption(helics_flag_coupled_iterations);
+    }
+
+    vFed1->enterExecutingModeAsync();
+    vFed2->enterExecutingModeAsync();
+    vFed3->enterExecutingMode();
+    vFed1->enterExecutingModeComplete();
+    vFed2->enterExecutingModeComplete();
+
+    int64_t cnt = 0;
+    pub1.publish(cnt);
+    pub2.publish(cnt);
+    pub3.publish(cnt);
+    while (cnt <= 5) {
+        EXPECT_EQ(sub1.getValue<int64_t>(), cnt);
+        EXPECT_EQ(sub2.getValue<int64_t>(), cnt);
+        EXPECT_EQ(sub3.getValue<int64_t>(), cnt);
+        ++cnt;
+        if (cnt <= 5) {
+            pub1.publish(cnt);
+            pub2.publish(cnt);
+            pub3.publish(cnt);
+        }
+        vFed1->requestTimeIterativeAsync(1.0, helics::iteration_request::iterate_if_needed);
+        vFed2->requestTimeIterativeAsync(1.0, helics::iteration_request::iterate_if_needed);
+        auto res3 = vFed3->requestTimeIterative(1.0, helics::iteration_request::iterate_if_needed);
+        auto res1 = vFed1->requestTimeIterativeComplete();
+        auto res2 = vFed2->requestTimeIterativeComplete();
+        if (cnt <= 5) {
+            EXPECT_TRUE(res1.state == helics::iteration_result::iterating);
+            EXPECT_TRUE(res2.state == helics::iteration_result::iterating);
+            EXPECT_TRUE(res3.state == helics::iteration_result::iterating);
+            EXPECT_EQ(res3.grantedTime, 0.0);
+        } else {
+            EXPECT_TRUE(res1.state == helics::iteration_result::next_step);
+            EXPECT_TRUE(res2.state == helics::iteration_result::next_step);
+            EXPECT_TRUE(res3.state == helics::iteration_result::next_step);
+            EXPECT_EQ(res3.grantedTime, 1.0);
+        }
+    }
+
+    std::map<std::string, Json::Value> stats;
+    collectIterationStats(loadJsonStr(vFed1->query("root", "global_iterations")), stats);
+    ASSERT_EQ(stats.size(), 3U);
+    for (const auto& fed : {vFed1, vFed2, vFed3}) {
+        EXPECT_EQ(stats[fed->getName()]["iterations"].asInt(), 5);
+        // every dependent is in the coupled set so no iteration message was skipped
+        EXPECT_EQ(stats[fed->getName()]["messages_skipped"].asInt64(), 0);
+    }
+
+    vFed1->finalize();
+    vFed2->finalize();
+    vFed3->finalize();
+}
@@ -7,6 +7,8 @@ SPDX-License-Identifier: BSD-3-Clause
 
 #include "../application_api/testFixtures.hpp"
 #include "helics/ValueFederates.hpp"
+#include "helics/application_api/CombinationFederate.hpp"
+#include "helics/common/JsonProcessingFunctions.hpp"
 #include "helics/helics-config.h"
 
 #include "gtest/gtest.h"
@@ -120,3 +122,56 @@ TEST_F(network_tests, test_external_udp_ipv4)
 }
 
 #endif
+
+/** test connections resolved through sub-brokers owning their interfaces*/
+TEST_F(network_tests, interface_directory)
+{
+    auto root = AddBroker("test", "-f 2 --root");
+    auto sub1 = AddBroker("test", "--broker=" + root->getIdentifier() + " --interface_directory");
+    auto sub2 = AddBroker("test", "--broker=" + root->getIdentifier() + " --interface_directory");
+    ASSERT_TRUE(sub1->isConnected());
+    ASSERT_TRUE(sub2->isConnected());
+
+    helics::FederateInfo fi(helics::core_type::TEST);
+    fi.coreInitString = "-f 1 --broker=" + sub1->getIdentifier();
+    auto vFed1 = std::make_shared<helics::CombinationFederate>("dir_fed1", fi);
+    fi.coreInitString = "-f 1 --broker=" + sub2->getIdentifier();
+    auto vFed2 = std::make_shared<helics::CombinationFederate>("dir_fed2", fi);
+    federates.push_back(vFed1);
+    federates.push_back(vFed2);
+
+    // the subscription is made before the publication exists so the root looks it up at the
+    // other owning broker once both subtrees are ready
+    auto& sub = vFed2->registerSubscription("dir_pub");
+    auto& pub = vFed1->registerGlobalPublication<double>("dir_pub", "m");
+    auto& ept1 = vFed1->registerGlobalEndpoint("dir_ept1");
+    vFed2->registerGlobalEndpoint("dir_ept2");
+    sub.setDefault(0.0);
+
+    vFed1->enterExecutingModeAsync();
+    vFed2->enterExecutingMode();
+    vFed1->enterExecutingModeComplete();
+
+    pub.publish(3.5);
+    ept1.send("dir_ept2", "message");
+    vFed1->requestTimeAsync(1.0);
+    vFed2->requestTime(1.0);
+    vFed1->requestTimeComplete();
+
+    EXPECT_DOUBLE_EQ(sub.getValue<double>(), 3.5);
+    EXPECT_EQ(sub.getPublicationType(), "double");
+    EXPECT_TRUE(vFed2->hasMessage());
+
+    // the root caches the owners found by its lookups
+    auto counts = root->query("broker", "counts");
+    EXPECT_NE(counts.find("interface_directory"), std::string::npos);
+    // the interfaces held by the sub-brokers are listed by asking the owners
+    EXPECT_EQ(root->query("broker", "publications"), "[dir_pub]");
+    EXPECT_EQ(root->query("broker", "endpoints"), "[dir_ept1;dir_ept2]");
+    auto countsJson = loadJsonStr(counts);
+    EXPECT_GE(countsJson["handles"].asInt(), 3);
+    auto dataFlow = root->query("broker", "data_flow_graph");
+    EXPECT_NE(dataFlow.find("dir_pub"), std::string::npos);
+    vFed1->finalize();
+    vFed2->finalize();
+}
@@ -102,6 +102,13 @@ class webTest: public ::testing::Test {
         return result;
     }
 
+    static std::string readText()
+    {
+        buffer.consume(buffer.size());
+        stream->read(buffer);
+        return std::string{boost::asio::buffer_cast<const char*>(buffer.data()), buffer.size()};
+    }
+
     static std::shared_ptr<helics::Broker> addBroker(helics::core_type ctype,
                                                      const std::string& init)
     {
@@ -376,3 +383,45 @@ TEST_F(webTest, deleteJson)
     EXPECT_TRUE(val["brokers"].isArray());
     EXPECT_EQ(val["brokers"].size(), 0U);
 }
+
+TEST_F(webTest, subscribe)
+{
+    addBroker(helics::core_type::TEST, "--name=brksub");
+    Json::Value sub;
+    sub["command"] = "subscribe";
+    sub["broker"] = "brksub";
+    sub["target"] = "broker";
+    sub["query"] = "isconnected";
+    sub["period"] = "20";
+    sub["every_period"] = "true";
+    auto result = sendText(generateJsonString(sub));
+    auto val = loadJson(result);
+    EXPECT_EQ(val["status"].asInt(), 0);
+    ASSERT_TRUE(val.isMember("subscription"));
+    auto index = val["subscription"].asInt();
+
+    // the result is pushed every period without any further requests
+    for (int ii = 0; ii < 2; ++ii) {
+        val = loadJson(readText());
+        EXPECT_EQ(val["status"].asInt(), 0);
+        EXPECT_EQ(val["subscription"].asInt(), index);
+        EXPECT_EQ(val["value"].asString(), "true");
+    }
+
+    Json::Value unsub;
+    unsub["command"] = "unsubscribe";
+    unsub["subscription"] = std::to_string(index);
+    val = loadJson(sendText(generateJsonString(unsub)));
+    // updates already in flight can arrive before the response
+    while (val.isMember("value")) {
+        val = loadJson(readText());
+    }
+    EXPECT_EQ(val["status"].asInt(), 0);
+
+    unsub["subscription"] = std::to_string(index + 1000);
+    val = loadJson(sendText(generateJsonString(unsub)));
+    while (val.isMember("value")) {
+        val = loadJson(readText());
+    }
+    EXPECT_EQ(val["status"].asInt(), 404);
+}
@@ -1,3 +1,4 @@
+import array
 import os
 import time
 import pytest as pt
@@ -389,6 +390,35 @@ def test_value_federate_runFederateTestVectorD(vFed):
     assert value == [3, 4, 5]
 
 
+def test_value_federate_runFederateTestVectorBuffer(vFed):
+    testValue = array.array("d", [3.5, 4.5, 5.5])
+    pubid = h.helicsFederateRegisterGlobalPublication(vFed, "pub1", h.helics_data_type_vector, "")
+    subid = h.helicsFederateRegisterSubscription(vFed, "pub1", "")
+    h.helicsInputSetDefaultVector(subid, array.array("d", [0.0, 1.0]))
+
+    h.helicsFederateEnterExecutingMode(vFed)
+
+    value = h.helicsInputGetVectorData(subid)
+    assert value.format == "d"
+    assert value.tolist() == [0.0, 1.0]
+
+    h.helicsPublicationPublishVector(pubid, testValue)
+    grantedtime = h.helicsFederateRequestTime(vFed, 1.0)
+    assert grantedtime == 0.01
+
+    value = h.helicsInputGetVectorData(subid)
+    assert value.tolist() == [3.5, 4.5, 5.5]
+
+    # the view owns its data so it is unaffected by later values of the input
+    h.helicsPublicationPublishVector(pubid, [1.0])
+    h.helicsFederateRequestTime(vFed, 2.0)
+    assert h.helicsInputGetVector(subid) == [1.0]
+    assert value.tolist() == [3.5, 4.5, 5.5]
+
+    with pt.raises(ValueError):
+        h.helicsPublicationPublishVector(pubid, array.array("f", [1.0]))
+
+
 @pt.fixture
 def helicsBroker():
     initstring = "-f 1 --name=mainbroker"